@@ -0,0 +1,65 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdio.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Reads a monotonic clock.
+ *
+ *  Returns:
+ *    The current time in seconds.
+ */
+double bench_now(void);
+
+/** Produces the next pseudo random number.
+ *
+ *  Arguments:
+ *    state: The generator state, must not start at zero.
+ *
+ *  Returns:
+ *    The next number in the sequence.
+ */
+unsigned long bench_random(unsigned long * state);
+
+/** Prints a line of results.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ *    name: The name of the benchmark.
+ *    operations: The number of operations that were timed.
+ *    seconds: The time they took.
+ */
+void bench_report(FILE * stream, const char * name,
+	size_t operations, double seconds);
+
+/** Prints the spread of a set of timings.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ *    name: The name of the benchmark.
+ *    samples: The time each operation took in seconds.
+ *             They are sorted in place.
+ *    count: The number of samples.
+ */
+void bench_report_latency(FILE * stream, const char * name,
+	double * samples, size_t count);
+
+/** Parses a count from the command line.
+ *
+ *  Arguments:
+ *    text: The argument text.
+ *    count: Where to put the count.
+ *
+ *  Returns:
+ *    Zero on success. -1 otherwise.
+ */
+int bench_parse_count(const char * text, size_t * count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //__BENCH_H__
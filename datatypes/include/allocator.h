@@ -0,0 +1,108 @@
+#ifndef __ALLOCATOR_H__
+#define __ALLOCATOR_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/** Where a container gets its memory.
+ *
+ *  Containers made with a _new_with_allocator constructor
+ *  get the container itself, and everything it allocates
+ *  later such as buffers, nodes, buckets and iterators,
+ *  from its allocator. Passing NULL for the allocator
+ *  uses malloc, realloc and free.
+ *
+ *  Notes:
+ *    Containers keep a pointer to the allocator so it
+ *    must outlive every container made with it.
+ *    Sizes are passed to realloc and free so arenas
+ *    and accounting allocators need no headers.
+ */
+struct dt_allocator {
+	/** Allocates memory.
+	 *
+	 *  Arguments:
+	 *    ctx: The allocator's ctx.
+	 *    size: The number of bytes wanted.
+	 *
+	 *  Returns:
+	 *    Memory aligned for any type. Or NULL if there
+	 *    is not enough memory.
+	 */
+	void * (* alloc)(void * ctx, size_t size);
+
+	/** Resizes memory from alloc, keeping its contents.
+	 *
+	 *  Arguments:
+	 *    ctx: The allocator's ctx.
+	 *    pointer: The memory to resize.
+	 *    old_size: The size pointer was allocated with.
+	 *    new_size: The number of bytes wanted.
+	 *
+	 *  Returns:
+	 *    The resized memory. Or NULL if there is not
+	 *    enough memory, in which case pointer is untouched.
+	 */
+	void * (* realloc)(void * ctx, void * pointer,
+		size_t old_size, size_t new_size);
+
+	/** Gives memory back.
+	 *
+	 *  Arguments:
+	 *    ctx: The allocator's ctx.
+	 *    pointer: The memory to give back.
+	 *    size: The size pointer was allocated with.
+	 */
+	void (* free)(void * ctx, void * pointer, size_t size);
+
+	// Passed to every call. Whatever the allocator needs.
+	void * ctx;
+};
+
+/** Allocates memory from an allocator.
+ *
+ *  Arguments:
+ *    allocator: The allocator. NULL for malloc.
+ *    size: The number of bytes wanted.
+ *
+ *  Returns:
+ *    The memory. Or NULL if there is not enough memory.
+ */
+void * dt_allocator_alloc(const struct dt_allocator * allocator,
+	size_t size);
+
+/** Resizes memory from an allocator.
+ *
+ *  Arguments:
+ *    allocator: The allocator the memory came from.
+ *               NULL for malloc.
+ *    pointer: The memory to resize.
+ *    old_size: The size pointer was allocated with.
+ *    new_size: The number of bytes wanted.
+ *
+ *  Returns:
+ *    The resized memory. Or NULL if there is not
+ *    enough memory, in which case pointer is untouched.
+ */
+void * dt_allocator_realloc(const struct dt_allocator * allocator,
+	void * pointer, size_t old_size, size_t new_size);
+
+/** Gives memory back to an allocator.
+ *
+ *  Arguments:
+ *    allocator: The allocator the memory came from.
+ *               NULL for malloc.
+ *    pointer: The memory to give back.
+ *    size: The size pointer was allocated with.
+ */
+void dt_allocator_free(const struct dt_allocator * allocator,
+	void * pointer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __ALLOCATOR_H__
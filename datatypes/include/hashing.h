@@ -0,0 +1,28 @@
+#ifndef __HASHING_H__
+#define __HASHING_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Remaps a hash to another hash.
+ *
+ *  Computes (a * hash + b) mod p for a fixed prime p
+ *  just over 2^32, a universal hash. Used by the hash
+ *  containers so a poor hash function, one that only
+ *  varies in its high bits say, still spreads items
+ *  over a power of two table.
+ *
+ *  Arguments:
+ *    hash: The hash to remap.
+ *
+ *  Returns:
+ *    The remapped hash.
+ */
+unsigned int dt_hash_universal(unsigned int hash);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HASHING_H__
@@ -10,6 +10,10 @@ extern "C" {
 struct dt_list;
 struct dt_list_iterator;
 
+// The number of pointers of state an iterator
+// can keep without allocating.
+#define DT_LIST_ITERATOR_STATE_LENGTH 4
+
 
 /** A List Interface.
  */
@@ -55,6 +59,60 @@ struct dt_list {
 	 */
 	int (* remove)(struct dt_list * this_, size_t index);
 
+	/** Inserts several items starting at the given index.
+	 *
+	 *  Arguments:
+	 *    this_: This list.
+	 *    index: The index to insert the first item at [0, length].
+	 *    items: The items to insert, in order.
+	 *    count: The number of items to insert.
+	 *
+	 *  Returns:
+	 *    Zero on success. A negative number otherwise.
+	 *
+	 *  Notes:
+	 *    Invalidates all iterators.
+	 *
+	 *    The list is left unchanged on failure.
+	 */
+	int (* insert_range)(struct dt_list * this_, size_t index,
+		void * const * items, size_t count);
+
+	/** Removes several items starting at the given index.
+	 *
+	 *  Arguments:
+	 *    this_: This list.
+	 *    index: The index of the first item to remove.
+	 *    count: The number of items to remove,
+	 *           index + count must be in [0, length].
+	 *
+	 *  Returns:
+	 *    Zero on success. A negative number otherwise.
+	 *
+	 *  Notes:
+	 *    Invalidates all iterators.
+	 */
+	int (* remove_range)(struct dt_list * this_, size_t index,
+		size_t count);
+
+	/** Adds several items to the end of the list.
+	 *
+	 *  Arguments:
+	 *    this_: This list.
+	 *    items: The items to add, in order.
+	 *    count: The number of items to add.
+	 *
+	 *  Returns:
+	 *    Zero on success. A negative number otherwise.
+	 *
+	 *  Notes:
+	 *    Invalidates all iterators.
+	 *
+	 *    The list is left unchanged on failure.
+	 */
+	int (* append_many)(struct dt_list * this_,
+		void * const * items, size_t count);
+
 	/** Gets the length of the list.
 	 *
 	 *  Arguments:
@@ -79,6 +137,22 @@ struct dt_list {
 	 */
 	struct dt_list_iterator * (* iterator)
 		(struct dt_list * this_);
+
+	/** Creates a list iterator in memory owned by the caller.
+	 *
+	 *  Arguments:
+	 *    this_: This list.
+	 *    storage: The memory to set the iterator up in.
+	 *
+	 *  Returns:
+	 *    storage as an iterator. This never fails.
+	 *
+	 *  Notes:
+	 *    The same as iterator but nothing is allocated.
+	 *    del must still be called but does not free storage.
+	 */
+	struct dt_list_iterator * (* iterator_init)
+		(struct dt_list * this_, struct dt_list_iterator * storage);
 	
 	/** Deletes this list.
 	 *
@@ -199,6 +273,11 @@ struct dt_list_iterator {
 	/** Internal state.
 	 */
 	void * _data;
+
+	/** Room for internal state so the
+	 *  iterator does not need to allocate.
+	 */
+	void * _state[DT_LIST_ITERATOR_STATE_LENGTH];
 };
 
 
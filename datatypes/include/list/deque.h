@@ -0,0 +1,21 @@
+#ifndef __LIST_DEQUE_H__
+#define __LIST_DEQUE_H__
+
+#include "list.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Creates a new deque list.
+ *
+ *  Returns:
+ *    A new list. Or NULL if there is not
+ *    enough memory.
+ */
+struct dt_list * dt_list_deque_new(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //__LIST_DEQUE_H__
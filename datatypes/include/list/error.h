@@ -7,5 +7,8 @@
 /** Invalid index.
  */
 #define DT_LIST_EINDEX -1
+/** The list can not be used for the operation.
+ */
+#define DT_LIST_ETYPE -3
 
 #endif //__LIST_ERROR_H__
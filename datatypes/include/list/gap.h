@@ -0,0 +1,21 @@
+#ifndef __LIST_GAP_H__
+#define __LIST_GAP_H__
+
+#include "list.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Creates a new gap buffer list.
+ *
+ *  Returns:
+ *    A new list. Or NULL if there is not
+ *    enough memory.
+ */
+struct dt_list * dt_list_gap_new(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //__LIST_GAP_H__
@@ -0,0 +1,49 @@
+#ifndef __LIST_INTRUSIVE_H__
+#define __LIST_INTRUSIVE_H__
+
+#include "list.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct dt_list_link;
+
+/** The links an item embeds to be put in an intrusive list.
+ */
+struct dt_list_link {
+	struct dt_list_link * next;
+	struct dt_list_link * previous;
+};
+
+/** Creates a new intrusive linked list.
+ *
+ *  The list chains items through a dt_list_link embedded
+ *  in each item, so inserting never allocates.
+ *
+ *  Arguments:
+ *    offset: The offset of the dt_list_link in each item,
+ *            as given by offsetof.
+ *
+ *  Returns:
+ *    A new list. Or NULL if there is not
+ *    enough memory.
+ *
+ *  Notes:
+ *    Items must not be NULL and can only be in one list
+ *    through the same link at a time. The list does not own
+ *    its items: removing or deleting the list leaves them
+ *    alone apart from their links.
+ *
+ *    Like the linked list it remembers the last link found
+ *    by index, so get changes the list even though it takes
+ *    a const list. Threads sharing an intrusive list, or a
+ *    read only list of one, must synchronise even when they
+ *    only read.
+ */
+struct dt_list * dt_list_intrusive_new(size_t offset);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //__LIST_INTRUSIVE_H__
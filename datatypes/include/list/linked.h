@@ -1,7 +1,9 @@
 #ifndef __LIST_LINKED_H__
 #define __LIST_LINKED_H__
 
+#include "allocator.h"
 #include "list.h"
+#include "pool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -12,9 +14,142 @@ extern "C" {
  *  Returns:
  *    A new list. Or NULL if there is not
  *    enough memory.
+ *
+ *  Notes:
+ *    Every linked list remembers the last node found by
+ *    index, so get changes the list even though it takes
+ *    a const list. Threads sharing a linked list, or a
+ *    read only list of one, must synchronise even when
+ *    they only read.
  */
 struct dt_list * dt_list_linked_new(void);
 
+/** Creates a new linked list using an allocator.
+ *
+ *  Arguments:
+ *    allocator: Where the list, its nodes and its
+ *               iterators come from. NULL for malloc.
+ *
+ *  Returns:
+ *    A new list. Or NULL if there is not
+ *    enough memory.
+ */
+struct dt_list * dt_list_linked_new_with_allocator(
+	const struct dt_allocator * allocator);
+
+/** Creates a new linked list that takes its nodes from a pool.
+ *
+ *  Arguments:
+ *    pool: The pool to use. Its items must be at least
+ *          dt_list_linked_node_size() bytes. It may be
+ *          shared with other containers and must outlive
+ *          the list. If NULL the list makes a pool of its
+ *          own and deletes it with the list.
+ *
+ *  Returns:
+ *    A new list. Or NULL if there is not
+ *    enough memory or the pool's items are too small.
+ */
+struct dt_list * dt_list_linked_pooled_new(struct dt_pool * pool);
+
+/** The size of a linked list node.
+ *
+ *  Returns:
+ *    The size in bytes.
+ */
+size_t dt_list_linked_node_size(void);
+
+/** Moves a range of items from one linked list to another.
+ *
+ *  Arguments:
+ *    dst: The linked list to move the items to.
+ *    dst_index: Where in dst the first item goes. At most
+ *               the length of dst.
+ *    src: The linked list to move the items from. Must not
+ *         be dst.
+ *    src_begin: The index of the first item to move.
+ *    src_end: The index after the last item to move.
+ *
+ *  Returns:
+ *    Zero on success. DT_LIST_EINDEX if an index is out of
+ *    range. DT_LIST_ETYPE if either list is not a linked list
+ *    or both are the same list. DT_LIST_ENOMEM if there is
+ *    not enough memory. Nothing changes on failure.
+ *
+ *  Notes:
+ *    The nodes are relinked, not copied, when both lists take
+ *    their nodes from the same place, so the cost is one walk
+ *    to each end of the range and one to dst_index. Lists
+ *    with different pools copy the nodes instead.
+ */
+int dt_list_linked_splice(struct dt_list * dst, size_t dst_index,
+	struct dt_list * src, size_t src_begin, size_t src_end);
+
+/** Moves a range of items between linked lists using iterators.
+ *
+ *  Arguments:
+ *    dst: An iterator on the linked list to move the items
+ *         to. The items go before its current item.
+ *    src_begin: An iterator at the first item to move.
+ *    src_end: An iterator after the last item to move, on
+ *             the same list as src_begin and not before it.
+ *
+ *  Returns:
+ *    Zero on success. DT_LIST_EINDEX if src_end is before
+ *    src_begin. DT_LIST_ETYPE if an iterator is not from a
+ *    linked list or cannot edit it, as for a read only
+ *    list, src_begin and src_end are from different
+ *    lists or dst is from the same list. DT_LIST_ENOMEM if
+ *    there is not enough memory.
+ *
+ *  Notes:
+ *    Takes constant time when both lists take their nodes
+ *    from the same place. Afterwards dst is at the first
+ *    item moved, and src_begin and src_end are both at the
+ *    item that followed the range. Other iterators on either
+ *    list are invalidated.
+ */
+int dt_list_linked_splice_iterators(struct dt_list_iterator * dst,
+	struct dt_list_iterator * src_begin,
+	struct dt_list_iterator * src_end);
+
+/** Moves every item of one linked list to the end of another.
+ *
+ *  Arguments:
+ *    dst: The linked list to append to.
+ *    src: The linked list to empty. Must not be dst.
+ *
+ *  Returns:
+ *    The same as dt_list_linked_splice.
+ *
+ *  Notes:
+ *    Takes constant time when both lists take their
+ *    nodes from the same place.
+ */
+int dt_list_linked_concat(struct dt_list * dst, struct dt_list * src);
+
+/** Splits a linked list in two.
+ *
+ *  Arguments:
+ *    list: The linked list to split.
+ *    index: The index of the first item to move out. At
+ *           most the length of the list.
+ *
+ *  Returns:
+ *    A new linked list holding the items from index on,
+ *    which are removed from list. Or NULL if there is not
+ *    enough memory, the index is out of range or list is
+ *    not a linked list.
+ *
+ *  Notes:
+ *    The new list takes its nodes from the same place as
+ *    list, so the nodes are relinked with a single walk.
+ *    A list that owns its pool is the exception: the new
+ *    list gets a pool of its own and the nodes are copied.
+ */
+struct dt_list * dt_list_linked_split_at(struct dt_list * list,
+	size_t index);
+
 #ifdef __cplusplus
 }
 #endif
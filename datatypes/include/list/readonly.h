@@ -1,6 +1,7 @@
 #ifndef __LIST_READONLY_H__
 #define __LIST_READONLY_H__
 
+#include "allocator.h"
 #include "list.h"
 
 #ifdef __cplusplus
@@ -22,6 +23,20 @@ extern "C" {
  */
 struct dt_list * dt_list_readonly_new(struct dt_list * list);
 
+/** Creates a new read only list using an allocator.
+ *
+ *  Arguments:
+ *    list: The list to make an image of.
+ *    allocator: Where the read only list and its
+ *               iterators come from. NULL for malloc.
+ *
+ *  Returns:
+ *    A new list. Or NULL if there is not
+ *    enough memory.
+ */
+struct dt_list * dt_list_readonly_new_with_allocator(struct dt_list * list,
+	const struct dt_allocator * allocator);
+
 #ifdef __cplusplus
 }
 #endif
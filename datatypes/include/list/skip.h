@@ -0,0 +1,25 @@
+#ifndef __LIST_SKIP_H__
+#define __LIST_SKIP_H__
+
+#include "list.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Creates a new indexable skip list.
+ *
+ *  Returns:
+ *    A new list. Or NULL if there is not
+ *    enough memory.
+ *
+ *  Notes:
+ *    Get, insert and remove by index take O(log n)
+ *    expected time. Iterators step in O(1).
+ */
+struct dt_list * dt_list_skip_new(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //__LIST_SKIP_H__
@@ -1,20 +1,82 @@
 #ifndef __LIST_VECTOR_H__
 #define __LIST_VECTOR_H__
 
+#include "allocator.h"
 #include "list.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// The number of items a vector list holds
+// before it needs a buffer of its own.
+#define DT_LIST_VECTOR_INLINE_LENGTH 8
+
+/** Memory for a vector list set up with dt_list_vector_init.
+ *
+ *  Notes:
+ *    The fields are private. Only the size matters.
+ */
+struct dt_list_vector_storage {
+	struct dt_list list;
+	void * _implementation[4 + DT_LIST_VECTOR_INLINE_LENGTH];
+};
+
 /** Creates a new vector list.
  *
  *  Returns:
  *    A new list. Or NULL if there is not
  *    enough memory.
+ *
+ *  Notes:
+ *    The list and its first few items live in a single
+ *    allocation. See DT_LIST_VECTOR_INLINE_LENGTH.
  */
 struct dt_list * dt_list_vector_new(void);
 
+/** Creates a new vector list using an allocator.
+ *
+ *  Arguments:
+ *    allocator: Where the list, its buffer and its
+ *               iterators come from. NULL for malloc.
+ *
+ *  Returns:
+ *    A new list. Or NULL if there is not
+ *    enough memory.
+ */
+struct dt_list * dt_list_vector_new_with_allocator(
+	const struct dt_allocator * allocator);
+
+/** Sets up a vector list in memory owned by the caller.
+ *
+ *  Arguments:
+ *    storage: The memory to use. It must outlive the list.
+ *
+ *  Returns:
+ *    The list. This never fails.
+ *
+ *  Notes:
+ *    The list's del releases anything the list allocated
+ *    after it outgrew storage but does not free storage.
+ */
+struct dt_list * dt_list_vector_init(struct dt_list_vector_storage * storage);
+
+/** Sets up a vector list in memory owned by the caller
+ *  using an allocator.
+ *
+ *  Arguments:
+ *    storage: The memory to use. It must outlive the list.
+ *    allocator: Where the buffer and iterators come from
+ *               once the list outgrows storage. NULL for
+ *               malloc.
+ *
+ *  Returns:
+ *    The list. This never fails.
+ */
+struct dt_list * dt_list_vector_init_with_allocator(
+	struct dt_list_vector_storage * storage,
+	const struct dt_allocator * allocator);
+
 #ifdef __cplusplus
 }
 #endif
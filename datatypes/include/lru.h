@@ -0,0 +1,117 @@
+#ifndef __LRU_H__
+#define __LRU_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+struct dt_lru;
+
+/** Creates a new least recently used cache.
+ *
+ *  Items are found through a hash index whose entries
+ *  are also linked in order of use, so finding, promoting
+ *  and evicting an item are all O(1).
+ *
+ * Arguments:
+ *   capacity: The most items the cache holds. Not zero.
+ *   comparator: A function which orders inputs.
+ *     Arguments:
+ *       a: The first item.
+ *       b: The second item.
+ *
+ *     Returns:
+ *       0 if a is logically equal to b.
+ *       -1 if a comes before b.
+ *       1 if a comes after b.
+ *   hash: A function which maps
+ *         inputs down to a number.
+ *     Arguments:
+ *       item: The item to hash.
+ *     Returns:
+ *       A number.
+ *   evict: Called with each item the cache lets go of:
+ *          the least recently used one when a put overflows,
+ *          one replaced by an equal item and everything left
+ *          when the cache is deleted. May be NULL.
+ *     Arguments:
+ *       item: The item let go of.
+ *
+ *  Returns:
+ *    A new cache. Or NULL if capacity is zero or there
+ *    is not enough memory.
+ *
+ *  Notes:
+ *    Like a set the comparator and hash may look at only
+ *    part of an item, such as a key, leaving the rest for
+ *    the cached value. evict must not use the cache.
+ */
+struct dt_lru * dt_lru_new(size_t capacity,
+	int (* comparator)(void * a, void * b),
+	unsigned int (* hash)(void * item),
+	void (* evict)(void * item));
+
+/** Looks up an item and marks it most recently used.
+ *
+ *  Arguments:
+ *    lru: The cache.
+ *    item: An item equal to the one to find.
+ *
+ *  Returns:
+ *    The cached item, if found, NULL otherwise.
+ */
+void * dt_lru_get(struct dt_lru * lru, void * item);
+
+/** Puts an item in the cache as the most recently used.
+ *
+ *  Arguments:
+ *    lru: The cache.
+ *    item: The item to put. It replaces an equal item
+ *          already cached.
+ *
+ *  Returns:
+ *    Zero on success. DT_LRU_ENOMEM if there is not
+ *    enough memory.
+ *
+ *  Notes:
+ *    If the cache was full the least recently used item
+ *    is evicted to make room.
+ */
+int dt_lru_put(struct dt_lru * lru, void * item);
+
+/** Takes an item out of the cache.
+ *
+ *  Arguments:
+ *    lru: The cache.
+ *    item: An item equal to the one to remove.
+ *
+ *  Returns:
+ *    The removed item, if found, NULL otherwise.
+ *    It is not passed to evict.
+ */
+void * dt_lru_remove(struct dt_lru * lru, void * item);
+
+/** The number of items in the cache.
+ *
+ *  Arguments:
+ *    lru: The cache.
+ *
+ *  Returns:
+ *    The number of items.
+ */
+size_t dt_lru_length(const struct dt_lru * lru);
+
+/** Deletes the cache, evicting every item left.
+ *
+ *  Arguments:
+ *    lru: The cache.
+ */
+void dt_lru_del(struct dt_lru * lru);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LRU_H__
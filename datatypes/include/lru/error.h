@@ -0,0 +1,8 @@
+#ifndef __LRU_ERROR_H__
+#define __LRU_ERROR_H__
+
+/** Not enough memory.
+ */
+#define DT_LRU_ENOMEM -1
+
+#endif //__LRU_ERROR_H__
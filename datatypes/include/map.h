@@ -0,0 +1,143 @@
+#ifndef __MAP_H__
+#define __MAP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+struct dt_map;
+
+/** A Map Interface.
+ *
+ *  Keys and values are fixed size and copied into
+ *  the map, which owns its copies.
+ */
+
+struct dt_map {
+
+	/** Maps the key to the value.
+	 *
+	 *  Arguments:
+	 *    this_: This map.
+	 *    key: The key to copy in.
+	 *    value: The value to copy in. Replaces the value
+	 *           already mapped to an equal key. May be
+	 *           NULL if the map's value_size is zero.
+	 *
+	 *  Returns:
+	 *    Zero on success. A negative number otherwise.
+	 */
+	int (* put)(struct dt_map * this_, void * key, void * value);
+
+	/** Looks up the value for a key.
+	 *
+	 *  Arguments:
+	 *    this_: This map.
+	 *    key: The key to look up.
+	 *
+	 *  Returns:
+	 *    The map's copy of the value, if found, null
+	 *    otherwise. It may be changed in place.
+	 *
+	 *  Note:
+	 *    Any put or remove may move the value.
+	 */
+	void * (* get)(const struct dt_map * this_, void * key);
+
+	/** Removes a key and its value from the map.
+	 *
+	 *  Arguments:
+	 *    this_: This map.
+	 *    key: The key to remove.
+	 */
+	void (* remove)(struct dt_map * this_, void * key);
+
+	/** Calls a function on every key and value.
+	 *
+	 *  Arguments:
+	 *    this_: This map.
+	 *    visit: The function to call.
+	 *      Arguments:
+	 *        key: The map's copy of a key. Do not change it.
+	 *        value: The map's copy of its value.
+	 *        context: The context given to iterate.
+	 *      Returns:
+	 *        Zero to carry on. Anything else stops.
+	 *    context: Passed along to visit.
+	 *
+	 *  Returns:
+	 *    Zero if every entry was visited, otherwise
+	 *    what visit returned when it stopped.
+	 *
+	 *  Note:
+	 *    The order is not defined. visit must not put
+	 *    or remove.
+	 */
+	int (* iterate)(const struct dt_map * this_,
+		int (* visit)(void * key, void * value, void * context),
+		void * context);
+
+	/** The number of keys in the map.
+	 *
+	 *  Arguments:
+	 *    this_: This map.
+	 *
+	 *  Returns:
+	 *    The number of keys.
+	 */
+	size_t (* length)(const struct dt_map * this_);
+
+	/** Deletes this map.
+	 *
+	 *  Arguments:
+	 *    this_: This map.
+	 */
+	void (* del)(struct dt_map * this_);
+
+	/** Internal state.
+	 */
+	void * _data;
+};
+
+
+
+/** Creates a new Map.
+ *
+ *  This should create the map you will
+ *  most likely want to use.
+ *
+ * Arguments:
+ *   key_size: The size of a key in bytes. Not zero.
+ *   value_size: The size of a value in bytes.
+ *   comparator: A function which orders keys.
+ *     Arguments:
+ *       a: The first key.
+ *       b: The second key.
+ *
+ *     Returns:
+ *       0 if a is logically equal to b.
+ *       -1 if a comes before b.
+ *       1 if a comes after b.
+ *   hash: A function which maps
+ *         keys down to a number.
+ *     Arguments:
+ *       key: The key to hash.
+ *     Returns:
+ *       A number.
+ *
+ *  Returns:
+ *    A map. Or null if key_size is zero or there is
+ *    not enough memory.
+ */
+struct dt_map * dt_map_new(
+	size_t key_size, size_t value_size,
+	int (* comparator)(void * a, void * b),
+	unsigned int (* hash)(void * key));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __MAP_H__
@@ -0,0 +1,8 @@
+#ifndef __MAP_ERROR_H__
+#define __MAP_ERROR_H__
+
+/** Not enough memory.
+ */
+#define DT_MAP_ENOMEM -1
+
+#endif //__MAP_ERROR_H__
@@ -0,0 +1,48 @@
+#ifndef __MAP_HASH_H__
+#define __MAP_HASH_H__
+
+#include "map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Creates a new hash map.
+ *
+ *  Keys and values are stored side by side in one open
+ *  addressed table, so an entry costs no allocation of
+ *  its own and a lookup reads the table and nothing else.
+ *
+ * Arguments:
+ *   key_size: The size of a key in bytes. Not zero.
+ *   value_size: The size of a value in bytes.
+ *   comparator: A function which orders keys.
+ *     Arguments:
+ *       a: The first key.
+ *       b: The second key.
+ *
+ *     Returns:
+ *       0 if a is logically equal to b.
+ *       -1 if a comes before b.
+ *       1 if a comes after b.
+ *   hash: A function which maps
+ *         keys down to a number.
+ *     Arguments:
+ *       key: The key to hash.
+ *     Returns:
+ *       A number.
+ *
+ *  Returns:
+ *    A new map. Or null if key_size is zero or there
+ *    is not enough memory.
+ */
+struct dt_map * dt_map_hash_new(
+	size_t key_size, size_t value_size,
+	int (* comparator)(void * a, void * b),
+	unsigned int (* hash)(void * key));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __MAP_HASH_H__
@@ -0,0 +1,100 @@
+#ifndef __POOL_H__
+#define __POOL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+struct dt_pool;
+
+/** The number of items in a slab when none is given.
+ */
+#define DT_POOL_DEFAULT_SLAB_LENGTH 64
+
+/** Creates a new pool of fixed size items.
+ *
+ *  Items are carved out of slabs that hold many items
+ *  each. Freed items are kept on a free list and handed
+ *  out again before any new slab is made.
+ *
+ *  Arguments:
+ *    item_size: The size of every item in bytes.
+ *    slab_length: The number of items in each slab.
+ *                 Zero picks DT_POOL_DEFAULT_SLAB_LENGTH.
+ *
+ *  Returns:
+ *    A new pool. Or NULL if there is not
+ *    enough memory.
+ *
+ *  Notes:
+ *    A pool is not thread safe. Share one between
+ *    containers only when they are used by one thread.
+ */
+struct dt_pool * dt_pool_new(size_t item_size, size_t slab_length);
+
+/** Gets an item from the pool.
+ *
+ *  Arguments:
+ *    pool: The pool.
+ *
+ *  Returns:
+ *    An item aligned for pointers. Or NULL if there is
+ *    not enough memory.
+ */
+void * dt_pool_alloc(struct dt_pool * pool);
+
+/** Gives an item back to the pool.
+ *
+ *  Arguments:
+ *    pool: The pool the item came from.
+ *    item: The item to give back.
+ */
+void dt_pool_free(struct dt_pool * pool, void * item);
+
+/** The size of the items in the pool.
+ *
+ *  Arguments:
+ *    pool: The pool.
+ *
+ *  Returns:
+ *    The size in bytes. At least the size asked for.
+ */
+size_t dt_pool_item_size(const struct dt_pool * pool);
+
+/** The number of slabs the pool has allocated.
+ *
+ *  Arguments:
+ *    pool: The pool.
+ *
+ *  Returns:
+ *    The number of calls made to the memory allocator.
+ */
+size_t dt_pool_slab_count(const struct dt_pool * pool);
+
+/** The number of items handed out and not given back.
+ *
+ *  Arguments:
+ *    pool: The pool.
+ *
+ *  Returns:
+ *    The number of items in use.
+ */
+size_t dt_pool_length(const struct dt_pool * pool);
+
+/** Deletes the pool and every slab in it.
+ *
+ *  Arguments:
+ *    pool: The pool.
+ *
+ *  Notes:
+ *    Invalidates every item from the pool.
+ */
+void dt_pool_del(struct dt_pool * pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __POOL_H__
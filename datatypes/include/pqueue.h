@@ -0,0 +1,101 @@
+#ifndef __PQUEUE_H__
+#define __PQUEUE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+struct dt_pqueue;
+
+
+/** A priority queue interface.
+ */
+
+struct dt_pqueue {
+
+	/** Puts an item in the queue.
+	 *
+	 *  Arguments:
+	 *    this_: This queue.
+	 *    item: The item to put in the queue.
+	 *  Returns:
+	 *    Zero on success a negative number otherwise.
+	 *
+	 *  Notes:
+	 *    Items that compare equal may all be in the
+	 *    queue at once.
+	 */
+	int (* push)(struct dt_pqueue * this_, void * item);
+
+	/** Removes the smallest item from the queue.
+	 *
+	 *  Arguments:
+	 *    this_: This queue.
+	 *
+	 *  Returns:
+	 *    The smallest item, if it exists. Otherwise NULL.
+	 *    Which of several equal items comes first is
+	 *    not defined.
+	 */
+	void * (* pop_min)(struct dt_pqueue * this_);
+
+	/** Shows the smallest item without removing it.
+	 *
+	 *  Arguments:
+	 *    this_: This queue.
+	 *
+	 *  Returns:
+	 *    The smallest item, if it exists. Otherwise NULL.
+	 */
+	void * (* peek)(const struct dt_pqueue * this_);
+
+	/** The length of the queue.
+	 *
+	 *  Arguments:
+	 *    this_: This queue.
+	 *
+	 *  Returns:
+	 *    The number of items in the queue.
+	 */
+	size_t (* length)(const struct dt_pqueue * this_);
+
+	/** Deletes this queue.
+	 *
+	 *  Arguments:
+	 *    this_: This queue.
+	 */
+	void (* del)(struct dt_pqueue * this_);
+
+	/** Internal state.
+	 */
+	void * _data;
+};
+
+/** Creates a new priority queue.
+ *
+ *  This should create the queue you will
+ *  most likely want to use.
+ *
+ * Arguments:
+ *   comparator: A function which orders inputs.
+ *     Arguments:
+ *       a: The first item.
+ *       b: The second item.
+ *
+ *     Returns:
+ *       0 if a is logically equal to b.
+ *       -1 if a comes before b.
+ *       1 if a comes after b.
+ *
+ *  Returns:
+ *    A queue. Or NULL if there is not enough memory.
+ */
+struct dt_pqueue * dt_pqueue_new(int (* comparator)(void * a, void * b));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __PQUEUE_H__
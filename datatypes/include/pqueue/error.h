@@ -0,0 +1,8 @@
+#ifndef __PQUEUE_ERROR_H__
+#define __PQUEUE_ERROR_H__
+
+/** Not enough memory.
+ */
+#define DT_PQUEUE_ENOMEM -1
+
+#endif //__PQUEUE_ERROR_H__
@@ -0,0 +1,47 @@
+#ifndef __PQUEUE_HEAP_H__
+#define __PQUEUE_HEAP_H__
+
+#include "pqueue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The number of children each heap node has when
+// created through dt_pqueue_new.
+#define DT_PQUEUE_HEAP_DEFAULT_ARITY 4
+
+/** Creates a new heap priority queue.
+ *
+ *  The items are kept in one array laid out as a d-ary
+ *  heap: the children of index i are at i * arity + 1
+ *  to i * arity + arity.
+ *
+ * Arguments:
+ *   comparator: A function which orders inputs.
+ *     Arguments:
+ *       a: The first item.
+ *       b: The second item.
+ *
+ *     Returns:
+ *       0 if a is logically equal to b.
+ *       -1 if a comes before b.
+ *       1 if a comes after b.
+ *   arity: The number of children of each node, at least 2.
+ *
+ *  Returns:
+ *    A new queue. Or NULL if arity is less than 2 or there
+ *    is not enough memory.
+ *
+ *  Notes:
+ *    A wider heap is shallower, so a push compares less
+ *    and a pop compares more but touches fewer cache
+ *    lines. An arity of 4 is usually a good choice.
+ */
+struct dt_pqueue * dt_pqueue_heap_new(
+	int (* comparator)(void * a, void * b), size_t arity);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __PQUEUE_HEAP_H__
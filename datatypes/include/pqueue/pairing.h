@@ -0,0 +1,95 @@
+#ifndef __PQUEUE_PAIRING_H__
+#define __PQUEUE_PAIRING_H__
+
+#include "pqueue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** A queued item in a pairing heap.
+ *
+ *  Notes:
+ *    The fields are private. A handle stays valid until
+ *    its item is popped or removed.
+ */
+struct dt_pqueue_handle;
+
+/** Creates a new pairing heap priority queue.
+ *
+ *  Each item gets a node that can be used as a handle
+ *  to change or remove the item while it is queued.
+ *
+ * Arguments:
+ *   comparator: A function which orders inputs.
+ *     Arguments:
+ *       a: The first item.
+ *       b: The second item.
+ *
+ *     Returns:
+ *       0 if a is logically equal to b.
+ *       -1 if a comes before b.
+ *       1 if a comes after b.
+ *
+ *  Returns:
+ *    A new queue. Or NULL if there is not
+ *    enough memory.
+ *
+ *  Notes:
+ *    Nodes come from a dt_pool owned by the queue, so
+ *    pushing after a pop does not call the memory
+ *    allocator.
+ */
+struct dt_pqueue * dt_pqueue_pairing_new(
+	int (* comparator)(void * a, void * b));
+
+/** Puts an item in a pairing heap and returns its handle.
+ *
+ *  Arguments:
+ *    pqueue: A queue from dt_pqueue_pairing_new.
+ *    item: The item to put in the queue.
+ *
+ *  Returns:
+ *    The item's handle. Or NULL if there is not
+ *    enough memory.
+ */
+struct dt_pqueue_handle * dt_pqueue_pairing_push(struct dt_pqueue * pqueue,
+	void * item);
+
+/** The item a handle refers to.
+ *
+ *  Arguments:
+ *    handle: A handle from dt_pqueue_pairing_push.
+ *
+ *  Returns:
+ *    The item.
+ */
+void * dt_pqueue_pairing_item(const struct dt_pqueue_handle * handle);
+
+/** Moves an item forward after its key went down.
+ *
+ *  Arguments:
+ *    pqueue: The queue the item is in.
+ *    handle: The item's handle.
+ *
+ *  Notes:
+ *    Change the item first so it compares no greater than
+ *    before, then call this. Raising a key this way breaks
+ *    the queue, remove and push the item instead.
+ */
+void dt_pqueue_pairing_decrease_key(struct dt_pqueue * pqueue,
+	struct dt_pqueue_handle * handle);
+
+/** Removes an item from anywhere in the queue.
+ *
+ *  Arguments:
+ *    pqueue: The queue the item is in.
+ *    handle: The item's handle. It is invalid afterwards.
+ */
+void dt_pqueue_pairing_remove(struct dt_pqueue * pqueue,
+	struct dt_pqueue_handle * handle);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __PQUEUE_PAIRING_H__
@@ -0,0 +1,80 @@
+#ifndef __QUEUE_H__
+#define __QUEUE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+struct dt_queue;
+
+
+/** A first in first out queue interface.
+ */
+
+struct dt_queue {
+
+	/** Puts an item at the back of the queue.
+	 *
+	 *  Arguments:
+	 *    this_: This queue.
+	 *    item: The item to put in the queue. Not NULL.
+	 *  Returns:
+	 *    Zero on success a negative number otherwise.
+	 */
+	int (* push)(struct dt_queue * this_, void * item);
+
+	/** Removes the item at the front of the queue.
+	 *
+	 *  Arguments:
+	 *    this_: This queue.
+	 *
+	 *  Returns:
+	 *    The item at the front, if it exists. Otherwise NULL.
+	 */
+	void * (* pop)(struct dt_queue * this_);
+
+	/** The length of the queue.
+	 *
+	 *  Arguments:
+	 *    this_: This queue.
+	 *
+	 *  Returns:
+	 *    The length of the queue. While other threads push
+	 *    and pop it is only a snapshot.
+	 */
+	size_t (* length)(const struct dt_queue * this_);
+
+	/** Deletes this queue.
+	 *
+	 *  Arguments:
+	 *    this_: This queue.
+	 */
+	void (* del)(struct dt_queue * this_);
+
+	/** Internal state.
+	 */
+	void * _data;
+};
+
+/** Creates a new queue.
+ *
+ *  This should create the queue you will
+ *  most likely want to use. Any number of threads
+ *  may push and pop at once.
+ *
+ *  Arguments:
+ *    capacity: The most items the queue holds.
+ *
+ *  Returns:
+ *    A queue. Or NULL if capacity is zero or there
+ *    is not enough memory.
+ */
+struct dt_queue * dt_queue_new(size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __QUEUE_H_
@@ -0,0 +1,11 @@
+#ifndef __QUEUE_ERROR_H__
+#define __QUEUE_ERROR_H__
+
+/** Not enough memory.
+ */
+#define DT_QUEUE_ENOMEM -1
+/** The queue is full.
+ */
+#define DT_QUEUE_EFULL -2
+
+#endif //__QUEUE_ERROR_H__
@@ -0,0 +1,34 @@
+#ifndef __QUEUE_MPMC_H__
+#define __QUEUE_MPMC_H__
+
+#include "queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Creates a new multi producer multi consumer queue.
+ *
+ *  A ring buffer where each slot carries a sequence
+ *  number telling pushers and poppers whose turn it is,
+ *  so any number of threads can use it without locks.
+ *
+ *  Arguments:
+ *    capacity: The most items the queue holds, rounded
+ *              up to a power of two.
+ *
+ *  Returns:
+ *    A new queue. Or NULL if capacity is zero or there
+ *    is not enough memory.
+ *
+ *  Notes:
+ *    push fails with DT_QUEUE_EFULL when the queue is full.
+ *    A thread stalled between claiming a slot and filling
+ *    it holds up poppers of that slot until it carries on.
+ */
+struct dt_queue * dt_queue_mpmc_new(size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __QUEUE_MPMC_H__
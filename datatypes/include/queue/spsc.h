@@ -0,0 +1,33 @@
+#ifndef __QUEUE_SPSC_H__
+#define __QUEUE_SPSC_H__
+
+#include "queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Creates a new single producer single consumer queue.
+ *
+ *  A ring buffer that one thread pushes to while another
+ *  pops from, without locks. Every call finishes in a
+ *  bounded number of steps whatever the other thread does.
+ *
+ *  Arguments:
+ *    capacity: The most items the queue holds, rounded
+ *              up to a power of two.
+ *
+ *  Returns:
+ *    A new queue. Or NULL if capacity is zero or there
+ *    is not enough memory.
+ *
+ *  Notes:
+ *    push fails with DT_QUEUE_EFULL when the queue is full.
+ *    Only one thread may push and only one may pop.
+ */
+struct dt_queue * dt_queue_spsc_new(size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __QUEUE_SPSC_H__
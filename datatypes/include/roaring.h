@@ -0,0 +1,177 @@
+#ifndef __ROARING_H__
+#define __ROARING_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct dt_roaring;
+struct dt_roaring_cursor;
+
+/** Creates a new empty compressed bitmap of 32 bit integers.
+ *
+ *  Values are split by their high 16 bits into containers of
+ *  up to 65536 values each. A container is a sorted array
+ *  while it has few values, a bitmap once it has many, or
+ *  a list of runs after dt_roaring_optimize if that is
+ *  smaller.
+ *
+ *  Returns:
+ *    A new bitmap. Or NULL if there is not enough memory.
+ */
+struct dt_roaring * dt_roaring_new(void);
+
+/** Adds a value.
+ *
+ *  Arguments:
+ *    roaring: The bitmap.
+ *    value: The value to add.
+ *
+ *  Returns:
+ *    Zero on success. DT_ROARING_ENOMEM if there is not
+ *    enough memory.
+ */
+int dt_roaring_add(struct dt_roaring * roaring, uint32_t value);
+
+/** Removes a value.
+ *
+ *  Arguments:
+ *    roaring: The bitmap.
+ *    value: The value to remove.
+ *
+ *  Returns:
+ *    Zero on success. DT_ROARING_ENOMEM if there is not
+ *    enough memory, which can only happen splitting a run.
+ */
+int dt_roaring_remove(struct dt_roaring * roaring, uint32_t value);
+
+/** Checks if the bitmap has a value.
+ *
+ *  Arguments:
+ *    roaring: The bitmap.
+ *    value: The value to check.
+ *
+ *  Returns:
+ *    True if the value is there.
+ */
+bool dt_roaring_has(const struct dt_roaring * roaring, uint32_t value);
+
+/** The number of values in the bitmap.
+ *
+ *  Arguments:
+ *    roaring: The bitmap.
+ *
+ *  Returns:
+ *    The number of values.
+ */
+size_t dt_roaring_cardinality(const struct dt_roaring * roaring);
+
+/** Makes a bitmap of the values in either of two.
+ *
+ *  Arguments:
+ *    a: The first bitmap.
+ *    b: The second bitmap.
+ *
+ *  Returns:
+ *    A new bitmap. Or NULL if there is not enough memory.
+ */
+struct dt_roaring * dt_roaring_union(const struct dt_roaring * a,
+	const struct dt_roaring * b);
+
+/** Makes a bitmap of the values in both of two.
+ *
+ *  Arguments:
+ *    a: The first bitmap.
+ *    b: The second bitmap.
+ *
+ *  Returns:
+ *    A new bitmap. Or NULL if there is not enough memory.
+ */
+struct dt_roaring * dt_roaring_intersection(const struct dt_roaring * a,
+	const struct dt_roaring * b);
+
+/** Counts the values in both of two bitmaps without
+ *  making their intersection.
+ *
+ *  Arguments:
+ *    a: The first bitmap.
+ *    b: The second bitmap.
+ *
+ *  Returns:
+ *    The number of values in both.
+ */
+size_t dt_roaring_intersection_cardinality(const struct dt_roaring * a,
+	const struct dt_roaring * b);
+
+/** Changes containers to runs where that is smaller.
+ *
+ *  Arguments:
+ *    roaring: The bitmap.
+ *
+ *  Notes:
+ *    Worth calling once a bitmap of long stretches of
+ *    values has been built. Failing for lack of memory
+ *    leaves containers as they were.
+ */
+void dt_roaring_optimize(struct dt_roaring * roaring);
+
+/** The memory the bitmap uses.
+ *
+ *  Arguments:
+ *    roaring: The bitmap.
+ *
+ *  Returns:
+ *    The bytes allocated for the bitmap and its containers.
+ */
+size_t dt_roaring_size(const struct dt_roaring * roaring);
+
+/** Deletes the bitmap.
+ *
+ *  Arguments:
+ *    roaring: The bitmap.
+ */
+void dt_roaring_del(struct dt_roaring * roaring);
+
+/** Starts a walk over the values of a bitmap in order.
+ *
+ *  Arguments:
+ *    roaring: The bitmap.
+ *
+ *  Returns:
+ *    A new cursor. Or NULL if there is not enough memory.
+ *
+ *  Notes:
+ *    Any modification to the bitmap invalidates the cursor.
+ */
+struct dt_roaring_cursor * dt_roaring_cursor_new(
+	const struct dt_roaring * roaring);
+
+/** Moves a cursor on to its next value.
+ *
+ *  Arguments:
+ *    cursor: The cursor.
+ *    value: Where to put the value.
+ *
+ *  Returns:
+ *    True if there was a value. False once every value
+ *    has been seen.
+ */
+bool dt_roaring_cursor_next(struct dt_roaring_cursor * cursor,
+	uint32_t * value);
+
+/** Deletes a cursor.
+ *
+ *  Arguments:
+ *    cursor: The cursor.
+ */
+void dt_roaring_cursor_del(struct dt_roaring_cursor * cursor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __ROARING_H__
@@ -0,0 +1,8 @@
+#ifndef __ROARING_ERROR_H__
+#define __ROARING_ERROR_H__
+
+/** Not enough memory.
+ */
+#define DT_ROARING_ENOMEM -1
+
+#endif //__ROARING_ERROR_H__
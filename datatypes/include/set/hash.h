@@ -1,6 +1,7 @@
 #ifndef __SET_HASH_H__
 #define __SET_HASH_H__
 
+#include "allocator.h"
 #include "set.h"
 
 #ifdef __cplusplus
@@ -35,6 +36,23 @@ struct dt_set * dt_set_hash_new(
 	int (* comparator)(void * a, void * b),
 	unsigned int (* hash)(void * item));
 
+/** Creates a new hash set using an allocator.
+ *
+ *  Arguments:
+ *    comparator: As for dt_set_hash_new.
+ *    hash: As for dt_set_hash_new.
+ *    allocator: Where the set, its buckets and the lists
+ *               from items come from. NULL for malloc.
+ *
+ *  Returns:
+ *    A new set. Or null if there is not
+ *    enough memory.
+ */
+struct dt_set * dt_set_hash_new_with_allocator(
+	int (* comparator)(void * a, void * b),
+	unsigned int (* hash)(void * item),
+	const struct dt_allocator * allocator);
+
 
 #ifdef __cplusplus
 }
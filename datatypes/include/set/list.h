@@ -1,7 +1,9 @@
 #ifndef __SET_LIST_H__
 #define __SET_LIST_H__
 
+#include "allocator.h"
 #include "set.h"
+#include "list/vector.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,6 +37,53 @@ struct dt_set * dt_set_list_new(
 	int (* comparator)(void * a, void * b),
 	unsigned int (* hash)(void * item));
 
+/** Creates a new list set using an allocator.
+ *
+ *  Arguments:
+ *    comparator: As for dt_set_list_new.
+ *    hash: As for dt_set_list_new.
+ *    allocator: Where the set, its list and the lists
+ *               from items come from. NULL for malloc.
+ *
+ *  Returns:
+ *    A new set. Or null if there is not
+ *    enough memory.
+ */
+struct dt_set * dt_set_list_new_with_allocator(
+	int (* comparator)(void * a, void * b),
+	unsigned int (* hash)(void * item),
+	const struct dt_allocator * allocator);
+
+/** Memory for a list set set up with dt_set_list_init.
+ *
+ *  Notes:
+ *    The fields are private. Only the size matters.
+ */
+struct dt_set_list_storage {
+	struct dt_set set;
+	struct dt_list_vector_storage _list;
+	void * _implementation[3];
+};
+
+/** Sets up a list set in memory owned by the caller.
+ *
+ *  Arguments:
+ *    storage: The memory to use. It must outlive the set.
+ *    comparator: As for dt_set_list_new.
+ *    hash: As for dt_set_list_new.
+ *
+ *  Returns:
+ *    The set. This never fails.
+ *
+ *  Notes:
+ *    The set's del releases anything the set allocated
+ *    as it grew but does not free storage.
+ */
+struct dt_set * dt_set_list_init(
+	struct dt_set_list_storage * storage,
+	int (* comparator)(void * a, void * b),
+	unsigned int (* hash)(void * item));
+
 
 #ifdef __cplusplus
 }
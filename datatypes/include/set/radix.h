@@ -0,0 +1,68 @@
+#ifndef __SET_RADIX_H__
+#define __SET_RADIX_H__
+
+#include "set.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct dt_set_radix_cursor;
+
+/** Creates a new radix set of strings.
+ *
+ *  Items are NUL terminated strings and are ordered and
+ *  compared by their bytes, so no comparator or hash is
+ *  needed.
+ *
+ *  Returns:
+ *    A new set. Or null if there is not
+ *    enough memory.
+ *
+ *  Notes:
+ *    The set keeps pointers to the items rather than copies.
+ *    An item must not change or be freed while it is in
+ *    the set.
+ */
+struct dt_set * dt_set_radix_new(void);
+
+/** Starts a walk over the items that begin with a prefix.
+ *
+ *  Arguments:
+ *    set: A set made by dt_set_radix_new.
+ *    prefix: The prefix to look for. The empty string
+ *      walks the whole set.
+ *
+ *  Returns:
+ *    A new cursor. Or null if there is not
+ *    enough memory.
+ *
+ *  Notes:
+ *    Any modification to the set invalidates the cursor.
+ */
+struct dt_set_radix_cursor * dt_set_radix_prefix_cursor(
+	const struct dt_set * set, const char * prefix);
+
+/** Moves a cursor on to its next item.
+ *
+ *  Arguments:
+ *    cursor: The cursor.
+ *
+ *  Returns:
+ *    The next item in byte order. Or null once every
+ *    item with the prefix has been seen.
+ */
+void * dt_set_radix_cursor_next(struct dt_set_radix_cursor * cursor);
+
+/** Deletes a cursor.
+ *
+ *  Arguments:
+ *    cursor: The cursor.
+ */
+void dt_set_radix_cursor_del(struct dt_set_radix_cursor * cursor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SET_RADIX_H__
@@ -0,0 +1,33 @@
+#ifndef __SET_ROARING_H__
+#define __SET_ROARING_H__
+
+#include "set.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Creates a new set of integers kept in a compressed
+ *  bitmap (see roaring.h).
+ *
+ *  Items are the integers themselves cast to pointers,
+ *  (void *) (uintptr_t) value, up to UINT32_MAX. Nothing
+ *  is allocated per item, so no comparator or hash is
+ *  needed.
+ *
+ *  Returns:
+ *    A new set. Or null if there is not
+ *    enough memory.
+ *
+ *  Notes:
+ *    Inserting an item past UINT32_MAX fails with
+ *    DT_SET_ERROR. Zero can be stored but has cannot tell
+ *    it from a miss, so offset values by one if that matters.
+ */
+struct dt_set * dt_set_roaring_new(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SET_ROARING_H__
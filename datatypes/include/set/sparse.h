@@ -0,0 +1,74 @@
+#ifndef __SET_SPARSE_H__
+#define __SET_SPARSE_H__
+
+#include "set.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Creates a new sparse set of integers below a bound.
+ *
+ *  Items are the integers themselves cast to pointers,
+ *  (void *) (uintptr_t) value. A dense array holds the
+ *  items and a sparse array indexed by value says where,
+ *  so insert, has, remove and clear are all O(1) and no
+ *  comparator or hash is needed.
+ *
+ * Arguments:
+ *   universe: One more than the largest item the set can
+ *     hold. Both arrays are allocated up front at this
+ *     length, so nothing is allocated afterwards.
+ *
+ *  Returns:
+ *    A new set. Or null if there is not
+ *    enough memory.
+ *
+ *  Notes:
+ *    Inserting an item at or past universe fails with
+ *    DT_SET_ERROR. Zero can be stored but has cannot tell
+ *    it from a miss, so offset values by one if that matters.
+ */
+struct dt_set * dt_set_sparse_new(size_t universe);
+
+/** Removes every item in O(1).
+ *
+ *  Arguments:
+ *    set: A set made by dt_set_sparse_new.
+ *
+ *  Notes:
+ *    Neither array is touched, so a set can be cleared
+ *    and reused for each request instead of being made
+ *    and deleted.
+ */
+void dt_set_sparse_clear(struct dt_set * set);
+
+/** The number of items in the set.
+ *
+ *  Arguments:
+ *    set: A set made by dt_set_sparse_new.
+ *
+ *  Returns:
+ *    The number of items.
+ */
+size_t dt_set_sparse_length(const struct dt_set * set);
+
+/** The items of the set, for iterating without a list.
+ *
+ *  Arguments:
+ *    set: A set made by dt_set_sparse_new.
+ *
+ *  Returns:
+ *    The dense array, dt_set_sparse_length items long.
+ *
+ *  Notes:
+ *    Any modification to the set invalidates the order.
+ *    Removing an item moves the last one into its place.
+ */
+void * const * dt_set_sparse_items(const struct dt_set * set);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SET_SPARSE_H__
@@ -35,6 +35,37 @@ struct dt_stack {
 	 */
 	void * (* pop)(struct dt_stack * this_);
 
+	/** Puts many items on top of the stack.
+	 *
+	 *  Arguments:
+	 *    this_: This stack.
+	 *    items: The items to put on the stack. The last
+	 *           one ends up on top.
+	 *    count: The number of items.
+	 *
+	 *  Returns:
+	 *    Zero on success a negative number otherwise.
+	 *
+	 *  Notes:
+	 *    Either every item is pushed or none are.
+	 */
+	int (* push_many)(struct dt_stack * this_, void * const * items,
+		size_t count);
+
+	/** Removes many items from the top of the stack.
+	 *
+	 *  Arguments:
+	 *    this_: This stack.
+	 *    out: Where to put the items, in the order they were
+	 *         pushed. The item that was on top goes last.
+	 *    count: The most items to remove.
+	 *
+	 *  Returns:
+	 *    The number of items removed. Less than count
+	 *    only if the stack ran out.
+	 */
+	size_t (* pop_many)(struct dt_stack * this_, void ** out, size_t count);
+
 	/** Shows the top item without removing it.
 	 *
 	 *  Arguments:
@@ -0,0 +1,39 @@
+#ifndef __STACK_BOUNDED_H__
+#define __STACK_BOUNDED_H__
+
+#include "stack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// What a push onto a full bounded stack does.
+// Fail with DT_STACK_ENOMEM and leave the stack alone.
+#define DT_STACK_BOUNDED_FAIL 0
+// Drop the oldest item to make room.
+#define DT_STACK_BOUNDED_OVERWRITE 1
+
+/** Creates a new bounded stack.
+ *
+ *  The items are kept in a ring buffer allocated along
+ *  with the stack. Nothing is allocated after this call.
+ *
+ *  Arguments:
+ *    capacity: The most items the stack holds.
+ *    policy: DT_STACK_BOUNDED_FAIL or DT_STACK_BOUNDED_OVERWRITE.
+ *
+ *  Returns:
+ *    A new stack. Or NULL if capacity is zero, the policy
+ *    is unknown or there is not enough memory.
+ *
+ *  Notes:
+ *    With DT_STACK_BOUNDED_OVERWRITE the stack keeps the
+ *    last capacity items pushed. A push_many of more than
+ *    capacity items keeps only the last ones.
+ */
+struct dt_stack * dt_stack_bounded_new(size_t capacity, int policy);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __STACK_BOUNDED_H__
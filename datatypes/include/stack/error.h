@@ -4,5 +4,11 @@
 /** Not enough memory.
  */
 #define DT_STACK_ENOMEM -1
+/** There was nothing to take.
+ */
+#define DT_STACK_EEMPTY -2
+/** Lost a race with another thread, try again.
+ */
+#define DT_STACK_EAGAIN -3
 
 #endif //__STACK_ERROR_H__
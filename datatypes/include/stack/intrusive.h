@@ -0,0 +1,41 @@
+#ifndef __STACK_INTRUSIVE_H__
+#define __STACK_INTRUSIVE_H__
+
+#include "stack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct dt_stack_link;
+
+/** The link an item embeds to be put on an intrusive stack.
+ */
+struct dt_stack_link {
+	struct dt_stack_link * next;
+};
+
+/** Creates a new intrusive stack.
+ *
+ *  The stack chains items through a dt_stack_link
+ *  embedded in each item, so pushing never allocates.
+ *
+ *  Arguments:
+ *    offset: The offset of the dt_stack_link in each item,
+ *            as given by offsetof.
+ *
+ *  Returns:
+ *    A new stack. Or null if there is not
+ *    enough memory.
+ *
+ *  Notes:
+ *    Items must not be null and can only be on one stack
+ *    through the same link at a time. The stack does not
+ *    own its items.
+ */
+struct dt_stack * dt_stack_intrusive_new(size_t offset);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __STACK_INTRUSIVE_H__
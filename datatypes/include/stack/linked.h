@@ -1,7 +1,9 @@
 #ifndef __STACK_LINKED_H__
 #define __STACK_LINKED_H__
 
+#include "allocator.h"
 #include "stack.h"
+#include "pool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -15,6 +17,41 @@ extern "C" {
  */
 struct dt_stack * dt_stack_linked_new(void);
 
+/** Creates a new linked stack using an allocator.
+ *
+ *  Arguments:
+ *    allocator: Where the stack and its nodes come from.
+ *               NULL for malloc.
+ *
+ *  Returns:
+ *    A new stack. Or null if there is not
+ *    enough memory.
+ */
+struct dt_stack * dt_stack_linked_new_with_allocator(
+	const struct dt_allocator * allocator);
+
+/** Creates a new linked stack that takes its nodes from a pool.
+ *
+ *  Arguments:
+ *    pool: The pool to use. Its items must be at least
+ *          dt_stack_linked_node_size() bytes. It may be
+ *          shared with other containers and must outlive
+ *          the stack. If NULL the stack makes a pool of its
+ *          own and deletes it with the stack.
+ *
+ *  Returns:
+ *    A new stack. Or null if there is not
+ *    enough memory or the pool's items are too small.
+ */
+struct dt_stack * dt_stack_linked_pooled_new(struct dt_pool * pool);
+
+/** The size of a linked stack node.
+ *
+ *  Returns:
+ *    The size in bytes.
+ */
+size_t dt_stack_linked_node_size(void);
+
 #ifdef __cplusplus
 }
 #endif
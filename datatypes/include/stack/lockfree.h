@@ -0,0 +1,33 @@
+#ifndef __STACK_LOCKFREE_H__
+#define __STACK_LOCKFREE_H__
+
+#include "stack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Creates a new lock-free stack.
+ *
+ *  Push, pop, peek and length may be called from many
+ *  threads at once without a lock.
+ *
+ *  Returns:
+ *    A new stack. Or null if there is not
+ *    enough memory.
+ *
+ *  Notes:
+ *    The top of the stack is a pointer and a counter
+ *    swapped together, so a node that is popped and pushed
+ *    again between a read and a swap is noticed (the ABA
+ *    problem). Popped nodes are kept for reuse until the
+ *    stack is deleted, so the stack holds on to memory for
+ *    as many nodes as it ever held items at once.
+ *    Deleting the stack is not thread safe.
+ */
+struct dt_stack * dt_stack_lockfree_new(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __STACK_LOCKFREE_H__
@@ -0,0 +1,33 @@
+#ifndef __STACK_SEGMENTED_H__
+#define __STACK_SEGMENTED_H__
+
+#include "stack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The number of items in each segment.
+#define DT_STACK_SEGMENTED_SEGMENT_LENGTH 512
+
+/** Creates a new segmented stack.
+ *
+ *  The items are kept in a chain of fixed size arrays.
+ *  Growing adds a segment instead of copying the items
+ *  so no push or pop ever moves more than one item.
+ *
+ *  Returns:
+ *    A new stack. Or null if there is not
+ *    enough memory.
+ *
+ *  Notes:
+ *    One emptied segment is kept as a spare so pushing
+ *    and popping across a segment boundary does not
+ *    call the memory allocator each time.
+ */
+struct dt_stack * dt_stack_segmented_new(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __STACK_SEGMENTED_H__
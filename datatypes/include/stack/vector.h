@@ -1,20 +1,66 @@
 #ifndef __STACK_VECTOR_H__
 #define __STACK_VECTOR_H__
 
+#include "allocator.h"
 #include "stack.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// The number of items a vector stack holds
+// before it needs a buffer of its own.
+#define DT_STACK_VECTOR_INLINE_LENGTH 8
+
+/** Memory for a vector stack set up with dt_stack_vector_init.
+ *
+ *  Notes:
+ *    The fields are private. Only the size matters.
+ */
+struct dt_stack_vector_storage {
+	struct dt_stack stack;
+	void * _implementation[4 + DT_STACK_VECTOR_INLINE_LENGTH];
+};
+
 /** Creates a new vector stack.
  *
  *  Returns:
  *    A new stack. Or NULL if there is not
  *    enough memory.
+ *
+ *  Notes:
+ *    The stack and its first few items live in a single
+ *    allocation. See DT_STACK_VECTOR_INLINE_LENGTH.
  */
 struct dt_stack * dt_stack_vector_new(void);
 
+/** Creates a new vector stack using an allocator.
+ *
+ *  Arguments:
+ *    allocator: Where the stack and its buffer come from.
+ *               NULL for malloc.
+ *
+ *  Returns:
+ *    A new stack. Or NULL if there is not
+ *    enough memory.
+ */
+struct dt_stack * dt_stack_vector_new_with_allocator(
+	const struct dt_allocator * allocator);
+
+/** Sets up a vector stack in memory owned by the caller.
+ *
+ *  Arguments:
+ *    storage: The memory to use. It must outlive the stack.
+ *
+ *  Returns:
+ *    The stack. This never fails.
+ *
+ *  Notes:
+ *    The stack's del releases anything the stack allocated
+ *    after it outgrew storage but does not free storage.
+ */
+struct dt_stack * dt_stack_vector_init(struct dt_stack_vector_storage * storage);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,49 @@
+#ifndef __STACK_WORKSTEALING_H__
+#define __STACK_WORKSTEALING_H__
+
+#include "stack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Creates a new work-stealing deque (a Chase-Lev deque).
+ *
+ *  One thread owns the deque and uses it as a stack
+ *  through the dt_stack interface. Any other thread may
+ *  take the oldest item with dt_stack_workstealing_steal.
+ *
+ *  Returns:
+ *    A new stack. Or null if there is not
+ *    enough memory.
+ *
+ *  Notes:
+ *    Only the owner may call the dt_stack functions. Their
+ *    results for peek and length are a snapshot while
+ *    thieves are at work. Items must not be null. Outgrown
+ *    buffers are kept until the stack is deleted as a thief
+ *    may still be reading them. Deleting the stack is not
+ *    thread safe.
+ */
+struct dt_stack * dt_stack_workstealing_new(void);
+
+/** Takes the oldest item from a work-stealing deque.
+ *
+ *  Arguments:
+ *    stack: A stack from dt_stack_workstealing_new.
+ *    item: A result variable. The item taken.
+ *
+ *  Returns:
+ *    Zero on success. DT_STACK_EEMPTY if there was nothing
+ *    to take. DT_STACK_EAGAIN if another thread took the
+ *    item first, in which case there may be more.
+ *
+ *  Notes:
+ *    Safe to call from any thread, including the owner.
+ */
+int dt_stack_workstealing_steal(struct dt_stack * stack, void ** item);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __STACK_WORKSTEALING_H__
@@ -0,0 +1,393 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "allocator.h"
+#include "list.h"
+#include "list/linked.h"
+#include "list/vector.h"
+#include "set.h"
+#include "set/hash.h"
+#include "set/tree.h"
+#include "stack.h"
+#include "stack/linked.h"
+
+#include "bench.h"
+
+#define DEFAULT_COUNT 10000
+#define DEFAULT_ITEMS 256
+// The bytes in the bump arena. Enough for a round of any
+// container at the default number of items.
+#define ARENA_SIZE (1 << 24)
+#define ALIGNMENT 16
+
+static char * program_name = "allocator_bench";
+
+// Hands out memory by moving a pointer through one big
+// block. Nothing is freed until the whole arena is reset.
+struct bump_arena {
+	unsigned char * memory;
+	size_t used;
+	// The last allocation, which can grow in place.
+	unsigned char * last;
+};
+
+struct container_kind {
+	char * name;
+	/** Builds a container of the items, looks them all
+	 *  up or walks them, then deletes it.
+	 *
+	 *  Arguments:
+	 *    allocator: Where the container gets its memory.
+	 *    items: The number of items.
+	 *    state: The random state.
+	 *
+	 *  Returns:
+	 *    A checksum of what was seen. Or (size_t) -1 if
+	 *    there was not enough memory.
+	 */
+	size_t (* round)(const struct dt_allocator * allocator, size_t items,
+		unsigned long * state);
+};
+
+int main(int argc, char ** argv);
+
+/** Prints the usage to the given stream.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ */
+void usage(FILE * stream);
+
+/** Runs rounds of a container against an allocator.
+ *
+ *  Arguments:
+ *    kind: The container.
+ *    allocator: The allocator. NULL for malloc.
+ *    arena: The arena behind allocator, reset after every
+ *           round. NULL if there is none.
+ *    count: The number of rounds.
+ *    items: The number of items in each round.
+ *    seconds: Where to put the time taken.
+ *
+ *  Returns:
+ *    Zero on success. Non zero if a round ran out of memory.
+ */
+static int run(struct container_kind * kind,
+	const struct dt_allocator * allocator, struct bump_arena * arena,
+	size_t count, size_t items, double * seconds);
+
+static void * bump_alloc(void * ctx, size_t size);
+static void * bump_realloc(void * ctx, void * pointer,
+	size_t old_size, size_t new_size);
+static void bump_free(void * ctx, void * pointer, size_t size);
+
+static int compare_items(void * a, void * b);
+static unsigned int hash_item(void * item);
+
+/** A random item that is never NULL.
+ */
+static void * random_item(unsigned long * state);
+
+// Kinds.
+static size_t vector_list_round(const struct dt_allocator * allocator,
+	size_t items, unsigned long * state);
+static size_t linked_list_round(const struct dt_allocator * allocator,
+	size_t items, unsigned long * state);
+static size_t hash_set_round(const struct dt_allocator * allocator,
+	size_t items, unsigned long * state);
+static size_t tree_set_round(const struct dt_allocator * allocator,
+	size_t items, unsigned long * state);
+static size_t linked_stack_round(const struct dt_allocator * allocator,
+	size_t items, unsigned long * state);
+
+static struct container_kind kinds[] = {
+	{"vector list", &vector_list_round},
+	{"linked list", &linked_list_round},
+	{"hash set", &hash_set_round},
+	{"tree set", &tree_set_round},
+	{"linked stack", &linked_stack_round}
+};
+
+void usage(FILE * stream)
+{
+	fprintf(stream, "usage: %s [count [items [container]]]\n",
+		program_name);
+	fprintf(stream, "\tcount: the number of rounds (default %d)\n",
+		DEFAULT_COUNT);
+	fprintf(stream, "\titems: the items in each round (default %d)\n",
+		DEFAULT_ITEMS);
+	fprintf(stream, "\tcontainer: only run against the named container\n");
+}
+
+int main(int argc, char ** argv)
+{
+	size_t count = DEFAULT_COUNT;
+	size_t items = DEFAULT_ITEMS;
+	char * only_kind = NULL;
+
+	if (argc) {
+		program_name = argv[0];
+	}
+
+	if (argc > 4 || (argc >= 2 && bench_parse_count(argv[1], &count)) ||
+		(argc >= 3 && bench_parse_count(argv[2], &items))) {
+		usage(stderr);
+		return 1;
+	}
+
+	if (argc == 4) {
+		only_kind = argv[3];
+	}
+
+	struct bump_arena arena;
+	arena.memory = malloc(ARENA_SIZE);
+	arena.used = 0;
+	arena.last = NULL;
+	if (!arena.memory) {
+		fprintf(stderr, "Failed to make arena\n");
+		return 1;
+	}
+
+	struct dt_allocator bump;
+	bump.alloc = &bump_alloc;
+	bump.realloc = &bump_realloc;
+	bump.free = &bump_free;
+	bump.ctx = &arena;
+
+	int status = 0;
+	for (size_t j = 0; j < sizeof(kinds) / sizeof(*kinds); j++) {
+		if (only_kind && strcmp(only_kind, kinds[j].name) != 0) continue;
+
+		double malloc_seconds = 0;
+		double bump_seconds = 0;
+		if (run(&kinds[j], NULL, NULL, count, items, &malloc_seconds) ||
+			run(&kinds[j], &bump, &arena, count, items, &bump_seconds)) {
+			fprintf(stderr, "Out of memory\n");
+			status = 1;
+			break;
+		}
+
+		char name[128];
+		snprintf(name, sizeof(name), "%zu items/%s/malloc",
+			items, kinds[j].name);
+		bench_report(stdout, name, count, malloc_seconds);
+		snprintf(name, sizeof(name), "%zu items/%s/bump",
+			items, kinds[j].name);
+		bench_report(stdout, name, count, bump_seconds);
+	}
+
+	free(arena.memory);
+	return status;
+}
+
+static int run(struct container_kind * kind,
+	const struct dt_allocator * allocator, struct bump_arena * arena,
+	size_t count, size_t items, double * seconds)
+{
+	unsigned long state = 88172645463325252ul;
+	size_t checksum = 0;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		size_t seen = kind->round(allocator, items, &state);
+		if (seen == (size_t) -1) return 1;
+		checksum += seen;
+
+		if (arena) {
+			arena->used = 0;
+			arena->last = NULL;
+		}
+	}
+	*seconds = bench_now() - start;
+
+	// Keeps the rounds from being optimized away.
+	if (checksum == 1) printf("\n");
+	return 0;
+}
+
+static void * bump_alloc(void * ctx, size_t size)
+{
+	struct bump_arena * arena = ctx;
+
+	size_t rounded = (size + ALIGNMENT - 1) & ~(size_t) (ALIGNMENT - 1);
+	if (rounded < size || rounded > ARENA_SIZE - arena->used) return NULL;
+
+	arena->last = arena->memory + arena->used;
+	arena->used += rounded;
+	return arena->last;
+}
+
+static void * bump_realloc(void * ctx, void * pointer,
+	size_t old_size, size_t new_size)
+{
+	struct bump_arena * arena = ctx;
+
+	if (pointer == arena->last) {
+		size_t offset = arena->last - arena->memory;
+		if (new_size <= ARENA_SIZE - offset) {
+			arena->used = offset;
+			return bump_alloc(ctx, new_size);
+		}
+		return NULL;
+	}
+
+	void * moved = bump_alloc(ctx, new_size);
+	if (!moved) return NULL;
+
+	memcpy(moved, pointer, old_size < new_size ? old_size : new_size);
+	return moved;
+}
+
+static void bump_free(void * ctx, void * pointer, size_t size)
+{
+	// Everything goes when the arena is reset.
+}
+
+static int compare_items(void * a, void * b)
+{
+	uintptr_t x = (uintptr_t) a;
+	uintptr_t y = (uintptr_t) b;
+	return
+		x == y ? 0 :
+		x < y ? -1 : 1;
+}
+
+static unsigned int hash_item(void * item)
+{
+	return (uintptr_t) item;
+}
+
+static void * random_item(unsigned long * state)
+{
+	return (void *) (uintptr_t) (bench_random(state) | 1);
+}
+
+static size_t vector_list_round(const struct dt_allocator * allocator,
+	size_t items, unsigned long * state)
+{
+	struct dt_list * list = dt_list_vector_new_with_allocator(allocator);
+	if (!list) return (size_t) -1;
+
+	for (size_t i = 0; i < items; i++) {
+		if (list->insert(list, list->length(list), random_item(state))) {
+			list->del(list);
+			return (size_t) -1;
+		}
+	}
+
+	size_t seen = 0;
+	struct dt_list_iterator * iterator = list->iterator(list);
+	if (!iterator) {
+		list->del(list);
+		return (size_t) -1;
+	}
+	for (; iterator->valid(iterator); iterator->next(iterator)) {
+		seen += (uintptr_t) iterator->get(iterator);
+	}
+	iterator->del(iterator);
+
+	list->del(list);
+	return seen;
+}
+
+static size_t linked_list_round(const struct dt_allocator * allocator,
+	size_t items, unsigned long * state)
+{
+	struct dt_list * list = dt_list_linked_new_with_allocator(allocator);
+	if (!list) return (size_t) -1;
+
+	for (size_t i = 0; i < items; i++) {
+		if (list->insert(list, list->length(list), random_item(state))) {
+			list->del(list);
+			return (size_t) -1;
+		}
+	}
+
+	size_t seen = 0;
+	struct dt_list_iterator * iterator = list->iterator(list);
+	if (!iterator) {
+		list->del(list);
+		return (size_t) -1;
+	}
+	for (; iterator->valid(iterator); iterator->next(iterator)) {
+		seen += (uintptr_t) iterator->get(iterator);
+	}
+	iterator->del(iterator);
+
+	list->del(list);
+	return seen;
+}
+
+static size_t hash_set_round(const struct dt_allocator * allocator,
+	size_t items, unsigned long * state)
+{
+	struct dt_set * set = dt_set_hash_new_with_allocator(
+		&compare_items, &hash_item, allocator);
+	if (!set) return (size_t) -1;
+
+	unsigned long start = *state;
+	for (size_t i = 0; i < items; i++) {
+		if (set->insert(set, random_item(state))) {
+			set->del(set);
+			return (size_t) -1;
+		}
+	}
+
+	size_t seen = 0;
+	*state = start;
+	for (size_t i = 0; i < items; i++) {
+		if (set->has(set, random_item(state))) seen++;
+	}
+
+	set->del(set);
+	return seen;
+}
+
+static size_t tree_set_round(const struct dt_allocator * allocator,
+	size_t items, unsigned long * state)
+{
+	struct dt_set * set = dt_set_tree_new_with_allocator(
+		&compare_items, &hash_item, allocator);
+	if (!set) return (size_t) -1;
+
+	unsigned long start = *state;
+	for (size_t i = 0; i < items; i++) {
+		if (set->insert(set, random_item(state))) {
+			set->del(set);
+			return (size_t) -1;
+		}
+	}
+
+	size_t seen = 0;
+	*state = start;
+	for (size_t i = 0; i < items; i++) {
+		if (set->has(set, random_item(state))) seen++;
+	}
+
+	set->del(set);
+	return seen;
+}
+
+static size_t linked_stack_round(const struct dt_allocator * allocator,
+	size_t items, unsigned long * state)
+{
+	struct dt_stack * stack = dt_stack_linked_new_with_allocator(allocator);
+	if (!stack) return (size_t) -1;
+
+	for (size_t i = 0; i < items; i++) {
+		if (stack->push(stack, random_item(state))) {
+			stack->del(stack);
+			return (size_t) -1;
+		}
+	}
+
+	size_t seen = 0;
+	while (stack->length(stack)) {
+		seen += (uintptr_t) stack->pop(stack);
+	}
+
+	stack->del(stack);
+	return seen;
+}
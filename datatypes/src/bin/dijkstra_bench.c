@@ -0,0 +1,358 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "pqueue.h"
+#include "pqueue/heap.h"
+#include "pqueue/pairing.h"
+#include "set.h"
+#include "set/tree.h"
+#include "list.h"
+
+#include "bench.h"
+
+#define DEFAULT_VERTICES 10000
+// Edges leaving each vertex, besides the one to the next
+// vertex that keeps the graph connected.
+#define DEGREE 8
+#define MAX_WEIGHT 1000
+
+static char * program_name = "dijkstra_bench";
+
+struct edge {
+	size_t to;
+	unsigned long weight;
+};
+
+// A random graph in one array, the edges of vertex v
+// are edges[v * (DEGREE + 1), (v + 1) * (DEGREE + 1)).
+struct graph {
+	size_t vertices;
+	struct edge * edges;
+};
+
+struct vertex {
+	unsigned long distance;
+	struct dt_pqueue_handle * handle;
+	int queued;
+	int done;
+};
+
+// A queued distance for the heap, which cannot find
+// an entry to lower it, so pushes another one.
+struct entry {
+	unsigned long distance;
+	size_t vertex;
+};
+
+struct search_kind {
+	char * name;
+	/** Finds the distance from vertex 0 to every vertex.
+	 *
+	 *  Arguments:
+	 *    graph: The graph to search.
+	 *    vertices: Where to put the distances, one per vertex.
+	 *
+	 *  Returns:
+	 *    Zero on success. A negative number otherwise.
+	 */
+	int (* run)(const struct graph * graph, struct vertex * vertices);
+};
+
+int main(int argc, char ** argv);
+
+/** Prints the usage to the given stream.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ */
+void usage(FILE * stream);
+
+/** Makes a random graph.
+ *
+ *  Arguments:
+ *    graph: Where to put the graph.
+ *    vertices: The number of vertices.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise.
+ */
+static int graph_new(struct graph * graph, size_t vertices);
+
+static int compare_distances(void * a, void * b);
+static int compare_vertices(void * a, void * b);
+
+// Kinds.
+static int pairing_search(const struct graph * graph,
+	struct vertex * vertices);
+static int heap_search(const struct graph * graph,
+	struct vertex * vertices);
+static int set_search(const struct graph * graph,
+	struct vertex * vertices);
+
+static struct search_kind kinds[] = {
+	{"pairing decrease key", &pairing_search},
+	{"4-ary heap duplicates", &heap_search},
+	{"tree set reinsert", &set_search}
+};
+
+void usage(FILE * stream)
+{
+	fprintf(stream, "usage: %s [vertices [pqueue]]\n", program_name);
+	fprintf(stream, "\tvertices: the size of the graph (default %d)\n",
+		DEFAULT_VERTICES);
+	fprintf(stream, "\tpqueue: only run against the named queue\n");
+}
+
+int main(int argc, char ** argv)
+{
+	size_t count = DEFAULT_VERTICES;
+	char * only_kind = NULL;
+
+	if (argc) {
+		program_name = argv[0];
+	}
+
+	if (argc > 3 || (argc >= 2 && bench_parse_count(argv[1], &count)) ||
+		count == 0) {
+		usage(stderr);
+		return 1;
+	}
+
+	if (argc == 3) {
+		only_kind = argv[2];
+	}
+
+	struct graph graph;
+	if (graph_new(&graph, count)) {
+		fprintf(stderr, "Failed to make graph\n");
+		return 1;
+	}
+
+	struct vertex * vertices = malloc(sizeof(*vertices) * count);
+	if (!vertices) {
+		fprintf(stderr, "Failed to make vertices\n");
+		return 1;
+	}
+
+	// Every kind must agree on the distances.
+	unsigned long long first_total = 0;
+	int have_total = 0;
+
+	for (size_t j = 0; j < sizeof(kinds) / sizeof(*kinds); j++) {
+		if (only_kind && strcmp(only_kind, kinds[j].name) != 0) continue;
+
+		for (size_t i = 0; i < count; i++) {
+			vertices[i].distance = (unsigned long) -1;
+			vertices[i].handle = NULL;
+			vertices[i].queued = 0;
+			vertices[i].done = 0;
+		}
+
+		double start = bench_now();
+		int result = kinds[j].run(&graph, vertices);
+		double seconds = bench_now() - start;
+
+		if (result) {
+			fprintf(stderr, "Failed to search\n");
+			return 1;
+		}
+
+		unsigned long long total = 0;
+		for (size_t i = 0; i < count; i++) total += vertices[i].distance;
+
+		if (have_total && total != first_total) {
+			fprintf(stderr, "%s found different distances\n", kinds[j].name);
+			return 1;
+		}
+		first_total = total;
+		have_total = 1;
+
+		// An operation is an edge looked at.
+		char name[128];
+		snprintf(name, sizeof(name), "dijkstra/%s", kinds[j].name);
+		bench_report(stdout, name, count * (DEGREE + 1), seconds);
+	}
+
+	free(vertices);
+	free(graph.edges);
+	return 0;
+}
+
+static int graph_new(struct graph * graph, size_t vertices)
+{
+	unsigned long state = 88172645463325252ul;
+
+	graph->vertices = vertices;
+	graph->edges = malloc(sizeof(*graph->edges) * vertices * (DEGREE + 1));
+	if (!graph->edges) return -1;
+
+	for (size_t v = 0; v < vertices; v++) {
+		struct edge * edges = graph->edges + v * (DEGREE + 1);
+
+		edges[0].to = (v + 1) % vertices;
+		edges[0].weight = MAX_WEIGHT;
+
+		for (size_t i = 1; i <= DEGREE; i++) {
+			edges[i].to = bench_random(&state) % vertices;
+			edges[i].weight = 1 + bench_random(&state) % MAX_WEIGHT;
+		}
+	}
+
+	return 0;
+}
+
+static int compare_distances(void * a, void * b)
+{
+	unsigned long x = *(unsigned long *) a;
+	unsigned long y = *(unsigned long *) b;
+	return
+		x == y ? 0 :
+		x < y ? -1 : 1;
+}
+
+static int compare_vertices(void * a, void * b)
+{
+	// Sets hold no duplicates so tell equal distances
+	// apart by the vertex.
+	int compare = compare_distances(a, b);
+	if (compare) return compare;
+	return
+		a == b ? 0 :
+		(char *) a < (char *) b ? -1 : 1;
+}
+
+static int pairing_search(const struct graph * graph,
+	struct vertex * vertices)
+{
+	struct dt_pqueue * pqueue = dt_pqueue_pairing_new(&compare_distances);
+	if (!pqueue) return -1;
+
+	vertices[0].distance = 0;
+	vertices[0].handle = dt_pqueue_pairing_push(pqueue, vertices);
+
+	struct vertex * vertex;
+	while ((vertex = pqueue->pop_min(pqueue))) {
+		vertex->done = 1;
+		struct edge * edges = graph->edges +
+			(vertex - vertices) * (DEGREE + 1);
+
+		for (size_t i = 0; i <= DEGREE; i++) {
+			struct vertex * to = vertices + edges[i].to;
+			unsigned long distance = vertex->distance + edges[i].weight;
+			if (to->done || distance >= to->distance) continue;
+
+			to->distance = distance;
+			if (to->handle) {
+				dt_pqueue_pairing_decrease_key(pqueue, to->handle);
+			} else {
+				to->handle = dt_pqueue_pairing_push(pqueue, to);
+				if (!to->handle) {
+					pqueue->del(pqueue);
+					return -1;
+				}
+			}
+		}
+	}
+
+	pqueue->del(pqueue);
+	return 0;
+}
+
+static int heap_search(const struct graph * graph,
+	struct vertex * vertices)
+{
+	// At most one entry per edge plus the start.
+	struct entry * entries = malloc(sizeof(*entries) *
+		(graph->vertices * (DEGREE + 1) + 1));
+	if (!entries) return -1;
+	size_t entry_count = 0;
+
+	struct dt_pqueue * pqueue = dt_pqueue_heap_new(&compare_distances, 4);
+	if (!pqueue) {
+		free(entries);
+		return -1;
+	}
+
+	vertices[0].distance = 0;
+	entries[entry_count] = (struct entry) {0, 0};
+	pqueue->push(pqueue, entries + entry_count++);
+
+	struct entry * entry;
+	int result = 0;
+	while ((entry = pqueue->pop_min(pqueue))) {
+		struct vertex * vertex = vertices + entry->vertex;
+		// An entry left behind when the vertex got closer.
+		if (vertex->done) continue;
+
+		vertex->done = 1;
+		struct edge * edges = graph->edges + entry->vertex * (DEGREE + 1);
+
+		for (size_t i = 0; i <= DEGREE; i++) {
+			struct vertex * to = vertices + edges[i].to;
+			unsigned long distance = vertex->distance + edges[i].weight;
+			if (to->done || distance >= to->distance) continue;
+
+			to->distance = distance;
+			entries[entry_count] = (struct entry) {distance, edges[i].to};
+			if (pqueue->push(pqueue, entries + entry_count++)) result = -1;
+		}
+	}
+
+	pqueue->del(pqueue);
+	free(entries);
+	return result;
+}
+
+static int set_search(const struct graph * graph,
+	struct vertex * vertices)
+{
+	struct dt_set * set = dt_set_tree_new(&compare_vertices, NULL);
+	if (!set) return -1;
+
+	vertices[0].distance = 0;
+	vertices[0].queued = 1;
+	if (set->insert(set, vertices)) {
+		set->del(set);
+		return -1;
+	}
+
+	for (;;) {
+		// The only way to the closest vertex is the sorted list.
+		struct dt_list * items = set->items(set);
+		if (!items) {
+			set->del(set);
+			return -1;
+		}
+
+		struct vertex * vertex = NULL;
+		if (items->length(items)) vertex = items->get(items, 0);
+		items->del(items);
+		if (!vertex) break;
+
+		set->remove(set, vertex);
+		vertex->queued = 0;
+		vertex->done = 1;
+		struct edge * edges = graph->edges +
+			(vertex - vertices) * (DEGREE + 1);
+
+		for (size_t i = 0; i <= DEGREE; i++) {
+			struct vertex * to = vertices + edges[i].to;
+			unsigned long distance = vertex->distance + edges[i].weight;
+			if (to->done || distance >= to->distance) continue;
+
+			// Moving a vertex means taking it out and putting
+			// it back, freeing and allocating a node.
+			if (to->queued) set->remove(set, to);
+			to->distance = distance;
+			to->queued = 1;
+			if (set->insert(set, to)) {
+				set->del(set);
+				return -1;
+			}
+		}
+	}
+
+	set->del(set);
+	return 0;
+}
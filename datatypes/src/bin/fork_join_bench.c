@@ -0,0 +1,189 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "stack.h"
+#include "stack/workstealing.h"
+
+#include "bench.h"
+
+#define DEFAULT_N 32
+#define DEFAULT_THREADS 8
+// Below this fib is worked out on the spot instead of
+// being split into more tasks.
+#define CUTOFF 16
+
+static char * program_name = "fork_join_bench";
+
+struct worker {
+	pthread_t thread;
+	struct dt_stack * deque;
+	// Every worker, so thieves can pick a victim.
+	struct worker * workers;
+	size_t worker_count;
+	unsigned long state;
+	unsigned long long sum;
+	size_t tasks;
+};
+
+// Tasks spawned and not yet finished, across all workers.
+static atomic_size_t pending;
+
+int main(int argc, char ** argv);
+
+/** Prints the usage to the given stream.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ */
+void usage(FILE * stream);
+
+/** Runs one worker until every task is done.
+ *
+ *  Arguments:
+ *    argument: The worker to run.
+ *
+ *  Returns:
+ *    NULL.
+ */
+static void * work(void * argument);
+
+/** Works out fib the slow way.
+ *
+ *  Arguments:
+ *    n: Which number to work out.
+ *
+ *  Returns:
+ *    The nth fibonacci number.
+ */
+static unsigned long long fib(unsigned long n);
+
+void usage(FILE * stream)
+{
+	fprintf(stream, "usage: %s [n [threads]]\n", program_name);
+	fprintf(stream, "\tn: the fibonacci number to work out (default %d)\n",
+		DEFAULT_N);
+	fprintf(stream, "\tthreads: the most threads to run, doubling from one"
+		" (default %d)\n", DEFAULT_THREADS);
+}
+
+int main(int argc, char ** argv)
+{
+	size_t n = DEFAULT_N;
+	size_t most_threads = DEFAULT_THREADS;
+
+	if (argc) {
+		program_name = argv[0];
+	}
+
+	if (argc > 3 || (argc >= 2 && bench_parse_count(argv[1], &n)) ||
+		(argc >= 3 && bench_parse_count(argv[2], &most_threads))) {
+		usage(stderr);
+		return 1;
+	}
+
+	for (size_t threads = 1; threads <= most_threads; threads *= 2) {
+		struct worker * workers = calloc(threads, sizeof(*workers));
+		if (!workers) {
+			fprintf(stderr, "Failed to make workers\n");
+			return 1;
+		}
+
+		for (size_t i = 0; i < threads; i++) {
+			workers[i].deque = dt_stack_workstealing_new();
+			if (!workers[i].deque) {
+				fprintf(stderr, "Failed to make deque\n");
+				return 1;
+			}
+			workers[i].workers = workers;
+			workers[i].worker_count = threads;
+			workers[i].state = 88172645463325252ul + i;
+		}
+
+		// Tasks are numbers, offset so none is NULL.
+		atomic_store(&pending, 1);
+		workers[0].deque->push(workers[0].deque, (void *) (uintptr_t) (n + 1));
+
+		double start = bench_now();
+		size_t started = 0;
+		for (; started < threads; started++) {
+			if (pthread_create(&workers[started].thread, NULL, &work,
+				workers + started)) break;
+		}
+		for (size_t i = 0; i < started; i++) {
+			pthread_join(workers[i].thread, NULL);
+		}
+		double seconds = bench_now() - start;
+
+		if (started != threads) {
+			fprintf(stderr, "Failed to start threads\n");
+			return 1;
+		}
+
+		unsigned long long sum = 0;
+		size_t tasks = 0;
+		for (size_t i = 0; i < threads; i++) {
+			sum += workers[i].sum;
+			tasks += workers[i].tasks;
+			workers[i].deque->del(workers[i].deque);
+		}
+		free(workers);
+
+		if (sum != fib(n)) {
+			fprintf(stderr, "Wrong answer %llu\n", sum);
+			return 1;
+		}
+
+		char name[128];
+		snprintf(name, sizeof(name), "fib %zu/%zu threads", n, threads);
+		bench_report(stdout, name, tasks, seconds);
+	}
+
+	return 0;
+}
+
+static void * work(void * argument)
+{
+	struct worker * worker = argument;
+	struct dt_stack * deque = worker->deque;
+
+	while (atomic_load(&pending)) {
+		void * task = deque->pop(deque);
+
+		if (!task) {
+			// Out of work, try someone else's oldest task.
+			// Those are the biggest ones.
+			struct worker * victim = worker->workers +
+				bench_random(&worker->state) % worker->worker_count;
+			if (victim == worker) continue;
+			if (dt_stack_workstealing_steal(victim->deque, &task)) continue;
+		}
+
+		// fib(n) = fib(n - 1) + fib(n - 2). Hand out one half
+		// and carry on with the other.
+		unsigned long n = (uintptr_t) task - 1;
+		while (n >= CUTOFF) {
+			atomic_fetch_add(&pending, 1);
+			if (deque->push(deque, (void *) (uintptr_t) (n - 2 + 1))) {
+				// No room to hand it out, do it here.
+				atomic_fetch_sub(&pending, 1);
+				worker->sum += fib(n - 2);
+			}
+			n--;
+		}
+
+		worker->sum += fib(n);
+		worker->tasks++;
+		atomic_fetch_sub(&pending, 1);
+	}
+
+	return NULL;
+}
+
+static unsigned long long fib(unsigned long n)
+{
+	if (n < 2) return n;
+	return fib(n - 1) + fib(n - 2);
+}
@@ -0,0 +1,411 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "list.h"
+#include "list/vector.h"
+#include "list/linked.h"
+#include "list/gap.h"
+#include "list/deque.h"
+#include "list/tiered.h"
+#include "list/skip.h"
+
+#include "bench.h"
+
+#define DEFAULT_COUNT 20000
+
+static char * program_name = "list_bench";
+static char items[256];
+
+struct list_kind {
+	char * name;
+	struct dt_list * (* new)(void);
+};
+
+struct list_workload {
+	char * name;
+	/** Runs the workload.
+	 *
+	 *  Arguments:
+	 *    list: An empty list to run against.
+	 *    count: The size of the workload.
+	 *    seconds: Where to put the time taken.
+	 *
+	 *  Returns:
+	 *    The number of operations timed.
+	 */
+	size_t (* run)(struct dt_list * list, size_t count, double * seconds);
+};
+
+int main(int argc, char ** argv);
+
+/** Prints the usage to the given stream.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ */
+void usage(FILE * stream);
+
+/** Fills the list with count items without timing it.
+ *
+ *  Arguments:
+ *    list: The list to fill.
+ *    count: The number of items to add.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise.
+ */
+static int fill(struct dt_list * list, size_t count);
+
+// Kinds.
+static struct dt_list * linked_pooled_new(void);
+
+// Workloads.
+static size_t edit_locality(struct dt_list * list, size_t count,
+	double * seconds);
+static size_t append_single(struct dt_list * list, size_t count,
+	double * seconds);
+static size_t append_many(struct dt_list * list, size_t count,
+	double * seconds);
+static size_t slice_single(struct dt_list * list, size_t count,
+	double * seconds);
+static size_t slice_range(struct dt_list * list, size_t count,
+	double * seconds);
+static size_t queue(struct dt_list * list, size_t count,
+	double * seconds);
+static size_t random_insert(struct dt_list * list, size_t count,
+	double * seconds);
+static size_t indexed_scan(struct dt_list * list, size_t count,
+	double * seconds);
+static size_t mixed(struct dt_list * list, size_t count,
+	double * seconds);
+static size_t move_chunks(struct dt_list * list, size_t count,
+	double * seconds);
+
+static struct list_kind kinds[] = {
+	{"vector", &dt_list_vector_new},
+	{"linked", &dt_list_linked_new},
+	{"linked pooled", &linked_pooled_new},
+	{"gap", &dt_list_gap_new},
+	{"deque", &dt_list_deque_new},
+	{"tiered", &dt_list_tiered_new},
+	{"skip", &dt_list_skip_new}
+};
+
+static struct list_workload workloads[] = {
+	{"edit locality", &edit_locality},
+	{"append single", &append_single},
+	{"append many", &append_many},
+	{"slice remove single", &slice_single},
+	{"slice remove range", &slice_range},
+	{"queue", &queue},
+	{"random insert", &random_insert},
+	{"indexed scan", &indexed_scan},
+	{"mixed", &mixed},
+	{"move chunks", &move_chunks}
+};
+
+void usage(FILE * stream)
+{
+	fprintf(stream, "usage: %s [count [workload [list]]]\n", program_name);
+	fprintf(stream, "\tcount: the size of each workload (default %d)\n",
+		DEFAULT_COUNT);
+	fprintf(stream, "\tworkload: only run the named workload\n");
+	fprintf(stream, "\tlist: only run against the named list\n");
+}
+
+int main(int argc, char ** argv)
+{
+	size_t count = DEFAULT_COUNT;
+	char * only = NULL;
+	char * only_kind = NULL;
+
+	if (argc) {
+		program_name = argv[0];
+	}
+
+	if (argc > 4 || (argc >= 2 && bench_parse_count(argv[1], &count))) {
+		usage(stderr);
+		return 1;
+	}
+
+	if (argc >= 3) {
+		only = argv[2];
+	}
+
+	if (argc == 4) {
+		only_kind = argv[3];
+	}
+
+	for (size_t i = 0; i < sizeof(workloads) / sizeof(*workloads); i++) {
+		if (only && strcmp(only, workloads[i].name) != 0) continue;
+
+		for (size_t j = 0; j < sizeof(kinds) / sizeof(*kinds); j++) {
+			if (only_kind && strcmp(only_kind, kinds[j].name) != 0) continue;
+
+			struct dt_list * list = kinds[j].new();
+			if (!list) {
+				fprintf(stderr, "Failed to make list\n");
+				return 1;
+			}
+
+			double seconds = 0;
+			size_t operations = workloads[i].run(list, count, &seconds);
+
+			char name[128];
+			snprintf(name, sizeof(name), "%s/%s",
+				workloads[i].name, kinds[j].name);
+			bench_report(stdout, name, operations, seconds);
+
+			list->del(list);
+		}
+	}
+
+	return 0;
+}
+
+static struct dt_list * linked_pooled_new(void)
+{
+	return dt_list_linked_pooled_new(NULL);
+}
+
+static int fill(struct dt_list * list, size_t count)
+{
+	struct dt_list_iterator storage;
+	struct dt_list_iterator * iterator = list->iterator_init(list, &storage);
+
+	for (size_t i = 0; i < count; i++) {
+		if (iterator->insert(iterator, items + i % sizeof(items))) {
+			iterator->del(iterator);
+			return -1;
+		}
+		iterator->next(iterator);
+	}
+
+	iterator->del(iterator);
+	return 0;
+}
+
+static size_t edit_locality(struct dt_list * list, size_t count,
+	double * seconds)
+{
+	// An editor like cursor that wanders a few places at a
+	// time typing and deleting as it goes.
+	if (fill(list, count)) return 0;
+
+	struct dt_list_iterator * iterator = list->iterator(list);
+	if (!iterator) return 0;
+
+	unsigned long state = 88172645463325252ul;
+	for (size_t i = 0; i < count / 2; i++) {
+		iterator->next(iterator);
+	}
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		unsigned long r = bench_random(&state);
+		long move = (long) (r % 9) - 4;
+
+		for (; move > 0; move--) {
+			if (!iterator->valid(iterator)) break;
+			iterator->next(iterator);
+		}
+		for (; move < 0; move++) {
+			if (iterator->previous(iterator)) break;
+		}
+
+		if (r & 0x100 || !iterator->valid(iterator)) {
+			iterator->insert(iterator, items + r % sizeof(items));
+		} else {
+			iterator->remove(iterator);
+		}
+	}
+	*seconds = bench_now() - start;
+
+	iterator->del(iterator);
+	return count;
+}
+
+static size_t append_single(struct dt_list * list, size_t count,
+	double * seconds)
+{
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		list->insert(list, list->length(list), items + i % sizeof(items));
+	}
+	*seconds = bench_now() - start;
+	return count;
+}
+
+static size_t append_many(struct dt_list * list, size_t count,
+	double * seconds)
+{
+	void ** batch = malloc(sizeof(*batch) * count);
+	if (!batch) return 0;
+
+	for (size_t i = 0; i < count; i++) {
+		batch[i] = items + i % sizeof(items);
+	}
+
+	double start = bench_now();
+	list->append_many(list, batch, count);
+	*seconds = bench_now() - start;
+
+	free(batch);
+	return count;
+}
+
+static size_t slice_single(struct dt_list * list, size_t count,
+	double * seconds)
+{
+	// Cut the middle tenth out one item at a time.
+	if (fill(list, count)) return 0;
+
+	size_t slice = count / 10;
+	size_t index = (count - slice) / 2;
+
+	double start = bench_now();
+	for (size_t i = 0; i < slice; i++) {
+		list->remove(list, index);
+	}
+	*seconds = bench_now() - start;
+	return slice;
+}
+
+static size_t slice_range(struct dt_list * list, size_t count,
+	double * seconds)
+{
+	if (fill(list, count)) return 0;
+
+	size_t slice = count / 10;
+	size_t index = (count - slice) / 2;
+
+	double start = bench_now();
+	list->remove_range(list, index, slice);
+	*seconds = bench_now() - start;
+	return slice;
+}
+
+static size_t queue(struct dt_list * list, size_t count,
+	double * seconds)
+{
+	// A work queue holding a steady backlog, pushing at the
+	// back and popping at the front.
+	if (fill(list, count / 4)) return 0;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		list->insert(list, list->length(list), items + i % sizeof(items));
+		list->remove(list, 0);
+	}
+	*seconds = bench_now() - start;
+	return count;
+}
+
+static size_t random_insert(struct dt_list * list, size_t count,
+	double * seconds)
+{
+	// Grow a list by inserting anywhere, then read it back.
+	unsigned long state = 2463534242ul;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		size_t index = bench_random(&state) % (list->length(list) + 1);
+		list->insert(list, index, items + i % sizeof(items));
+	}
+	for (size_t i = 0; i < count; i++) {
+		list->get(list, bench_random(&state) % count);
+	}
+	*seconds = bench_now() - start;
+	return count * 2;
+}
+
+static size_t indexed_scan(struct dt_list * list, size_t count,
+	double * seconds)
+{
+	// Read every item by index, forwards then backwards.
+	if (fill(list, count)) return 0;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		list->get(list, i);
+	}
+	for (size_t i = count; i > 0; i--) {
+		list->get(list, i - 1);
+	}
+	*seconds = bench_now() - start;
+	return count * 2;
+}
+
+static size_t mixed(struct dt_list * list, size_t count,
+	double * seconds)
+{
+	// An ordered log: mostly reads by index with inserts
+	// and removes anywhere, holding the size steady.
+	if (fill(list, count)) return 0;
+
+	unsigned long state = 2463534242ul;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		unsigned long r = bench_random(&state);
+		size_t index = (r >> 4) % list->length(list);
+
+		switch (r & 3) {
+		case 0:
+			list->insert(list, index, items + i % sizeof(items));
+			break;
+		case 1:
+			list->remove(list, index);
+			break;
+		default:
+			list->get(list, index);
+			break;
+		}
+	}
+	*seconds = bench_now() - start;
+	return count;
+}
+
+static size_t move_chunks(struct dt_list * list, size_t count,
+	double * seconds)
+{
+	// A batching stage handing tenths of the list to another
+	// list and taking them back somewhere else. Linked lists
+	// splice. Everything else copies out and back in.
+	if (fill(list, count)) return 0;
+
+	size_t chunk = count / 10;
+	size_t rounds = 1000;
+	struct dt_list * other = dt_list_linked_split_at(list, count);
+	void ** buffer = NULL;
+
+	if (!other) {
+		buffer = malloc(sizeof(*buffer) * (chunk + 1));
+		if (!buffer) return 0;
+	}
+
+	unsigned long state = 2463534242ul;
+
+	double start = bench_now();
+	for (size_t i = 0; i < rounds; i++) {
+		size_t from = bench_random(&state) % (count - chunk + 1);
+		size_t to = bench_random(&state) % (count - chunk + 1);
+
+		if (other) {
+			dt_list_linked_splice(other, 0, list, from, from + chunk);
+			dt_list_linked_splice(list, to, other, 0, chunk);
+		} else {
+			for (size_t j = 0; j < chunk; j++) {
+				buffer[j] = list->get(list, from + j);
+			}
+			list->remove_range(list, from, chunk);
+			list->insert_range(list, to, buffer, chunk);
+		}
+	}
+	*seconds = bench_now() - start;
+
+	if (other) other->del(other);
+	free(buffer);
+	return rounds;
+}
@@ -8,6 +8,10 @@
 #include "list.h"
 #include "list/vector.h"
 #include "list/linked.h"
+#include "list/gap.h"
+#include "list/deque.h"
+#include "list/tiered.h"
+#include "list/skip.h"
 
 #include "cli.h"
 
@@ -94,9 +98,13 @@ static struct cli_menu_item_t iterator_items[] = {
 
 void usage(FILE * stream)
 {
-	fprintf(stream, "usage: %s <linked|vector> [[no]tty]\n", program_name);
+	fprintf(stream, "usage: %s <linked|vector|gap|deque|tiered|skip> [[no]tty]\n", program_name);
 	fprintf(stream, "\tlinked: test a linked list\n");
 	fprintf(stream, "\tvector: test a vector list\n");
+	fprintf(stream, "\tgap: test a gap buffer list\n");
+	fprintf(stream, "\tdeque: test a deque list\n");
+	fprintf(stream, "\ttiered: test a tiered list\n");
+	fprintf(stream, "\tskip: test a skip list\n");
 	fprintf(stream, "\t[no]tty: [do not] start in interactive mode\n");
 }
 
@@ -132,6 +140,18 @@ int main (int argc, char ** argv)
 		} else if (strcmp(argv[1], "linked") == 0) {
 			list = dt_list_linked_new();
 			break;
+		} else if (strcmp(argv[1], "gap") == 0) {
+			list = dt_list_gap_new();
+			break;
+		} else if (strcmp(argv[1], "deque") == 0) {
+			list = dt_list_deque_new();
+			break;
+		} else if (strcmp(argv[1], "tiered") == 0) {
+			list = dt_list_tiered_new();
+			break;
+		} else if (strcmp(argv[1], "skip") == 0) {
+			list = dt_list_skip_new();
+			break;
 		} else {
 			usage(stderr);
 			return 1;
@@ -0,0 +1,281 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "lru.h"
+#include "set.h"
+#include "set/hash.h"
+#include "list.h"
+#include "list/linked.h"
+
+#include "bench.h"
+
+#define DEFAULT_COUNT 200000
+#define DEFAULT_KEYS 10000
+
+static char * program_name = "lru_bench";
+
+struct entry {
+	unsigned long key;
+};
+
+struct cache_kind {
+	char * name;
+	/** Runs the accesses through a cache.
+	 *
+	 *  Arguments:
+	 *    keys: The keys to access in order.
+	 *    count: The number of keys.
+	 *    capacity: The most keys the cache may hold.
+	 *    seconds: Where to put the time taken.
+	 *
+	 *  Returns:
+	 *    The number of hits. Or (size_t) -1 if the cache
+	 *    could not be made.
+	 */
+	size_t (* run)(const unsigned long * keys, size_t count,
+		size_t capacity, double * seconds);
+};
+
+int main(int argc, char ** argv);
+
+/** Prints the usage to the given stream.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ */
+void usage(FILE * stream);
+
+/** Draws keys from a zipfian distribution.
+ *
+ *  Arguments:
+ *    keys: Where to put the keys.
+ *    count: The number of keys to draw.
+ *    universe: The number of distinct keys. Key k is
+ *              drawn in proportion to 1 / (k + 1).
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise.
+ */
+static int zipfian(unsigned long * keys, size_t count, size_t universe);
+
+static int compare_keys(void * a, void * b);
+static unsigned int hash_key(void * item);
+static void free_entry(void * item);
+
+// Kinds.
+static size_t lru_run(const unsigned long * keys, size_t count,
+	size_t capacity, double * seconds);
+static size_t set_list_run(const unsigned long * keys, size_t count,
+	size_t capacity, double * seconds);
+
+static struct cache_kind kinds[] = {
+	{"lru", &lru_run},
+	{"hash set and linked list", &set_list_run}
+};
+
+void usage(FILE * stream)
+{
+	fprintf(stream, "usage: %s [count [keys [cache]]]\n", program_name);
+	fprintf(stream, "\tcount: the accesses in each run (default %d)\n",
+		DEFAULT_COUNT);
+	fprintf(stream, "\tkeys: the number of distinct keys (default %d)\n",
+		DEFAULT_KEYS);
+	fprintf(stream, "\tcache: only run against the named cache\n");
+}
+
+int main(int argc, char ** argv)
+{
+	size_t count = DEFAULT_COUNT;
+	size_t universe = DEFAULT_KEYS;
+	char * only_kind = NULL;
+
+	if (argc) {
+		program_name = argv[0];
+	}
+
+	if (argc > 4 || (argc >= 2 && bench_parse_count(argv[1], &count)) ||
+		(argc >= 3 && bench_parse_count(argv[2], &universe)) ||
+		universe < 100) {
+		usage(stderr);
+		return 1;
+	}
+
+	if (argc == 4) {
+		only_kind = argv[3];
+	}
+
+	unsigned long * keys = malloc(sizeof(*keys) * count);
+	if (!keys || zipfian(keys, count, universe)) {
+		fprintf(stderr, "Failed to make keys\n");
+		return 1;
+	}
+
+	// Caches holding 1% and 10% of the keys.
+	size_t capacities[] = {universe / 100, universe / 10};
+
+	for (size_t i = 0; i < sizeof(capacities) / sizeof(*capacities); i++) {
+		for (size_t j = 0; j < sizeof(kinds) / sizeof(*kinds); j++) {
+			if (only_kind && strcmp(only_kind, kinds[j].name) != 0) continue;
+
+			double seconds = 0;
+			size_t hits = kinds[j].run(keys, count, capacities[i], &seconds);
+			if (hits == (size_t) -1) {
+				fprintf(stderr, "Failed to make cache\n");
+				return 1;
+			}
+
+			char name[128];
+			snprintf(name, sizeof(name), "zipfian %zu/%s",
+				capacities[i], kinds[j].name);
+			bench_report(stdout, name, count, seconds);
+			printf("%-40s %9.2f%% hits\n", name, 100.0 * hits / count);
+		}
+	}
+
+	free(keys);
+	return 0;
+}
+
+static int zipfian(unsigned long * keys, size_t count, size_t universe)
+{
+	double * totals = malloc(sizeof(*totals) * universe);
+	if (!totals) return -1;
+
+	double total = 0;
+	for (size_t k = 0; k < universe; k++) {
+		total += 1.0 / (k + 1);
+		totals[k] = total;
+	}
+
+	unsigned long state = 88172645463325252ul;
+	for (size_t i = 0; i < count; i++) {
+		double target = (bench_random(&state) & 0xfffffffful) /
+			4294967296.0 * total;
+
+		// The first key whose running total reaches the target.
+		size_t low = 0;
+		size_t high = universe - 1;
+		while (low < high) {
+			size_t middle = low + (high - low) / 2;
+			if (totals[middle] < target) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+
+		// Scatter the popular keys so they do not share
+		// low bits.
+		keys[i] = low * 2654435761ul;
+	}
+
+	free(totals);
+	return 0;
+}
+
+static int compare_keys(void * a, void * b)
+{
+	unsigned long x = ((struct entry *) a)->key;
+	unsigned long y = ((struct entry *) b)->key;
+	return
+		x == y ? 0 :
+		x < y ? -1 : 1;
+}
+
+static unsigned int hash_key(void * item)
+{
+	unsigned long x = ((struct entry *) item)->key;
+	return x ^ (x >> 32);
+}
+
+static void free_entry(void * item)
+{
+	free(item);
+}
+
+static size_t lru_run(const unsigned long * keys, size_t count,
+	size_t capacity, double * seconds)
+{
+	struct dt_lru * lru = dt_lru_new(capacity, &compare_keys, &hash_key,
+		&free_entry);
+	if (!lru) return (size_t) -1;
+
+	size_t hits = 0;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		struct entry probe = {keys[i]};
+		if (dt_lru_get(lru, &probe)) {
+			hits++;
+			continue;
+		}
+
+		struct entry * entry = malloc(sizeof(*entry));
+		if (!entry) continue;
+		entry->key = keys[i];
+		if (dt_lru_put(lru, entry)) free(entry);
+	}
+	*seconds = bench_now() - start;
+
+	dt_lru_del(lru);
+	return hits;
+}
+
+static size_t set_list_run(const unsigned long * keys, size_t count,
+	size_t capacity, double * seconds)
+{
+	// The cache built by hand: a set to find entries and
+	// a list, most recent first, to know what to evict.
+	struct dt_set * set = dt_set_hash_new(&compare_keys, &hash_key);
+	struct dt_list * list = dt_list_linked_new();
+	if (!set || !list) {
+		if (set) set->del(set);
+		if (list) list->del(list);
+		return (size_t) -1;
+	}
+
+	size_t hits = 0;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		struct entry probe = {keys[i]};
+		struct entry * entry = set->has(set, &probe);
+
+		if (entry) {
+			hits++;
+
+			// Promoting means finding the entry's place first.
+			struct dt_list_iterator storage;
+			struct dt_list_iterator * iterator;
+			iterator = list->iterator_init(list, &storage);
+			while (iterator->get(iterator) != entry) iterator->next(iterator);
+			iterator->remove(iterator);
+			iterator->del(iterator);
+
+			list->insert(list, 0, entry);
+			continue;
+		}
+
+		if (list->length(list) == capacity) {
+			struct entry * oldest = list->get(list, capacity - 1);
+			list->remove(list, capacity - 1);
+			set->remove(set, oldest);
+			free(oldest);
+		}
+
+		entry = malloc(sizeof(*entry));
+		if (!entry) continue;
+		entry->key = keys[i];
+		set->insert(set, entry);
+		list->insert(list, 0, entry);
+	}
+	*seconds = bench_now() - start;
+
+	for (size_t i = 0; i < list->length(list); i++) {
+		free(list->get(list, i));
+	}
+	list->del(list);
+	set->del(set);
+	return hits;
+}
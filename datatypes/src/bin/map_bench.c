@@ -0,0 +1,382 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "map.h"
+#include "map/hash.h"
+#include "set.h"
+#include "set/hash.h"
+#include "set/tree.h"
+#include "list.h"
+
+#include "bench.h"
+
+#define DEFAULT_COUNT 200000
+
+static char * program_name = "map_bench";
+
+struct map_kind {
+	char * name;
+	struct dt_map * (* new)(void);
+};
+
+struct map_workload {
+	char * name;
+	/** Runs the workload.
+	 *
+	 *  Arguments:
+	 *    map: An empty map to run against.
+	 *    count: The size of the workload.
+	 *    seconds: Where to put the time taken.
+	 *
+	 *  Returns:
+	 *    The number of operations timed.
+	 */
+	size_t (* run)(struct dt_map * map, size_t count, double * seconds);
+};
+
+// A key and value allocated together and kept in a
+// set that only looks at the key, the way a set was
+// used as a map before there was a map.
+struct entry {
+	unsigned long key;
+	unsigned long value;
+};
+
+struct set_map {
+	struct dt_map map;
+	struct dt_set * set;
+	size_t length;
+};
+
+int main(int argc, char ** argv);
+
+/** Prints the usage to the given stream.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ */
+void usage(FILE * stream);
+
+static int compare_keys(void * a, void * b);
+static unsigned int hash_key(void * key);
+
+// Kinds.
+static struct dt_map * hash_new(void);
+static struct dt_map * hash_set_new(void);
+static struct dt_map * tree_set_new(void);
+static struct dt_map * set_map_new(struct dt_set * set);
+static int set_put(struct dt_map * this, void * key, void * value);
+static void * set_get(const struct dt_map * this, void * key);
+static void set_remove(struct dt_map * this, void * key);
+static int set_iterate(const struct dt_map * this,
+	int (* visit)(void * key, void * value, void * context),
+	void * context);
+static size_t set_length(const struct dt_map * this);
+static void set_del(struct dt_map * this);
+
+// Workloads.
+static size_t insert(struct dt_map * map, size_t count, double * seconds);
+static size_t lookup_hit(struct dt_map * map, size_t count,
+	double * seconds);
+static size_t lookup_miss(struct dt_map * map, size_t count,
+	double * seconds);
+static size_t churn(struct dt_map * map, size_t count, double * seconds);
+
+static struct map_kind kinds[] = {
+	{"hash map", &hash_new},
+	{"hash set of entries", &hash_set_new},
+	{"tree set of entries", &tree_set_new}
+};
+
+static struct map_workload workloads[] = {
+	{"insert", &insert},
+	{"lookup hit", &lookup_hit},
+	{"lookup miss", &lookup_miss},
+	{"churn", &churn}
+};
+
+void usage(FILE * stream)
+{
+	fprintf(stream, "usage: %s [count [workload [map]]]\n", program_name);
+	fprintf(stream, "\tcount: the size of each workload (default %d)\n",
+		DEFAULT_COUNT);
+	fprintf(stream, "\tworkload: only run the named workload\n");
+	fprintf(stream, "\tmap: only run against the named map\n");
+}
+
+int main(int argc, char ** argv)
+{
+	size_t count = DEFAULT_COUNT;
+	char * only = NULL;
+	char * only_kind = NULL;
+
+	if (argc) {
+		program_name = argv[0];
+	}
+
+	if (argc > 4 || (argc >= 2 && bench_parse_count(argv[1], &count))) {
+		usage(stderr);
+		return 1;
+	}
+
+	if (argc >= 3) {
+		only = argv[2];
+	}
+
+	if (argc == 4) {
+		only_kind = argv[3];
+	}
+
+	for (size_t i = 0; i < sizeof(workloads) / sizeof(*workloads); i++) {
+		if (only && strcmp(only, workloads[i].name) != 0) continue;
+
+		for (size_t j = 0; j < sizeof(kinds) / sizeof(*kinds); j++) {
+			if (only_kind && strcmp(only_kind, kinds[j].name) != 0) continue;
+
+			struct dt_map * map = kinds[j].new();
+			if (!map) {
+				fprintf(stderr, "Failed to make map\n");
+				return 1;
+			}
+
+			double seconds = 0;
+			size_t operations = workloads[i].run(map, count, &seconds);
+
+			char name[128];
+			snprintf(name, sizeof(name), "%s/%s",
+				workloads[i].name, kinds[j].name);
+			bench_report(stdout, name, operations, seconds);
+
+			map->del(map);
+		}
+	}
+
+	return 0;
+}
+
+static int compare_keys(void * a, void * b)
+{
+	// Entries start with their key so this works for both.
+	unsigned long x = *(unsigned long *) a;
+	unsigned long y = *(unsigned long *) b;
+	return
+		x == y ? 0 :
+		x < y ? -1 : 1;
+}
+
+static unsigned int hash_key(void * key)
+{
+	unsigned long x = *(unsigned long *) key;
+	return x ^ (x >> 32);
+}
+
+static struct dt_map * hash_new(void)
+{
+	return dt_map_hash_new(sizeof(unsigned long), sizeof(unsigned long),
+		&compare_keys, &hash_key);
+}
+
+static struct dt_map * hash_set_new(void)
+{
+	return set_map_new(dt_set_hash_new(&compare_keys, &hash_key));
+}
+
+static struct dt_map * tree_set_new(void)
+{
+	return set_map_new(dt_set_tree_new(&compare_keys, &hash_key));
+}
+
+static struct dt_map * set_map_new(struct dt_set * set)
+{
+	if (!set) return NULL;
+
+	struct set_map * wrapped = malloc(sizeof(*wrapped));
+	if (!wrapped) {
+		set->del(set);
+		return NULL;
+	}
+
+	wrapped->set = set;
+	wrapped->length = 0;
+
+	struct dt_map * map = &wrapped->map;
+	map->put = &set_put;
+	map->get = &set_get;
+	map->remove = &set_remove;
+	map->iterate = &set_iterate;
+	map->length = &set_length;
+	map->del = &set_del;
+	map->_data = wrapped;
+
+	return map;
+}
+
+static int set_put(struct dt_map * this, void * key, void * value)
+{
+	struct set_map * wrapped = this->_data;
+	struct entry * found = wrapped->set->has(wrapped->set, key);
+
+	if (found) {
+		found->value = *(unsigned long *) value;
+		return 0;
+	}
+
+	struct entry * entry = malloc(sizeof(*entry));
+	if (!entry) return -1;
+
+	entry->key = *(unsigned long *) key;
+	entry->value = *(unsigned long *) value;
+
+	if (wrapped->set->insert(wrapped->set, entry)) {
+		free(entry);
+		return -1;
+	}
+
+	wrapped->length++;
+	return 0;
+}
+
+static void * set_get(const struct dt_map * this, void * key)
+{
+	struct set_map * wrapped = this->_data;
+	struct entry * found = wrapped->set->has(wrapped->set, key);
+
+	if (!found) return NULL;
+	return &found->value;
+}
+
+static void set_remove(struct dt_map * this, void * key)
+{
+	struct set_map * wrapped = this->_data;
+	struct entry * found = wrapped->set->has(wrapped->set, key);
+
+	if (!found) return;
+
+	wrapped->set->remove(wrapped->set, found);
+	free(found);
+	wrapped->length--;
+}
+
+static int set_iterate(const struct dt_map * this,
+	int (* visit)(void * key, void * value, void * context),
+	void * context)
+{
+	struct set_map * wrapped = this->_data;
+	struct dt_list * items = wrapped->set->items(wrapped->set);
+	if (!items) return -1;
+
+	int result = 0;
+	for (size_t i = 0; i < items->length(items) && !result; i++) {
+		struct entry * entry = items->get(items, i);
+		result = visit(&entry->key, &entry->value, context);
+	}
+
+	items->del(items);
+	return result;
+}
+
+static size_t set_length(const struct dt_map * this)
+{
+	struct set_map * wrapped = this->_data;
+	return wrapped->length;
+}
+
+static int free_entry(void * key, void * value, void * context)
+{
+	free(key);
+	return 0;
+}
+
+static void set_del(struct dt_map * this)
+{
+	struct set_map * wrapped = this->_data;
+	set_iterate(this, &free_entry, NULL);
+	wrapped->set->del(wrapped->set);
+	free(wrapped);
+}
+
+static size_t insert(struct dt_map * map, size_t count, double * seconds)
+{
+	unsigned long state = 88172645463325252ul;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		unsigned long key = bench_random(&state);
+		map->put(map, &key, &i);
+	}
+	*seconds = bench_now() - start;
+	return count;
+}
+
+static size_t lookup_hit(struct dt_map * map, size_t count,
+	double * seconds)
+{
+	unsigned long state = 88172645463325252ul;
+	for (size_t i = 0; i < count; i++) {
+		unsigned long key = bench_random(&state);
+		map->put(map, &key, &i);
+	}
+
+	// The same keys again, in the same order.
+	unsigned long sum = 0;
+	state = 88172645463325252ul;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		unsigned long key = bench_random(&state);
+		unsigned long * value = map->get(map, &key);
+		if (value) sum += *value;
+	}
+	*seconds = bench_now() - start;
+
+	if (sum == 1) printf("%lu\n", sum);
+	return count;
+}
+
+static size_t lookup_miss(struct dt_map * map, size_t count,
+	double * seconds)
+{
+	unsigned long state = 88172645463325252ul;
+	for (size_t i = 0; i < count; i++) {
+		unsigned long key = bench_random(&state) | 1;
+		map->put(map, &key, &i);
+	}
+
+	// Even keys, none of which were put.
+	size_t found = 0;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		unsigned long key = bench_random(&state) & ~1ul;
+		if (map->get(map, &key)) found++;
+	}
+	*seconds = bench_now() - start;
+
+	if (found) printf("%zu\n", found);
+	return count;
+}
+
+static size_t churn(struct dt_map * map, size_t count, double * seconds)
+{
+	// A cache of a fixed size: put a new key and drop
+	// the oldest one.
+	size_t depth = count / 16 + 1;
+	unsigned long put_state = 88172645463325252ul;
+	unsigned long remove_state = put_state;
+
+	for (size_t i = 0; i < depth; i++) {
+		unsigned long key = bench_random(&put_state);
+		map->put(map, &key, &i);
+	}
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		unsigned long key = bench_random(&put_state);
+		map->put(map, &key, &i);
+		key = bench_random(&remove_state);
+		map->remove(map, &key);
+	}
+	*seconds = bench_now() - start;
+	return count * 2;
+}
@@ -0,0 +1,297 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "pqueue.h"
+#include "pqueue/heap.h"
+#include "set.h"
+#include "set/tree.h"
+#include "list.h"
+
+#include "bench.h"
+
+#define DEFAULT_COUNT 100000
+// The number of items queued at once.
+#define DEPTH 1000
+
+static char * program_name = "pqueue_bench";
+
+// The items queued, so each has its own address.
+static unsigned long keys[DEPTH];
+
+struct pqueue_kind {
+	char * name;
+	struct dt_pqueue * (* new)(void);
+};
+
+struct pqueue_workload {
+	char * name;
+	/** Runs the workload.
+	 *
+	 *  Arguments:
+	 *    pqueue: An empty queue to run against.
+	 *    count: The size of the workload.
+	 *    seconds: Where to put the time taken.
+	 *
+	 *  Returns:
+	 *    The number of operations timed.
+	 */
+	size_t (* run)(struct dt_pqueue * pqueue, size_t count, double * seconds);
+};
+
+// A tree set used as a queue, the way it had to be done
+// before there was a queue. Sets hold no duplicates so
+// equal keys are told apart by their address.
+struct set_pqueue {
+	struct dt_pqueue pqueue;
+	struct dt_set * set;
+	size_t length;
+};
+
+int main(int argc, char ** argv);
+
+/** Prints the usage to the given stream.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ */
+void usage(FILE * stream);
+
+static int compare_keys(void * a, void * b);
+static int compare_addresses(void * a, void * b);
+
+// Kinds.
+static struct dt_pqueue * binary_new(void);
+static struct dt_pqueue * quaternary_new(void);
+static struct dt_pqueue * octonary_new(void);
+static struct dt_pqueue * set_new(void);
+static int set_push(struct dt_pqueue * this, void * item);
+static void * set_pop_min(struct dt_pqueue * this);
+static void * set_peek(const struct dt_pqueue * this);
+static size_t set_length(const struct dt_pqueue * this);
+static void set_del(struct dt_pqueue * this);
+
+// Workloads.
+static size_t fill_drain(struct dt_pqueue * pqueue, size_t count,
+	double * seconds);
+static size_t hold(struct dt_pqueue * pqueue, size_t count,
+	double * seconds);
+
+static struct pqueue_kind kinds[] = {
+	{"binary heap", &binary_new},
+	{"4-ary heap", &quaternary_new},
+	{"8-ary heap", &octonary_new},
+	{"tree set", &set_new}
+};
+
+static struct pqueue_workload workloads[] = {
+	{"fill drain", &fill_drain},
+	{"hold", &hold}
+};
+
+void usage(FILE * stream)
+{
+	fprintf(stream, "usage: %s [count [workload [pqueue]]]\n", program_name);
+	fprintf(stream, "\tcount: the size of each workload (default %d)\n",
+		DEFAULT_COUNT);
+	fprintf(stream, "\tworkload: only run the named workload\n");
+	fprintf(stream, "\tpqueue: only run against the named queue\n");
+}
+
+int main(int argc, char ** argv)
+{
+	size_t count = DEFAULT_COUNT;
+	char * only = NULL;
+	char * only_kind = NULL;
+
+	if (argc) {
+		program_name = argv[0];
+	}
+
+	if (argc > 4 || (argc >= 2 && bench_parse_count(argv[1], &count))) {
+		usage(stderr);
+		return 1;
+	}
+
+	if (argc >= 3) {
+		only = argv[2];
+	}
+
+	if (argc == 4) {
+		only_kind = argv[3];
+	}
+
+	for (size_t i = 0; i < sizeof(workloads) / sizeof(*workloads); i++) {
+		if (only && strcmp(only, workloads[i].name) != 0) continue;
+
+		for (size_t j = 0; j < sizeof(kinds) / sizeof(*kinds); j++) {
+			if (only_kind && strcmp(only_kind, kinds[j].name) != 0) continue;
+
+			struct dt_pqueue * pqueue = kinds[j].new();
+			if (!pqueue) {
+				fprintf(stderr, "Failed to make queue\n");
+				return 1;
+			}
+
+			double seconds = 0;
+			size_t operations = workloads[i].run(pqueue, count, &seconds);
+
+			char name[128];
+			snprintf(name, sizeof(name), "%s/%s",
+				workloads[i].name, kinds[j].name);
+			bench_report(stdout, name, operations, seconds);
+
+			pqueue->del(pqueue);
+		}
+	}
+
+	return 0;
+}
+
+static int compare_keys(void * a, void * b)
+{
+	unsigned long x = *(unsigned long *) a;
+	unsigned long y = *(unsigned long *) b;
+	return
+		x == y ? 0 :
+		x < y ? -1 : 1;
+}
+
+static int compare_addresses(void * a, void * b)
+{
+	int compare = compare_keys(a, b);
+	if (compare) return compare;
+	return
+		a == b ? 0 :
+		(char *) a < (char *) b ? -1 : 1;
+}
+
+static struct dt_pqueue * binary_new(void)
+{
+	return dt_pqueue_heap_new(&compare_keys, 2);
+}
+
+static struct dt_pqueue * quaternary_new(void)
+{
+	return dt_pqueue_heap_new(&compare_keys, 4);
+}
+
+static struct dt_pqueue * octonary_new(void)
+{
+	return dt_pqueue_heap_new(&compare_keys, 8);
+}
+
+static struct dt_pqueue * set_new(void)
+{
+	struct set_pqueue * wrapped = malloc(sizeof(*wrapped));
+	if (!wrapped) return NULL;
+
+	wrapped->set = dt_set_tree_new(&compare_addresses, NULL);
+	if (!wrapped->set) {
+		free(wrapped);
+		return NULL;
+	}
+	wrapped->length = 0;
+
+	struct dt_pqueue * pqueue = &wrapped->pqueue;
+	pqueue->push = &set_push;
+	pqueue->pop_min = &set_pop_min;
+	pqueue->peek = &set_peek;
+	pqueue->length = &set_length;
+	pqueue->del = &set_del;
+	pqueue->_data = wrapped;
+
+	return pqueue;
+}
+
+static int set_push(struct dt_pqueue * this, void * item)
+{
+	struct set_pqueue * wrapped = this->_data;
+	int result = wrapped->set->insert(wrapped->set, item);
+	if (!result) wrapped->length++;
+	return result;
+}
+
+static void * set_pop_min(struct dt_pqueue * this)
+{
+	struct set_pqueue * wrapped = this->_data;
+	void * min = set_peek(this);
+	if (!min) return NULL;
+
+	wrapped->set->remove(wrapped->set, min);
+	wrapped->length--;
+	return min;
+}
+
+static void * set_peek(const struct dt_pqueue * this)
+{
+	// The only way to the smallest item is the sorted list.
+	struct set_pqueue * wrapped = this->_data;
+	if (!wrapped->length) return NULL;
+
+	struct dt_list * items = wrapped->set->items(wrapped->set);
+	if (!items) return NULL;
+
+	void * min = items->get(items, 0);
+	items->del(items);
+	return min;
+}
+
+static size_t set_length(const struct dt_pqueue * this)
+{
+	struct set_pqueue * wrapped = this->_data;
+	return wrapped->length;
+}
+
+static void set_del(struct dt_pqueue * this)
+{
+	struct set_pqueue * wrapped = this->_data;
+	wrapped->set->del(wrapped->set);
+	free(wrapped);
+}
+
+static size_t fill_drain(struct dt_pqueue * pqueue, size_t count,
+	double * seconds)
+{
+	// Queue a batch of random keys then take them all
+	// out in order, like a sort.
+	unsigned long state = 88172645463325252ul;
+	size_t rounds = count / DEPTH;
+
+	double start = bench_now();
+	for (size_t round = 0; round < rounds; round++) {
+		for (size_t i = 0; i < DEPTH; i++) {
+			keys[i] = bench_random(&state) % (DEPTH * 4);
+			pqueue->push(pqueue, keys + i);
+		}
+		for (size_t i = 0; i < DEPTH; i++) {
+			pqueue->pop_min(pqueue);
+		}
+	}
+	*seconds = bench_now() - start;
+	return rounds * DEPTH * 2;
+}
+
+static size_t hold(struct dt_pqueue * pqueue, size_t count,
+	double * seconds)
+{
+	// An event loop: take the next event and schedule
+	// it again a little later, keeping the depth fixed.
+	unsigned long state = 88172645463325252ul;
+
+	for (size_t i = 0; i < DEPTH; i++) {
+		keys[i] = bench_random(&state) % DEPTH;
+		pqueue->push(pqueue, keys + i);
+	}
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		unsigned long * key = pqueue->pop_min(pqueue);
+		*key += 1 + bench_random(&state) % DEPTH;
+		pqueue->push(pqueue, key);
+	}
+	*seconds = bench_now() - start;
+
+	while (pqueue->pop_min(pqueue));
+	return count * 2;
+}
@@ -0,0 +1,314 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "queue.h"
+#include "queue/error.h"
+#include "queue/spsc.h"
+#include "queue/mpmc.h"
+#include "list.h"
+#include "list/vector.h"
+
+#include "bench.h"
+
+#define DEFAULT_COUNT 1000000
+#define CAPACITY 1024
+
+static char * program_name = "queue_bench";
+
+struct queue_kind {
+	char * name;
+	struct dt_queue * (* new)(void);
+	// Only safe with one producer and one consumer.
+	int single;
+};
+
+// A vector list behind one mutex, popping from the
+// front, the way work was passed along before. Held
+// to the same capacity as the rings.
+struct mutex_queue {
+	struct dt_queue queue;
+	struct dt_list * list;
+	pthread_mutex_t mutex;
+};
+
+// Shared by the threads of one run.
+struct run {
+	struct dt_queue * queue;
+	size_t count;
+	size_t producers;
+	// When each item was pushed, and how long it took
+	// to be popped.
+	double * pushed;
+	double * samples;
+	atomic_size_t popped;
+};
+
+struct worker {
+	pthread_t thread;
+	struct run * run;
+	size_t index;
+};
+
+int main(int argc, char ** argv);
+
+/** Prints the usage to the given stream.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ */
+void usage(FILE * stream);
+
+/** Pushes one producer's share of the items.
+ *
+ *  Arguments:
+ *    argument: The worker to run.
+ *
+ *  Returns:
+ *    NULL.
+ */
+static void * produce(void * argument);
+
+/** Pops items until every item has been popped.
+ *
+ *  Arguments:
+ *    argument: The worker to run.
+ *
+ *  Returns:
+ *    NULL.
+ */
+static void * consume(void * argument);
+
+// Kinds.
+static struct dt_queue * spsc_new(void);
+static struct dt_queue * mpmc_new(void);
+static struct dt_queue * mutex_new(void);
+static int mutex_push(struct dt_queue * this, void * item);
+static void * mutex_pop(struct dt_queue * this);
+static size_t mutex_length(const struct dt_queue * this);
+static void mutex_del(struct dt_queue * this);
+
+static struct queue_kind kinds[] = {
+	{"mutex vector list", &mutex_new, 0},
+	{"spsc", &spsc_new, 1},
+	{"mpmc", &mpmc_new, 0}
+};
+
+// Producers and consumers in each run.
+static size_t shapes[][2] = {
+	{1, 1},
+	{1, 4},
+	{4, 1},
+	{2, 2},
+	{4, 4}
+};
+
+void usage(FILE * stream)
+{
+	fprintf(stream, "usage: %s [count [queue]]\n", program_name);
+	fprintf(stream, "\tcount: the items passed in each run (default %d)\n",
+		DEFAULT_COUNT);
+	fprintf(stream, "\tqueue: only run against the named queue\n");
+}
+
+int main(int argc, char ** argv)
+{
+	size_t count = DEFAULT_COUNT;
+	char * only_kind = NULL;
+
+	if (argc) {
+		program_name = argv[0];
+	}
+
+	if (argc > 3 || (argc >= 2 && bench_parse_count(argv[1], &count))) {
+		usage(stderr);
+		return 1;
+	}
+
+	if (argc == 3) {
+		only_kind = argv[2];
+	}
+
+	struct run run;
+	run.pushed = malloc(sizeof(*run.pushed) * count);
+	run.samples = malloc(sizeof(*run.samples) * count);
+	if (!run.pushed || !run.samples) {
+		fprintf(stderr, "Failed to make samples\n");
+		return 1;
+	}
+
+	for (size_t i = 0; i < sizeof(shapes) / sizeof(*shapes); i++) {
+		size_t producers = shapes[i][0];
+		size_t consumers = shapes[i][1];
+
+		for (size_t j = 0; j < sizeof(kinds) / sizeof(*kinds); j++) {
+			if (only_kind && strcmp(only_kind, kinds[j].name) != 0) continue;
+			if (kinds[j].single && (producers > 1 || consumers > 1)) continue;
+
+			run.queue = kinds[j].new();
+			if (!run.queue) {
+				fprintf(stderr, "Failed to make queue\n");
+				return 1;
+			}
+			run.count = count / producers * producers;
+			run.producers = producers;
+			atomic_store(&run.popped, 0);
+
+			struct worker workers[8];
+			size_t started = 0;
+
+			double start = bench_now();
+			for (; started < producers + consumers; started++) {
+				workers[started].run = &run;
+				workers[started].index = started;
+				if (pthread_create(&workers[started].thread, NULL,
+					started < producers ? &produce : &consume,
+					workers + started)) break;
+			}
+			for (size_t k = 0; k < started; k++) {
+				pthread_join(workers[k].thread, NULL);
+			}
+			double seconds = bench_now() - start;
+
+			if (started != producers + consumers) {
+				fprintf(stderr, "Failed to start threads\n");
+				return 1;
+			}
+
+			char name[128];
+			snprintf(name, sizeof(name), "%s/%zup %zuc",
+				kinds[j].name, producers, consumers);
+			bench_report(stdout, name, run.count, seconds);
+			bench_report_latency(stdout, name, run.samples, run.count);
+
+			run.queue->del(run.queue);
+		}
+	}
+
+	free(run.pushed);
+	free(run.samples);
+	return 0;
+}
+
+static void * produce(void * argument)
+{
+	struct worker * worker = argument;
+	struct run * run = worker->run;
+	size_t share = run->count / run->producers;
+	size_t first = worker->index * share;
+
+	for (size_t i = first; i < first + share; i++) {
+		run->pushed[i] = bench_now();
+		// Items are indexes, offset so none is NULL.
+		while (run->queue->push(run->queue, (void *) (uintptr_t) (i + 1))) {
+			// Full, let a consumer run.
+			sched_yield();
+			run->pushed[i] = bench_now();
+		}
+	}
+
+	return NULL;
+}
+
+static void * consume(void * argument)
+{
+	struct worker * worker = argument;
+	struct run * run = worker->run;
+
+	while (atomic_load(&run->popped) < run->count) {
+		void * item = run->queue->pop(run->queue);
+		if (!item) {
+			sched_yield();
+			continue;
+		}
+
+		double now = bench_now();
+		size_t i = (uintptr_t) item - 1;
+		run->samples[i] = now - run->pushed[i];
+		atomic_fetch_add(&run->popped, 1);
+	}
+
+	return NULL;
+}
+
+static struct dt_queue * spsc_new(void)
+{
+	return dt_queue_spsc_new(CAPACITY);
+}
+
+static struct dt_queue * mpmc_new(void)
+{
+	return dt_queue_mpmc_new(CAPACITY);
+}
+
+static struct dt_queue * mutex_new(void)
+{
+	struct mutex_queue * locked = malloc(sizeof(*locked));
+	if (!locked) return NULL;
+
+	locked->list = dt_list_vector_new();
+	if (!locked->list) {
+		free(locked);
+		return NULL;
+	}
+	pthread_mutex_init(&locked->mutex, NULL);
+
+	struct dt_queue * queue = &locked->queue;
+	queue->push = &mutex_push;
+	queue->pop = &mutex_pop;
+	queue->length = &mutex_length;
+	queue->del = &mutex_del;
+	queue->_data = locked;
+
+	return queue;
+}
+
+static int mutex_push(struct dt_queue * this, void * item)
+{
+	struct mutex_queue * locked = this->_data;
+	int result = DT_QUEUE_EFULL;
+
+	pthread_mutex_lock(&locked->mutex);
+	size_t length = locked->list->length(locked->list);
+	if (length < CAPACITY) {
+		result = locked->list->insert(locked->list, length, item);
+	}
+	pthread_mutex_unlock(&locked->mutex);
+	return result;
+}
+
+static void * mutex_pop(struct dt_queue * this)
+{
+	struct mutex_queue * locked = this->_data;
+	void * item = NULL;
+
+	pthread_mutex_lock(&locked->mutex);
+	if (locked->list->length(locked->list)) {
+		item = locked->list->get(locked->list, 0);
+		locked->list->remove(locked->list, 0);
+	}
+	pthread_mutex_unlock(&locked->mutex);
+
+	return item;
+}
+
+static size_t mutex_length(const struct dt_queue * this)
+{
+	struct mutex_queue * locked = this->_data;
+	pthread_mutex_lock(&locked->mutex);
+	size_t length = locked->list->length(locked->list);
+	pthread_mutex_unlock(&locked->mutex);
+	return length;
+}
+
+static void mutex_del(struct dt_queue * this)
+{
+	struct mutex_queue * locked = this->_data;
+	locked->list->del(locked->list);
+	pthread_mutex_destroy(&locked->mutex);
+	free(locked);
+}
@@ -0,0 +1,500 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(__GLIBC__) && \
+	(__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define HEAP_STATS
+#endif
+
+#include "roaring.h"
+#include "set.h"
+#include "set/hash.h"
+#include "set/roaring.h"
+#include "set/tree.h"
+#include "list.h"
+
+#include "bench.h"
+
+#define DEFAULT_COUNT 500000
+
+static char * program_name = "roaring_bench";
+
+// Every kind behind the same calls so the workloads can
+// use the bitmap's own union and intersection.
+struct int_kind {
+	char * name;
+	void * (* new)(void);
+	int (* add)(void * set, uint32_t value);
+	bool (* has)(void * set, uint32_t value);
+	size_t (* intersection_cardinality)(void * a, void * b);
+	void * (* union_of)(void * a, void * b);
+	void (* del)(void * set);
+};
+
+struct int_workload {
+	char * name;
+	/** Runs the workload.
+	 *
+	 *  Arguments:
+	 *    kind: The kind of set to run against.
+	 *    count: The size of the workload.
+	 *    seconds: Where to put the time taken.
+	 *
+	 *  Returns:
+	 *    The number of operations timed. Zero if a set
+	 *    could not be made.
+	 */
+	size_t (* run)(const struct int_kind * kind, size_t count,
+		double * seconds);
+};
+
+// A dt_set of integers, either boxed in their own
+// allocation or cast straight to the item pointer.
+struct set_of_ints {
+	struct dt_set * set;
+	struct dt_set * (* new)(void);
+	bool boxed;
+};
+
+int main(int argc, char ** argv);
+
+/** Prints the usage to the given stream.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ */
+void usage(FILE * stream);
+
+/** Reads how much of the heap is in use.
+ *
+ *  Returns:
+ *    The bytes allocated. Zero if it cannot be told.
+ */
+static size_t heap_used(void);
+
+/** Fills a set with ids.
+ *
+ *  Arguments:
+ *    kind: The kind of set.
+ *    set: The set.
+ *    count: The number of ids to add.
+ *    seed: Picks which ids, about half of the first
+ *      count * 2.
+ *
+ *  Returns:
+ *    Zero on success. Non zero if an add failed.
+ */
+static int fill(const struct int_kind * kind, void * set, size_t count,
+	unsigned long seed);
+
+static int compare_boxed(void * a, void * b);
+static unsigned int hash_boxed(void * item);
+
+// Kinds.
+static void * roaring_new(void);
+static int roaring_add(void * set, uint32_t value);
+static bool roaring_has(void * set, uint32_t value);
+static size_t roaring_intersection_cardinality(void * a, void * b);
+static void * roaring_union(void * a, void * b);
+static void roaring_del(void * set);
+
+static void * roaring_set_new(void);
+static void * hash_set_new(void);
+static void * tree_set_new(void);
+static void * set_new(struct dt_set * (* new)(void), bool boxed);
+static int set_add(void * set, uint32_t value);
+static bool set_has(void * set, uint32_t value);
+static size_t set_intersection_cardinality(void * a, void * b);
+static void * set_union(void * a, void * b);
+static void set_del(void * set);
+
+static struct dt_set * hash_new(void);
+static struct dt_set * tree_new(void);
+
+// Workloads.
+static size_t insert(const struct int_kind * kind, size_t count,
+	double * seconds);
+static size_t lookup(const struct int_kind * kind, size_t count,
+	double * seconds);
+static size_t intersection(const struct int_kind * kind, size_t count,
+	double * seconds);
+static size_t union_(const struct int_kind * kind, size_t count,
+	double * seconds);
+
+static struct int_kind kinds[] = {
+	{"roaring", &roaring_new, &roaring_add, &roaring_has,
+		&roaring_intersection_cardinality, &roaring_union, &roaring_del},
+	{"roaring set", &roaring_set_new, &set_add, &set_has,
+		&set_intersection_cardinality, &set_union, &set_del},
+	{"hash set of boxed ints", &hash_set_new, &set_add, &set_has,
+		&set_intersection_cardinality, &set_union, &set_del},
+	{"tree set of boxed ints", &tree_set_new, &set_add, &set_has,
+		&set_intersection_cardinality, &set_union, &set_del}
+};
+
+static struct int_workload workloads[] = {
+	{"insert", &insert},
+	{"lookup", &lookup},
+	{"intersection count", &intersection},
+	{"union", &union_}
+};
+
+void usage(FILE * stream)
+{
+	fprintf(stream, "usage: %s [count [workload [set]]]\n", program_name);
+	fprintf(stream, "\tcount: the ids in each set (default %d)\n",
+		DEFAULT_COUNT);
+	fprintf(stream, "\tworkload: only run the named workload\n");
+	fprintf(stream, "\tset: only run against the named set\n");
+}
+
+int main(int argc, char ** argv)
+{
+	size_t count = DEFAULT_COUNT;
+	char * only = NULL;
+	char * only_kind = NULL;
+
+	if (argc) {
+		program_name = argv[0];
+	}
+
+	if (argc > 4 || (argc >= 2 && bench_parse_count(argv[1], &count)) ||
+		count > UINT32_MAX / 2) {
+		usage(stderr);
+		return 1;
+	}
+
+	if (argc >= 3) {
+		only = argv[2];
+	}
+
+	if (argc == 4) {
+		only_kind = argv[3];
+	}
+
+	for (size_t i = 0; i < sizeof(workloads) / sizeof(*workloads); i++) {
+		if (only && strcmp(only, workloads[i].name) != 0) continue;
+
+		for (size_t j = 0; j < sizeof(kinds) / sizeof(*kinds); j++) {
+			if (only_kind && strcmp(only_kind, kinds[j].name) != 0) continue;
+
+			double seconds = 0;
+			size_t operations = workloads[i].run(kinds + j, count, &seconds);
+			if (!operations) {
+				fprintf(stderr, "Failed to make set\n");
+				return 1;
+			}
+
+			char name[128];
+			snprintf(name, sizeof(name), "%s/%s",
+				workloads[i].name, kinds[j].name);
+			bench_report(stdout, name, operations, seconds);
+		}
+	}
+
+	return 0;
+}
+
+static size_t heap_used(void)
+{
+#ifdef HEAP_STATS
+	struct mallinfo2 info = mallinfo2();
+	return info.uordblks + info.hblkhd;
+#else
+	return 0;
+#endif
+}
+
+static int fill(const struct int_kind * kind, void * set, size_t count,
+	unsigned long seed)
+{
+	unsigned long state = seed;
+	for (size_t i = 0; i < count; i++) {
+		if (kind->add(set, bench_random(&state) % (count * 2))) return 1;
+	}
+	return 0;
+}
+
+static int compare_boxed(void * a, void * b)
+{
+	uint32_t x = *(uint32_t *) a;
+	uint32_t y = *(uint32_t *) b;
+	return
+		x == y ? 0 :
+		x < y ? -1 : 1;
+}
+
+static unsigned int hash_boxed(void * item)
+{
+	return *(uint32_t *) item;
+}
+
+static void * roaring_new(void)
+{
+	return dt_roaring_new();
+}
+
+static int roaring_add(void * set, uint32_t value)
+{
+	return dt_roaring_add(set, value);
+}
+
+static bool roaring_has(void * set, uint32_t value)
+{
+	return dt_roaring_has(set, value);
+}
+
+static size_t roaring_intersection_cardinality(void * a, void * b)
+{
+	return dt_roaring_intersection_cardinality(a, b);
+}
+
+static void * roaring_union(void * a, void * b)
+{
+	return dt_roaring_union(a, b);
+}
+
+static void roaring_del(void * set)
+{
+	dt_roaring_del(set);
+}
+
+static void * roaring_set_new(void)
+{
+	return set_new(&dt_set_roaring_new, false);
+}
+
+static void * hash_set_new(void)
+{
+	return set_new(&hash_new, true);
+}
+
+static void * tree_set_new(void)
+{
+	return set_new(&tree_new, true);
+}
+
+static void * set_new(struct dt_set * (* new)(void), bool boxed)
+{
+	struct set_of_ints * ints = malloc(sizeof(*ints));
+	if (!ints) return NULL;
+
+	ints->set = new();
+	if (!ints->set) {
+		free(ints);
+		return NULL;
+	}
+	ints->new = new;
+	ints->boxed = boxed;
+	return ints;
+}
+
+static int set_add(void * set, uint32_t value)
+{
+	struct set_of_ints * ints = set;
+	if (!ints->boxed) {
+		return ints->set->insert(ints->set, (void *) (uintptr_t) value);
+	}
+
+	if (ints->set->has(ints->set, &value)) return 0;
+
+	uint32_t * box = malloc(sizeof(*box));
+	if (!box) return -1;
+
+	*box = value;
+	if (ints->set->insert(ints->set, box)) {
+		free(box);
+		return -1;
+	}
+	return 0;
+}
+
+static bool set_has(void * set, uint32_t value)
+{
+	struct set_of_ints * ints = set;
+	if (!ints->boxed) {
+		return ints->set->has(ints->set, (void *) (uintptr_t) value);
+	}
+	return ints->set->has(ints->set, &value);
+}
+
+static size_t set_intersection_cardinality(void * a, void * b)
+{
+	// Through the set interface: list one, look each up
+	// in the other.
+	struct set_of_ints * ints = a;
+	struct set_of_ints * other = b;
+	struct dt_list * items = ints->set->items(ints->set);
+	if (!items) return 0;
+
+	size_t cardinality = 0;
+	struct dt_list_iterator storage;
+	struct dt_list_iterator * iterator;
+	iterator = items->iterator_init(items, &storage);
+	for (; iterator->valid(iterator); iterator->next(iterator)) {
+		if (other->set->has(other->set, iterator->get(iterator))) cardinality++;
+	}
+
+	iterator->del(iterator);
+	items->del(items);
+	return cardinality;
+}
+
+static void * set_union(void * a, void * b)
+{
+	struct set_of_ints * ints = a;
+	struct set_of_ints * out = set_new(ints->new, ints->boxed);
+	if (!out) return NULL;
+
+	struct set_of_ints * sources[] = {a, b};
+	for (size_t i = 0; i < 2; i++) {
+		struct dt_list * items = sources[i]->set->items(sources[i]->set);
+		if (!items) {
+			set_del(out);
+			return NULL;
+		}
+
+		struct dt_list_iterator storage;
+		struct dt_list_iterator * iterator;
+		iterator = items->iterator_init(items, &storage);
+		for (; iterator->valid(iterator); iterator->next(iterator)) {
+			void * item = iterator->get(iterator);
+			uint32_t value = out->boxed ?
+				*(uint32_t *) item : (uintptr_t) item;
+			set_add(out, value);
+		}
+
+		iterator->del(iterator);
+		items->del(items);
+	}
+
+	return out;
+}
+
+static void set_del(void * set)
+{
+	struct set_of_ints * ints = set;
+
+	if (ints->boxed) {
+		struct dt_list * items = ints->set->items(ints->set);
+		if (items) {
+			for (size_t i = 0; i < items->length(items); i++) {
+				free(items->get(items, i));
+			}
+			items->del(items);
+		}
+	}
+
+	ints->set->del(ints->set);
+	free(ints);
+}
+
+static struct dt_set * hash_new(void)
+{
+	return dt_set_hash_new(&compare_boxed, &hash_boxed);
+}
+
+static struct dt_set * tree_new(void)
+{
+	return dt_set_tree_new(&compare_boxed, &hash_boxed);
+}
+
+static size_t insert(const struct int_kind * kind, size_t count,
+	double * seconds)
+{
+	size_t before = heap_used();
+	void * set = kind->new();
+	if (!set) return 0;
+
+	double start = bench_now();
+	int failed = fill(kind, set, count, 88172645463325252ul);
+	*seconds = bench_now() - start;
+
+	size_t after = heap_used();
+	if (!failed && after) {
+		char name[128];
+		snprintf(name, sizeof(name), "memory/%s", kind->name);
+		printf("%-40s %9.2f bytes/insert\n", name,
+			(double) (after - before) / count);
+	}
+
+	kind->del(set);
+	return failed ? 0 : count;
+}
+
+static size_t lookup(const struct int_kind * kind, size_t count,
+	double * seconds)
+{
+	void * set = kind->new();
+	if (!set) return 0;
+	if (fill(kind, set, count, 88172645463325252ul)) {
+		kind->del(set);
+		return 0;
+	}
+
+	// Ids from the same range, about half of them there.
+	unsigned long state = 2463534242ul;
+	size_t found = 0;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		if (kind->has(set, bench_random(&state) % (count * 2))) found++;
+	}
+	*seconds = bench_now() - start;
+
+	if (!found) printf("%zu\n", found);
+	kind->del(set);
+	return count;
+}
+
+static size_t intersection(const struct int_kind * kind, size_t count,
+	double * seconds)
+{
+	void * a = kind->new();
+	void * b = kind->new();
+	if (!a || !b || fill(kind, a, count, 88172645463325252ul) ||
+		fill(kind, b, count, 2463534242ul)) {
+		if (a) kind->del(a);
+		if (b) kind->del(b);
+		return 0;
+	}
+
+	double start = bench_now();
+	size_t cardinality = kind->intersection_cardinality(a, b);
+	*seconds = bench_now() - start;
+
+	if (!cardinality) printf("%zu\n", cardinality);
+	kind->del(a);
+	kind->del(b);
+
+	// Counted as the inputs gone through.
+	return count * 2;
+}
+
+static size_t union_(const struct int_kind * kind, size_t count,
+	double * seconds)
+{
+	void * a = kind->new();
+	void * b = kind->new();
+	if (!a || !b || fill(kind, a, count, 88172645463325252ul) ||
+		fill(kind, b, count, 2463534242ul)) {
+		if (a) kind->del(a);
+		if (b) kind->del(b);
+		return 0;
+	}
+
+	double start = bench_now();
+	void * both = kind->union_of(a, b);
+	*seconds = bench_now() - start;
+
+	kind->del(a);
+	kind->del(b);
+	if (!both) return 0;
+
+	kind->del(both);
+	return count * 2;
+}
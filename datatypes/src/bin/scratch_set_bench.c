@@ -0,0 +1,180 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "set.h"
+#include "set/hash.h"
+#include "set/sparse.h"
+
+#include "bench.h"
+
+#define DEFAULT_COUNT 100000
+#define DEFAULT_IDS 64
+// The ids are below this.
+#define UNIVERSE (1 << 20)
+
+static char * program_name = "scratch_set_bench";
+
+struct scratch_kind {
+	char * name;
+	/** Runs the requests.
+	 *
+	 *  Arguments:
+	 *    count: The number of requests.
+	 *    ids: The ids each request adds and looks up.
+	 *    seconds: Where to put the time taken.
+	 *
+	 *  Returns:
+	 *    The number of lookups that hit. Or (size_t) -1
+	 *    if a set could not be made.
+	 */
+	size_t (* run)(size_t count, size_t ids, double * seconds);
+};
+
+int main(int argc, char ** argv);
+
+/** Prints the usage to the given stream.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ */
+void usage(FILE * stream);
+
+/** Does the work of one request against a scratch set.
+ *
+ *  Arguments:
+ *    set: An empty set.
+ *    ids: The ids to add and look up.
+ *    state: The random state.
+ *
+ *  Returns:
+ *    The number of lookups that hit.
+ */
+static size_t request(struct dt_set * set, size_t ids, unsigned long * state);
+
+static int compare_ids(void * a, void * b);
+static unsigned int hash_id(void * item);
+
+// Kinds.
+static size_t sparse_cleared(size_t count, size_t ids, double * seconds);
+static size_t hash_per_request(size_t count, size_t ids, double * seconds);
+
+static struct scratch_kind kinds[] = {
+	{"sparse set cleared", &sparse_cleared},
+	{"hash set per request", &hash_per_request}
+};
+
+void usage(FILE * stream)
+{
+	fprintf(stream, "usage: %s [count [ids [set]]]\n", program_name);
+	fprintf(stream, "\tcount: the number of requests (default %d)\n",
+		DEFAULT_COUNT);
+	fprintf(stream, "\tids: the ids each request adds (default %d)\n",
+		DEFAULT_IDS);
+	fprintf(stream, "\tset: only run against the named set\n");
+}
+
+int main(int argc, char ** argv)
+{
+	size_t count = DEFAULT_COUNT;
+	size_t ids = DEFAULT_IDS;
+	char * only_kind = NULL;
+
+	if (argc) {
+		program_name = argv[0];
+	}
+
+	if (argc > 4 || (argc >= 2 && bench_parse_count(argv[1], &count)) ||
+		(argc >= 3 && bench_parse_count(argv[2], &ids))) {
+		usage(stderr);
+		return 1;
+	}
+
+	if (argc == 4) {
+		only_kind = argv[3];
+	}
+
+	for (size_t j = 0; j < sizeof(kinds) / sizeof(*kinds); j++) {
+		if (only_kind && strcmp(only_kind, kinds[j].name) != 0) continue;
+
+		double seconds = 0;
+		size_t hits = kinds[j].run(count, ids, &seconds);
+		if (hits == (size_t) -1) {
+			fprintf(stderr, "Failed to make set\n");
+			return 1;
+		}
+
+		char name[128];
+		snprintf(name, sizeof(name), "%zu ids/%s", ids, kinds[j].name);
+		bench_report(stdout, name, count, seconds);
+	}
+
+	return 0;
+}
+
+static size_t request(struct dt_set * set, size_t ids, unsigned long * state)
+{
+	// Ids offset by one, so none is NULL.
+	for (size_t i = 0; i < ids; i++) {
+		set->insert(set, (void *) (uintptr_t) (bench_random(state) %
+			(UNIVERSE - 1) + 1));
+	}
+
+	size_t hits = 0;
+	for (size_t i = 0; i < ids; i++) {
+		if (set->has(set, (void *) (uintptr_t) (bench_random(state) %
+			(UNIVERSE - 1) + 1))) hits++;
+	}
+	return hits;
+}
+
+static int compare_ids(void * a, void * b)
+{
+	uintptr_t x = (uintptr_t) a;
+	uintptr_t y = (uintptr_t) b;
+	return
+		x == y ? 0 :
+		x < y ? -1 : 1;
+}
+
+static unsigned int hash_id(void * item)
+{
+	return (uintptr_t) item;
+}
+
+static size_t sparse_cleared(size_t count, size_t ids, double * seconds)
+{
+	unsigned long state = 88172645463325252ul;
+	size_t hits = 0;
+
+	double start = bench_now();
+	struct dt_set * set = dt_set_sparse_new(UNIVERSE);
+	if (!set) return (size_t) -1;
+
+	for (size_t i = 0; i < count; i++) {
+		hits += request(set, ids, &state);
+		dt_set_sparse_clear(set);
+	}
+
+	set->del(set);
+	*seconds = bench_now() - start;
+	return hits;
+}
+
+static size_t hash_per_request(size_t count, size_t ids, double * seconds)
+{
+	unsigned long state = 88172645463325252ul;
+	size_t hits = 0;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		struct dt_set * set = dt_set_hash_new(&compare_ids, &hash_id);
+		if (!set) return (size_t) -1;
+
+		hits += request(set, ids, &state);
+		set->del(set);
+	}
+	*seconds = bench_now() - start;
+	return hits;
+}
@@ -0,0 +1,310 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "stack.h"
+#include "stack/vector.h"
+#include "stack/linked.h"
+#include "stack/lockfree.h"
+#include "stack/segmented.h"
+#include "stack/bounded.h"
+#include "pool.h"
+
+#include "bench.h"
+
+#define DEFAULT_COUNT 1000000
+
+static char * program_name = "stack_bench";
+static char items[256];
+
+// Shared by the pooled stacks so its slabs can be counted.
+static struct dt_pool * shared_pool = NULL;
+
+// Filled by workloads that time each operation.
+static double * samples = NULL;
+static size_t sample_count = 0;
+
+struct stack_kind {
+	char * name;
+	struct dt_stack * (* new)(void);
+};
+
+struct stack_workload {
+	char * name;
+	/** Runs the workload.
+	 *
+	 *  Arguments:
+	 *    stack: An empty stack to run against.
+	 *    count: The size of the workload.
+	 *    seconds: Where to put the time taken.
+	 *
+	 *  Returns:
+	 *    The number of operations timed.
+	 */
+	size_t (* run)(struct dt_stack * stack, size_t count, double * seconds);
+};
+
+int main(int argc, char ** argv);
+
+/** Prints the usage to the given stream.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ */
+void usage(FILE * stream);
+
+// Kinds.
+static struct dt_stack * linked_pooled_new(void);
+static struct dt_stack * linked_shared_new(void);
+static struct dt_stack * bounded_new(void);
+
+// Workloads.
+static size_t churn(struct dt_stack * stack, size_t count,
+	double * seconds);
+static size_t fill_drain(struct dt_stack * stack, size_t count,
+	double * seconds);
+static size_t burst(struct dt_stack * stack, size_t count,
+	double * seconds);
+static size_t burst_many(struct dt_stack * stack, size_t count,
+	double * seconds);
+static size_t push_latency(struct dt_stack * stack, size_t count,
+	double * seconds);
+static size_t pop_latency(struct dt_stack * stack, size_t count,
+	double * seconds);
+
+static struct stack_kind kinds[] = {
+	{"vector", &dt_stack_vector_new},
+	{"linked", &dt_stack_linked_new},
+	{"segmented", &dt_stack_segmented_new},
+	{"bounded", &bounded_new},
+	{"linked pooled", &linked_pooled_new},
+	{"linked shared pool", &linked_shared_new},
+	{"lockfree", &dt_stack_lockfree_new}
+};
+
+static struct stack_workload workloads[] = {
+	{"churn", &churn},
+	{"fill drain", &fill_drain},
+	{"burst", &burst},
+	{"burst many", &burst_many},
+	{"push latency", &push_latency},
+	{"pop latency", &pop_latency}
+};
+
+void usage(FILE * stream)
+{
+	fprintf(stream, "usage: %s [count [workload [stack]]]\n", program_name);
+	fprintf(stream, "\tcount: the size of each workload (default %d)\n",
+		DEFAULT_COUNT);
+	fprintf(stream, "\tworkload: only run the named workload\n");
+	fprintf(stream, "\tstack: only run against the named stack\n");
+}
+
+int main(int argc, char ** argv)
+{
+	size_t count = DEFAULT_COUNT;
+	char * only = NULL;
+	char * only_kind = NULL;
+
+	if (argc) {
+		program_name = argv[0];
+	}
+
+	if (argc > 4 || (argc >= 2 && bench_parse_count(argv[1], &count))) {
+		usage(stderr);
+		return 1;
+	}
+
+	if (argc >= 3) {
+		only = argv[2];
+	}
+
+	if (argc == 4) {
+		only_kind = argv[3];
+	}
+
+	for (size_t i = 0; i < sizeof(workloads) / sizeof(*workloads); i++) {
+		if (only && strcmp(only, workloads[i].name) != 0) continue;
+
+		for (size_t j = 0; j < sizeof(kinds) / sizeof(*kinds); j++) {
+			if (only_kind && strcmp(only_kind, kinds[j].name) != 0) continue;
+
+			shared_pool = dt_pool_new(dt_stack_linked_node_size(), 0);
+			if (!shared_pool) {
+				fprintf(stderr, "Failed to make pool\n");
+				return 1;
+			}
+
+			struct dt_stack * stack = kinds[j].new();
+			if (!stack) {
+				fprintf(stderr, "Failed to make stack\n");
+				return 1;
+			}
+
+			double seconds = 0;
+			size_t operations = workloads[i].run(stack, count, &seconds);
+
+			char name[128];
+			snprintf(name, sizeof(name), "%s/%s",
+				workloads[i].name, kinds[j].name);
+			bench_report(stdout, name, operations, seconds);
+
+			if (sample_count) {
+				bench_report_latency(stdout, name, samples, sample_count);
+				free(samples);
+				samples = NULL;
+				sample_count = 0;
+			}
+
+			if (dt_pool_slab_count(shared_pool)) {
+				printf("%-40s %10zu slabs\n", name,
+					dt_pool_slab_count(shared_pool));
+			}
+
+			stack->del(stack);
+			dt_pool_del(shared_pool);
+		}
+	}
+
+	return 0;
+}
+
+static struct dt_stack * linked_pooled_new(void)
+{
+	return dt_stack_linked_pooled_new(NULL);
+}
+
+static struct dt_stack * linked_shared_new(void)
+{
+	return dt_stack_linked_pooled_new(shared_pool);
+}
+
+static struct dt_stack * bounded_new(void)
+{
+	// Big enough for the default workloads. Larger
+	// ones lose their oldest items.
+	return dt_stack_bounded_new(DEFAULT_COUNT, DT_STACK_BOUNDED_OVERWRITE);
+}
+
+static size_t churn(struct dt_stack * stack, size_t count,
+	double * seconds)
+{
+	// Hover around a small depth, pushing and popping in
+	// random bursts like a parser or an interpreter would.
+	unsigned long state = 88172645463325252ul;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count; i++) {
+		unsigned long r = bench_random(&state);
+		if (r & 1 || stack->length(stack) < 8) {
+			stack->push(stack, items + r % sizeof(items));
+		} else {
+			stack->pop(stack);
+		}
+		if (stack->length(stack) > 64) stack->pop(stack);
+	}
+	*seconds = bench_now() - start;
+	return count;
+}
+
+static size_t fill_drain(struct dt_stack * stack, size_t count,
+	double * seconds)
+{
+	// Fill up and drain completely a few times.
+	size_t depth = count / 4;
+
+	double start = bench_now();
+	for (size_t round = 0; round < 4; round++) {
+		for (size_t i = 0; i < depth; i++) {
+			stack->push(stack, items + i % sizeof(items));
+		}
+		for (size_t i = 0; i < depth; i++) {
+			stack->pop(stack);
+		}
+	}
+	*seconds = bench_now() - start;
+	return depth * 8;
+}
+
+static size_t burst(struct dt_stack * stack, size_t count,
+	double * seconds)
+{
+	// A depth first search pushing every child of a node
+	// then draining bursts, an item at a time.
+	void * batch[32];
+	for (size_t i = 0; i < 32; i++) batch[i] = items + i;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count / 32; i++) {
+		for (size_t j = 0; j < 32; j++) {
+			stack->push(stack, batch[j]);
+		}
+		for (size_t j = 0; j < 32; j++) {
+			batch[j] = stack->pop(stack);
+		}
+	}
+	*seconds = bench_now() - start;
+	return count / 32 * 64;
+}
+
+static size_t burst_many(struct dt_stack * stack, size_t count,
+	double * seconds)
+{
+	// The same as burst with a call per burst.
+	void * batch[32];
+	for (size_t i = 0; i < 32; i++) batch[i] = items + i;
+
+	double start = bench_now();
+	for (size_t i = 0; i < count / 32; i++) {
+		stack->push_many(stack, batch, 32);
+		stack->pop_many(stack, batch, 32);
+	}
+	*seconds = bench_now() - start;
+	return count / 32 * 64;
+}
+
+static size_t push_latency(struct dt_stack * stack, size_t count,
+	double * seconds)
+{
+	// Grow one deep stack timing every push, so a rare
+	// slow push that copies everything shows in the tail.
+	samples = malloc(sizeof(*samples) * count);
+	if (!samples) return 0;
+
+	double start = bench_now();
+	double last = start;
+	for (size_t i = 0; i < count; i++) {
+		stack->push(stack, items + i % sizeof(items));
+
+		double now = bench_now();
+		samples[i] = now - last;
+		last = now;
+	}
+	*seconds = last - start;
+	sample_count = count;
+	return count;
+}
+
+static size_t pop_latency(struct dt_stack * stack, size_t count,
+	double * seconds)
+{
+	for (size_t i = 0; i < count; i++) {
+		if (stack->push(stack, items + i % sizeof(items))) return 0;
+	}
+
+	samples = malloc(sizeof(*samples) * count);
+	if (!samples) return 0;
+
+	double start = bench_now();
+	double last = start;
+	for (size_t i = 0; i < count; i++) {
+		stack->pop(stack);
+
+		double now = bench_now();
+		samples[i] = now - last;
+		last = now;
+	}
+	*seconds = last - start;
+	sample_count = count;
+	return count;
+}
@@ -0,0 +1,277 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "stack.h"
+#include "stack/linked.h"
+#include "stack/lockfree.h"
+
+#include "bench.h"
+
+#define DEFAULT_COUNT 1000000
+#define DEFAULT_THREADS 8
+
+static char * program_name = "stack_threads_bench";
+static char items[256];
+
+struct stack_kind {
+	char * name;
+	struct dt_stack * (* new)(void);
+};
+
+// A linked stack behind one mutex, the usual way to share
+// a stack that is not thread safe.
+struct mutex_stack {
+	struct dt_stack stack;
+	struct dt_stack * inner;
+	pthread_mutex_t mutex;
+};
+
+struct worker {
+	pthread_t thread;
+	struct dt_stack * stack;
+	size_t count;
+	unsigned long state;
+};
+
+int main(int argc, char ** argv);
+
+/** Prints the usage to the given stream.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ */
+void usage(FILE * stream);
+
+/** Runs one thread of the workload.
+ *
+ *  Arguments:
+ *    argument: The worker to run.
+ *
+ *  Returns:
+ *    NULL.
+ */
+static void * work(void * argument);
+
+/** Runs the workload on a number of threads.
+ *
+ *  Arguments:
+ *    stack: An empty stack to run against.
+ *    count: The number of push and pop pairs in total.
+ *    threads: The number of threads to split them over.
+ *    seconds: Where to put the time taken.
+ *
+ *  Returns:
+ *    The number of operations timed. Zero if the
+ *    threads could not be started.
+ */
+static size_t run(struct dt_stack * stack, size_t count, size_t threads,
+	double * seconds);
+
+// Kinds.
+static struct dt_stack * mutex_new(void);
+static int mutex_push(struct dt_stack * this, void * item);
+static void * mutex_pop(struct dt_stack * this);
+static int mutex_push_many(struct dt_stack * this, void * const * items,
+	size_t count);
+static size_t mutex_pop_many(struct dt_stack * this, void ** out,
+	size_t count);
+static void * mutex_peek(const struct dt_stack * this);
+static size_t mutex_length(const struct dt_stack * this);
+static void mutex_del(struct dt_stack * this);
+
+static struct stack_kind kinds[] = {
+	{"mutex linked", &mutex_new},
+	{"lockfree", &dt_stack_lockfree_new}
+};
+
+void usage(FILE * stream)
+{
+	fprintf(stream, "usage: %s [count [threads [stack]]]\n", program_name);
+	fprintf(stream, "\tcount: the push and pop pairs in each run (default %d)\n",
+		DEFAULT_COUNT);
+	fprintf(stream, "\tthreads: the most threads to run, doubling from one"
+		" (default %d)\n", DEFAULT_THREADS);
+	fprintf(stream, "\tstack: only run against the named stack\n");
+}
+
+int main(int argc, char ** argv)
+{
+	size_t count = DEFAULT_COUNT;
+	size_t most_threads = DEFAULT_THREADS;
+	char * only_kind = NULL;
+
+	if (argc) {
+		program_name = argv[0];
+	}
+
+	if (argc > 4 || (argc >= 2 && bench_parse_count(argv[1], &count)) ||
+		(argc >= 3 && bench_parse_count(argv[2], &most_threads))) {
+		usage(stderr);
+		return 1;
+	}
+
+	if (argc == 4) {
+		only_kind = argv[3];
+	}
+
+	for (size_t j = 0; j < sizeof(kinds) / sizeof(*kinds); j++) {
+		if (only_kind && strcmp(only_kind, kinds[j].name) != 0) continue;
+
+		for (size_t threads = 1; threads <= most_threads; threads *= 2) {
+			struct dt_stack * stack = kinds[j].new();
+			if (!stack) {
+				fprintf(stderr, "Failed to make stack\n");
+				return 1;
+			}
+
+			double seconds = 0;
+			size_t operations = run(stack, count, threads, &seconds);
+			if (!operations) {
+				fprintf(stderr, "Failed to start threads\n");
+				return 1;
+			}
+
+			char name[128];
+			snprintf(name, sizeof(name), "%s/%zu threads",
+				kinds[j].name, threads);
+			bench_report(stdout, name, operations, seconds);
+
+			stack->del(stack);
+		}
+	}
+
+	return 0;
+}
+
+static void * work(void * argument)
+{
+	// A shared free list: take a few objects, put a few
+	// back, staying close to empty.
+	struct worker * worker = argument;
+	struct dt_stack * stack = worker->stack;
+
+	for (size_t i = 0; i < worker->count; i++) {
+		unsigned long r = bench_random(&worker->state);
+		stack->push(stack, items + r % sizeof(items));
+		stack->pop(stack);
+	}
+
+	return NULL;
+}
+
+static size_t run(struct dt_stack * stack, size_t count, size_t threads,
+	double * seconds)
+{
+	struct worker * workers = malloc(sizeof(*workers) * threads);
+	if (!workers) return 0;
+
+	size_t started = 0;
+
+	double start = bench_now();
+	for (; started < threads; started++) {
+		workers[started].stack = stack;
+		workers[started].count = count / threads;
+		workers[started].state = 88172645463325252ul + started;
+		if (pthread_create(&workers[started].thread, NULL, &work,
+			workers + started)) break;
+	}
+	for (size_t i = 0; i < started; i++) {
+		pthread_join(workers[i].thread, NULL);
+	}
+	*seconds = bench_now() - start;
+
+	free(workers);
+	if (started != threads) return 0;
+	return count / threads * threads * 2;
+}
+
+static struct dt_stack * mutex_new(void)
+{
+	struct mutex_stack * locked = malloc(sizeof(*locked));
+	if (!locked) return NULL;
+
+	locked->inner = dt_stack_linked_new();
+	if (!locked->inner) {
+		free(locked);
+		return NULL;
+	}
+	pthread_mutex_init(&locked->mutex, NULL);
+
+	struct dt_stack * stack = &locked->stack;
+	stack->push = &mutex_push;
+	stack->pop = &mutex_pop;
+	stack->push_many = &mutex_push_many;
+	stack->pop_many = &mutex_pop_many;
+	stack->peek = &mutex_peek;
+	stack->length = &mutex_length;
+	stack->del = &mutex_del;
+	stack->_data = locked;
+
+	return stack;
+}
+
+static int mutex_push(struct dt_stack * this, void * item)
+{
+	struct mutex_stack * locked = this->_data;
+	pthread_mutex_lock(&locked->mutex);
+	int result = locked->inner->push(locked->inner, item);
+	pthread_mutex_unlock(&locked->mutex);
+	return result;
+}
+
+static void * mutex_pop(struct dt_stack * this)
+{
+	struct mutex_stack * locked = this->_data;
+	pthread_mutex_lock(&locked->mutex);
+	void * item = locked->inner->pop(locked->inner);
+	pthread_mutex_unlock(&locked->mutex);
+	return item;
+}
+
+static int mutex_push_many(struct dt_stack * this, void * const * items,
+	size_t count)
+{
+	struct mutex_stack * locked = this->_data;
+	pthread_mutex_lock(&locked->mutex);
+	int result = locked->inner->push_many(locked->inner, items, count);
+	pthread_mutex_unlock(&locked->mutex);
+	return result;
+}
+
+static size_t mutex_pop_many(struct dt_stack * this, void ** out,
+	size_t count)
+{
+	struct mutex_stack * locked = this->_data;
+	pthread_mutex_lock(&locked->mutex);
+	size_t popped = locked->inner->pop_many(locked->inner, out, count);
+	pthread_mutex_unlock(&locked->mutex);
+	return popped;
+}
+
+static void * mutex_peek(const struct dt_stack * this)
+{
+	struct mutex_stack * locked = this->_data;
+	pthread_mutex_lock(&locked->mutex);
+	void * item = locked->inner->peek(locked->inner);
+	pthread_mutex_unlock(&locked->mutex);
+	return item;
+}
+
+static size_t mutex_length(const struct dt_stack * this)
+{
+	struct mutex_stack * locked = this->_data;
+	pthread_mutex_lock(&locked->mutex);
+	size_t length = locked->inner->length(locked->inner);
+	pthread_mutex_unlock(&locked->mutex);
+	return length;
+}
+
+static void mutex_del(struct dt_stack * this)
+{
+	struct mutex_stack * locked = this->_data;
+	locked->inner->del(locked->inner);
+	pthread_mutex_destroy(&locked->mutex);
+	free(locked);
+}
@@ -0,0 +1,381 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "set.h"
+#include "set/hash.h"
+#include "set/radix.h"
+#include "set/tree.h"
+#include "list.h"
+
+#include "bench.h"
+
+#define DEFAULT_COUNT 200000
+#define PREFIX_QUERIES 20
+// Longest url the generator makes.
+#define URL_LENGTH 256
+
+static char * program_name = "string_set_bench";
+
+// The urls every workload runs on, and the same urls with
+// a fragment added that none of the first ones have.
+static char ** urls;
+static char ** misses;
+static size_t url_count;
+
+static const char * words[] = {
+	"blog", "docs", "api", "v1", "v2", "users", "items", "search",
+	"static", "images", "2023", "2024", "posts", "tags", "about", "help"
+};
+
+struct set_kind {
+	char * name;
+	struct dt_set * (* new)(void);
+	/** Counts the items that start with a prefix.
+	 *
+	 *  Arguments:
+	 *    set: The set.
+	 *    prefix: The prefix.
+	 *
+	 *  Returns:
+	 *    The number of items found.
+	 */
+	size_t (* prefixed)(struct dt_set * set, const char * prefix);
+};
+
+struct set_workload {
+	char * name;
+	/** Runs the workload.
+	 *
+	 *  Arguments:
+	 *    kind: The kind of set.
+	 *    set: An empty set to run against.
+	 *    seconds: Where to put the time taken.
+	 *
+	 *  Returns:
+	 *    The number of operations timed.
+	 */
+	size_t (* run)(const struct set_kind * kind, struct dt_set * set,
+		double * seconds);
+};
+
+int main(int argc, char ** argv);
+
+/** Prints the usage to the given stream.
+ *
+ *  Arguments:
+ *    stream: The stream to write to.
+ */
+void usage(FILE * stream);
+
+/** Makes up a url such as a crawler might see.
+ *
+ *  Arguments:
+ *    state: The random state.
+ *    hosts: The number of hosts to pick from.
+ *    url: Where to write the url, URL_LENGTH bytes.
+ */
+static void make_url(unsigned long * state, size_t hosts, char * url);
+
+/** Makes the url corpus.
+ *
+ *  Arguments:
+ *    count: The number of urls.
+ *
+ *  Returns:
+ *    Zero on success. Non zero if there is not enough memory.
+ */
+static int make_corpus(size_t count);
+static void free_corpus(void);
+
+static int compare_strings(void * a, void * b);
+static unsigned int hash_string(void * item);
+
+// Kinds.
+static struct dt_set * hash_new(void);
+static struct dt_set * tree_new(void);
+static size_t radix_prefixed(struct dt_set * set, const char * prefix);
+static size_t scan_prefixed(struct dt_set * set, const char * prefix);
+
+// Workloads.
+static size_t insert(const struct set_kind * kind, struct dt_set * set,
+	double * seconds);
+static size_t lookup_hit(const struct set_kind * kind, struct dt_set * set,
+	double * seconds);
+static size_t lookup_miss(const struct set_kind * kind, struct dt_set * set,
+	double * seconds);
+static size_t prefix(const struct set_kind * kind, struct dt_set * set,
+	double * seconds);
+
+static struct set_kind kinds[] = {
+	{"radix", &dt_set_radix_new, &radix_prefixed},
+	{"hash", &hash_new, &scan_prefixed},
+	{"tree", &tree_new, &scan_prefixed}
+};
+
+static struct set_workload workloads[] = {
+	{"insert", &insert},
+	{"lookup hit", &lookup_hit},
+	{"lookup miss", &lookup_miss},
+	{"prefix", &prefix}
+};
+
+void usage(FILE * stream)
+{
+	fprintf(stream, "usage: %s [count [workload [set]]]\n", program_name);
+	fprintf(stream, "\tcount: the number of urls (default %d)\n",
+		DEFAULT_COUNT);
+	fprintf(stream, "\tworkload: only run the named workload\n");
+	fprintf(stream, "\tset: only run against the named set\n");
+}
+
+int main(int argc, char ** argv)
+{
+	size_t count = DEFAULT_COUNT;
+	char * only = NULL;
+	char * only_kind = NULL;
+
+	if (argc) {
+		program_name = argv[0];
+	}
+
+	if (argc > 4 || (argc >= 2 && bench_parse_count(argv[1], &count))) {
+		usage(stderr);
+		return 1;
+	}
+
+	if (argc >= 3) {
+		only = argv[2];
+	}
+
+	if (argc == 4) {
+		only_kind = argv[3];
+	}
+
+	if (make_corpus(count)) {
+		fprintf(stderr, "Failed to make urls\n");
+		return 1;
+	}
+
+	for (size_t i = 0; i < sizeof(workloads) / sizeof(*workloads); i++) {
+		if (only && strcmp(only, workloads[i].name) != 0) continue;
+
+		for (size_t j = 0; j < sizeof(kinds) / sizeof(*kinds); j++) {
+			if (only_kind && strcmp(only_kind, kinds[j].name) != 0) continue;
+
+			struct dt_set * set = kinds[j].new();
+			if (!set) {
+				fprintf(stderr, "Failed to make set\n");
+				return 1;
+			}
+
+			double seconds = 0;
+			size_t operations = workloads[i].run(kinds + j, set, &seconds);
+
+			char name[128];
+			snprintf(name, sizeof(name), "%s/%s",
+				workloads[i].name, kinds[j].name);
+			bench_report(stdout, name, operations, seconds);
+
+			set->del(set);
+		}
+	}
+
+	free_corpus();
+	return 0;
+}
+
+static void make_url(unsigned long * state, size_t hosts, char * url)
+{
+	int length = snprintf(url, URL_LENGTH, "https://www.host%lu.example.com",
+		bench_random(state) % hosts);
+
+	size_t segments = 1 + bench_random(state) % 4;
+	for (size_t i = 0; i < segments; i++) {
+		length += snprintf(url + length, URL_LENGTH - length, "/%s",
+			words[bench_random(state) % (sizeof(words) / sizeof(*words))]);
+	}
+
+	snprintf(url + length, URL_LENGTH - length, "/page-%lu.html?id=%lu",
+		bench_random(state) % 1000, bench_random(state) % 100000);
+}
+
+static int make_corpus(size_t count)
+{
+	// About a thousand urls a host.
+	size_t hosts = count / 1000 + 1;
+	unsigned long state = 88172645463325252ul;
+	char url[URL_LENGTH + sizeof("#miss")];
+
+	urls = calloc(count, sizeof(*urls));
+	misses = calloc(count, sizeof(*misses));
+	url_count = count;
+	if (!urls || !misses) return 1;
+
+	for (size_t i = 0; i < count; i++) {
+		make_url(&state, hosts, url);
+		urls[i] = strdup(url);
+
+		strcat(url, "#miss");
+		misses[i] = strdup(url);
+
+		if (!urls[i] || !misses[i]) return 1;
+	}
+
+	return 0;
+}
+
+static void free_corpus(void)
+{
+	for (size_t i = 0; i < url_count; i++) {
+		free(urls[i]);
+		free(misses[i]);
+	}
+	free(urls);
+	free(misses);
+}
+
+static int compare_strings(void * a, void * b)
+{
+	int result = strcmp(a, b);
+	return
+		result == 0 ? 0 :
+		result < 0 ? -1 : 1;
+}
+
+static unsigned int hash_string(void * item)
+{
+	// FNV-1a
+	unsigned int hash = 2166136261u;
+	for (unsigned char * c = item; *c; c++) {
+		hash = (hash ^ *c) * 16777619u;
+	}
+	return hash;
+}
+
+static struct dt_set * hash_new(void)
+{
+	return dt_set_hash_new(&compare_strings, &hash_string);
+}
+
+static struct dt_set * tree_new(void)
+{
+	return dt_set_tree_new(&compare_strings, &hash_string);
+}
+
+static size_t radix_prefixed(struct dt_set * set, const char * prefix)
+{
+	struct dt_set_radix_cursor * cursor;
+	cursor = dt_set_radix_prefix_cursor(set, prefix);
+	if (!cursor) return 0;
+
+	size_t found = 0;
+	while (dt_set_radix_cursor_next(cursor)) found++;
+
+	dt_set_radix_cursor_del(cursor);
+	return found;
+}
+
+static size_t scan_prefixed(struct dt_set * set, const char * prefix)
+{
+	// Without a prefix search every item has to be looked at.
+	struct dt_list * items = set->items(set);
+	if (!items) return 0;
+
+	size_t length = strlen(prefix);
+	size_t found = 0;
+
+	struct dt_list_iterator storage;
+	struct dt_list_iterator * iterator;
+	iterator = items->iterator_init(items, &storage);
+	for (; iterator->valid(iterator); iterator->next(iterator)) {
+		if (strncmp(iterator->get(iterator), prefix, length) == 0) found++;
+	}
+
+	iterator->del(iterator);
+	items->del(items);
+	return found;
+}
+
+static size_t insert(const struct set_kind * kind, struct dt_set * set,
+	double * seconds)
+{
+	double start = bench_now();
+	for (size_t i = 0; i < url_count; i++) {
+		set->insert(set, urls[i]);
+	}
+	*seconds = bench_now() - start;
+	return url_count;
+}
+
+static size_t lookup_hit(const struct set_kind * kind, struct dt_set * set,
+	double * seconds)
+{
+	for (size_t i = 0; i < url_count; i++) {
+		set->insert(set, urls[i]);
+	}
+
+	size_t found = 0;
+
+	double start = bench_now();
+	for (size_t i = 0; i < url_count; i++) {
+		if (set->has(set, urls[i])) found++;
+	}
+	*seconds = bench_now() - start;
+
+	if (found != url_count) printf("%zu\n", found);
+	return url_count;
+}
+
+static size_t lookup_miss(const struct set_kind * kind, struct dt_set * set,
+	double * seconds)
+{
+	for (size_t i = 0; i < url_count; i++) {
+		set->insert(set, urls[i]);
+	}
+
+	// Each miss shares all but its last few bytes with a
+	// url in the set.
+	size_t found = 0;
+
+	double start = bench_now();
+	for (size_t i = 0; i < url_count; i++) {
+		if (set->has(set, misses[i])) found++;
+	}
+	*seconds = bench_now() - start;
+
+	if (found) printf("%zu\n", found);
+	return url_count;
+}
+
+static size_t prefix(const struct set_kind * kind, struct dt_set * set,
+	double * seconds)
+{
+	for (size_t i = 0; i < url_count; i++) {
+		set->insert(set, urls[i]);
+	}
+
+	// Everything under the first directory of a url, such
+	// as one section of one site.
+	unsigned long state = 88172645463325252ul;
+	char prefixes[PREFIX_QUERIES][URL_LENGTH];
+	for (size_t i = 0; i < PREFIX_QUERIES; i++) {
+		const char * url = urls[bench_random(&state) % url_count];
+		const char * end = strchr(url + sizeof("https://") - 1, '/');
+		end = strchr(end + 1, '/');
+
+		memcpy(prefixes[i], url, end - url + 1);
+		prefixes[i][end - url + 1] = '\0';
+	}
+
+	size_t found = 0;
+
+	double start = bench_now();
+	for (size_t i = 0; i < PREFIX_QUERIES; i++) {
+		found += kind->prefixed(set, prefixes[i]);
+	}
+	*seconds = bench_now() - start;
+
+	if (!found) printf("%zu\n", found);
+	return PREFIX_QUERIES;
+}
@@ -0,0 +1,71 @@
+#include "bench.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+
+/** Orders two timings for qsort.
+ */
+static int compare_samples(const void * a, const void * b);
+
+double bench_now(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+unsigned long bench_random(unsigned long * state)
+{
+	// xorshift64*
+	unsigned long long x = *state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*state = x;
+	return (unsigned long) ((x * 2685821657736338717ull) >> 16);
+}
+
+void bench_report(FILE * stream, const char * name,
+	size_t operations, double seconds)
+{
+	double rate = seconds > 0 ? operations / seconds : 0;
+	fprintf(stream, "%-40s %10zu ops %10.4f s %14.0f ops/s\n",
+		name, operations, seconds, rate);
+	fflush(stream);
+}
+
+void bench_report_latency(FILE * stream, const char * name,
+	double * samples, size_t count)
+{
+	if (!count) return;
+
+	qsort(samples, count, sizeof(*samples), &compare_samples);
+
+	// In nanoseconds, at the median, the tail and the worst.
+	fprintf(stream, "%-40s p50 %8.0f p99 %8.0f p99.9 %8.0f max %10.0f ns\n",
+		name,
+		samples[count / 2] * 1e9,
+		samples[count - 1 - (count - 1) / 100] * 1e9,
+		samples[count - 1 - (count - 1) / 1000] * 1e9,
+		samples[count - 1] * 1e9);
+	fflush(stream);
+}
+
+static int compare_samples(const void * a, const void * b)
+{
+	double left = *(const double *) a;
+	double right = *(const double *) b;
+	return (left > right) - (left < right);
+}
+
+int bench_parse_count(const char * text, size_t * count)
+{
+	char * endptr;
+	errno = 0;
+	long long value = strtoll(text, &endptr, 0);
+	if (*text == '\0' || *endptr != '\0') return -1;
+	if (errno == ERANGE || value <= 0) return -1;
+	*count = value;
+	return 0;
+}
@@ -0,0 +1,27 @@
+#include "allocator.h"
+
+#include <stdlib.h>
+
+void * dt_allocator_alloc(const struct dt_allocator * allocator,
+	size_t size)
+{
+	if (!allocator) return malloc(size);
+	return allocator->alloc(allocator->ctx, size);
+}
+
+void * dt_allocator_realloc(const struct dt_allocator * allocator,
+	void * pointer, size_t old_size, size_t new_size)
+{
+	if (!allocator) return realloc(pointer, new_size);
+	return allocator->realloc(allocator->ctx, pointer, old_size, new_size);
+}
+
+void dt_allocator_free(const struct dt_allocator * allocator,
+	void * pointer, size_t size)
+{
+	if (!allocator) {
+		free(pointer);
+		return;
+	}
+	allocator->free(allocator->ctx, pointer, size);
+}
@@ -0,0 +1,13 @@
+#include "hashing.h"
+
+// a must stay below 2^32 so a * hash + b fits in
+// 64 bits.
+static unsigned long long const universal_hash_a = 1188764207ull;
+static unsigned long long const universal_hash_b = 3227431836ull;
+static unsigned long long const universal_hash_prime = 4294967311ull;
+
+unsigned int dt_hash_universal(unsigned int hash)
+{
+	return (universal_hash_a * hash + universal_hash_b) %
+		universal_hash_prime;
+}
@@ -0,0 +1,415 @@
+#include "list/deque.h"
+
+#include "list/error.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "buffers.h"
+
+// The buffer never shrinks below this many items.
+// It must be a power of two.
+#define MINIMUM_LENGTH 8
+
+struct list_implementation;
+struct deque_list;
+
+// The items wrap around the end of the buffer starting at head.
+// The buffer length is always a power of two so wrapping is a mask.
+struct list_implementation {
+	void ** buffer;
+	size_t buffer_size;
+	size_t head;
+	size_t length;
+};
+
+// The list and its implementation share one allocation.
+struct deque_list {
+	struct dt_list list;
+	struct list_implementation implementation;
+};
+
+// List functions
+static void * list_get(const struct dt_list * this, size_t index);
+static int list_insert(struct dt_list * this, size_t index, void * item);
+static int list_remove(struct dt_list * this, size_t index);
+static int list_insert_range(struct dt_list * this, size_t index,
+	void * const * items, size_t count);
+static int list_remove_range(struct dt_list * this, size_t index,
+	size_t count);
+static int list_append_many(struct dt_list * this,
+	void * const * items, size_t count);
+static size_t list_length(const struct dt_list * this);
+static struct dt_list_iterator * list_iterator(struct dt_list * this);
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage);
+static void list_del(struct dt_list * this);
+
+// Iterator functions
+static void * iterator_get(const struct dt_list_iterator * this);
+static int iterator_valid(const struct dt_list_iterator * this);
+static int iterator_next(struct dt_list_iterator * this);
+static int iterator_previous(struct dt_list_iterator * this);
+static int iterator_insert(struct dt_list_iterator * this, void * item);
+static int iterator_remove(struct dt_list_iterator * this);
+static void iterator_del(struct dt_list_iterator * this);
+static void iterator_dispose(struct dt_list_iterator * this);
+
+// Internal functions
+/** Finds the slot in the buffer for an index.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    index: The index in the list.
+ *
+ *  Returns:
+ *    A pointer to the slot.
+ */
+static void ** slot(const struct list_implementation * data, size_t index);
+
+/** Moves a run of items to another place in the list.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    to: The index to move the run to.
+ *    from: The index the run starts at.
+ *    count: The number of items in the run.
+ *
+ *  Notes:
+ *    The runs may overlap. Indices are taken from the head
+ *    so they must all fit within the buffer length.
+ */
+static void move(struct list_implementation * data,
+	size_t to, size_t from, size_t count);
+
+/** Moves the items into a new buffer of the given size,
+ *  unwrapping them so the head is at the start again.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    new_size: The new size of the buffer in bytes.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise.
+ */
+static int resize(struct list_implementation * data, size_t new_size);
+
+/** Picks the buffer size for holding length items.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    length: The number of items the buffer must hold.
+ *
+ *  Returns:
+ *    The new size in bytes. Or zero if it would overflow.
+ */
+static size_t fit_size(struct list_implementation * data, size_t length);
+
+struct dt_list * dt_list_deque_new(void) {
+	struct deque_list * deque;
+	deque = malloc(sizeof(*deque));
+
+	if (!deque) return NULL;
+
+	struct dt_list * list = &deque->list;
+	struct list_implementation * implementation = &deque->implementation;
+
+	implementation->buffer_size =
+		ARRAY_SIZE(implementation->buffer, MINIMUM_LENGTH);
+	implementation->length = 0;
+	implementation->head = 0;
+	implementation->buffer = malloc(implementation->buffer_size);
+
+	if (!implementation->buffer) {
+		free(deque);
+		return NULL;
+	}
+
+	list->_data = implementation;
+
+	list->get = &list_get;
+	list->insert = &list_insert;
+	list->remove = &list_remove;
+	list->insert_range = &list_insert_range;
+	list->remove_range = &list_remove_range;
+	list->append_many = &list_append_many;
+	list->length = &list_length;
+	list->iterator = &list_iterator;
+	list->iterator_init = &list_iterator_init;
+	list->del = &list_del;
+
+	return list;
+}
+
+static void * list_get(const struct dt_list * this, size_t index)
+{
+	struct list_implementation * data = this->_data;
+	if (index >= data->length) return NULL;
+	return *slot(data, index);
+}
+
+static int list_insert(struct dt_list * this, size_t index, void * item)
+{
+	return list_insert_range(this, index, &item, 1);
+}
+
+static int list_remove(struct dt_list * this, size_t index)
+{
+	struct list_implementation * data = this->_data;
+	if (index >= data->length) return DT_LIST_EINDEX;
+	return list_remove_range(this, index, 1);
+}
+
+static int list_insert_range(struct dt_list * this, size_t index,
+	void * const * items, size_t count)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length) return DT_LIST_EINDEX;
+
+	if (data->length + count < data->length) {
+		// Overflow
+		return DT_LIST_ENOMEM;
+	}
+
+	size_t buffer_length =
+		ARRAY_LENGTH(data->buffer, data->buffer_size);
+
+	if (buffer_length - data->length < count) {
+		size_t new_size = fit_size(data, data->length + count);
+		if (!new_size) return DT_LIST_ENOMEM;
+		if (resize(data, new_size)) return DT_LIST_ENOMEM;
+		buffer_length = ARRAY_LENGTH(data->buffer, data->buffer_size);
+	}
+
+	// Open the space by moving whichever side is shorter.
+	if (index < data->length - index) {
+		data->head = (data->head - count) & (buffer_length - 1);
+		move(data, 0, count, index);
+	} else {
+		move(data, index + count, index, data->length - index);
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		*slot(data, index + i) = items[i];
+	}
+
+	data->length += count;
+	return 0;
+}
+
+static int list_remove_range(struct dt_list * this, size_t index,
+	size_t count)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length || count > data->length - index)
+		return DT_LIST_EINDEX;
+
+	size_t buffer_length =
+		ARRAY_LENGTH(data->buffer, data->buffer_size);
+
+	// Close the space by moving whichever side is shorter.
+	if (index < data->length - index - count) {
+		move(data, count, 0, index);
+		data->head = (data->head + count) & (buffer_length - 1);
+	} else {
+		move(data, index, index + count, data->length - index - count);
+	}
+
+	data->length -= count;
+
+	size_t new_size = fit_size(data, data->length);
+	if (new_size < data->buffer_size) {
+		// Failing to shrink is harmless.
+		resize(data, new_size);
+	}
+
+	return 0;
+}
+
+static int list_append_many(struct dt_list * this,
+	void * const * items, size_t count)
+{
+	struct list_implementation * data = this->_data;
+	return list_insert_range(this, data->length, items, count);
+}
+
+static size_t list_length(const struct dt_list * this)
+{
+	struct list_implementation * data = this->_data;
+	return data->length;
+}
+
+static struct dt_list_iterator * list_iterator(struct dt_list * this)
+{
+	struct dt_list_iterator * iterator;
+	iterator = malloc(sizeof(*iterator));
+
+	if (!iterator) return NULL;
+
+	list_iterator_init(this, iterator);
+	iterator->del = &iterator_del;
+	return iterator;
+}
+
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage)
+{
+	storage->get = &iterator_get;
+	storage->valid = &iterator_valid;
+	storage->next = &iterator_next;
+	storage->previous = &iterator_previous;
+	storage->insert = &iterator_insert;
+	storage->remove = &iterator_remove;
+	storage->del = &iterator_dispose;
+
+	storage->position = 0;
+	storage->list = this;
+	// The iterator works on this list even when
+	// storage->list is swapped for a wrapper.
+	storage->_data = this;
+	return storage;
+}
+
+static void list_del(struct dt_list * this)
+{
+	struct list_implementation * data = this->_data;
+	free(data->buffer);
+	free(this);
+}
+
+
+static void * iterator_get(const struct dt_list_iterator * this)
+{
+	return list_get(this->_data, this->position);
+}
+
+static int iterator_valid(const struct dt_list_iterator * this)
+{
+	return this->position < list_length(this->_data);
+}
+
+static int iterator_next(struct dt_list_iterator * this)
+{
+	if (this->position >= list_length(this->_data))
+		return DT_LIST_EINDEX;
+
+	this->position++;
+
+	if (this->position == list_length(this->_data))
+		return DT_LIST_EINDEX;
+	return 0;
+}
+
+static int iterator_previous(struct dt_list_iterator * this)
+{
+	if (this->position <= 0) return DT_LIST_EINDEX;
+	this->position--;
+	return 0;
+}
+
+static int iterator_insert(struct dt_list_iterator * this, void * item)
+{
+	return list_insert(this->_data, this->position, item);
+}
+
+static int iterator_remove(struct dt_list_iterator * this)
+{
+	return list_remove(this->_data, this->position);
+}
+
+static void iterator_del(struct dt_list_iterator * this)
+{
+	free(this);
+}
+
+static void iterator_dispose(struct dt_list_iterator * this)
+{
+}
+
+static void ** slot(const struct list_implementation * data, size_t index)
+{
+	size_t mask = ARRAY_LENGTH(data->buffer, data->buffer_size) - 1;
+	return data->buffer + ((data->head + index) & mask);
+}
+
+static void move(struct list_implementation * data,
+	size_t to, size_t from, size_t count)
+{
+	size_t buffer_length =
+		ARRAY_LENGTH(data->buffer, data->buffer_size);
+	size_t mask = buffer_length - 1;
+
+	// Copy in the largest pieces that do not wrap, starting from
+	// the end the run is moving towards so nothing is overwritten
+	// before it is copied.
+	if (to < from) {
+		while (count) {
+			size_t source = (data->head + from) & mask;
+			size_t target = (data->head + to) & mask;
+			size_t run = count;
+			if (run > buffer_length - source) run = buffer_length - source;
+			if (run > buffer_length - target) run = buffer_length - target;
+
+			memmove(data->buffer + target, data->buffer + source,
+				ARRAY_SIZE(data->buffer, run));
+			to += run;
+			from += run;
+			count -= run;
+		}
+	} else if (to > from) {
+		while (count) {
+			size_t source = ((data->head + from + count - 1) & mask) + 1;
+			size_t target = ((data->head + to + count - 1) & mask) + 1;
+			size_t run = count;
+			if (run > source) run = source;
+			if (run > target) run = target;
+
+			memmove(data->buffer + target - run,
+				data->buffer + source - run,
+				ARRAY_SIZE(data->buffer, run));
+			count -= run;
+		}
+	}
+}
+
+static int resize(struct list_implementation * data, size_t new_size)
+{
+	void ** new_buf = malloc(new_size);
+	if (!new_buf) return DT_LIST_ENOMEM;
+
+	size_t buffer_length =
+		ARRAY_LENGTH(data->buffer, data->buffer_size);
+	size_t first = buffer_length - data->head;
+	if (first > data->length) first = data->length;
+
+	memcpy(new_buf, data->buffer + data->head,
+		ARRAY_SIZE(data->buffer, first));
+	memcpy(new_buf + first, data->buffer,
+		ARRAY_SIZE(data->buffer, (data->length - first)));
+
+	free(data->buffer);
+	data->buffer = new_buf;
+	data->buffer_size = new_size;
+	data->head = 0;
+	return 0;
+}
+
+static size_t fit_size(struct list_implementation * data, size_t length)
+{
+	size_t new_size = data->buffer_size;
+
+	while (ARRAY_LENGTH(data->buffer, new_size) < length) {
+		if (new_size * 2 < new_size) {
+			// Overflow
+			return 0;
+		}
+		new_size *= 2;
+	}
+
+	while (ARRAY_LENGTH(data->buffer, new_size) / 4 > length &&
+		ARRAY_LENGTH(data->buffer, new_size) > MINIMUM_LENGTH) {
+		new_size /= 2;
+	}
+
+	return new_size;
+}
@@ -0,0 +1,403 @@
+#include "list/gap.h"
+
+#include "list/error.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "buffers.h"
+
+struct list_implementation;
+struct gap_list;
+
+// The items live in [0, gap_start) and [gap_end, buffer length).
+// The gap is left wherever the last edit happened so runs of
+// edits around the same place only move the items in between.
+struct list_implementation {
+	void ** buffer;
+	size_t buffer_size;
+	size_t gap_start;
+	size_t gap_end;
+	size_t length;
+};
+
+// The list and its implementation share one allocation.
+struct gap_list {
+	struct dt_list list;
+	struct list_implementation implementation;
+};
+
+// List functions
+static void * list_get(const struct dt_list * this, size_t index);
+static int list_insert(struct dt_list * this, size_t index, void * item);
+static int list_remove(struct dt_list * this, size_t index);
+static int list_insert_range(struct dt_list * this, size_t index,
+	void * const * items, size_t count);
+static int list_remove_range(struct dt_list * this, size_t index,
+	size_t count);
+static int list_append_many(struct dt_list * this,
+	void * const * items, size_t count);
+static size_t list_length(const struct dt_list * this);
+static struct dt_list_iterator * list_iterator(struct dt_list * this);
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage);
+static void list_del(struct dt_list * this);
+
+// Iterator functions
+static void * iterator_get(const struct dt_list_iterator * this);
+static int iterator_valid(const struct dt_list_iterator * this);
+static int iterator_next(struct dt_list_iterator * this);
+static int iterator_previous(struct dt_list_iterator * this);
+static int iterator_insert(struct dt_list_iterator * this, void * item);
+static int iterator_remove(struct dt_list_iterator * this);
+static void iterator_del(struct dt_list_iterator * this);
+static void iterator_dispose(struct dt_list_iterator * this);
+
+// Internal functions
+/** Moves the gap so that it starts at index.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    index: The index the gap should start at [0, length].
+ */
+static void move_gap(struct list_implementation * data, size_t index);
+
+/** Resizes the buffer keeping the gap where it is.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    new_size: The new size of the buffer in bytes.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise.
+ */
+static int resize(struct list_implementation * data, size_t new_size);
+
+/** Picks the buffer size for holding length items.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    length: The number of items the buffer must hold.
+ *
+ *  Returns:
+ *    The new size in bytes. Or zero if it would overflow.
+ */
+static size_t fit_size(struct list_implementation * data, size_t length);
+
+struct dt_list * dt_list_gap_new(void) {
+	struct gap_list * gap;
+	gap = malloc(sizeof(*gap));
+
+	if (!gap) return NULL;
+
+	struct dt_list * list = &gap->list;
+	struct list_implementation * implementation = &gap->implementation;
+
+	implementation->buffer_size =
+		ARRAY_SIZE(implementation->buffer, 8);
+	implementation->length = 0;
+	implementation->gap_start = 0;
+	implementation->gap_end = 8;
+	implementation->buffer = malloc(implementation->buffer_size);
+
+	if (!implementation->buffer) {
+		free(gap);
+		return NULL;
+	}
+
+	list->_data = implementation;
+
+	list->get = &list_get;
+	list->insert = &list_insert;
+	list->remove = &list_remove;
+	list->insert_range = &list_insert_range;
+	list->remove_range = &list_remove_range;
+	list->append_many = &list_append_many;
+	list->length = &list_length;
+	list->iterator = &list_iterator;
+	list->iterator_init = &list_iterator_init;
+	list->del = &list_del;
+
+	return list;
+}
+
+static void * list_get(const struct dt_list * this, size_t index)
+{
+	struct list_implementation * data = this->_data;
+	if (index >= data->length) return NULL;
+	if (index < data->gap_start) return data->buffer[index];
+	return data->buffer[index + (data->gap_end - data->gap_start)];
+}
+
+static int list_insert(struct dt_list * this, size_t index, void * item)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length) return DT_LIST_EINDEX;
+
+	if (data->gap_start == data->gap_end) {
+
+		size_t new_size = data->buffer_size * 2;
+
+		if (new_size < data->buffer_size) {
+			// Overflow
+			return DT_LIST_ENOMEM;
+		}
+
+		if (resize(data, new_size)) return DT_LIST_ENOMEM;
+	}
+
+	move_gap(data, index);
+	data->buffer[data->gap_start] = item;
+	data->gap_start++;
+
+	data->length++;
+	return 0;
+}
+
+static int list_remove(struct dt_list * this, size_t index)
+{
+	struct list_implementation * data = this->_data;
+	if (index >= data->length) return DT_LIST_EINDEX;
+
+	move_gap(data, index);
+	data->gap_end++;
+	data->length--;
+
+	size_t buffer_length =
+		ARRAY_LENGTH(data->buffer, data->buffer_size);
+
+	if (buffer_length / 4 > data->length) {
+		// Failing to shrink is harmless.
+		resize(data, data->buffer_size / 2);
+	}
+
+	return 0;
+}
+
+static int list_insert_range(struct dt_list * this, size_t index,
+	void * const * items, size_t count)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length) return DT_LIST_EINDEX;
+
+	if (data->length + count < data->length) {
+		// Overflow
+		return DT_LIST_ENOMEM;
+	}
+
+	if (data->gap_end - data->gap_start < count) {
+		size_t new_size = fit_size(data, data->length + count);
+		if (!new_size) return DT_LIST_ENOMEM;
+		if (resize(data, new_size)) return DT_LIST_ENOMEM;
+	}
+
+	move_gap(data, index);
+	memcpy(data->buffer + data->gap_start, items,
+		ARRAY_SIZE(items, count));
+	data->gap_start += count;
+
+	data->length += count;
+	return 0;
+}
+
+static int list_remove_range(struct dt_list * this, size_t index,
+	size_t count)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length || count > data->length - index)
+		return DT_LIST_EINDEX;
+
+	move_gap(data, index);
+	data->gap_end += count;
+	data->length -= count;
+
+	size_t new_size = fit_size(data, data->length);
+	if (new_size < data->buffer_size) {
+		// Failing to shrink is harmless.
+		resize(data, new_size);
+	}
+
+	return 0;
+}
+
+static int list_append_many(struct dt_list * this,
+	void * const * items, size_t count)
+{
+	struct list_implementation * data = this->_data;
+	return list_insert_range(this, data->length, items, count);
+}
+
+static size_t list_length(const struct dt_list * this)
+{
+	struct list_implementation * data = this->_data;
+	return data->length;
+}
+
+static struct dt_list_iterator * list_iterator(struct dt_list * this)
+{
+	struct dt_list_iterator * iterator;
+	iterator = malloc(sizeof(*iterator));
+
+	if (!iterator) return NULL;
+
+	list_iterator_init(this, iterator);
+	iterator->del = &iterator_del;
+	return iterator;
+}
+
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage)
+{
+	storage->get = &iterator_get;
+	storage->valid = &iterator_valid;
+	storage->next = &iterator_next;
+	storage->previous = &iterator_previous;
+	storage->insert = &iterator_insert;
+	storage->remove = &iterator_remove;
+	storage->del = &iterator_dispose;
+
+	storage->position = 0;
+	storage->list = this;
+	// The iterator works on this list even when
+	// storage->list is swapped for a wrapper.
+	storage->_data = this;
+	return storage;
+}
+
+static void list_del(struct dt_list * this)
+{
+	struct list_implementation * data = this->_data;
+	free(data->buffer);
+	free(this);
+}
+
+
+static void * iterator_get(const struct dt_list_iterator * this)
+{
+	return list_get(this->_data, this->position);
+}
+
+static int iterator_valid(const struct dt_list_iterator * this)
+{
+	return this->position < list_length(this->_data);
+}
+
+static int iterator_next(struct dt_list_iterator * this)
+{
+	if (this->position >= list_length(this->_data))
+		return DT_LIST_EINDEX;
+
+	this->position++;
+
+	if (this->position == list_length(this->_data))
+		return DT_LIST_EINDEX;
+	return 0;
+}
+
+static int iterator_previous(struct dt_list_iterator * this)
+{
+	if (this->position <= 0) return DT_LIST_EINDEX;
+	this->position--;
+	return 0;
+}
+
+static int iterator_insert(struct dt_list_iterator * this, void * item)
+{
+	return list_insert(this->_data, this->position, item);
+}
+
+static int iterator_remove(struct dt_list_iterator * this)
+{
+	return list_remove(this->_data, this->position);
+}
+
+static void iterator_del(struct dt_list_iterator * this)
+{
+	free(this);
+}
+
+static void iterator_dispose(struct dt_list_iterator * this)
+{
+}
+
+static void move_gap(struct list_implementation * data, size_t index)
+{
+	if (index < data->gap_start) {
+		size_t count = data->gap_start - index;
+		memmove(data->buffer + data->gap_end - count,
+			data->buffer + index,
+			ARRAY_SIZE(data->buffer, count));
+		data->gap_start -= count;
+		data->gap_end -= count;
+	} else if (index > data->gap_start) {
+		size_t count = index - data->gap_start;
+		memmove(data->buffer + data->gap_start,
+			data->buffer + data->gap_end,
+			ARRAY_SIZE(data->buffer, count));
+		data->gap_start += count;
+		data->gap_end += count;
+	}
+}
+
+static int resize(struct list_implementation * data, size_t new_size)
+{
+	size_t buffer_length =
+		ARRAY_LENGTH(data->buffer, data->buffer_size);
+	size_t new_length = ARRAY_LENGTH(data->buffer, new_size);
+	size_t tail = buffer_length - data->gap_end;
+
+	if (new_length < data->length) return DT_LIST_ENOMEM;
+
+	if (new_length < buffer_length) {
+		// Pull the tail down before the end is cut off.
+		memmove(data->buffer + new_length - tail,
+			data->buffer + data->gap_end,
+			ARRAY_SIZE(data->buffer, tail));
+		data->gap_end = new_length - tail;
+	}
+
+	void ** new_buf = realloc(data->buffer, new_size);
+
+	if (!new_buf) {
+		if (new_length < buffer_length) {
+			// Shrinking failed, put the tail back.
+			memmove(data->buffer + buffer_length - tail,
+				data->buffer + data->gap_end,
+				ARRAY_SIZE(data->buffer, tail));
+			data->gap_end = buffer_length - tail;
+		}
+		return DT_LIST_ENOMEM;
+	}
+
+	data->buffer = new_buf;
+	data->buffer_size = new_size;
+
+	if (new_length > buffer_length) {
+		// Push the tail up to the new end.
+		memmove(data->buffer + new_length - tail,
+			data->buffer + data->gap_end,
+			ARRAY_SIZE(data->buffer, tail));
+		data->gap_end = new_length - tail;
+	}
+
+	return 0;
+}
+
+static size_t fit_size(struct list_implementation * data, size_t length)
+{
+	size_t new_size = data->buffer_size;
+
+	while (ARRAY_LENGTH(data->buffer, new_size) < length) {
+		if (new_size * 2 < new_size) {
+			// Overflow
+			return 0;
+		}
+		new_size *= 2;
+	}
+
+	while (ARRAY_LENGTH(data->buffer, new_size) / 4 > length) {
+		new_size /= 2;
+	}
+
+	return new_size;
+}
@@ -0,0 +1,533 @@
+#include "list/intrusive.h"
+
+#include "list/error.h"
+
+#include <stdlib.h>
+
+struct list_implementation;
+struct iterator_implementation;
+struct intrusive_list;
+
+struct list_implementation {
+	struct dt_list_link * head;
+	struct dt_list_link * tail;
+	size_t length;
+	// Where the link sits in each item.
+	size_t offset;
+	// The last link found by index, as in the linked list.
+	struct dt_list_link * finger;
+	size_t finger_index;
+};
+
+// The list and its implementation share one allocation.
+struct intrusive_list {
+	struct dt_list list;
+	struct list_implementation implementation;
+};
+
+// Kept in the iterator's _state.
+struct iterator_implementation {
+	struct list_implementation * list_data;
+	struct dt_list_link ** last_link_pointer;
+	struct dt_list_link * last_link;
+};
+
+_Static_assert(
+	sizeof(struct iterator_implementation) <=
+		sizeof(((struct dt_list_iterator *) 0)->_state),
+	"iterator_implementation does not fit in an iterator");
+
+// List functions
+static void * list_get(const struct dt_list * this, size_t index);
+static int list_insert(struct dt_list * this, size_t index, void * item);
+static int list_remove(struct dt_list * this, size_t index);
+static int list_insert_range(struct dt_list * this, size_t index,
+	void * const * items, size_t count);
+static int list_remove_range(struct dt_list * this, size_t index,
+	size_t count);
+static int list_append_many(struct dt_list * this,
+	void * const * items, size_t count);
+static size_t list_length(const struct dt_list * this);
+static struct dt_list_iterator * list_iterator(struct dt_list * this);
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage);
+static void list_del(struct dt_list * this);
+
+// Iterator functions
+static void * iterator_get(const struct dt_list_iterator * this);
+static int iterator_valid(const struct dt_list_iterator * this);
+static int iterator_next(struct dt_list_iterator * this);
+static int iterator_previous(struct dt_list_iterator * this);
+static int iterator_insert(struct dt_list_iterator * this, void * item);
+static int iterator_remove(struct dt_list_iterator * this);
+static void iterator_del(struct dt_list_iterator * this);
+static void iterator_dispose(struct dt_list_iterator * this);
+
+// Internal functions
+/** Gets the link embedded in an item.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    item: The item.
+ *
+ *  Returns:
+ *    The item's link.
+ */
+static struct dt_list_link * item_link(
+	const struct list_implementation * data, void * item);
+
+/** Gets the item a link is embedded in.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    link: The link.
+ *
+ *  Returns:
+ *    The item.
+ */
+static void * link_item(const struct list_implementation * data,
+	struct dt_list_link * link);
+
+/** Finds the link at an index.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    index: The index of the link, less than the length.
+ *
+ *  Returns:
+ *    The link at index.
+ *
+ *  Notes:
+ *    Walks from the head, the tail or the finger, whichever
+ *    is closest, then moves the finger to the link found.
+ */
+static struct dt_list_link * find_link(struct list_implementation * data,
+	size_t index);
+
+/** Points the finger at a link after an edit.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    before: The link before the edit or NULL.
+ *    after: The link after the edit or NULL.
+ *    index: The index of after.
+ */
+static void set_finger(struct list_implementation * data,
+	struct dt_list_link * before, struct dt_list_link * after, size_t index);
+
+/** Gets the current link for the iterator.
+ *
+ *  Arguments:
+ *    iterator: The iterator.
+ *
+ *  Returns:
+ *    The link that is referenced.
+ */
+static struct dt_list_link * iterator_link
+	(const struct dt_list_iterator * iterator);
+
+// List functions
+struct dt_list * dt_list_intrusive_new(size_t offset)
+{
+	struct intrusive_list * intrusive = NULL;
+	intrusive = malloc(sizeof(*intrusive));
+	if (!intrusive) return NULL;
+	struct dt_list * list = &intrusive->list;
+	struct list_implementation * implementation = &intrusive->implementation;
+	list->get = &list_get;
+	list->insert = &list_insert;
+	list->remove = &list_remove;
+	list->insert_range = &list_insert_range;
+	list->remove_range = &list_remove_range;
+	list->append_many = &list_append_many;
+	list->length = &list_length;
+	list->iterator = &list_iterator;
+	list->iterator_init = &list_iterator_init;
+	list->del = &list_del;
+
+	list->_data = implementation;
+
+	implementation->head = NULL;
+	implementation->tail = NULL;
+	implementation->length = 0;
+	implementation->offset = offset;
+	implementation->finger = NULL;
+	implementation->finger_index = 0;
+
+	return list;
+}
+
+static void * list_get(const struct dt_list * this, size_t index)
+{
+	struct list_implementation * data = this->_data;
+	if (data->length <= index) return NULL;
+	// Moves the finger, so readers are not thread safe.
+	return link_item(data, find_link(data, index));
+}
+
+static int list_insert(struct dt_list * this, size_t index, void * item)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length) return DT_LIST_EINDEX;
+
+	struct dt_list_link * link = item_link(data, item);
+	struct dt_list_link * link_before = NULL;
+
+	if (index > 0) {
+		link_before = find_link(data, index - 1);
+		link->next = link_before->next;
+		link_before->next = link;
+	} else {
+		link->next = data->head;
+		data->head = link;
+	}
+
+	link->previous = link_before;
+
+	if (link->next) {
+		link->next->previous = link;
+	} else {
+		data->tail = link;
+	}
+
+	data->length += 1;
+	set_finger(data, NULL, link, index);
+
+	return 0;
+}
+
+static int list_remove(struct dt_list * this, size_t index)
+{
+	struct list_implementation * data = this->_data;
+	if (index >= data->length) return DT_LIST_EINDEX;
+
+	struct dt_list_link * link = find_link(data, index);
+
+	if (link->previous) {
+		link->previous->next = link->next;
+	} else {
+		data->head = link->next;
+	}
+
+	if (link->next) {
+		link->next->previous = link->previous;
+	} else {
+		data->tail = link->previous;
+	}
+
+	data->length -= 1;
+	set_finger(data, link->previous, link->next, index);
+
+	link->next = NULL;
+	link->previous = NULL;
+
+	return 0;
+}
+
+static int list_insert_range(struct dt_list * this, size_t index,
+	void * const * items, size_t count)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length) return DT_LIST_EINDEX;
+	if (!count) return 0;
+
+	struct dt_list_link ** link = &(data->head);
+	struct dt_list_link * link_before = NULL;
+	if (index > 0) {
+		link_before = find_link(data, index - 1);
+		link = &(link_before->next);
+	}
+
+	struct dt_list_link * after = *link;
+	struct dt_list_link * first = item_link(data, items[0]);
+
+	for (size_t i = 0; i < count; i++) {
+		struct dt_list_link * current = item_link(data, items[i]);
+		current->previous = link_before;
+		*link = current;
+
+		link_before = current;
+		link = &(current->next);
+	}
+
+	*link = after;
+	if (after) {
+		after->previous = link_before;
+	} else {
+		data->tail = link_before;
+	}
+
+	data->length += count;
+	set_finger(data, NULL, first, index);
+
+	return 0;
+}
+
+static int list_remove_range(struct dt_list * this, size_t index,
+	size_t count)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length || count > data->length - index)
+		return DT_LIST_EINDEX;
+	if (!count) return 0;
+
+	struct dt_list_link ** link = &(data->head);
+	struct dt_list_link * link_before = NULL;
+	if (index > 0) {
+		link_before = find_link(data, index - 1);
+		link = &(link_before->next);
+	}
+
+	struct dt_list_link * current = *link;
+	for (size_t i = 0; i < count; i++) {
+		struct dt_list_link * unlink_me = current;
+		current = current->next;
+		unlink_me->next = NULL;
+		unlink_me->previous = NULL;
+	}
+
+	*link = current;
+	if (current) {
+		current->previous = link_before;
+	} else {
+		data->tail = link_before;
+	}
+
+	data->length -= count;
+	set_finger(data, link_before, current, index);
+
+	return 0;
+}
+
+static int list_append_many(struct dt_list * this,
+	void * const * items, size_t count)
+{
+	struct list_implementation * data = this->_data;
+	return list_insert_range(this, data->length, items, count);
+}
+
+static size_t list_length(const struct dt_list * this)
+{
+	struct list_implementation * data = this->_data;
+	return data->length;
+}
+
+static struct dt_list_iterator * list_iterator(struct dt_list * this)
+{
+	struct dt_list_iterator * iterator = NULL;
+	iterator = malloc(sizeof(*iterator));
+	if (!iterator) return NULL;
+
+	list_iterator_init(this, iterator);
+	iterator->del = &iterator_del;
+	return iterator;
+}
+
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage)
+{
+	struct list_implementation * data = this->_data;
+	struct iterator_implementation * implementation =
+		(struct iterator_implementation *) storage->_state;
+
+	storage->get = &iterator_get;
+	storage->valid = &iterator_valid;
+	storage->next = &iterator_next;
+	storage->previous = &iterator_previous;
+	storage->insert = &iterator_insert;
+	storage->remove = &iterator_remove;
+	storage->del = &iterator_dispose;
+
+	storage->list = this;
+	storage->position = 0;
+
+	storage->_data = implementation;
+
+	implementation->list_data = data;
+	implementation->last_link_pointer = &(data->head);
+	implementation->last_link = NULL;
+
+	return storage;
+}
+
+static void list_del(struct dt_list * this)
+{
+	// The items belong to the caller.
+	free(this);
+}
+
+// Iterator functions
+static void * iterator_get(const struct dt_list_iterator * this)
+{
+	struct iterator_implementation * data = this->_data;
+	struct dt_list_link * current = iterator_link(this);
+	if (current) return link_item(data->list_data, current);
+	return NULL;
+}
+
+static int iterator_valid(const struct dt_list_iterator * this)
+{
+	struct dt_list_link * current = iterator_link(this);
+	if (current) return 1;
+	return 0;
+}
+
+static int iterator_next(struct dt_list_iterator * this)
+{
+	struct iterator_implementation * data = this->_data;
+	struct dt_list_link * current = iterator_link(this);
+
+	if (!current) {
+		return DT_LIST_EINDEX;
+	}
+
+	data->last_link_pointer = &(current->next);
+	data->last_link = current;
+	this->position += 1;
+
+	if (iterator_link(this)) return 0;
+	return DT_LIST_EINDEX;
+}
+
+static int iterator_previous(struct dt_list_iterator * this)
+{
+	struct iterator_implementation * data = this->_data;
+	struct list_implementation * list_data = data->list_data;
+
+	if (!data->last_link) return DT_LIST_EINDEX;
+
+	data->last_link = data->last_link->previous;
+
+	if (data->last_link) {
+		data->last_link_pointer = &(data->last_link->next);
+	} else {
+		data->last_link_pointer = &(list_data->head);
+	}
+
+	this->position--;
+	return 0;
+}
+
+static int iterator_insert(struct dt_list_iterator * this, void * item)
+{
+	struct iterator_implementation * data = this->_data;
+	struct list_implementation * list_data = data->list_data;
+	struct dt_list_link * current = iterator_link(this);
+	struct dt_list_link * link = item_link(list_data, item);
+
+	*(data->last_link_pointer) = link;
+	link->next = current;
+	link->previous = data->last_link;
+
+	if (current) {
+		current->previous = link;
+	} else {
+		list_data->tail = link;
+	}
+
+	list_data->length += 1;
+	set_finger(list_data, NULL, link, this->position);
+
+	return 0;
+}
+
+static int iterator_remove(struct dt_list_iterator * this)
+{
+	struct iterator_implementation * data = this->_data;
+	struct list_implementation * list_data = data->list_data;
+	struct dt_list_link * current = iterator_link(this);
+
+	if (!current) return DT_LIST_EINDEX;
+
+	*(data->last_link_pointer) = current->next;
+
+	if (current->next) {
+		current->next->previous = current->previous;
+	} else {
+		list_data->tail = current->previous;
+	}
+
+	list_data->length -= 1;
+	set_finger(list_data, current->previous, current->next,
+		this->position);
+
+	current->next = NULL;
+	current->previous = NULL;
+
+	return 0;
+}
+
+static void iterator_del(struct dt_list_iterator * this)
+{
+	free(this);
+}
+
+static void iterator_dispose(struct dt_list_iterator * this)
+{
+}
+
+// Internal functions
+static struct dt_list_link * item_link(
+	const struct list_implementation * data, void * item)
+{
+	return (struct dt_list_link *) ((char *) item + data->offset);
+}
+
+static void * link_item(const struct list_implementation * data,
+	struct dt_list_link * link)
+{
+	return (char *) link - data->offset;
+}
+
+static struct dt_list_link * find_link(struct list_implementation * data,
+	size_t index)
+{
+	struct dt_list_link * link = data->head;
+	size_t at = 0;
+	size_t distance = index;
+
+	if (data->length - 1 - index < distance) {
+		link = data->tail;
+		at = data->length - 1;
+		distance = at - index;
+	}
+
+	if (data->finger) {
+		size_t finger_distance = index > data->finger_index ?
+			index - data->finger_index :
+			data->finger_index - index;
+
+		if (finger_distance < distance) {
+			link = data->finger;
+			at = data->finger_index;
+		}
+	}
+
+	for (; at < index; at++) link = link->next;
+	for (; at > index; at--) link = link->previous;
+
+	data->finger = link;
+	data->finger_index = index;
+	return link;
+}
+
+static void set_finger(struct list_implementation * data,
+	struct dt_list_link * before, struct dt_list_link * after, size_t index)
+{
+	if (after) {
+		data->finger = after;
+		data->finger_index = index;
+	} else if (before) {
+		data->finger = before;
+		data->finger_index = index - 1;
+	} else {
+		data->finger = NULL;
+	}
+}
+
+static struct dt_list_link * iterator_link
+	(const struct dt_list_iterator * iterator)
+{
+	struct iterator_implementation * data = iterator->_data;
+	return *(data->last_link_pointer);
+}
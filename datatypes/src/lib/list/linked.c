@@ -2,25 +2,53 @@
 
 #include "list/error.h"
 
-#include <stdlib.h>
+#include <stdbool.h>
+
+#include "allocator.h"
+#include "pool.h"
 
 struct list_implementation;
 struct iterator_implementation;
+struct linked_list;
 
 struct list_node;
 
 struct list_implementation {
 	struct list_node * head;
+	struct list_node * tail;
 	size_t length;
+	// The last node found by index. Walks start from
+	// here when it is closer than either end so
+	// sequential access does not rescan the list.
+	struct list_node * finger;
+	size_t finger_index;
+	// Where nodes come from. NULL for the allocator.
+	struct dt_pool * pool;
+	bool owns_pool;
+	// Where the list, its nodes and iterators come from.
+	const struct dt_allocator * allocator;
+};
+
+// The list and its implementation share one allocation.
+struct linked_list {
+	struct dt_list list;
+	struct list_implementation implementation;
 };
 
+// Kept in the iterator's _state.
 struct iterator_implementation {
+	struct list_implementation * list_data;
 	struct list_node ** last_node_pointer;
 	// Messy, but required for iterator_insert and
 	// iterator_previous to work efficiently and correctly.
 	struct list_node * last_node;
 };
 
+_Static_assert(
+	sizeof(struct iterator_implementation) <=
+		sizeof(((struct dt_list_iterator *) 0)->_state),
+	"iterator_implementation does not fit in an iterator");
+
 struct list_node {
 	void * data;
 	struct list_node * next;
@@ -31,8 +59,16 @@ struct list_node {
 static void * list_get(const struct dt_list * this, size_t index);
 static int list_insert(struct dt_list * this, size_t index, void * item);
 static int list_remove(struct dt_list * this, size_t index);
+static int list_insert_range(struct dt_list * this, size_t index,
+	void * const * items, size_t count);
+static int list_remove_range(struct dt_list * this, size_t index,
+	size_t count);
+static int list_append_many(struct dt_list * this,
+	void * const * items, size_t count);
 static size_t list_length(const struct dt_list * this);
 static struct dt_list_iterator * list_iterator(struct dt_list * this);
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage);
 static void list_del(struct dt_list * this);
 
 // Iterator functions
@@ -43,19 +79,146 @@ static int iterator_previous(struct dt_list_iterator * this);
 static int iterator_insert(struct dt_list_iterator * this, void * item);
 static int iterator_remove(struct dt_list_iterator * this);
 static void iterator_del(struct dt_list_iterator * this);
+static void iterator_dispose(struct dt_list_iterator * this);
 
 // Internal functions
-/** Finds the node that comes in a later position.
+/** Finds the node at an index.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    index: The index of the node, less than the length.
+ *
+ *  Returns:
+ *    The node at index.
+ *
+ *  Notes:
+ *    Walks from the head, the tail or the finger, whichever
+ *    is closest, then moves the finger to the node found.
+ */
+static struct list_node * find_node(struct list_implementation * data,
+	size_t index);
+
+/** Points the finger at a node after an edit.
  *
  *  Arguments:
- *    node: The node to start from.
- *    distance: The number of nodes to traverse.
+ *    data: The list implementation.
+ *    before: The node before the edit or NULL.
+ *    after: The node after the edit or NULL.
+ *    index: The index of after.
+ */
+static void set_finger(struct list_implementation * data,
+	struct list_node * before, struct list_node * after, size_t index);
+
+/** Allocates a node.
  *
+ *  Arguments:
+ *    data: The list implementation.
  *
  *  Returns:
- *    The node that is `distance` away.
+ *    A new node. Or NULL if there is not enough memory.
  */
-static struct list_node * node_at(struct list_node * node, size_t distance);
+static struct list_node * node_new(struct list_implementation * data);
+
+/** Frees a node.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    node: The node to free.
+ */
+static void node_free(struct list_implementation * data,
+	struct list_node * node);
+
+/** Sets up a new linked list.
+ *
+ *  Arguments:
+ *    pool: Where nodes come from. NULL for the allocator.
+ *    owns_pool: True if the list deletes the pool.
+ *    allocator: Where the list comes from. NULL for malloc.
+ *
+ *  Returns:
+ *    A new list. Or NULL if there is not enough memory.
+ */
+static struct dt_list * linked_new(struct dt_pool * pool, bool owns_pool,
+	const struct dt_allocator * allocator);
+
+/** Builds a chain of new nodes holding the items.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    items: The items to put in the chain, in order.
+ *    count: The number of items, must be at least one.
+ *    last: A result variable. The last node in the chain.
+ *
+ *  Returns:
+ *    The first node in the chain. Or NULL if there is not
+ *    enough memory.
+ */
+static struct list_node * chain_new(struct list_implementation * data,
+	void * const * items, size_t count, struct list_node ** last);
+
+/** Copies a chain of nodes into new nodes for a list.
+ *
+ *  Arguments:
+ *    data: The list implementation the copies are for.
+ *    from: The first node to copy.
+ *    count: The number of nodes to copy, must be at least one.
+ *    last: A result variable. The last node in the copy.
+ *
+ *  Returns:
+ *    The first node in the copy. Or NULL if there is not
+ *    enough memory.
+ */
+static struct list_node * chain_copy(struct list_implementation * data,
+	struct list_node * from, size_t count, struct list_node ** last);
+
+/** Unlinks a chain of nodes from a list without freeing them.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    first: The first node in the chain.
+ *    last: The last node in the chain.
+ *    count: The number of nodes in the chain.
+ */
+static void chain_detach(struct list_implementation * data,
+	struct list_node * first, struct list_node * last, size_t count);
+
+/** Links a chain of nodes into a list.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    before: The node to put the chain after. NULL for the head.
+ *    first: The first node in the chain.
+ *    last: The last node in the chain.
+ *    count: The number of nodes in the chain.
+ */
+static void chain_attach(struct list_implementation * data,
+	struct list_node * before, struct list_node * first,
+	struct list_node * last, size_t count);
+
+/** Moves a chain of nodes from one list to another.
+ *
+ *  Arguments:
+ *    dst: The list implementation to move to.
+ *    before: The node in dst to put the chain after.
+ *            NULL for the head.
+ *    src: The list implementation to move from.
+ *    first: The first node in the chain.
+ *    last: The last node in the chain.
+ *    count: The number of nodes in the chain.
+ *
+ *  Returns:
+ *    Zero on success. DT_LIST_ENOMEM if the nodes had to be
+ *    copied and there is not enough memory.
+ *
+ *  Notes:
+ *    Nodes are relinked when both lists share a pool, or
+ *    both use the same allocator. Otherwise each list would
+ *    free the other's nodes to the wrong place, so they are
+ *    copied.
+ */
+static int chain_move(struct list_implementation * dst,
+	struct list_node * before, struct list_implementation * src,
+	struct list_node * first, struct list_node * last, size_t count);
 
 /** Gets the current node for the iterator.
  *
@@ -68,29 +231,177 @@ static struct list_node * node_at(struct list_node * node, size_t distance);
 static struct list_node * iterator_node
 	(const struct dt_list_iterator * iterator);
 
+/** Checks an iterator can edit a linked list.
+ *
+ *  Arguments:
+ *    iterator: The iterator.
+ *
+ *  Returns:
+ *    True if the iterator is on a linked list and can
+ *    insert and remove. False for iterators of other
+ *    lists and of read only wrappers of a linked list.
+ */
+static bool iterator_editable(const struct dt_list_iterator * iterator);
+
 // List functions
 struct dt_list * dt_list_linked_new(void)
 {
-	struct dt_list * list = NULL;
-	list = malloc(sizeof(*list));
-	if (!list) return NULL;
-	struct list_implementation * implementation;
-	implementation = malloc(sizeof(*implementation));
-	if (!implementation){
-		free(list);
+	return linked_new(NULL, false, NULL);
+}
+
+struct dt_list * dt_list_linked_new_with_allocator(
+	const struct dt_allocator * allocator)
+{
+	return linked_new(NULL, false, allocator);
+}
+
+struct dt_list * dt_list_linked_pooled_new(struct dt_pool * pool)
+{
+	if (!pool) {
+		pool = dt_pool_new(dt_list_linked_node_size(), 0);
+		if (!pool) return NULL;
+
+		struct dt_list * list = linked_new(pool, true, NULL);
+		if (!list) dt_pool_del(pool);
+		return list;
+	}
+
+	if (dt_pool_item_size(pool) < dt_list_linked_node_size()) return NULL;
+	return linked_new(pool, false, NULL);
+}
+
+size_t dt_list_linked_node_size(void)
+{
+	return sizeof(struct list_node);
+}
+
+int dt_list_linked_splice(struct dt_list * dst, size_t dst_index,
+	struct dt_list * src, size_t src_begin, size_t src_end)
+{
+	if (dst->get != &list_get || src->get != &list_get || dst == src) {
+		return DT_LIST_ETYPE;
+	}
+
+	struct list_implementation * dst_data = dst->_data;
+	struct list_implementation * src_data = src->_data;
+
+	if (src_begin > src_end || src_end > src_data->length ||
+		dst_index > dst_data->length) {
+		return DT_LIST_EINDEX;
+	}
+
+	size_t count = src_end - src_begin;
+	if (!count) return 0;
+
+	// The finger is left on the first node, so the second
+	// walk starts from whichever of it and the tail is closer.
+	struct list_node * first = find_node(src_data, src_begin);
+	struct list_node * last = find_node(src_data, src_end - 1);
+	struct list_node * before = NULL;
+	if (dst_index) before = find_node(dst_data, dst_index - 1);
+
+	return chain_move(dst_data, before, src_data, first, last, count);
+}
+
+int dt_list_linked_splice_iterators(struct dt_list_iterator * dst,
+	struct dt_list_iterator * src_begin,
+	struct dt_list_iterator * src_end)
+{
+	if (!iterator_editable(dst) || !iterator_editable(src_begin) ||
+		!iterator_editable(src_end)) {
+		return DT_LIST_ETYPE;
+	}
+
+	struct iterator_implementation * dst_data = dst->_data;
+	struct iterator_implementation * begin_data = src_begin->_data;
+	struct iterator_implementation * end_data = src_end->_data;
+
+	if (begin_data->list_data != end_data->list_data ||
+		dst_data->list_data == begin_data->list_data) {
+		return DT_LIST_ETYPE;
+	}
+
+	if (src_begin->position > src_end->position) return DT_LIST_EINDEX;
+
+	size_t count = src_end->position - src_begin->position;
+	if (!count) return 0;
+
+	int error = chain_move(dst_data->list_data, dst_data->last_node,
+		begin_data->list_data, iterator_node(src_begin),
+		end_data->last_node, count);
+	if (error) return error;
+
+	// src_begin already points at what followed the range.
+	*end_data = *begin_data;
+	src_end->position = src_begin->position;
+
+	return 0;
+}
+
+int dt_list_linked_concat(struct dt_list * dst, struct dt_list * src)
+{
+	if (dst->get != &list_get || src->get != &list_get) {
+		return DT_LIST_ETYPE;
+	}
+
+	return dt_list_linked_splice(dst, dst->length(dst),
+		src, 0, src->length(src));
+}
+
+struct dt_list * dt_list_linked_split_at(struct dt_list * list,
+	size_t index)
+{
+	if (list->get != &list_get) return NULL;
+
+	struct list_implementation * data = list->_data;
+	if (index > data->length) return NULL;
+
+	struct dt_list * rest;
+	if (data->owns_pool) {
+		rest = dt_list_linked_pooled_new(NULL);
+	} else {
+		rest = linked_new(data->pool, false, data->allocator);
+	}
+
+	if (!rest) return NULL;
+
+	if (dt_list_linked_splice(rest, 0, list, index, data->length)) {
+		rest->del(rest);
 		return NULL;
 	}
+
+	return rest;
+}
+
+static struct dt_list * linked_new(struct dt_pool * pool, bool owns_pool,
+	const struct dt_allocator * allocator)
+{
+	struct linked_list * linked = NULL;
+	linked = dt_allocator_alloc(allocator, sizeof(*linked));
+	if (!linked) return NULL;
+	struct dt_list * list = &linked->list;
+	struct list_implementation * implementation = &linked->implementation;
 	list->get = &list_get;
 	list->insert = &list_insert;
 	list->remove = &list_remove;
+	list->insert_range = &list_insert_range;
+	list->remove_range = &list_remove_range;
+	list->append_many = &list_append_many;
 	list->length = &list_length;
 	list->iterator = &list_iterator;
+	list->iterator_init = &list_iterator_init;
 	list->del = &list_del;
 
 	list->_data = implementation;
 
 	implementation->head = NULL;
+	implementation->tail = NULL;
 	implementation->length = 0;
+	implementation->finger = NULL;
+	implementation->finger_index = 0;
+	implementation->pool = pool;
+	implementation->owns_pool = owns_pool;
+	implementation->allocator = allocator;
 
 	return list;
 }
@@ -99,7 +410,8 @@ static void * list_get(const struct dt_list * this, size_t index)
 {
 	struct list_implementation * data = this->_data;
 	if (this->length(this) <= index) return NULL;
-	return node_at(data->head, index)->data;
+	// Moves the finger, so readers are not thread safe.
+	return find_node(data, index)->data;
 }
 
 
@@ -107,15 +419,14 @@ static int list_insert(struct dt_list * this, size_t index, void * item)
 {
 	if (index > this->length(this)) return DT_LIST_EINDEX;
 
-	struct list_node * node = NULL;
-	node = malloc(sizeof(*node));
+	struct list_implementation * data = this->_data;
+	struct list_node * node = node_new(data);
 	if (!node) return DT_LIST_ENOMEM;
 
 	node->data = item;
 
-	struct list_implementation * data = this->_data;
 	if (index > 0) {
-		struct list_node * node_before = node_at(data->head, index - 1);
+		struct list_node * node_before = find_node(data, index - 1);
 		struct list_node * node_after = node_before->next;
 		
 		node->next = node_after;
@@ -131,7 +442,10 @@ static int list_insert(struct dt_list * this, size_t index, void * item)
 		data->head = node;
 	}
 
+	if (!node->next) data->tail = node;
+
 	data->length += 1;
+	set_finger(data, NULL, node, index);
 
 	return 0;
 }
@@ -139,13 +453,13 @@ static int list_insert(struct dt_list * this, size_t index, void * item)
 
 static int list_remove(struct dt_list * this, size_t index)
 {
-	if (index > this->length(this)) return DT_LIST_EINDEX;
+	if (index >= this->length(this)) return DT_LIST_EINDEX;
 
 	struct list_node * node = NULL;
 
 	struct list_implementation * data = this->_data;
 	if (index > 0) {
-		struct list_node * node_before = node_at(data->head, index - 1);
+		struct list_node * node_before = find_node(data, index - 1);
 		node = node_before->next;
 		struct list_node * node_after = node->next;
 		
@@ -158,14 +472,88 @@ static int list_remove(struct dt_list * this, size_t index)
 		if(node->next) node->next->previous = NULL;
 	}
 
-	free(node);
+	if (!node->next) data->tail = node->previous;
 
 	data->length -= 1;
+	set_finger(data, node->previous, node->next, index);
+
+	node_free(data, node);
 
 	return 0;
 }
 
 
+static int list_insert_range(struct dt_list * this, size_t index,
+	void * const * items, size_t count)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length) return DT_LIST_EINDEX;
+	if (!count) return 0;
+
+	struct list_node * first;
+	struct list_node * last;
+	first = chain_new(data, items, count, &last);
+	if (!first) return DT_LIST_ENOMEM;
+
+	struct list_node * * link = &(data->head);
+	struct list_node * node_before = NULL;
+	if (index > 0) {
+		node_before = find_node(data, index - 1);
+		link = &(node_before->next);
+	}
+
+	last->next = *link;
+	if (last->next) last->next->previous = last;
+	first->previous = node_before;
+	*link = first;
+
+	if (!last->next) data->tail = last;
+
+	data->length += count;
+	set_finger(data, NULL, first, index);
+
+	return 0;
+}
+
+static int list_remove_range(struct dt_list * this, size_t index,
+	size_t count)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length || count > data->length - index)
+		return DT_LIST_EINDEX;
+	if (!count) return 0;
+
+	struct list_node * * link = &(data->head);
+	struct list_node * node_before = NULL;
+	if (index > 0) {
+		node_before = find_node(data, index - 1);
+		link = &(node_before->next);
+	}
+
+	struct list_node * node = *link;
+	for (size_t i = 0; i < count; i++) {
+		struct list_node * del_me = node;
+		node = node->next;
+		node_free(data, del_me);
+	}
+
+	*link = node;
+	if (node) node->previous = node_before;
+	if (!node) data->tail = node_before;
+
+	data->length -= count;
+	set_finger(data, node_before, node, index);
+
+	return 0;
+}
+
+static int list_append_many(struct dt_list * this,
+	void * const * items, size_t count)
+{
+	struct list_implementation * data = this->_data;
+	return list_insert_range(this, data->length, items, count);
+}
+
 static size_t list_length(const struct dt_list * this)
 {
 	struct list_implementation * data = this->_data;
@@ -176,49 +564,61 @@ static size_t list_length(const struct dt_list * this)
 static struct dt_list_iterator * list_iterator(struct dt_list * this)
 {
 	struct list_implementation * data = this->_data;
-
 	struct dt_list_iterator * iterator = NULL;
-	iterator = malloc(sizeof(*iterator));
+	iterator = dt_allocator_alloc(data->allocator, sizeof(*iterator));
 	if (!iterator) return NULL;
-	struct iterator_implementation * implementation;
-	implementation = malloc(sizeof(*implementation));
-	if (!implementation){
-		free(iterator);
-		return NULL;
-	}
 
-	iterator->get = &iterator_get;
-	iterator->valid = &iterator_valid;
-	iterator->next = &iterator_next;
-	iterator->previous = &iterator_previous;
-	iterator->insert = &iterator_insert;
-	iterator->remove = &iterator_remove;
+	list_iterator_init(this, iterator);
 	iterator->del = &iterator_del;
-	
-	iterator->list = this;
-	iterator->position = 0;
+	return iterator;
+}
+
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage)
+{
+	struct list_implementation * data = this->_data;
+	struct iterator_implementation * implementation =
+		(struct iterator_implementation *) storage->_state;
 
-	iterator->_data = implementation;
+	storage->get = &iterator_get;
+	storage->valid = &iterator_valid;
+	storage->next = &iterator_next;
+	storage->previous = &iterator_previous;
+	storage->insert = &iterator_insert;
+	storage->remove = &iterator_remove;
+	storage->del = &iterator_dispose;
 
+	storage->list = this;
+	storage->position = 0;
+
+	storage->_data = implementation;
+
+	implementation->list_data = data;
 	implementation->last_node_pointer = &(data->head);
 	implementation->last_node = NULL;
 
-	return iterator;
+	return storage;
 }
 
 static void list_del(struct dt_list * this)
 {
 	struct list_implementation * data = this->_data;
 
+	if (data->owns_pool) {
+		// Every node is in the pool.
+		dt_pool_del(data->pool);
+		dt_allocator_free(data->allocator, this, sizeof(struct linked_list));
+		return;
+	}
+
 	struct list_node * node = data->head;
 
 	while(node){
-		void * del_me = node;
+		struct list_node * del_me = node;
 		node = node->next;
-		free(del_me);
+		node_free(data, del_me);
 	}
-	free(this->_data);
-	free(this);
+	dt_allocator_free(data->allocator, this, sizeof(struct linked_list));
 }
 
 // Iterator functions
@@ -260,7 +660,7 @@ static int iterator_previous(struct dt_list_iterator * this)
 	// it easy to become a singlely linked list.
 	
 	struct iterator_implementation * data = this->_data;
-	struct list_implementation * list_data = this->list->_data;
+	struct list_implementation * list_data = data->list_data;
 	struct list_node * current = iterator_node(this);
 
 	if (!current) {
@@ -291,8 +691,7 @@ static int iterator_insert(struct dt_list_iterator * this, void * item)
 	struct iterator_implementation * data = this->_data;
 	struct list_node * current = iterator_node(this);
 	
-	struct list_node * node = NULL;
-	node = malloc(sizeof(*node));
+	struct list_node * node = node_new(data->list_data);
 	if (!node) return DT_LIST_ENOMEM;
 
 	node->data = item;
@@ -304,8 +703,10 @@ static int iterator_insert(struct dt_list_iterator * this, void * item)
 	if(node->next) node->next->previous = node;
 
 
-	struct list_implementation * list_data = this->list->_data;
+	struct list_implementation * list_data = data->list_data;
+	if (!node->next) list_data->tail = node;
 	list_data->length += 1;
+	set_finger(list_data, NULL, node, this->position);
 
 	return 0;
 }
@@ -320,29 +721,228 @@ static int iterator_remove(struct dt_list_iterator * this)
 	if (current->next) current->next->previous = current->previous;
 	*(data->last_node_pointer) = current->next;
 
-	struct list_implementation * list_data = this->list->_data;
+	struct list_implementation * list_data = data->list_data;
+	if (!current->next) list_data->tail = current->previous;
 	list_data->length -= 1;
+	set_finger(list_data, current->previous, current->next,
+		this->position);
 
-	free(current);
+	node_free(list_data, current);
 
 	return 0;
 }
 
 static void iterator_del(struct dt_list_iterator * this)
 {
-	free(this->_data);
-	free(this);
+	struct iterator_implementation * data = this->_data;
+	dt_allocator_free(data->list_data->allocator, this, sizeof(*this));
+}
+
+static void iterator_dispose(struct dt_list_iterator * this)
+{
 }
 
 // Internal functions
-static struct list_node * node_at(struct list_node * node, size_t distance)
+static struct list_node * find_node(struct list_implementation * data,
+	size_t index)
 {
-	for (size_t i = distance; i > 0; i--) {
-		node = node->next;
+	struct list_node * node = data->head;
+	size_t at = 0;
+	size_t distance = index;
+
+	if (data->length - 1 - index < distance) {
+		node = data->tail;
+		at = data->length - 1;
+		distance = at - index;
 	}
+
+	if (data->finger) {
+		size_t finger_distance = index > data->finger_index ?
+			index - data->finger_index :
+			data->finger_index - index;
+
+		if (finger_distance < distance) {
+			node = data->finger;
+			at = data->finger_index;
+		}
+	}
+
+	for (; at < index; at++) node = node->next;
+	for (; at > index; at--) node = node->previous;
+
+	data->finger = node;
+	data->finger_index = index;
 	return node;
 }
 
+static void set_finger(struct list_implementation * data,
+	struct list_node * before, struct list_node * after, size_t index)
+{
+	if (after) {
+		data->finger = after;
+		data->finger_index = index;
+	} else if (before) {
+		data->finger = before;
+		data->finger_index = index - 1;
+	} else {
+		data->finger = NULL;
+	}
+}
+
+static struct list_node * node_new(struct list_implementation * data)
+{
+	if (data->pool) return dt_pool_alloc(data->pool);
+	return dt_allocator_alloc(data->allocator, sizeof(struct list_node));
+}
+
+static void node_free(struct list_implementation * data,
+	struct list_node * node)
+{
+	if (data->pool) {
+		dt_pool_free(data->pool, node);
+	} else {
+		dt_allocator_free(data->allocator, node, sizeof(*node));
+	}
+}
+
+static struct list_node * chain_new(struct list_implementation * data,
+	void * const * items, size_t count, struct list_node ** last)
+{
+	struct list_node * first = NULL;
+	struct list_node * previous = NULL;
+
+	for (size_t i = 0; i < count; i++) {
+		struct list_node * node = node_new(data);
+
+		if (!node) {
+			while (first) {
+				struct list_node * del_me = first;
+				first = first->next;
+				node_free(data, del_me);
+			}
+			return NULL;
+		}
+
+		node->data = items[i];
+		node->next = NULL;
+		node->previous = previous;
+
+		if (previous) {
+			previous->next = node;
+		} else {
+			first = node;
+		}
+		previous = node;
+	}
+
+	*last = previous;
+	return first;
+}
+
+static struct list_node * chain_copy(struct list_implementation * data,
+	struct list_node * from, size_t count, struct list_node ** last)
+{
+	struct list_node * first = NULL;
+	struct list_node * previous = NULL;
+
+	for (size_t i = 0; i < count; i++, from = from->next) {
+		struct list_node * node = node_new(data);
+
+		if (!node) {
+			while (first) {
+				struct list_node * del_me = first;
+				first = first->next;
+				node_free(data, del_me);
+			}
+			return NULL;
+		}
+
+		node->data = from->data;
+		node->next = NULL;
+		node->previous = previous;
+
+		if (previous) {
+			previous->next = node;
+		} else {
+			first = node;
+		}
+		previous = node;
+	}
+
+	*last = previous;
+	return first;
+}
+
+static void chain_detach(struct list_implementation * data,
+	struct list_node * first, struct list_node * last, size_t count)
+{
+	struct list_node * before = first->previous;
+	struct list_node * after = last->next;
+
+	if (before) {
+		before->next = after;
+	} else {
+		data->head = after;
+	}
+
+	if (after) {
+		after->previous = before;
+	} else {
+		data->tail = before;
+	}
+
+	data->length -= count;
+	data->finger = NULL;
+}
+
+static void chain_attach(struct list_implementation * data,
+	struct list_node * before, struct list_node * first,
+	struct list_node * last, size_t count)
+{
+	struct list_node ** link = before ? &(before->next) : &(data->head);
+	struct list_node * after = *link;
+
+	first->previous = before;
+	last->next = after;
+	*link = first;
+
+	if (after) {
+		after->previous = last;
+	} else {
+		data->tail = last;
+	}
+
+	data->length += count;
+	data->finger = NULL;
+}
+
+static int chain_move(struct list_implementation * dst,
+	struct list_node * before, struct list_implementation * src,
+	struct list_node * first, struct list_node * last, size_t count)
+{
+	if (dst->pool == src->pool &&
+		(dst->pool || dst->allocator == src->allocator)) {
+		chain_detach(src, first, last, count);
+		chain_attach(dst, before, first, last, count);
+		return 0;
+	}
+
+	struct list_node * copy_last;
+	struct list_node * copy = chain_copy(dst, first, count, &copy_last);
+	if (!copy) return DT_LIST_ENOMEM;
+
+	chain_detach(src, first, last, count);
+	chain_attach(dst, before, copy, copy_last, count);
+
+	for (size_t i = 0; i < count; i++) {
+		struct list_node * del_me = first;
+		first = first->next;
+		node_free(src, del_me);
+	}
+
+	return 0;
+}
+
 static struct list_node * iterator_node
 	(const struct dt_list_iterator * iterator)
 {
@@ -350,3 +950,11 @@ static struct list_node * iterator_node
 	return *(data->last_node_pointer);
 }
 
+static bool iterator_editable(const struct dt_list_iterator * iterator)
+{
+	// Read only wrappers reuse iterator_get but drop the
+	// edits and swap in their own list.
+	return iterator->get == &iterator_get &&
+		iterator->insert && iterator->remove &&
+		iterator->list->get == &list_get;
+}
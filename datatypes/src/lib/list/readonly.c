@@ -1,115 +1,115 @@
 #include "list/readonly.h"
 
-#include <stdlib.h>
+#include "allocator.h"
+
+struct list_implementation;
+struct readonly_list;
+
+struct list_implementation {
+	struct dt_list * list;
+	// Where the list and its iterators come from.
+	const struct dt_allocator * allocator;
+};
+
+// The list and its implementation share one allocation.
+struct readonly_list {
+	struct dt_list list;
+	struct list_implementation implementation;
+};
 
 // List functions
 static void * list_get(const struct dt_list * this, size_t index);
 static size_t list_length(const struct dt_list * this);
 static struct dt_list_iterator * list_iterator(struct dt_list * this);
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage);
 static void list_del(struct dt_list * this);
 
 // Iterator functions
-static void * iterator_get(const struct dt_list_iterator * this);
-static int iterator_valid(const struct dt_list_iterator * this);
-static int iterator_next(struct dt_list_iterator * this);
-static int iterator_previous(struct dt_list_iterator * this);
 static void iterator_del(struct dt_list_iterator * this);
 
 struct dt_list * dt_list_readonly_new(struct dt_list * list) {
-	struct dt_list * read_list;
-	read_list = malloc(sizeof(*read_list));
+	return dt_list_readonly_new_with_allocator(list, NULL);
+}
+
+struct dt_list * dt_list_readonly_new_with_allocator(struct dt_list * list,
+	const struct dt_allocator * allocator)
+{
+	struct readonly_list * readonly;
+	readonly = dt_allocator_alloc(allocator, sizeof(*readonly));
 
-	if (!read_list) return NULL;
+	if (!readonly) return NULL;
+
+	struct dt_list * read_list = &readonly->list;
+	struct list_implementation * implementation = &readonly->implementation;
+
+	implementation->list = list;
+	implementation->allocator = allocator;
 
 	read_list->get = &list_get;
 	read_list->insert = NULL;
 	read_list->remove = NULL;
+	read_list->insert_range = NULL;
+	read_list->remove_range = NULL;
+	read_list->append_many = NULL;
 	read_list->length = &list_length;
 	read_list->iterator = &list_iterator;
+	read_list->iterator_init = &list_iterator_init;
 	read_list->del = &list_del;
-	read_list->_data = list;
+	read_list->_data = implementation;
 
 	return read_list;
 }
 
 static void * list_get(const struct dt_list * this, size_t index)
 {
-	const struct dt_list * data = this->_data;
-	return data->get(data, index);
+	const struct list_implementation * data = this->_data;
+	return data->list->get(data->list, index);
 }
 
 static size_t list_length(const struct dt_list * this)
 {
-	const struct dt_list * data = this->_data;
-	return data->length(data);
+	const struct list_implementation * data = this->_data;
+	return data->list->length(data->list);
 }
 
 static struct dt_list_iterator * list_iterator(struct dt_list * this)
 {
-	struct dt_list * data = this->_data;
-
+	struct list_implementation * data = this->_data;
 	struct dt_list_iterator * iterator;
-	iterator = malloc(sizeof(*iterator));
+	iterator = dt_allocator_alloc(data->allocator, sizeof(*iterator));
 
 	if (!iterator) return NULL;
 
-	iterator->get = &iterator_get;
-	iterator->valid = &iterator_valid;
-	iterator->next = &iterator_next;
-	iterator->previous = &iterator_previous;
-	iterator->insert = NULL;
-	iterator->remove = NULL;
+	list_iterator_init(this, iterator);
 	iterator->del = &iterator_del;
-
-	iterator->position = 0;
-	iterator->list = this;
-	iterator->_data = data->iterator(data);
-
-	if (!iterator->_data) {
-		free(iterator);
-		return NULL;
-	}
-
 	return iterator;
 }
 
-static void list_del(struct dt_list * this)
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage)
 {
-	free(this);
-}
+	struct list_implementation * data = this->_data;
 
+	// The wrapped list's iterator keeps all its state in
+	// storage so it can be used as is, less the edits.
+	data->list->iterator_init(data->list, storage);
 
-static void * iterator_get(const struct dt_list_iterator * this)
-{
-	const struct dt_list_iterator * data = this->_data;
-	return data->get(data);
-}
-
-static int iterator_valid(const struct dt_list_iterator * this)
-{
-	const struct dt_list_iterator * data = this->_data;
-	return data->valid(data);
+	storage->insert = NULL;
+	storage->remove = NULL;
+	storage->list = this;
+	return storage;
 }
 
-static int iterator_next(struct dt_list_iterator * this)
+static void list_del(struct dt_list * this)
 {
-	struct dt_list_iterator * data = this->_data;
-	int next = data->next(data);
-	this->position = data->position;
-	return next;
+	struct list_implementation * data = this->_data;
+	dt_allocator_free(data->allocator, this, sizeof(struct readonly_list));
 }
 
-static int iterator_previous(struct dt_list_iterator * this)
-{
-	struct dt_list_iterator * data = this->_data;
-	int previous = data->previous(data);
-	this->position = data->position;
-	return previous;
-}
 
 static void iterator_del(struct dt_list_iterator * this)
 {
-	struct dt_list_iterator * data = this->_data;
-	data->del(data);
-	free(this);
+	struct list_implementation * data = this->list->_data;
+	dt_allocator_free(data->allocator, this, sizeof(*this));
 }
@@ -0,0 +1,517 @@
+#include "list/skip.h"
+
+#include "list/error.h"
+
+#include <stdlib.h>
+
+// The most levels a node can have. With a quarter of the
+// nodes moving up a level this covers far more items
+// than fit in memory.
+#define MAXIMUM_LEVEL 32
+
+struct list_implementation;
+struct iterator_implementation;
+struct skip_list;
+struct skip_node;
+struct skip_link;
+
+// A forward link and the number of positions it skips.
+// A link to NULL spans to the end of the list.
+struct skip_link {
+	struct skip_node * next;
+	size_t span;
+};
+
+struct skip_node {
+	void * data;
+	struct skip_node * previous;
+	struct skip_link links[];
+};
+
+// The head is a node with every level that holds no item.
+// It sits at rank zero so the item at index i has rank i + 1.
+struct list_implementation {
+	struct skip_node * head;
+	struct skip_node * tail;
+	size_t level;
+	size_t length;
+	unsigned long random_state;
+};
+
+// The list and its implementation share one allocation.
+struct skip_list {
+	struct dt_list list;
+	struct list_implementation implementation;
+};
+
+// Kept in the iterator's _state.
+struct iterator_implementation {
+	struct list_implementation * list_data;
+	// NULL when past the end.
+	struct skip_node * node;
+};
+
+_Static_assert(
+	sizeof(struct iterator_implementation) <=
+		sizeof(((struct dt_list_iterator *) 0)->_state),
+	"iterator_implementation does not fit in an iterator");
+
+// List functions
+static void * list_get(const struct dt_list * this, size_t index);
+static int list_insert(struct dt_list * this, size_t index, void * item);
+static int list_remove(struct dt_list * this, size_t index);
+static int list_insert_range(struct dt_list * this, size_t index,
+	void * const * items, size_t count);
+static int list_remove_range(struct dt_list * this, size_t index,
+	size_t count);
+static int list_append_many(struct dt_list * this,
+	void * const * items, size_t count);
+static size_t list_length(const struct dt_list * this);
+static struct dt_list_iterator * list_iterator(struct dt_list * this);
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage);
+static void list_del(struct dt_list * this);
+
+// Iterator functions
+static void * iterator_get(const struct dt_list_iterator * this);
+static int iterator_valid(const struct dt_list_iterator * this);
+static int iterator_next(struct dt_list_iterator * this);
+static int iterator_previous(struct dt_list_iterator * this);
+static int iterator_insert(struct dt_list_iterator * this, void * item);
+static int iterator_remove(struct dt_list_iterator * this);
+static void iterator_del(struct dt_list_iterator * this);
+static void iterator_dispose(struct dt_list_iterator * this);
+
+// Internal functions
+/** Allocates a node.
+ *
+ *  Arguments:
+ *    level: The number of links the node has.
+ *
+ *  Returns:
+ *    A new node. Or NULL if there is not enough memory.
+ */
+static struct skip_node * node_new(size_t level);
+
+/** Picks the level for a new node.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *
+ *  Returns:
+ *    A level in [1, MAXIMUM_LEVEL].
+ */
+static size_t random_level(struct list_implementation * data);
+
+/** Finds the node at an index.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    index: The index of the node, less than the length.
+ *
+ *  Returns:
+ *    The node at index.
+ */
+static struct skip_node * find_node(const struct list_implementation * data,
+	size_t index);
+
+/** Finds the last node on each level before an index.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    index: The index to stop before.
+ *    update: A result variable. The node on each level.
+ *    rank: A result variable. The rank of each node in update.
+ */
+static void find_before(const struct list_implementation * data,
+	size_t index, struct skip_node ** update, size_t * rank);
+
+/** Inserts an item at an index.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    index: The index to insert at, at most the length.
+ *    item: The item to insert.
+ *
+ *  Returns:
+ *    The new node. Or NULL if there is not enough memory.
+ */
+static struct skip_node * insert_at(struct list_implementation * data,
+	size_t index, void * item);
+
+/** Removes the item at an index.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    index: The index to remove, less than the length.
+ */
+static void remove_at(struct list_implementation * data, size_t index);
+
+struct dt_list * dt_list_skip_new(void) {
+	struct skip_list * skip;
+	skip = malloc(sizeof(*skip));
+
+	if (!skip) return NULL;
+
+	struct dt_list * list = &skip->list;
+	struct list_implementation * implementation = &skip->implementation;
+
+	implementation->head = node_new(MAXIMUM_LEVEL);
+
+	if (!implementation->head) {
+		free(skip);
+		return NULL;
+	}
+
+	implementation->head->data = NULL;
+	implementation->head->previous = NULL;
+	for (size_t i = 0; i < MAXIMUM_LEVEL; i++) {
+		implementation->head->links[i].next = NULL;
+		implementation->head->links[i].span = 0;
+	}
+
+	implementation->tail = NULL;
+	implementation->level = 1;
+	implementation->length = 0;
+	implementation->random_state = 88172645463325252ul;
+
+	list->_data = implementation;
+
+	list->get = &list_get;
+	list->insert = &list_insert;
+	list->remove = &list_remove;
+	list->insert_range = &list_insert_range;
+	list->remove_range = &list_remove_range;
+	list->append_many = &list_append_many;
+	list->length = &list_length;
+	list->iterator = &list_iterator;
+	list->iterator_init = &list_iterator_init;
+	list->del = &list_del;
+
+	return list;
+}
+
+static void * list_get(const struct dt_list * this, size_t index)
+{
+	const struct list_implementation * data = this->_data;
+	if (index >= data->length) return NULL;
+	return find_node(data, index)->data;
+}
+
+static int list_insert(struct dt_list * this, size_t index, void * item)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length) return DT_LIST_EINDEX;
+	if (!insert_at(data, index, item)) return DT_LIST_ENOMEM;
+	return 0;
+}
+
+static int list_remove(struct dt_list * this, size_t index)
+{
+	struct list_implementation * data = this->_data;
+	if (index >= data->length) return DT_LIST_EINDEX;
+	remove_at(data, index);
+	return 0;
+}
+
+static int list_insert_range(struct dt_list * this, size_t index,
+	void * const * items, size_t count)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length) return DT_LIST_EINDEX;
+
+	for (size_t i = 0; i < count; i++) {
+		if (!insert_at(data, index + i, items[i])) {
+			// Take back what went in so the list is unchanged.
+			for (; i > 0; i--) {
+				remove_at(data, index);
+			}
+			return DT_LIST_ENOMEM;
+		}
+	}
+
+	return 0;
+}
+
+static int list_remove_range(struct dt_list * this, size_t index,
+	size_t count)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length || count > data->length - index)
+		return DT_LIST_EINDEX;
+
+	for (size_t i = 0; i < count; i++) {
+		remove_at(data, index);
+	}
+
+	return 0;
+}
+
+static int list_append_many(struct dt_list * this,
+	void * const * items, size_t count)
+{
+	struct list_implementation * data = this->_data;
+	return list_insert_range(this, data->length, items, count);
+}
+
+static size_t list_length(const struct dt_list * this)
+{
+	const struct list_implementation * data = this->_data;
+	return data->length;
+}
+
+static struct dt_list_iterator * list_iterator(struct dt_list * this)
+{
+	struct dt_list_iterator * iterator;
+	iterator = malloc(sizeof(*iterator));
+
+	if (!iterator) return NULL;
+
+	list_iterator_init(this, iterator);
+	iterator->del = &iterator_del;
+	return iterator;
+}
+
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage)
+{
+	struct list_implementation * data = this->_data;
+	struct iterator_implementation * implementation =
+		(struct iterator_implementation *) storage->_state;
+
+	storage->get = &iterator_get;
+	storage->valid = &iterator_valid;
+	storage->next = &iterator_next;
+	storage->previous = &iterator_previous;
+	storage->insert = &iterator_insert;
+	storage->remove = &iterator_remove;
+	storage->del = &iterator_dispose;
+
+	storage->position = 0;
+	storage->list = this;
+	storage->_data = implementation;
+
+	implementation->list_data = data;
+	implementation->node = data->head->links[0].next;
+	return storage;
+}
+
+static void list_del(struct dt_list * this)
+{
+	struct list_implementation * data = this->_data;
+	struct skip_node * node = data->head;
+
+	while (node) {
+		struct skip_node * del_me = node;
+		node = node->links[0].next;
+		free(del_me);
+	}
+
+	free(this);
+}
+
+
+static void * iterator_get(const struct dt_list_iterator * this)
+{
+	const struct iterator_implementation * data = this->_data;
+	if (!data->node) return NULL;
+	return data->node->data;
+}
+
+static int iterator_valid(const struct dt_list_iterator * this)
+{
+	const struct iterator_implementation * data = this->_data;
+	return data->node != NULL;
+}
+
+static int iterator_next(struct dt_list_iterator * this)
+{
+	struct iterator_implementation * data = this->_data;
+	if (!data->node) return DT_LIST_EINDEX;
+
+	data->node = data->node->links[0].next;
+	this->position++;
+
+	if (!data->node) return DT_LIST_EINDEX;
+	return 0;
+}
+
+static int iterator_previous(struct dt_list_iterator * this)
+{
+	struct iterator_implementation * data = this->_data;
+	if (this->position <= 0) return DT_LIST_EINDEX;
+
+	if (data->node) {
+		data->node = data->node->previous;
+	} else {
+		data->node = data->list_data->tail;
+	}
+	this->position--;
+	return 0;
+}
+
+static int iterator_insert(struct dt_list_iterator * this, void * item)
+{
+	struct iterator_implementation * data = this->_data;
+	struct skip_node * node = insert_at(data->list_data, this->position, item);
+	if (!node) return DT_LIST_ENOMEM;
+
+	data->node = node;
+	return 0;
+}
+
+static int iterator_remove(struct dt_list_iterator * this)
+{
+	struct iterator_implementation * data = this->_data;
+	if (!data->node) return DT_LIST_EINDEX;
+
+	struct skip_node * next = data->node->links[0].next;
+	remove_at(data->list_data, this->position);
+
+	data->node = next;
+	return 0;
+}
+
+static void iterator_del(struct dt_list_iterator * this)
+{
+	free(this);
+}
+
+static void iterator_dispose(struct dt_list_iterator * this)
+{
+}
+
+static struct skip_node * node_new(size_t level)
+{
+	return malloc(sizeof(struct skip_node) +
+		level * sizeof(struct skip_link));
+}
+
+static size_t random_level(struct list_implementation * data)
+{
+	// xorshift64*, two bits per level.
+	unsigned long long x = data->random_state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	data->random_state = x;
+	x *= 2685821657736338717ull;
+
+	size_t level = 1;
+	while (level < MAXIMUM_LEVEL && (x & 3) == 0) {
+		level++;
+		x >>= 2;
+	}
+	return level;
+}
+
+static struct skip_node * find_node(const struct list_implementation * data,
+	size_t index)
+{
+	struct skip_node * node = data->head;
+	size_t rank = 0;
+
+	for (size_t i = data->level; i > 0; i--) {
+		while (node->links[i - 1].next &&
+			rank + node->links[i - 1].span <= index + 1) {
+			rank += node->links[i - 1].span;
+			node = node->links[i - 1].next;
+		}
+		if (rank == index + 1) return node;
+	}
+
+	return node;
+}
+
+static void find_before(const struct list_implementation * data,
+	size_t index, struct skip_node ** update, size_t * rank)
+{
+	struct skip_node * node = data->head;
+	size_t traversed = 0;
+
+	for (size_t i = data->level; i > 0; i--) {
+		while (node->links[i - 1].next &&
+			traversed + node->links[i - 1].span <= index) {
+			traversed += node->links[i - 1].span;
+			node = node->links[i - 1].next;
+		}
+		update[i - 1] = node;
+		rank[i - 1] = traversed;
+	}
+}
+
+static struct skip_node * insert_at(struct list_implementation * data,
+	size_t index, void * item)
+{
+	struct skip_node * update[MAXIMUM_LEVEL];
+	size_t rank[MAXIMUM_LEVEL];
+	size_t level = random_level(data);
+
+	struct skip_node * node = node_new(level);
+	if (!node) return NULL;
+
+	find_before(data, index, update, rank);
+
+	for (size_t i = data->level; i < level; i++) {
+		update[i] = data->head;
+		rank[i] = 0;
+		data->head->links[i].next = NULL;
+		data->head->links[i].span = data->length;
+	}
+	if (level > data->level) data->level = level;
+
+	node->data = item;
+	for (size_t i = 0; i < level; i++) {
+		struct skip_link * link = &(update[i]->links[i]);
+		node->links[i].next = link->next;
+		node->links[i].span = link->span - (index - rank[i]);
+		link->next = node;
+		link->span = index - rank[i] + 1;
+	}
+
+	for (size_t i = level; i < data->level; i++) {
+		update[i]->links[i].span++;
+	}
+
+	node->previous = update[0] == data->head ? NULL : update[0];
+	if (node->links[0].next) {
+		node->links[0].next->previous = node;
+	} else {
+		data->tail = node;
+	}
+
+	data->length++;
+	return node;
+}
+
+static void remove_at(struct list_implementation * data, size_t index)
+{
+	struct skip_node * update[MAXIMUM_LEVEL];
+	size_t rank[MAXIMUM_LEVEL];
+
+	find_before(data, index, update, rank);
+	struct skip_node * node = update[0]->links[0].next;
+
+	for (size_t i = 0; i < data->level; i++) {
+		struct skip_link * link = &(update[i]->links[i]);
+		if (link->next == node) {
+			link->span += node->links[i].span - 1;
+			link->next = node->links[i].next;
+		} else {
+			link->span--;
+		}
+	}
+
+	if (node->links[0].next) {
+		node->links[0].next->previous = node->previous;
+	} else {
+		data->tail = node->previous;
+	}
+
+	while (data->level > 1 && !data->head->links[data->level - 1].next) {
+		data->level--;
+	}
+
+	data->length--;
+	free(node);
+}
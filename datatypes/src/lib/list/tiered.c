@@ -0,0 +1,816 @@
+#include "list/tiered.h"
+
+#include "list/error.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "buffers.h"
+
+// The number of items in a chunk.
+// It must be a power of two.
+//
+// Inserting costs about CHUNK_LENGTH / 2 moves inside a chunk
+// plus one move per chunk after it, so this is picked to suit
+// lists of a few million items.
+#define CHUNK_LENGTH 2048
+
+struct list_implementation;
+struct tiered_list;
+struct list_chunk;
+
+// A circular buffer of items. Every chunk but the last is full.
+struct list_chunk {
+	size_t head;
+	void * slots[CHUNK_LENGTH];
+};
+
+struct list_implementation {
+	struct list_chunk ** chunks;
+	size_t chunks_size;
+	size_t chunk_count;
+	// Kept around so going back and forth over a chunk
+	// boundary does not allocate every time.
+	struct list_chunk * spare;
+	size_t length;
+};
+
+// The list and its implementation share one allocation.
+struct tiered_list {
+	struct dt_list list;
+	struct list_implementation implementation;
+};
+
+// List functions
+static void * list_get(const struct dt_list * this, size_t index);
+static int list_insert(struct dt_list * this, size_t index, void * item);
+static int list_remove(struct dt_list * this, size_t index);
+static int list_insert_range(struct dt_list * this, size_t index,
+	void * const * items, size_t count);
+static int list_remove_range(struct dt_list * this, size_t index,
+	size_t count);
+static int list_append_many(struct dt_list * this,
+	void * const * items, size_t count);
+static size_t list_length(const struct dt_list * this);
+static struct dt_list_iterator * list_iterator(struct dt_list * this);
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage);
+static void list_del(struct dt_list * this);
+
+// Iterator functions
+static void * iterator_get(const struct dt_list_iterator * this);
+static int iterator_valid(const struct dt_list_iterator * this);
+static int iterator_next(struct dt_list_iterator * this);
+static int iterator_previous(struct dt_list_iterator * this);
+static int iterator_insert(struct dt_list_iterator * this, void * item);
+static int iterator_remove(struct dt_list_iterator * this);
+static void iterator_del(struct dt_list_iterator * this);
+static void iterator_dispose(struct dt_list_iterator * this);
+
+// Internal functions
+/** Finds the slot for an offset in a chunk.
+ *
+ *  Arguments:
+ *    chunk: The chunk.
+ *    offset: The offset from the head of the chunk.
+ *
+ *  Returns:
+ *    A pointer to the slot.
+ */
+static void ** chunk_slot(struct list_chunk * chunk, size_t offset);
+
+/** Finds the slot for an index in the list.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    index: The index [0, length).
+ *
+ *  Returns:
+ *    A pointer to the slot.
+ */
+static void ** slot(const struct list_implementation * data, size_t index);
+
+/** Moves a run of items to another place in a chunk.
+ *
+ *  Arguments:
+ *    chunk: The chunk.
+ *    to: The offset to move the run to.
+ *    from: The offset the run starts at.
+ *    count: The number of items in the run.
+ *
+ *  Notes:
+ *    The runs may overlap.
+ */
+static void chunk_move(struct list_chunk * chunk,
+	size_t to, size_t from, size_t count);
+
+/** Makes sure there are enough chunks for length items.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    length: The number of items that must fit.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise.
+ *
+ *  Notes:
+ *    Nothing is changed on failure.
+ */
+static int grow(struct list_implementation * data, size_t length);
+
+/** Releases chunks that are no longer needed for the length.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ */
+static void shrink(struct list_implementation * data);
+
+/** Reverses the chunks in [begin, end) of the chunk array.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    begin: The first chunk.
+ *    end: One past the last chunk.
+ */
+static void reverse_chunks(struct list_implementation * data,
+	size_t begin, size_t end);
+
+/** Inserts fewer than CHUNK_LENGTH items.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    index: The index to insert at, before the last item.
+ *    items: The items to insert.
+ *    count: The number of items, less than CHUNK_LENGTH.
+ *
+ *  Notes:
+ *    There must already be chunks for the new length.
+ *    Shifts items within the chunk at index, then hands
+ *    count items across each following chunk boundary.
+ */
+static void insert_part(struct list_implementation * data, size_t index,
+	void * const * items, size_t count);
+
+/** Inserts whole chunks of items.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    index: The index to insert at, before the last item.
+ *    items: The items to insert.
+ *    chunks: The number of chunks of items to insert.
+ *
+ *  Notes:
+ *    The chunks are taken from the end of the chunk array,
+ *    past those the current length needs. The chunk at
+ *    index is split between the first and last of them.
+ */
+static void insert_chunks(struct list_implementation * data, size_t index,
+	void * const * items, size_t chunks);
+
+/** Removes fewer than CHUNK_LENGTH items.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    index: The index of the first item to remove.
+ *    count: The number of items, less than CHUNK_LENGTH.
+ *           At least one item must follow them.
+ *
+ *  Notes:
+ *    Closes the gap within the chunk at index, then pulls
+ *    count items back across each following chunk boundary.
+ */
+static void remove_part(struct list_implementation * data, size_t index,
+	size_t count);
+
+/** Removes whole chunks of items.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    index: The index of the first item to remove.
+ *    chunks: The number of chunks of items to remove.
+ *            At least one item must follow them.
+ *
+ *  Notes:
+ *    The emptied chunks are moved to the end of the chunk
+ *    array for shrink to release.
+ */
+static void remove_chunks(struct list_implementation * data, size_t index,
+	size_t chunks);
+
+struct dt_list * dt_list_tiered_new(void) {
+	struct tiered_list * tiered;
+	tiered = malloc(sizeof(*tiered));
+
+	if (!tiered) return NULL;
+
+	struct dt_list * list = &tiered->list;
+	struct list_implementation * implementation = &tiered->implementation;
+
+	implementation->chunks_size =
+		ARRAY_SIZE(implementation->chunks, 8);
+	implementation->chunk_count = 0;
+	implementation->spare = NULL;
+	implementation->length = 0;
+	implementation->chunks = malloc(implementation->chunks_size);
+
+	if (!implementation->chunks) {
+		free(tiered);
+		return NULL;
+	}
+
+	list->_data = implementation;
+
+	list->get = &list_get;
+	list->insert = &list_insert;
+	list->remove = &list_remove;
+	list->insert_range = &list_insert_range;
+	list->remove_range = &list_remove_range;
+	list->append_many = &list_append_many;
+	list->length = &list_length;
+	list->iterator = &list_iterator;
+	list->iterator_init = &list_iterator_init;
+	list->del = &list_del;
+
+	return list;
+}
+
+static void * list_get(const struct dt_list * this, size_t index)
+{
+	struct list_implementation * data = this->_data;
+	if (index >= data->length) return NULL;
+	return *slot(data, index);
+}
+
+static int list_insert(struct dt_list * this, size_t index, void * item)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length) return DT_LIST_EINDEX;
+
+	if (grow(data, data->length + 1)) return DT_LIST_ENOMEM;
+
+	size_t last = data->chunk_count - 1;
+	size_t chunk = index / CHUNK_LENGTH;
+
+	// Pass the last item of each full chunk on to the front
+	// of the next one to make room in the chunk being inserted to.
+	for (size_t i = last; i > chunk; i--) {
+		struct list_chunk * to = data->chunks[i];
+		struct list_chunk * from = data->chunks[i - 1];
+		to->head = (to->head - 1) & (CHUNK_LENGTH - 1);
+		to->slots[to->head] = *chunk_slot(from, CHUNK_LENGTH - 1);
+	}
+
+	struct list_chunk * target = data->chunks[chunk];
+	size_t used = chunk < last ?
+		CHUNK_LENGTH - 1 : data->length - last * CHUNK_LENGTH;
+	size_t offset = index % CHUNK_LENGTH;
+
+	if (offset < used - offset) {
+		target->head = (target->head - 1) & (CHUNK_LENGTH - 1);
+		chunk_move(target, 0, 1, offset);
+	} else {
+		chunk_move(target, offset + 1, offset, used - offset);
+	}
+	*chunk_slot(target, offset) = item;
+
+	data->length++;
+	return 0;
+}
+
+static int list_remove(struct dt_list * this, size_t index)
+{
+	struct list_implementation * data = this->_data;
+	if (index >= data->length) return DT_LIST_EINDEX;
+
+	size_t last = data->chunk_count - 1;
+	size_t chunk = index / CHUNK_LENGTH;
+
+	struct list_chunk * target = data->chunks[chunk];
+	size_t used = chunk < last ?
+		CHUNK_LENGTH : data->length - last * CHUNK_LENGTH;
+	size_t offset = index % CHUNK_LENGTH;
+
+	if (offset < used - offset - 1) {
+		chunk_move(target, 1, 0, offset);
+		target->head = (target->head + 1) & (CHUNK_LENGTH - 1);
+	} else {
+		chunk_move(target, offset, offset + 1, used - offset - 1);
+	}
+
+	// Pull the first item of each following chunk back to
+	// the end of the one before to fill the hole.
+	for (size_t i = chunk; i < last; i++) {
+		struct list_chunk * to = data->chunks[i];
+		struct list_chunk * from = data->chunks[i + 1];
+		*chunk_slot(to, CHUNK_LENGTH - 1) = from->slots[from->head];
+		from->head = (from->head + 1) & (CHUNK_LENGTH - 1);
+	}
+
+	data->length--;
+	shrink(data);
+	return 0;
+}
+
+static int list_insert_range(struct dt_list * this, size_t index,
+	void * const * items, size_t count)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length) return DT_LIST_EINDEX;
+
+	if (index == data->length) {
+		return list_append_many(this, items, count);
+	}
+
+	if (data->length + count < data->length) {
+		// Overflow
+		return DT_LIST_ENOMEM;
+	}
+
+	if (grow(data, data->length + count)) return DT_LIST_ENOMEM;
+
+	// The part goes in first, so the whole chunks go in
+	// ahead of it and the items keep their order.
+	size_t chunks = count / CHUNK_LENGTH;
+	size_t part = count % CHUNK_LENGTH;
+	if (part) {
+		insert_part(data, index, items + chunks * CHUNK_LENGTH, part);
+	}
+	if (chunks) insert_chunks(data, index, items, chunks);
+	return 0;
+}
+
+static int list_remove_range(struct dt_list * this, size_t index,
+	size_t count)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length || count > data->length - index)
+		return DT_LIST_EINDEX;
+
+	if (index + count == data->length) {
+		data->length = index;
+		shrink(data);
+		return 0;
+	}
+
+	size_t chunks = count / CHUNK_LENGTH;
+	size_t part = count % CHUNK_LENGTH;
+	if (chunks) remove_chunks(data, index, chunks);
+	if (part) remove_part(data, index, part);
+
+	shrink(data);
+	return 0;
+}
+
+static int list_append_many(struct dt_list * this,
+	void * const * items, size_t count)
+{
+	struct list_implementation * data = this->_data;
+
+	if (data->length + count < data->length) {
+		// Overflow
+		return DT_LIST_ENOMEM;
+	}
+
+	if (grow(data, data->length + count)) return DT_LIST_ENOMEM;
+
+	size_t done = 0;
+	while (done < count) {
+		size_t index = data->length + done;
+		struct list_chunk * chunk = data->chunks[index / CHUNK_LENGTH];
+		size_t offset = index % CHUNK_LENGTH;
+		size_t run = CHUNK_LENGTH - offset;
+		if (run > count - done) run = count - done;
+
+		for (size_t i = 0; i < run; i++) {
+			*chunk_slot(chunk, offset + i) = items[done + i];
+		}
+		done += run;
+	}
+
+	data->length += count;
+	return 0;
+}
+
+static size_t list_length(const struct dt_list * this)
+{
+	struct list_implementation * data = this->_data;
+	return data->length;
+}
+
+static struct dt_list_iterator * list_iterator(struct dt_list * this)
+{
+	struct dt_list_iterator * iterator;
+	iterator = malloc(sizeof(*iterator));
+
+	if (!iterator) return NULL;
+
+	list_iterator_init(this, iterator);
+	iterator->del = &iterator_del;
+	return iterator;
+}
+
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage)
+{
+	storage->get = &iterator_get;
+	storage->valid = &iterator_valid;
+	storage->next = &iterator_next;
+	storage->previous = &iterator_previous;
+	storage->insert = &iterator_insert;
+	storage->remove = &iterator_remove;
+	storage->del = &iterator_dispose;
+
+	storage->position = 0;
+	storage->list = this;
+	// The iterator works on this list even when
+	// storage->list is swapped for a wrapper.
+	storage->_data = this;
+	return storage;
+}
+
+static void list_del(struct dt_list * this)
+{
+	struct list_implementation * data = this->_data;
+	for (size_t i = 0; i < data->chunk_count; i++) {
+		free(data->chunks[i]);
+	}
+	free(data->spare);
+	free(data->chunks);
+	free(this);
+}
+
+
+static void * iterator_get(const struct dt_list_iterator * this)
+{
+	return list_get(this->_data, this->position);
+}
+
+static int iterator_valid(const struct dt_list_iterator * this)
+{
+	return this->position < list_length(this->_data);
+}
+
+static int iterator_next(struct dt_list_iterator * this)
+{
+	if (this->position >= list_length(this->_data))
+		return DT_LIST_EINDEX;
+
+	this->position++;
+
+	if (this->position == list_length(this->_data))
+		return DT_LIST_EINDEX;
+	return 0;
+}
+
+static int iterator_previous(struct dt_list_iterator * this)
+{
+	if (this->position <= 0) return DT_LIST_EINDEX;
+	this->position--;
+	return 0;
+}
+
+static int iterator_insert(struct dt_list_iterator * this, void * item)
+{
+	return list_insert(this->_data, this->position, item);
+}
+
+static int iterator_remove(struct dt_list_iterator * this)
+{
+	return list_remove(this->_data, this->position);
+}
+
+static void iterator_del(struct dt_list_iterator * this)
+{
+	free(this);
+}
+
+static void iterator_dispose(struct dt_list_iterator * this)
+{
+}
+
+static void ** chunk_slot(struct list_chunk * chunk, size_t offset)
+{
+	return chunk->slots + ((chunk->head + offset) & (CHUNK_LENGTH - 1));
+}
+
+static void ** slot(const struct list_implementation * data, size_t index)
+{
+	return chunk_slot(data->chunks[index / CHUNK_LENGTH],
+		index % CHUNK_LENGTH);
+}
+
+static void chunk_move(struct list_chunk * chunk,
+	size_t to, size_t from, size_t count)
+{
+	size_t mask = CHUNK_LENGTH - 1;
+
+	// Copy in the largest pieces that do not wrap, starting from
+	// the end the run is moving towards so nothing is overwritten
+	// before it is copied.
+	if (to < from) {
+		while (count) {
+			size_t source = (chunk->head + from) & mask;
+			size_t target = (chunk->head + to) & mask;
+			size_t run = count;
+			if (run > CHUNK_LENGTH - source) run = CHUNK_LENGTH - source;
+			if (run > CHUNK_LENGTH - target) run = CHUNK_LENGTH - target;
+
+			memmove(chunk->slots + target, chunk->slots + source,
+				ARRAY_SIZE(chunk->slots, run));
+			to += run;
+			from += run;
+			count -= run;
+		}
+	} else if (to > from) {
+		while (count) {
+			size_t source = ((chunk->head + from + count - 1) & mask) + 1;
+			size_t target = ((chunk->head + to + count - 1) & mask) + 1;
+			size_t run = count;
+			if (run > source) run = source;
+			if (run > target) run = target;
+
+			memmove(chunk->slots + target - run,
+				chunk->slots + source - run,
+				ARRAY_SIZE(chunk->slots, run));
+			count -= run;
+		}
+	}
+}
+
+static int grow(struct list_implementation * data, size_t length)
+{
+	size_t needed = length / CHUNK_LENGTH +
+		(length % CHUNK_LENGTH ? 1 : 0);
+	if (needed <= data->chunk_count) return 0;
+
+	size_t new_size = data->chunks_size;
+	while (ARRAY_LENGTH(data->chunks, new_size) < needed) {
+		if (new_size * 2 < new_size) {
+			// Overflow
+			return DT_LIST_ENOMEM;
+		}
+		new_size *= 2;
+	}
+
+	if (new_size != data->chunks_size) {
+		struct list_chunk ** new_chunks;
+		new_chunks = realloc(data->chunks, new_size);
+		if (!new_chunks) return DT_LIST_ENOMEM;
+
+		data->chunks = new_chunks;
+		data->chunks_size = new_size;
+	}
+
+	for (size_t i = data->chunk_count; i < needed; i++) {
+		struct list_chunk * chunk = data->spare;
+		data->spare = NULL;
+
+		if (!chunk) chunk = malloc(sizeof(*chunk));
+		if (!chunk) {
+			// Give back what was taken so nothing changes.
+			for (; i > data->chunk_count; i--) {
+				free(data->chunks[i - 1]);
+			}
+			return DT_LIST_ENOMEM;
+		}
+
+		chunk->head = 0;
+		data->chunks[i] = chunk;
+	}
+
+	data->chunk_count = needed;
+	return 0;
+}
+
+static void shrink(struct list_implementation * data)
+{
+	size_t needed = data->length / CHUNK_LENGTH +
+		(data->length % CHUNK_LENGTH ? 1 : 0);
+
+	// Chunks past those needed hold no items.
+	for (; data->chunk_count > needed; data->chunk_count--) {
+		struct list_chunk * chunk = data->chunks[data->chunk_count - 1];
+		if (data->spare) {
+			free(chunk);
+		} else {
+			data->spare = chunk;
+		}
+	}
+
+	size_t new_size = data->chunks_size;
+	while (ARRAY_LENGTH(data->chunks, new_size) / 4 > needed &&
+		ARRAY_LENGTH(data->chunks, new_size) > 8) {
+		new_size /= 2;
+	}
+
+	if (new_size != data->chunks_size) {
+		struct list_chunk ** new_chunks;
+		new_chunks = realloc(data->chunks, new_size);
+
+		if (new_chunks) {
+			data->chunks = new_chunks;
+			data->chunks_size = new_size;
+		}
+	}
+}
+
+static void reverse_chunks(struct list_implementation * data,
+	size_t begin, size_t end)
+{
+	for (; begin + 1 < end; begin++, end--) {
+		struct list_chunk * swap = data->chunks[begin];
+		data->chunks[begin] = data->chunks[end - 1];
+		data->chunks[end - 1] = swap;
+	}
+}
+
+static void insert_part(struct list_implementation * data, size_t index,
+	void * const * items, size_t count)
+{
+	size_t mask = CHUNK_LENGTH - 1;
+	size_t last = (data->length - 1) / CHUNK_LENGTH;
+	size_t last_used = data->length - last * CHUNK_LENGTH;
+	size_t new_last = (data->length + count - 1) / CHUNK_LENGTH;
+	size_t chunk = index / CHUNK_LENGTH;
+	size_t offset = index % CHUNK_LENGTH;
+
+	// Working back from the end, each chunk makes room at its
+	// front for the items that overflow the chunk before it.
+	// Full chunks overflow count items, the last one only
+	// what no longer fits.
+	for (size_t i = new_last; i > chunk; i--) {
+		struct list_chunk * to = data->chunks[i];
+		struct list_chunk * from = data->chunks[i - 1];
+		size_t from_used = i - 1 < last ? CHUNK_LENGTH : last_used;
+		size_t passed = i - 1 < last ?
+			count : last_used + count - CHUNK_LENGTH;
+
+		to->head = (to->head - passed) & mask;
+
+		if (i - 1 > chunk) {
+			for (size_t j = 0; j < passed; j++) {
+				*chunk_slot(to, j) =
+					*chunk_slot(from, from_used - passed + j);
+			}
+			continue;
+		}
+
+		// The overflow of the chunk inserted to may
+		// include some of the new items.
+		for (size_t j = 0; j < passed; j++) {
+			size_t at = CHUNK_LENGTH + j;
+			*chunk_slot(to, j) = at < offset + count ?
+				items[at - offset] : *chunk_slot(from, at - count);
+		}
+	}
+
+	struct list_chunk * target = data->chunks[chunk];
+	size_t used = chunk < last ? CHUNK_LENGTH : last_used;
+
+	// The items after the index that stay in the chunk.
+	size_t kept = used < CHUNK_LENGTH - count ?
+		used : CHUNK_LENGTH - count;
+	size_t after = kept > offset ? kept - offset : 0;
+
+	// Moving the front back is only safe when the slots
+	// wrapped round to were passed on or never used.
+	if (offset < after && offset + count <= CHUNK_LENGTH) {
+		target->head = (target->head - count) & mask;
+		chunk_move(target, 0, count, offset);
+	} else {
+		chunk_move(target, offset + count, offset, after);
+	}
+
+	for (size_t j = 0; j < count && offset + j < CHUNK_LENGTH; j++) {
+		*chunk_slot(target, offset + j) = items[j];
+	}
+
+	data->length += count;
+}
+
+static void insert_chunks(struct list_implementation * data, size_t index,
+	void * const * items, size_t chunks)
+{
+	size_t last = (data->length - 1) / CHUNK_LENGTH;
+	size_t chunk = index / CHUNK_LENGTH;
+	size_t offset = index % CHUNK_LENGTH;
+	size_t used = chunk < last ?
+		CHUNK_LENGTH : data->length - last * CHUNK_LENGTH;
+
+	// Rotate the empty chunks from the end to just after
+	// the chunk inserted to.
+	reverse_chunks(data, chunk + 1, last + 1);
+	reverse_chunks(data, last + 1, last + 1 + chunks);
+	reverse_chunks(data, chunk + 1, last + 1 + chunks);
+
+	// Split the chunk at the index, copying whichever side
+	// is smaller into the empty chunk at the other end.
+	struct list_chunk * first = data->chunks[chunk];
+	struct list_chunk * second = data->chunks[chunk + chunks];
+
+	if (offset < used - offset) {
+		data->chunks[chunk] = second;
+		data->chunks[chunk + chunks] = first;
+		for (size_t i = 0; i < offset; i++) {
+			*chunk_slot(second, i) = *chunk_slot(first, i);
+		}
+	} else {
+		for (size_t i = offset; i < used; i++) {
+			*chunk_slot(second, i) = *chunk_slot(first, i);
+		}
+	}
+
+	for (size_t i = 0; i < chunks * CHUNK_LENGTH; i++) {
+		*slot(data, index + i) = items[i];
+	}
+
+	data->length += chunks * CHUNK_LENGTH;
+}
+
+static void remove_part(struct list_implementation * data, size_t index,
+	size_t count)
+{
+	size_t mask = CHUNK_LENGTH - 1;
+	size_t last = (data->length - 1) / CHUNK_LENGTH;
+	size_t last_used = data->length - last * CHUNK_LENGTH;
+	size_t chunk = index / CHUNK_LENGTH;
+	size_t offset = index % CHUNK_LENGTH;
+
+	struct list_chunk * target = data->chunks[chunk];
+	size_t used = chunk < last ? CHUNK_LENGTH : last_used;
+	size_t have;
+	// Removed items at the front of the next chunk.
+	size_t spilled = 0;
+
+	if (offset + count <= used) {
+		size_t after = used - offset - count;
+		if (offset < after) {
+			chunk_move(target, count, 0, offset);
+			target->head = (target->head + count) & mask;
+		} else {
+			chunk_move(target, offset, offset + count, after);
+		}
+		have = used - count;
+	} else {
+		// Only a full chunk can be followed by more items.
+		spilled = offset + count - CHUNK_LENGTH;
+		struct list_chunk * next = data->chunks[chunk + 1];
+		next->head = (next->head + spilled) & mask;
+		have = offset;
+	}
+
+	// Top each chunk back up from the front of the next.
+	for (size_t i = chunk; i < last; i++) {
+		struct list_chunk * to = data->chunks[i];
+		struct list_chunk * from = data->chunks[i + 1];
+		size_t from_have = i + 1 < last ? CHUNK_LENGTH : last_used;
+		if (i == chunk) from_have -= spilled;
+
+		size_t taken = CHUNK_LENGTH - have;
+		if (taken > from_have) taken = from_have;
+
+		for (size_t j = 0; j < taken; j++) {
+			*chunk_slot(to, have + j) = *chunk_slot(from, j);
+		}
+		from->head = (from->head + taken) & mask;
+		have = from_have - taken;
+	}
+
+	data->length -= count;
+}
+
+static void remove_chunks(struct list_implementation * data, size_t index,
+	size_t chunks)
+{
+	size_t last = (data->length - 1) / CHUNK_LENGTH;
+	size_t chunk = index / CHUNK_LENGTH;
+	size_t offset = index % CHUNK_LENGTH;
+	size_t end = chunk + chunks;
+	size_t used = end < last ?
+		CHUNK_LENGTH : data->length - last * CHUNK_LENGTH;
+
+	// The chunk at the index keeps its front and the chunk
+	// the removed items end in keeps its back. Copy whichever
+	// is smaller into the other and drop the rest.
+	struct list_chunk * first = data->chunks[chunk];
+	struct list_chunk * second = data->chunks[end];
+	size_t dropped;
+
+	if (offset < used - offset) {
+		for (size_t i = 0; i < offset; i++) {
+			*chunk_slot(second, i) = *chunk_slot(first, i);
+		}
+		dropped = chunk;
+	} else {
+		for (size_t i = offset; i < used; i++) {
+			*chunk_slot(first, i) = *chunk_slot(second, i);
+		}
+		dropped = chunk + 1;
+	}
+
+	reverse_chunks(data, dropped, dropped + chunks);
+	reverse_chunks(data, dropped + chunks, data->chunk_count);
+	reverse_chunks(data, dropped, data->chunk_count);
+
+	data->length -= chunks * CHUNK_LENGTH;
+}
@@ -2,27 +2,53 @@
 
 #include "list/error.h"
 
-#include <stdlib.h>
+#include <string.h>
 
+#include "allocator.h"
 #include "buffers.h"
 
 struct list_implementation;
+struct vector_list;
 
+// Small lists keep their items in inline_buffer and only move
+// to the heap once they outgrow it.
 struct list_implementation {
+	// Where the list, its buffer and iterators come from.
+	const struct dt_allocator * allocator;
 	void ** buffer;
 	size_t buffer_size;
 	size_t length;
+	void * inline_buffer[DT_LIST_VECTOR_INLINE_LENGTH];
 };
 
+// The list and its implementation share one allocation.
+struct vector_list {
+	struct dt_list list;
+	struct list_implementation implementation;
+};
+
+_Static_assert(
+	sizeof(struct vector_list) <= sizeof(struct dt_list_vector_storage),
+	"dt_list_vector_storage is too small");
+
 
 
 // List functions
 static void * list_get(const struct dt_list * this, size_t index);
 static int list_insert(struct dt_list * this, size_t index, void * item);
 static int list_remove(struct dt_list * this, size_t index);
+static int list_insert_range(struct dt_list * this, size_t index,
+	void * const * items, size_t count);
+static int list_remove_range(struct dt_list * this, size_t index,
+	size_t count);
+static int list_append_many(struct dt_list * this,
+	void * const * items, size_t count);
 static size_t list_length(const struct dt_list * this);
 static struct dt_list_iterator * list_iterator(struct dt_list * this);
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage);
 static void list_del(struct dt_list * this);
+static void list_dispose(struct dt_list * this);
 
 // Iterator functions
 static void * iterator_get(const struct dt_list_iterator * this);
@@ -32,6 +58,7 @@ static int iterator_previous(struct dt_list_iterator * this);
 static int iterator_insert(struct dt_list_iterator * this, void * item);
 static int iterator_remove(struct dt_list_iterator * this);
 static void iterator_del(struct dt_list_iterator * this);
+static void iterator_dispose(struct dt_list_iterator * this);
 
 // Internal functions
 /** Shifts elements right starting at start.
@@ -50,38 +77,100 @@ static void shift_right(struct dt_list * list, size_t start);
  */
 static void shift_left(struct dt_list * list, size_t start);
 
+/** Resizes the buffer so it can hold at least length items.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    length: The number of items the buffer must hold.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise.
+ *
+ *  Notes:
+ *    Grows by doubling and shrinks by halving so the buffer
+ *    ends up the same size as one resized an item at a time.
+ */
+static int reserve(struct list_implementation * data, size_t length);
+
+/** Moves the items into a buffer of the given size.
+ *
+ *  Arguments:
+ *    data: The list implementation.
+ *    new_size: The new size of the buffer in bytes.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise.
+ *
+ *  Notes:
+ *    Sizes that fit in the inline buffer use it
+ *    and release any heap buffer.
+ */
+static int resize(struct list_implementation * data, size_t new_size);
+
+/** Sets up a list in place.
+ *
+ *  Arguments:
+ *    vector: The memory to set the list up in.
+ *    allocator: Where the buffer comes from. NULL for malloc.
+ *
+ *  Returns:
+ *    The list.
+ */
+static struct dt_list * vector_init(struct vector_list * vector,
+	const struct dt_allocator * allocator);
+
 struct dt_list * dt_list_vector_new(void) {
-	struct dt_list * list;
-	list = malloc(sizeof(*list));
+	return dt_list_vector_new_with_allocator(NULL);
+}
 
-	if (!list) return NULL;
+struct dt_list * dt_list_vector_new_with_allocator(
+	const struct dt_allocator * allocator)
+{
+	struct vector_list * vector;
+	vector = dt_allocator_alloc(allocator, sizeof(*vector));
 
-	struct list_implementation * implementation;
-	implementation = malloc(sizeof(*implementation));
+	if (!vector) return NULL;
 
-	if (!implementation) {
-		free(list);
-		return NULL;
-	}
-	
-	implementation->buffer_size = 
-		ARRAY_SIZE(implementation->buffer, 8);
-	implementation->length = 0;
-	implementation->buffer = malloc(implementation->buffer_size);
+	return vector_init(vector, allocator);
+}
 
-	if (!implementation->buffer) {
-		free(implementation);
-		free(list);
-		return NULL;
-	}
+struct dt_list * dt_list_vector_init(struct dt_list_vector_storage * storage)
+{
+	return dt_list_vector_init_with_allocator(storage, NULL);
+}
+
+struct dt_list * dt_list_vector_init_with_allocator(
+	struct dt_list_vector_storage * storage,
+	const struct dt_allocator * allocator)
+{
+	struct dt_list * list = vector_init((struct vector_list *) storage,
+		allocator);
+	list->del = &list_dispose;
+	return list;
+}
+
+static struct dt_list * vector_init(struct vector_list * vector,
+	const struct dt_allocator * allocator)
+{
+	struct dt_list * list = &vector->list;
+	struct list_implementation * implementation = &vector->implementation;
+
+	implementation->allocator = allocator;
+	implementation->buffer = implementation->inline_buffer;
+	implementation->buffer_size = sizeof(implementation->inline_buffer);
+	implementation->length = 0;
 
 	list->_data = implementation;
-	
+
 	list->get = &list_get;
 	list->insert = &list_insert;
 	list->remove = &list_remove;
+	list->insert_range = &list_insert_range;
+	list->remove_range = &list_remove_range;
+	list->append_many = &list_append_many;
 	list->length = &list_length;
 	list->iterator = &list_iterator;
+	list->iterator_init = &list_iterator_init;
 	list->del = &list_del;
 
 	return list;
@@ -111,12 +200,7 @@ static int list_insert(struct dt_list * this, size_t index, void * item)
 			return DT_LIST_ENOMEM;
 		}
 
-		void ** new_buf = realloc(data->buffer, new_size);
-		if (!new_buf) return DT_LIST_ENOMEM;
-
-		data->buffer = new_buf;
-		data->buffer_size = new_size;
-
+		if (resize(data, new_size)) return DT_LIST_ENOMEM;
 	}
 
 	shift_right(this, index);
@@ -138,19 +222,58 @@ static int list_remove(struct dt_list * this, size_t index)
 		ARRAY_LENGTH(data->buffer, data->buffer_size);
 	
 	if (buffer_length / 4 > this->length(this)) {
+		// Failing to shrink is harmless.
+		resize(data, data->buffer_size / 2);
+	}
 
-		size_t new_size = data->buffer_size / 2;
-		void ** new_buf = realloc(data->buffer, new_size);
+	return 0;
+}
 
-		if (new_buf) {
-			data->buffer = new_buf;
-			data->buffer_size = new_size;
-		}
+static int list_insert_range(struct dt_list * this, size_t index,
+	void * const * items, size_t count)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length) return DT_LIST_EINDEX;
+
+	if (data->length + count < data->length) {
+		// Overflow
+		return DT_LIST_ENOMEM;
 	}
 
+	if (reserve(data, data->length + count)) return DT_LIST_ENOMEM;
+
+	memmove(data->buffer + index + count, data->buffer + index,
+		ARRAY_SIZE(data->buffer, (data->length - index)));
+	memcpy(data->buffer + index, items, ARRAY_SIZE(items, count));
+
+	data->length += count;
 	return 0;
 }
 
+static int list_remove_range(struct dt_list * this, size_t index,
+	size_t count)
+{
+	struct list_implementation * data = this->_data;
+	if (index > data->length || count > data->length - index)
+		return DT_LIST_EINDEX;
+
+	memmove(data->buffer + index, data->buffer + index + count,
+		ARRAY_SIZE(data->buffer, (data->length - index - count)));
+	data->length -= count;
+
+	// Failing to shrink is harmless.
+	reserve(data, data->length);
+
+	return 0;
+}
+
+static int list_append_many(struct dt_list * this,
+	void * const * items, size_t count)
+{
+	struct list_implementation * data = this->_data;
+	return list_insert_range(this, data->length, items, count);
+}
+
 static size_t list_length(const struct dt_list * this)
 {
 	struct list_implementation * data = this->_data;
@@ -159,53 +282,70 @@ static size_t list_length(const struct dt_list * this)
 
 static struct dt_list_iterator * list_iterator(struct dt_list * this)
 {
+	struct list_implementation * data = this->_data;
 	struct dt_list_iterator * iterator;
-	iterator = malloc(sizeof(*iterator));
+	iterator = dt_allocator_alloc(data->allocator, sizeof(*iterator));
 
 	if (!iterator) return NULL;
 
-	iterator->get = &iterator_get;
-	iterator->valid = &iterator_valid;
-	iterator->next = &iterator_next;
-	iterator->previous = &iterator_previous;
-	iterator->insert = &iterator_insert;
-	iterator->remove = &iterator_remove;
+	list_iterator_init(this, iterator);
 	iterator->del = &iterator_del;
-
-	iterator->position = 0;
-	iterator->list = this;
-	iterator->_data = NULL;
 	return iterator;
 }
 
+static struct dt_list_iterator * list_iterator_init(struct dt_list * this,
+	struct dt_list_iterator * storage)
+{
+	storage->get = &iterator_get;
+	storage->valid = &iterator_valid;
+	storage->next = &iterator_next;
+	storage->previous = &iterator_previous;
+	storage->insert = &iterator_insert;
+	storage->remove = &iterator_remove;
+	storage->del = &iterator_dispose;
+
+	storage->position = 0;
+	storage->list = this;
+	// The iterator works on this list even when
+	// storage->list is swapped for a wrapper.
+	storage->_data = this;
+	return storage;
+}
+
 static void list_del(struct dt_list * this)
 {
-	
 	struct list_implementation * data = this->_data;
-	free(data->buffer);
-	free(data);
-	free(this);
+	list_dispose(this);
+	dt_allocator_free(data->allocator, this, sizeof(struct vector_list));
+}
+
+static void list_dispose(struct dt_list * this)
+{
+	struct list_implementation * data = this->_data;
+	if (data->buffer != data->inline_buffer) {
+		dt_allocator_free(data->allocator, data->buffer, data->buffer_size);
+	}
 }
 
 
 static void * iterator_get(const struct dt_list_iterator * this)
 {
-	return this->list->get(this->list, this->position);
+	return list_get(this->_data, this->position);
 }
 
 static int iterator_valid(const struct dt_list_iterator * this)
 {
-	return this->position < this->list->length(this->list);
+	return this->position < list_length(this->_data);
 }
 
 static int iterator_next(struct dt_list_iterator * this)
 {
-	if (this->position >= this->list->length(this->list))
+	if (this->position >= list_length(this->_data))
 		return DT_LIST_EINDEX;
 	
 	this->position++;
 
-	if (this->position == this->list->length(this->list))
+	if (this->position == list_length(this->_data))
 		return DT_LIST_EINDEX;
 	return 0;
 }
@@ -219,17 +359,23 @@ static int iterator_previous(struct dt_list_iterator * this)
 
 static int iterator_insert(struct dt_list_iterator * this, void * item)
 {
-	return this->list->insert(this->list, this->position, item);
+	return list_insert(this->_data, this->position, item);
 }
 
 static int iterator_remove(struct dt_list_iterator * this)
 {
-	return this->list->remove(this->list, this->position);
+	return list_remove(this->_data, this->position);
 }
 
 static void iterator_del(struct dt_list_iterator * this)
 {
-	free(this);
+	struct dt_list * list = this->_data;
+	struct list_implementation * data = list->_data;
+	dt_allocator_free(data->allocator, this, sizeof(*this));
+}
+
+static void iterator_dispose(struct dt_list_iterator * this)
+{
 }
 
 static void shift_right(struct dt_list * list, size_t start)
@@ -254,3 +400,55 @@ static void shift_left(struct dt_list * list, size_t start)
 	}
 	
 }
+
+static int reserve(struct list_implementation * data, size_t length)
+{
+	size_t new_size = data->buffer_size;
+
+	while (ARRAY_LENGTH(data->buffer, new_size) < length) {
+		if (new_size * 2 < new_size) {
+			// Overflow
+			return DT_LIST_ENOMEM;
+		}
+		new_size *= 2;
+	}
+
+	while (ARRAY_LENGTH(data->buffer, new_size) / 4 > length) {
+		new_size /= 2;
+	}
+
+	return resize(data, new_size);
+}
+
+static int resize(struct list_implementation * data, size_t new_size)
+{
+	if (new_size < sizeof(data->inline_buffer)) {
+		new_size = sizeof(data->inline_buffer);
+	}
+
+	if (new_size == data->buffer_size) return 0;
+
+	if (new_size == sizeof(data->inline_buffer)) {
+		// Only shrinking gets here so the items fit.
+		memcpy(data->inline_buffer, data->buffer,
+			ARRAY_SIZE(data->buffer, data->length));
+		dt_allocator_free(data->allocator, data->buffer, data->buffer_size);
+		data->buffer = data->inline_buffer;
+	} else if (data->buffer == data->inline_buffer) {
+		void ** new_buf = dt_allocator_alloc(data->allocator, new_size);
+		if (!new_buf) return DT_LIST_ENOMEM;
+
+		memcpy(new_buf, data->inline_buffer,
+			ARRAY_SIZE(data->buffer, data->length));
+		data->buffer = new_buf;
+	} else {
+		void ** new_buf = dt_allocator_realloc(data->allocator,
+			data->buffer, data->buffer_size, new_size);
+		if (!new_buf) return DT_LIST_ENOMEM;
+
+		data->buffer = new_buf;
+	}
+
+	data->buffer_size = new_size;
+	return 0;
+}
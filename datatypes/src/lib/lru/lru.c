@@ -0,0 +1,235 @@
+#include "lru.h"
+#include "lru/error.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "hashing.h"
+#include "list/intrusive.h"
+#include "pool.h"
+
+struct lru_node;
+
+// Each node is in a hash chain and in the order of use.
+struct lru_node {
+	// First, so a link is its node.
+	struct dt_list_link link;
+	struct lru_node * chain;
+	unsigned int hash;
+	void * item;
+};
+
+struct dt_lru {
+	int (* comparator)(void * a, void * b);
+	unsigned int (* hash)(void * item);
+	void (* evict)(void * item);
+	size_t capacity;
+	size_t length;
+	// A ring through every node. next is the most
+	// recently used, previous the least.
+	struct dt_list_link recent;
+	struct dt_pool * pool;
+	// A power of two, at least the capacity, so chains
+	// stay short without ever growing.
+	size_t buckets_length;
+	struct lru_node * buckets[];
+};
+
+/** Finds the chain slot that points at an item's node.
+ *
+ *  Arguments:
+ *    lru: The cache.
+ *    item: An item equal to the one to find.
+ *    hash: The item's remapped hash.
+ *
+ *  Returns:
+ *    The slot pointing at the node, or the empty slot
+ *    at the end of the chain if there is none.
+ */
+static struct lru_node ** find(struct dt_lru * lru, void * item,
+	unsigned int hash);
+
+/** Links a node in as the most recently used.
+ *
+ *  Arguments:
+ *    lru: The cache.
+ *    node: A node that is not in the ring.
+ */
+static void link_front(struct dt_lru * lru, struct lru_node * node);
+
+/** Unlinks a node from the ring.
+ *
+ *  Arguments:
+ *    node: A node in the ring.
+ */
+static void unlink_node(struct lru_node * node);
+
+struct dt_lru * dt_lru_new(size_t capacity,
+	int (* comparator)(void * a, void * b),
+	unsigned int (* hash)(void * item),
+	void (* evict)(void * item))
+{
+	if (!capacity) return NULL;
+
+	size_t buckets_length = 1;
+	while (buckets_length < capacity) {
+		if (buckets_length * 2 < buckets_length) return NULL;
+		buckets_length *= 2;
+	}
+
+	if (buckets_length > (((size_t) -1) - sizeof(struct dt_lru)) /
+		sizeof(struct lru_node *)) {
+		// Overflow
+		return NULL;
+	}
+
+	// The cache and its buckets share one allocation.
+	struct dt_lru * lru = malloc(sizeof(*lru) +
+		sizeof(struct lru_node *) * buckets_length);
+	if (!lru) return NULL;
+
+	lru->pool = dt_pool_new(sizeof(struct lru_node), 0);
+	if (!lru->pool) {
+		free(lru);
+		return NULL;
+	}
+
+	lru->comparator = comparator;
+	lru->hash = hash;
+	lru->evict = evict;
+	lru->capacity = capacity;
+	lru->length = 0;
+	lru->recent.next = &lru->recent;
+	lru->recent.previous = &lru->recent;
+	lru->buckets_length = buckets_length;
+
+	for (size_t i = 0; i < buckets_length; i++) {
+		lru->buckets[i] = NULL;
+	}
+
+	return lru;
+}
+
+void * dt_lru_get(struct dt_lru * lru, void * item)
+{
+	unsigned int hash = dt_hash_universal(lru->hash(item));
+	struct lru_node * node = *find(lru, item, hash);
+	if (!node) return NULL;
+
+	unlink_node(node);
+	link_front(lru, node);
+	return node->item;
+}
+
+int dt_lru_put(struct dt_lru * lru, void * item)
+{
+	unsigned int hash = dt_hash_universal(lru->hash(item));
+	struct lru_node * node = *find(lru, item, hash);
+
+	if (node) {
+		void * replaced = node->item;
+		node->item = item;
+
+		unlink_node(node);
+		link_front(lru, node);
+
+		if (replaced != item && lru->evict) lru->evict(replaced);
+		return 0;
+	}
+
+	void * evicted = NULL;
+	bool evicting = lru->length == lru->capacity;
+
+	if (evicting) {
+		// Reuse the least recently used node.
+		node = (struct lru_node *) lru->recent.previous;
+		evicted = node->item;
+
+		*find(lru, evicted, node->hash) = node->chain;
+		unlink_node(node);
+		lru->length--;
+	} else {
+		node = dt_pool_alloc(lru->pool);
+		if (!node) return DT_LRU_ENOMEM;
+	}
+
+	struct lru_node ** bucket =
+		lru->buckets + (hash & (lru->buckets_length - 1));
+
+	node->item = item;
+	node->hash = hash;
+	node->chain = *bucket;
+	*bucket = node;
+	link_front(lru, node);
+	lru->length++;
+
+	// Last, once the cache is whole again.
+	if (evicting && lru->evict) lru->evict(evicted);
+	return 0;
+}
+
+void * dt_lru_remove(struct dt_lru * lru, void * item)
+{
+	unsigned int hash = dt_hash_universal(lru->hash(item));
+	struct lru_node ** slot = find(lru, item, hash);
+	struct lru_node * node = *slot;
+	if (!node) return NULL;
+
+	void * removed = node->item;
+	*slot = node->chain;
+	unlink_node(node);
+	dt_pool_free(lru->pool, node);
+	lru->length--;
+
+	return removed;
+}
+
+size_t dt_lru_length(const struct dt_lru * lru)
+{
+	return lru->length;
+}
+
+void dt_lru_del(struct dt_lru * lru)
+{
+	if (lru->evict) {
+		// Oldest first, the order they would have gone.
+		for (struct dt_list_link * link = lru->recent.previous;
+			link != &lru->recent; link = link->previous) {
+			lru->evict(((struct lru_node *) link)->item);
+		}
+	}
+
+	// Every node is in the pool.
+	dt_pool_del(lru->pool);
+	free(lru);
+}
+
+static struct lru_node ** find(struct dt_lru * lru, void * item,
+	unsigned int hash)
+{
+	struct lru_node ** slot = lru->buckets + (hash & (lru->buckets_length - 1));
+
+	while (*slot) {
+		struct lru_node * node = *slot;
+		if (node->hash == hash && lru->comparator(item, node->item) == 0) {
+			break;
+		}
+		slot = &node->chain;
+	}
+
+	return slot;
+}
+
+static void link_front(struct dt_lru * lru, struct lru_node * node)
+{
+	node->link.previous = &lru->recent;
+	node->link.next = lru->recent.next;
+	lru->recent.next->previous = &node->link;
+	lru->recent.next = &node->link;
+}
+
+static void unlink_node(struct lru_node * node)
+{
+	node->link.previous->next = node->link.next;
+	node->link.next->previous = node->link.previous;
+}
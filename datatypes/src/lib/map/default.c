@@ -0,0 +1,11 @@
+#include "map.h"
+#include "map/hash.h"
+
+
+struct dt_map * dt_map_new(
+	size_t key_size, size_t value_size,
+	int (* comparator)(void * a, void * b),
+	unsigned int (* hash)(void * key))
+{
+	return dt_map_hash_new(key_size, value_size, comparator, hash);
+}
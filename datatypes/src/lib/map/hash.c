@@ -0,0 +1,367 @@
+#include "map/hash.h"
+#include "map/error.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashing.h"
+
+// This must be a power of two.
+#define DEFAULT_SLOTS_COUNT 16
+
+struct map_implementation;
+struct hash_map;
+
+// An open addressed table with linear probing. The
+// entries are laid out key then value, and the remapped
+// hash of each is kept apart so probing mostly reads
+// hashes and only compares keys whose hashes match.
+struct map_implementation {
+	int (* comparator)(void * a, void * b);
+	unsigned int (* hash)(void * key);
+	size_t key_size;
+	size_t value_size;
+	// Where the value starts in an entry.
+	size_t value_offset;
+	// The size of an entry, padded to keep the next aligned.
+	size_t entry_size;
+	// The entries followed by their hashes, one allocation.
+	unsigned char * entries;
+	// Zero for an empty slot.
+	unsigned int * hashes;
+	size_t slots_count;
+	size_t length;
+};
+
+// The map and its implementation share one allocation.
+struct hash_map {
+	struct dt_map map;
+	struct map_implementation implementation;
+};
+
+static int map_put(struct dt_map * this, void * key, void * value);
+static void * map_get(const struct dt_map * this, void * key);
+static void map_remove(struct dt_map * this, void * key);
+static int map_iterate(const struct dt_map * this,
+	int (* visit)(void * key, void * value, void * context),
+	void * context);
+static size_t map_length(const struct dt_map * this);
+static void map_del(struct dt_map * this);
+
+/** Hashes a key for the table.
+ *
+ *  Arguments:
+ *    data: The hash map implementation.
+ *    key: The key to hash.
+ *
+ *  Returns:
+ *    The remapped hash, never zero.
+ */
+static unsigned int hash_key(const struct map_implementation * data,
+	void * key);
+
+/** Probes for a key.
+ *
+ *  Arguments:
+ *    data: The hash map implementation.
+ *    key: The key to find.
+ *    hash: The key's hash from hash_key.
+ *    slot: Where to put the slot holding the key, or
+ *          the empty slot that ended the probe.
+ *
+ *  Returns:
+ *    True if the key was found.
+ */
+static bool find(const struct map_implementation * data, void * key,
+	unsigned int hash, size_t * slot);
+
+/** Moves the entries into a table with the given slots.
+ *
+ *  Arguments:
+ *    data: The hash map implementation.
+ *    slots_count: The new number of slots, a power of two
+ *                 larger than the length.
+ *    old: Where to put the old entries for the caller
+ *         to free.
+ *
+ *  Returns:
+ *    Zero on success. DT_MAP_ENOMEM otherwise, leaving
+ *    the table as it was.
+ *
+ *  Notes:
+ *    The old entries are not freed here so a key or value
+ *    that points into them can still be copied.
+ */
+static int resize(struct map_implementation * data, size_t slots_count,
+	unsigned char ** old);
+
+/** The alignment an item of the given size may need.
+ *
+ *  Arguments:
+ *    size: The size in bytes.
+ *
+ *  Returns:
+ *    The largest power of two dividing size, at most
+ *    the alignment malloc guarantees.
+ */
+static size_t alignment(size_t size);
+
+struct dt_map * dt_map_hash_new(
+	size_t key_size, size_t value_size,
+	int (* comparator)(void * a, void * b),
+	unsigned int (* hash)(void * key))
+{
+	if (!key_size) return NULL;
+
+	struct hash_map * hash_map;
+	hash_map = malloc(sizeof(*hash_map));
+
+	if (!hash_map) return NULL;
+
+	struct dt_map * map = &hash_map->map;
+	struct map_implementation * implementation = &hash_map->implementation;
+
+	size_t value_alignment = alignment(value_size);
+	size_t entry_alignment = alignment(key_size);
+	if (entry_alignment < value_alignment) entry_alignment = value_alignment;
+
+	implementation->comparator = comparator;
+	implementation->hash = hash;
+	implementation->key_size = key_size;
+	implementation->value_size = value_size;
+	implementation->value_offset =
+		(key_size + value_alignment - 1) / value_alignment * value_alignment;
+	implementation->entry_size =
+		(implementation->value_offset + value_size + entry_alignment - 1) /
+		entry_alignment * entry_alignment;
+	implementation->entries = NULL;
+	implementation->hashes = NULL;
+	implementation->slots_count = 0;
+	implementation->length = 0;
+
+	if (implementation->entry_size < key_size) {
+		// Overflow
+		free(hash_map);
+		return NULL;
+	}
+
+	unsigned char * old;
+	if (resize(implementation, DEFAULT_SLOTS_COUNT, &old)) {
+		free(hash_map);
+		return NULL;
+	}
+
+	map->put = &map_put;
+	map->get = &map_get;
+	map->remove = &map_remove;
+	map->iterate = &map_iterate;
+	map->length = &map_length;
+	map->del = &map_del;
+	map->_data = implementation;
+
+	return map;
+}
+
+
+static int map_put(struct dt_map * this, void * key, void * value)
+{
+	struct map_implementation * data = this->_data;
+	unsigned int hash = hash_key(data, key);
+	size_t slot;
+
+	if (find(data, key, hash, &slot)) {
+		// Key only maps may be given no value at all.
+		if (data->value_size) {
+			memmove(data->entries + slot * data->entry_size +
+				data->value_offset, value, data->value_size);
+		}
+		return 0;
+	}
+
+	unsigned char * old = NULL;
+
+	// Keep at least a quarter of the slots empty so
+	// probes stay short.
+	if ((data->length + 1) * 4 > data->slots_count * 3) {
+		size_t slots_count = data->slots_count * 2;
+		if (slots_count < data->slots_count) {
+			// Overflow
+			return DT_MAP_ENOMEM;
+		}
+
+		if (resize(data, slots_count, &old)) return DT_MAP_ENOMEM;
+
+		find(data, key, hash, &slot);
+	}
+
+	unsigned char * entry = data->entries + slot * data->entry_size;
+	memcpy(entry, key, data->key_size);
+	if (data->value_size) {
+		memcpy(entry + data->value_offset, value, data->value_size);
+	}
+	data->hashes[slot] = hash;
+	data->length++;
+
+	free(old);
+	return 0;
+}
+
+static void * map_get(const struct dt_map * this, void * key)
+{
+	struct map_implementation * data = this->_data;
+	size_t slot;
+
+	if (!find(data, key, hash_key(data, key), &slot)) return NULL;
+	return data->entries + slot * data->entry_size + data->value_offset;
+}
+
+static void map_remove(struct dt_map * this, void * key)
+{
+	struct map_implementation * data = this->_data;
+	size_t mask = data->slots_count - 1;
+	size_t hole;
+
+	if (!find(data, key, hash_key(data, key), &hole)) return;
+
+	// Shift later entries of the probe back into the hole
+	// rather than leaving a marker, so lookups never walk
+	// over removed entries.
+	for (size_t slot = (hole + 1) & mask; data->hashes[slot];
+		slot = (slot + 1) & mask) {
+		size_t home = data->hashes[slot] & mask;
+
+		// Entries whose home is after the hole, up to
+		// themselves, would not be found from the hole.
+		bool stays = hole < slot ?
+			home > hole && home <= slot :
+			home > hole || home <= slot;
+		if (stays) continue;
+
+		memcpy(data->entries + hole * data->entry_size,
+			data->entries + slot * data->entry_size, data->entry_size);
+		data->hashes[hole] = data->hashes[slot];
+		hole = slot;
+	}
+
+	data->hashes[hole] = 0;
+	data->length--;
+
+	if (data->length * 8 < data->slots_count &&
+		data->slots_count > DEFAULT_SLOTS_COUNT) {
+		unsigned char * old;
+		// Failing to shrink is harmless.
+		if (!resize(data, data->slots_count / 2, &old)) free(old);
+	}
+}
+
+static int map_iterate(const struct dt_map * this,
+	int (* visit)(void * key, void * value, void * context),
+	void * context)
+{
+	struct map_implementation * data = this->_data;
+
+	for (size_t slot = 0; slot < data->slots_count; slot++) {
+		if (!data->hashes[slot]) continue;
+
+		unsigned char * entry = data->entries + slot * data->entry_size;
+		int result = visit(entry, entry + data->value_offset, context);
+		if (result) return result;
+	}
+
+	return 0;
+}
+
+static size_t map_length(const struct dt_map * this)
+{
+	struct map_implementation * data = this->_data;
+	return data->length;
+}
+
+static void map_del(struct dt_map * this)
+{
+	struct map_implementation * data = this->_data;
+	free(data->entries);
+	free(this);
+}
+
+static unsigned int hash_key(const struct map_implementation * data,
+	void * key)
+{
+	unsigned int hash = dt_hash_universal(data->hash(key));
+	if (!hash) hash = 1;
+	return hash;
+}
+
+static bool find(const struct map_implementation * data, void * key,
+	unsigned int hash, size_t * slot)
+{
+	size_t mask = data->slots_count - 1;
+	size_t index = hash & mask;
+
+	while (data->hashes[index]) {
+		if (data->hashes[index] == hash && data->comparator(key,
+			data->entries + index * data->entry_size) == 0) {
+			*slot = index;
+			return true;
+		}
+		index = (index + 1) & mask;
+	}
+
+	*slot = index;
+	return false;
+}
+
+static int resize(struct map_implementation * data, size_t slots_count,
+	unsigned char ** old)
+{
+	size_t entries_size = data->entry_size * slots_count;
+	if (entries_size / slots_count != data->entry_size ||
+		entries_size + sizeof(*data->hashes) * slots_count < entries_size) {
+		// Overflow
+		return DT_MAP_ENOMEM;
+	}
+
+	// The entries size is a multiple of the entry alignment
+	// times a power of two, so the hashes that follow are
+	// aligned once there are a few slots.
+	unsigned char * entries = malloc(entries_size +
+		sizeof(*data->hashes) * slots_count);
+	if (!entries) return DT_MAP_ENOMEM;
+
+	unsigned int * hashes = (unsigned int *) (entries + entries_size);
+	memset(hashes, 0, sizeof(*hashes) * slots_count);
+
+	unsigned char * old_entries = data->entries;
+	unsigned int * old_hashes = data->hashes;
+	size_t old_slots_count = data->slots_count;
+
+	data->entries = entries;
+	data->hashes = hashes;
+	data->slots_count = slots_count;
+
+	size_t mask = slots_count - 1;
+	for (size_t i = 0; i < old_slots_count; i++) {
+		if (!old_hashes[i]) continue;
+
+		size_t slot = old_hashes[i] & mask;
+		while (hashes[slot]) slot = (slot + 1) & mask;
+
+		memcpy(entries + slot * data->entry_size,
+			old_entries + i * data->entry_size, data->entry_size);
+		hashes[slot] = old_hashes[i];
+	}
+
+	*old = old_entries;
+	return 0;
+}
+
+static size_t alignment(size_t size)
+{
+	size_t most = _Alignof(max_align_t);
+	size_t lowest = size & -size;
+
+	if (!lowest) return 1;
+	if (lowest > most) return most;
+	return lowest;
+}
@@ -0,0 +1,144 @@
+#include "pool.h"
+
+#include <stdlib.h>
+
+struct pool_slab;
+struct pool_free_item;
+
+struct pool_slab {
+	struct pool_slab * next;
+	void * items[];
+};
+
+// Freed items are reused to hold the free list.
+struct pool_free_item {
+	struct pool_free_item * next;
+};
+
+struct dt_pool {
+	size_t item_size;
+	size_t slab_length;
+	struct pool_slab * slabs;
+	size_t slab_count;
+	// Items in the newest slab that were never handed out.
+	unsigned char * fresh;
+	size_t fresh_length;
+	struct pool_free_item * free_items;
+	size_t length;
+};
+
+/** Adds a slab to the pool.
+ *
+ *  Arguments:
+ *    pool: The pool.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise.
+ */
+static int add_slab(struct dt_pool * pool);
+
+struct dt_pool * dt_pool_new(size_t item_size, size_t slab_length)
+{
+	if (!slab_length) slab_length = DT_POOL_DEFAULT_SLAB_LENGTH;
+
+	// Round up so every item can hold a free list link
+	// and stays aligned for pointers.
+	size_t align = sizeof(struct pool_free_item);
+	if (item_size < align) item_size = align;
+	if (item_size + align - 1 < item_size) return NULL;
+	item_size = (item_size + align - 1) / align * align;
+
+	if ((((size_t) -1) - sizeof(struct pool_slab)) / item_size < slab_length) {
+		// Overflow
+		return NULL;
+	}
+
+	struct dt_pool * pool;
+	pool = malloc(sizeof(*pool));
+
+	if (!pool) return NULL;
+
+	pool->item_size = item_size;
+	pool->slab_length = slab_length;
+	pool->slabs = NULL;
+	pool->slab_count = 0;
+	pool->fresh = NULL;
+	pool->fresh_length = 0;
+	pool->free_items = NULL;
+	pool->length = 0;
+
+	return pool;
+}
+
+void * dt_pool_alloc(struct dt_pool * pool)
+{
+	void * item;
+
+	if (pool->free_items) {
+		item = pool->free_items;
+		pool->free_items = pool->free_items->next;
+	} else {
+		if (!pool->fresh_length && add_slab(pool)) return NULL;
+
+		item = pool->fresh;
+		pool->fresh += pool->item_size;
+		pool->fresh_length--;
+	}
+
+	pool->length++;
+	return item;
+}
+
+void dt_pool_free(struct dt_pool * pool, void * item)
+{
+	if (!item) return;
+
+	struct pool_free_item * free_item = item;
+	free_item->next = pool->free_items;
+	pool->free_items = free_item;
+	pool->length--;
+}
+
+size_t dt_pool_item_size(const struct dt_pool * pool)
+{
+	return pool->item_size;
+}
+
+size_t dt_pool_slab_count(const struct dt_pool * pool)
+{
+	return pool->slab_count;
+}
+
+size_t dt_pool_length(const struct dt_pool * pool)
+{
+	return pool->length;
+}
+
+void dt_pool_del(struct dt_pool * pool)
+{
+	struct pool_slab * slab = pool->slabs;
+
+	while (slab) {
+		struct pool_slab * del_me = slab;
+		slab = slab->next;
+		free(del_me);
+	}
+
+	free(pool);
+}
+
+static int add_slab(struct dt_pool * pool)
+{
+	struct pool_slab * slab;
+	slab = malloc(sizeof(*slab) + pool->item_size * pool->slab_length);
+
+	if (!slab) return -1;
+
+	slab->next = pool->slabs;
+	pool->slabs = slab;
+	pool->slab_count++;
+
+	pool->fresh = (unsigned char *) slab->items;
+	pool->fresh_length = pool->slab_length;
+	return 0;
+}
@@ -0,0 +1,8 @@
+#include "pqueue.h"
+#include "pqueue/heap.h"
+
+
+struct dt_pqueue * dt_pqueue_new(int (* comparator)(void * a, void * b))
+{
+	return dt_pqueue_heap_new(comparator, DT_PQUEUE_HEAP_DEFAULT_ARITY);
+}
@@ -0,0 +1,221 @@
+#include "pqueue/heap.h"
+#include "pqueue/error.h"
+
+#include <stdlib.h>
+
+#include "buffers.h"
+
+// The number of items the first buffer holds.
+#define INITIAL_LENGTH 16
+
+struct pqueue_implementation;
+struct heap_pqueue;
+
+struct pqueue_implementation {
+	int (* comparator)(void * a, void * b);
+	size_t arity;
+	// The heap, smallest item first.
+	void ** buffer;
+	size_t buffer_length;
+	size_t length;
+};
+
+// The queue and its implementation share one allocation.
+struct heap_pqueue {
+	struct dt_pqueue pqueue;
+	struct pqueue_implementation implementation;
+};
+
+
+static int pqueue_push(struct dt_pqueue * this, void * item);
+static void * pqueue_pop_min(struct dt_pqueue * this);
+static void * pqueue_peek(const struct dt_pqueue * this);
+static size_t pqueue_length(const struct dt_pqueue * this);
+static void pqueue_del(struct dt_pqueue * this);
+
+/** Moves an item up from a hole until its parent is not larger.
+ *
+ *  Arguments:
+ *    data: The queue implementation.
+ *    index: The empty slot to start from.
+ *    item: The item to place.
+ */
+static void sift_up(struct pqueue_implementation * data, size_t index,
+	void * item);
+
+/** Moves an item down from a hole until no child is smaller.
+ *
+ *  Arguments:
+ *    data: The queue implementation.
+ *    index: The empty slot to start from.
+ *    item: The item to place.
+ */
+static void sift_down(struct pqueue_implementation * data, size_t index,
+	void * item);
+
+/** Moves the items into a buffer of the given length.
+ *
+ *  Arguments:
+ *    data: The queue implementation.
+ *    new_length: The number of items the buffer holds.
+ *
+ *  Returns:
+ *    Zero on success. DT_PQUEUE_ENOMEM otherwise.
+ */
+static int resize(struct pqueue_implementation * data, size_t new_length);
+
+struct dt_pqueue * dt_pqueue_heap_new(
+	int (* comparator)(void * a, void * b), size_t arity)
+{
+	if (arity < 2) return NULL;
+
+	struct heap_pqueue * heap;
+	heap = malloc(sizeof(*heap));
+
+	if (!heap) return NULL;
+
+	struct dt_pqueue * pqueue = &heap->pqueue;
+	struct pqueue_implementation * implementation = &heap->implementation;
+
+	implementation->comparator = comparator;
+	implementation->arity = arity;
+	implementation->buffer = malloc(
+		ARRAY_SIZE(implementation->buffer, INITIAL_LENGTH));
+	implementation->buffer_length = INITIAL_LENGTH;
+	implementation->length = 0;
+
+	if (!implementation->buffer) {
+		free(heap);
+		return NULL;
+	}
+
+	pqueue->push = pqueue_push;
+	pqueue->pop_min = pqueue_pop_min;
+	pqueue->peek = pqueue_peek;
+	pqueue->length = pqueue_length;
+	pqueue->del = pqueue_del;
+	pqueue->_data = implementation;
+
+	return pqueue;
+}
+
+
+static int pqueue_push(struct dt_pqueue * this, void * item)
+{
+	struct pqueue_implementation * data = this->_data;
+
+	if (data->length == data->buffer_length) {
+		size_t new_length = data->buffer_length * 2;
+
+		if (new_length < data->buffer_length) {
+			//Overflow
+			return DT_PQUEUE_ENOMEM;
+		}
+
+		if (resize(data, new_length)) return DT_PQUEUE_ENOMEM;
+	}
+
+	data->length++;
+	sift_up(data, data->length - 1, item);
+	return 0;
+}
+
+static void * pqueue_pop_min(struct dt_pqueue * this)
+{
+	struct pqueue_implementation * data = this->_data;
+	if (!data->length) return NULL;
+
+	void * min = data->buffer[0];
+
+	// Refill the root's hole with the last item.
+	data->length--;
+	if (data->length) {
+		sift_down(data, 0, data->buffer[data->length]);
+	}
+
+	if (data->buffer_length / 4 > data->length &&
+		data->buffer_length > INITIAL_LENGTH) {
+		// Failing to shrink is harmless.
+		resize(data, data->buffer_length / 2);
+	}
+
+	return min;
+}
+
+static void * pqueue_peek(const struct dt_pqueue * this)
+{
+	struct pqueue_implementation * data = this->_data;
+	if (!data->length) return NULL;
+
+	return data->buffer[0];
+}
+
+static size_t pqueue_length(const struct dt_pqueue * this)
+{
+	struct pqueue_implementation * data = this->_data;
+	return data->length;
+}
+
+static void pqueue_del(struct dt_pqueue * this)
+{
+	struct pqueue_implementation * data = this->_data;
+	free(data->buffer);
+	free(this);
+}
+
+static void sift_up(struct pqueue_implementation * data, size_t index,
+	void * item)
+{
+	while (index) {
+		size_t parent = (index - 1) / data->arity;
+		if (data->comparator(data->buffer[parent], item) <= 0) break;
+
+		data->buffer[index] = data->buffer[parent];
+		index = parent;
+	}
+
+	data->buffer[index] = item;
+}
+
+static void sift_down(struct pqueue_implementation * data, size_t index,
+	void * item)
+{
+	for (;;) {
+		size_t first = index * data->arity + 1;
+		if (first >= data->length) break;
+
+		size_t last = first + data->arity;
+		if (last > data->length) last = data->length;
+
+		size_t smallest = first;
+		for (size_t child = first + 1; child < last; child++) {
+			if (data->comparator(data->buffer[child],
+				data->buffer[smallest]) < 0) {
+				smallest = child;
+			}
+		}
+
+		if (data->comparator(item, data->buffer[smallest]) <= 0) break;
+
+		data->buffer[index] = data->buffer[smallest];
+		index = smallest;
+	}
+
+	data->buffer[index] = item;
+}
+
+static int resize(struct pqueue_implementation * data, size_t new_length)
+{
+	if (new_length > ((size_t) -1) / sizeof(*data->buffer)) {
+		// Overflow
+		return DT_PQUEUE_ENOMEM;
+	}
+
+	void ** new_buffer = realloc(data->buffer,
+		ARRAY_SIZE(data->buffer, new_length));
+	if (!new_buffer) return DT_PQUEUE_ENOMEM;
+
+	data->buffer = new_buffer;
+	data->buffer_length = new_length;
+	return 0;
+}
@@ -0,0 +1,279 @@
+#include "pqueue/pairing.h"
+#include "pqueue/error.h"
+
+#include <stdlib.h>
+
+#include "pool.h"
+
+struct pqueue_implementation;
+struct pairing_pqueue;
+
+// A handle is the item's node. Each node's children form
+// a list, smallest first only at the root.
+struct dt_pqueue_handle {
+	void * item;
+	struct dt_pqueue_handle * child;
+	struct dt_pqueue_handle * next;
+	// The previous sibling, or the parent of a first child.
+	struct dt_pqueue_handle * previous;
+};
+
+struct pqueue_implementation {
+	int (* comparator)(void * a, void * b);
+	struct dt_pqueue_handle * root;
+	size_t length;
+	struct dt_pool * pool;
+};
+
+// The queue and its implementation share one allocation.
+struct pairing_pqueue {
+	struct dt_pqueue pqueue;
+	struct pqueue_implementation implementation;
+};
+
+
+static int pqueue_push(struct dt_pqueue * this, void * item);
+static void * pqueue_pop_min(struct dt_pqueue * this);
+static void * pqueue_peek(const struct dt_pqueue * this);
+static size_t pqueue_length(const struct dt_pqueue * this);
+static void pqueue_del(struct dt_pqueue * this);
+
+/** Joins two heaps, the larger root becoming a child.
+ *
+ *  Arguments:
+ *    data: The queue implementation.
+ *    a: A root with no siblings.
+ *    b: Another root with no siblings.
+ *
+ *  Returns:
+ *    The root of the joined heap.
+ */
+static struct dt_pqueue_handle * meld(struct pqueue_implementation * data,
+	struct dt_pqueue_handle * a, struct dt_pqueue_handle * b);
+
+/** Joins a list of siblings into one heap.
+ *
+ *  Arguments:
+ *    data: The queue implementation.
+ *    first: The first sibling, or NULL.
+ *
+ *  Returns:
+ *    The root of the joined heap, or NULL.
+ *
+ *  Notes:
+ *    Melds pairs left to right, then the results
+ *    right to left. Loops rather than recursing so a
+ *    long list cannot overflow the call stack.
+ */
+static struct dt_pqueue_handle * merge_pairs(
+	struct pqueue_implementation * data, struct dt_pqueue_handle * first);
+
+/** Cuts a node that is not the root out of its sibling list.
+ *
+ *  Arguments:
+ *    node: The node to cut. It keeps its children.
+ */
+static void detach(struct dt_pqueue_handle * node);
+
+struct dt_pqueue * dt_pqueue_pairing_new(
+	int (* comparator)(void * a, void * b))
+{
+	struct pairing_pqueue * pairing;
+	pairing = malloc(sizeof(*pairing));
+
+	if (!pairing) return NULL;
+
+	struct dt_pqueue * pqueue = &pairing->pqueue;
+	struct pqueue_implementation * implementation = &pairing->implementation;
+
+	implementation->comparator = comparator;
+	implementation->root = NULL;
+	implementation->length = 0;
+	implementation->pool = dt_pool_new(sizeof(struct dt_pqueue_handle), 0);
+
+	if (!implementation->pool) {
+		free(pairing);
+		return NULL;
+	}
+
+	pqueue->push = pqueue_push;
+	pqueue->pop_min = pqueue_pop_min;
+	pqueue->peek = pqueue_peek;
+	pqueue->length = pqueue_length;
+	pqueue->del = pqueue_del;
+	pqueue->_data = implementation;
+
+	return pqueue;
+}
+
+struct dt_pqueue_handle * dt_pqueue_pairing_push(struct dt_pqueue * pqueue,
+	void * item)
+{
+	struct pqueue_implementation * data = pqueue->_data;
+
+	struct dt_pqueue_handle * node = dt_pool_alloc(data->pool);
+	if (!node) return NULL;
+
+	node->item = item;
+	node->child = NULL;
+	node->next = NULL;
+	node->previous = NULL;
+
+	data->root = data->root ? meld(data, data->root, node) : node;
+	data->length++;
+
+	return node;
+}
+
+void * dt_pqueue_pairing_item(const struct dt_pqueue_handle * handle)
+{
+	return handle->item;
+}
+
+void dt_pqueue_pairing_decrease_key(struct dt_pqueue * pqueue,
+	struct dt_pqueue_handle * handle)
+{
+	struct pqueue_implementation * data = pqueue->_data;
+	if (handle == data->root) return;
+
+	// The node's subtree is still in order, only its
+	// place under its parent may be wrong.
+	detach(handle);
+	data->root = meld(data, data->root, handle);
+}
+
+void dt_pqueue_pairing_remove(struct dt_pqueue * pqueue,
+	struct dt_pqueue_handle * handle)
+{
+	struct pqueue_implementation * data = pqueue->_data;
+
+	if (handle == data->root) {
+		pqueue_pop_min(pqueue);
+		return;
+	}
+
+	detach(handle);
+	struct dt_pqueue_handle * children = merge_pairs(data, handle->child);
+	if (children) data->root = meld(data, data->root, children);
+
+	dt_pool_free(data->pool, handle);
+	data->length--;
+}
+
+
+static int pqueue_push(struct dt_pqueue * this, void * item)
+{
+	if (!dt_pqueue_pairing_push(this, item)) return DT_PQUEUE_ENOMEM;
+	return 0;
+}
+
+static void * pqueue_pop_min(struct dt_pqueue * this)
+{
+	struct pqueue_implementation * data = this->_data;
+	struct dt_pqueue_handle * root = data->root;
+	if (!root) return NULL;
+
+	void * item = root->item;
+	data->root = merge_pairs(data, root->child);
+
+	dt_pool_free(data->pool, root);
+	data->length--;
+
+	return item;
+}
+
+static void * pqueue_peek(const struct dt_pqueue * this)
+{
+	struct pqueue_implementation * data = this->_data;
+	if (!data->root) return NULL;
+
+	return data->root->item;
+}
+
+static size_t pqueue_length(const struct dt_pqueue * this)
+{
+	struct pqueue_implementation * data = this->_data;
+	return data->length;
+}
+
+static void pqueue_del(struct dt_pqueue * this)
+{
+	struct pqueue_implementation * data = this->_data;
+	// Every node is in the pool.
+	dt_pool_del(data->pool);
+	free(this);
+}
+
+static struct dt_pqueue_handle * meld(struct pqueue_implementation * data,
+	struct dt_pqueue_handle * a, struct dt_pqueue_handle * b)
+{
+	if (data->comparator(b->item, a->item) < 0) {
+		struct dt_pqueue_handle * swap = a;
+		a = b;
+		b = swap;
+	}
+
+	b->previous = a;
+	b->next = a->child;
+	if (a->child) a->child->previous = b;
+	a->child = b;
+
+	return a;
+}
+
+static struct dt_pqueue_handle * merge_pairs(
+	struct pqueue_implementation * data, struct dt_pqueue_handle * first)
+{
+	if (!first) return NULL;
+
+	// Meld neighbours, stacking the results through next
+	// so the last pair is on top.
+	struct dt_pqueue_handle * pairs = NULL;
+	while (first) {
+		struct dt_pqueue_handle * a = first;
+		struct dt_pqueue_handle * b = a->next;
+		struct dt_pqueue_handle * melded = a;
+
+		a->next = NULL;
+		a->previous = NULL;
+
+		if (b) {
+			first = b->next;
+			b->next = NULL;
+			b->previous = NULL;
+			melded = meld(data, a, b);
+		} else {
+			first = NULL;
+		}
+
+		melded->next = pairs;
+		pairs = melded;
+	}
+
+	struct dt_pqueue_handle * root = pairs;
+	pairs = pairs->next;
+	root->next = NULL;
+
+	while (pairs) {
+		struct dt_pqueue_handle * next = pairs->next;
+		pairs->next = NULL;
+		root = meld(data, root, pairs);
+		pairs = next;
+	}
+
+	return root;
+}
+
+static void detach(struct dt_pqueue_handle * node)
+{
+	if (node->previous->child == node) {
+		node->previous->child = node->next;
+	} else {
+		node->previous->next = node->next;
+	}
+
+	if (node->next) node->next->previous = node->previous;
+
+	node->next = NULL;
+	node->previous = NULL;
+}
@@ -0,0 +1,8 @@
+#include "queue.h"
+#include "queue/mpmc.h"
+
+
+struct dt_queue * dt_queue_new(size_t capacity)
+{
+	return dt_queue_mpmc_new(capacity);
+}
@@ -0,0 +1,179 @@
+#include "queue/mpmc.h"
+#include "queue/error.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Counters written by different threads live on their own
+// cache lines so one thread's writes do not keep taking
+// the line away from the other.
+#define CACHE_LINE_SIZE 64
+
+struct queue_cell;
+struct queue_implementation;
+struct mpmc_queue;
+
+// A slot's sequence is its position when it is free to
+// push into and its position plus one once it holds an
+// item, a lap behind the pushers after it is popped.
+struct queue_cell {
+	atomic_size_t sequence;
+	void * item;
+};
+
+struct queue_implementation {
+	// The next position to push into.
+	_Alignas(CACHE_LINE_SIZE) atomic_size_t tail;
+
+	// The next position to pop from.
+	_Alignas(CACHE_LINE_SIZE) atomic_size_t head;
+
+	// Read by both, written by neither.
+	_Alignas(CACHE_LINE_SIZE) size_t mask;
+	struct queue_cell * cells;
+};
+
+// The queue, its implementation and its cells share
+// one allocation.
+struct mpmc_queue {
+	struct dt_queue queue;
+	struct queue_implementation implementation;
+	struct queue_cell cells[];
+};
+
+
+static int queue_push(struct dt_queue * this, void * item);
+static void * queue_pop(struct dt_queue * this);
+static size_t queue_length(const struct dt_queue * this);
+static void queue_del(struct dt_queue * this);
+
+struct dt_queue * dt_queue_mpmc_new(size_t capacity)
+{
+	if (!capacity) return NULL;
+
+	size_t length = 1;
+	while (length < capacity) {
+		if (length * 2 < length) return NULL;
+		length *= 2;
+	}
+
+	if (length > (((size_t) -1) - sizeof(struct mpmc_queue) -
+		CACHE_LINE_SIZE) / sizeof(struct queue_cell)) {
+		// Overflow
+		return NULL;
+	}
+
+	// aligned_alloc wants a multiple of the alignment.
+	size_t size = sizeof(struct mpmc_queue) +
+		sizeof(struct queue_cell) * length;
+	size = (size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+
+	struct mpmc_queue * mpmc = aligned_alloc(CACHE_LINE_SIZE, size);
+	if (!mpmc) return NULL;
+
+	struct dt_queue * queue = &mpmc->queue;
+	struct queue_implementation * implementation = &mpmc->implementation;
+
+	atomic_init(&implementation->tail, 0);
+	atomic_init(&implementation->head, 0);
+	implementation->mask = length - 1;
+	implementation->cells = mpmc->cells;
+
+	for (size_t i = 0; i < length; i++) {
+		atomic_init(&mpmc->cells[i].sequence, i);
+	}
+
+	queue->push = queue_push;
+	queue->pop = queue_pop;
+	queue->length = queue_length;
+	queue->del = queue_del;
+	queue->_data = implementation;
+
+	return queue;
+}
+
+
+static int queue_push(struct dt_queue * this, void * item)
+{
+	struct queue_implementation * data = this->_data;
+	size_t position = atomic_load_explicit(&data->tail, memory_order_relaxed);
+	struct queue_cell * cell;
+
+	for (;;) {
+		cell = data->cells + (position & data->mask);
+		size_t sequence = atomic_load_explicit(&cell->sequence,
+			memory_order_acquire);
+		intptr_t difference = (intptr_t) sequence - (intptr_t) position;
+
+		if (difference == 0) {
+			// Free, claim it.
+			if (atomic_compare_exchange_weak_explicit(&data->tail, &position,
+				position + 1, memory_order_relaxed, memory_order_relaxed)) {
+				break;
+			}
+		} else if (difference < 0) {
+			// Still holds the item from a lap ago.
+			return DT_QUEUE_EFULL;
+		} else {
+			// Another pusher took it.
+			position = atomic_load_explicit(&data->tail,
+				memory_order_relaxed);
+		}
+	}
+
+	cell->item = item;
+	atomic_store_explicit(&cell->sequence, position + 1,
+		memory_order_release);
+	return 0;
+}
+
+static void * queue_pop(struct dt_queue * this)
+{
+	struct queue_implementation * data = this->_data;
+	size_t position = atomic_load_explicit(&data->head, memory_order_relaxed);
+	struct queue_cell * cell;
+
+	for (;;) {
+		cell = data->cells + (position & data->mask);
+		size_t sequence = atomic_load_explicit(&cell->sequence,
+			memory_order_acquire);
+		intptr_t difference = (intptr_t) sequence - (intptr_t) (position + 1);
+
+		if (difference == 0) {
+			// Filled, claim it.
+			if (atomic_compare_exchange_weak_explicit(&data->head, &position,
+				position + 1, memory_order_relaxed, memory_order_relaxed)) {
+				break;
+			}
+		} else if (difference < 0) {
+			// Not pushed into yet.
+			return NULL;
+		} else {
+			// Another popper took it.
+			position = atomic_load_explicit(&data->head,
+				memory_order_relaxed);
+		}
+	}
+
+	void * item = cell->item;
+	// Free for the pushers on the next lap.
+	atomic_store_explicit(&cell->sequence, position + data->mask + 1,
+		memory_order_release);
+	return item;
+}
+
+static size_t queue_length(const struct dt_queue * this)
+{
+	struct queue_implementation * data = this->_data;
+
+	size_t head = atomic_load_explicit(&data->head, memory_order_acquire);
+	size_t tail = atomic_load_explicit(&data->tail, memory_order_acquire);
+	if (tail < head) return 0;
+	return tail - head;
+}
+
+static void queue_del(struct dt_queue * this)
+{
+	free(this);
+}
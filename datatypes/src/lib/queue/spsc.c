@@ -0,0 +1,136 @@
+#include "queue/spsc.h"
+#include "queue/error.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+
+// Counters written by different threads live on their own
+// cache lines so one thread's writes do not keep taking
+// the line away from the other.
+#define CACHE_LINE_SIZE 64
+
+struct queue_implementation;
+struct spsc_queue;
+
+struct queue_implementation {
+	// Only the consumer writes these.
+	_Alignas(CACHE_LINE_SIZE) atomic_size_t head;
+	// The tail as the consumer last saw it, so it only
+	// reads the producer's line when it seems empty.
+	size_t tail_seen;
+
+	// Only the producer writes these.
+	_Alignas(CACHE_LINE_SIZE) atomic_size_t tail;
+	size_t head_seen;
+
+	// Read by both, written by neither.
+	_Alignas(CACHE_LINE_SIZE) size_t mask;
+	void ** items;
+};
+
+// The queue, its implementation and its buffer share
+// one allocation.
+struct spsc_queue {
+	struct dt_queue queue;
+	struct queue_implementation implementation;
+	void * items[];
+};
+
+
+static int queue_push(struct dt_queue * this, void * item);
+static void * queue_pop(struct dt_queue * this);
+static size_t queue_length(const struct dt_queue * this);
+static void queue_del(struct dt_queue * this);
+
+struct dt_queue * dt_queue_spsc_new(size_t capacity)
+{
+	if (!capacity) return NULL;
+
+	size_t length = 1;
+	while (length < capacity) {
+		if (length * 2 < length) return NULL;
+		length *= 2;
+	}
+
+	if (length > (((size_t) -1) - sizeof(struct spsc_queue) -
+		CACHE_LINE_SIZE) / sizeof(void *)) {
+		// Overflow
+		return NULL;
+	}
+
+	// aligned_alloc wants a multiple of the alignment.
+	size_t size = sizeof(struct spsc_queue) + sizeof(void *) * length;
+	size = (size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+
+	struct spsc_queue * spsc = aligned_alloc(CACHE_LINE_SIZE, size);
+	if (!spsc) return NULL;
+
+	struct dt_queue * queue = &spsc->queue;
+	struct queue_implementation * implementation = &spsc->implementation;
+
+	atomic_init(&implementation->head, 0);
+	implementation->tail_seen = 0;
+	atomic_init(&implementation->tail, 0);
+	implementation->head_seen = 0;
+	implementation->mask = length - 1;
+	implementation->items = spsc->items;
+
+	queue->push = queue_push;
+	queue->pop = queue_pop;
+	queue->length = queue_length;
+	queue->del = queue_del;
+	queue->_data = implementation;
+
+	return queue;
+}
+
+
+static int queue_push(struct dt_queue * this, void * item)
+{
+	struct queue_implementation * data = this->_data;
+	size_t tail = atomic_load_explicit(&data->tail, memory_order_relaxed);
+
+	if (tail - data->head_seen > data->mask) {
+		data->head_seen = atomic_load_explicit(&data->head,
+			memory_order_acquire);
+		if (tail - data->head_seen > data->mask) return DT_QUEUE_EFULL;
+	}
+
+	data->items[tail & data->mask] = item;
+
+	// The consumer must see the item before the new tail.
+	atomic_store_explicit(&data->tail, tail + 1, memory_order_release);
+	return 0;
+}
+
+static void * queue_pop(struct dt_queue * this)
+{
+	struct queue_implementation * data = this->_data;
+	size_t head = atomic_load_explicit(&data->head, memory_order_relaxed);
+
+	if (head == data->tail_seen) {
+		data->tail_seen = atomic_load_explicit(&data->tail,
+			memory_order_acquire);
+		if (head == data->tail_seen) return NULL;
+	}
+
+	void * item = data->items[head & data->mask];
+
+	// The producer may reuse the slot once it sees this.
+	atomic_store_explicit(&data->head, head + 1, memory_order_release);
+	return item;
+}
+
+static size_t queue_length(const struct dt_queue * this)
+{
+	struct queue_implementation * data = this->_data;
+
+	size_t head = atomic_load_explicit(&data->head, memory_order_acquire);
+	size_t tail = atomic_load_explicit(&data->tail, memory_order_acquire);
+	return tail - head;
+}
+
+static void queue_del(struct dt_queue * this)
+{
+	free(this);
+}
@@ -0,0 +1,1282 @@
+
+#include "roaring.h"
+#include "roaring/error.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Each container holds the values sharing their high 16 bits.
+#define CONTAINER_VALUES 65536
+#define BITMAP_WORDS (CONTAINER_VALUES / 64)
+// Past this many values an array is bigger than a bitmap.
+#define ARRAY_MAX 4096
+#define INITIAL_CONTAINERS 4
+#define INITIAL_ARRAY 4
+
+enum container_type {
+	ARRAY,
+	BITMAP,
+	RUN
+};
+
+struct container;
+struct run;
+
+// The values start to start + length.
+struct run {
+	uint16_t start;
+	uint16_t length;
+};
+
+struct container {
+	uint16_t key;
+	unsigned char type;
+	uint32_t cardinality;
+	// The array values or runs in use and room for.
+	// Unused by bitmaps.
+	uint32_t length;
+	uint32_t capacity;
+	union {
+		uint16_t * values;
+		uint64_t * words;
+		struct run * runs;
+	};
+};
+
+// Containers are kept sorted by key.
+struct dt_roaring {
+	struct container * containers;
+	size_t length;
+	size_t capacity;
+};
+
+struct dt_roaring_cursor {
+	const struct dt_roaring * roaring;
+	size_t container;
+	// The array index, the next bit or the run index,
+	// depending on the container.
+	uint32_t position;
+	// How far into the run.
+	uint32_t offset;
+};
+
+/** Finds the container for a key.
+ *
+ *  Arguments:
+ *    roaring: The bitmap.
+ *    key: The high 16 bits of a value.
+ *    index: Where to put the index of the container, or
+ *      where it would go if there is none.
+ *
+ *  Returns:
+ *    True if there is a container for the key.
+ */
+static bool find_container(const struct dt_roaring * roaring, uint16_t key,
+	size_t * index);
+
+/** Adds an empty array container.
+ *
+ *  Arguments:
+ *    roaring: The bitmap.
+ *    index: Where it goes.
+ *    key: The key of the container.
+ *
+ *  Returns:
+ *    The container. Or NULL if there is not enough memory.
+ */
+static struct container * insert_container(struct dt_roaring * roaring,
+	size_t index, uint16_t key);
+static void erase_container(struct dt_roaring * roaring, size_t index);
+
+/** Gets room for containers at the end of a bitmap.
+ *
+ *  Arguments:
+ *    roaring: The bitmap.
+ *    count: The number of containers it needs to hold.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise.
+ */
+static int reserve_containers(struct dt_roaring * roaring, size_t count);
+
+/** Finds a value in a sorted array.
+ *
+ *  Arguments:
+ *    values: The array.
+ *    length: The number of values.
+ *    low: The value to find.
+ *    index: Where to put its index, or where it would go.
+ *
+ *  Returns:
+ *    True if it was found.
+ */
+static bool find_value(const uint16_t * values, uint32_t length,
+	uint16_t low, uint32_t * index);
+
+/** Finds the last run starting at or before a value.
+ *
+ *  Arguments:
+ *    runs: The runs.
+ *    length: The number of runs.
+ *    low: The value.
+ *
+ *  Returns:
+ *    The index of the run. Or -1 if every run starts after.
+ */
+static long find_run(const struct run * runs, uint32_t length, uint16_t low);
+
+/** Finds the next bit set or clear.
+ *
+ *  Arguments:
+ *    words: The bitmap.
+ *    from: The first bit to look at.
+ *    set: Whether to look for a set bit or a clear one.
+ *
+ *  Returns:
+ *    The bit. Or CONTAINER_VALUES if there is none.
+ */
+static uint32_t next_bit(const uint64_t * words, uint32_t from, bool set);
+
+/** Counts the set bits in a range of a bitmap.
+ *
+ *  Arguments:
+ *    words: The bitmap.
+ *    first: The first bit.
+ *    last: The last bit, counted too.
+ *
+ *  Returns:
+ *    The number of bits set.
+ */
+static uint32_t count_range(const uint64_t * words, uint32_t first,
+	uint32_t last);
+
+static void set_range(uint64_t * words, uint32_t first, uint32_t last);
+
+static bool container_has(const struct container * container, uint16_t low);
+static int container_add(struct container * container, uint16_t low);
+static int container_remove(struct container * container, uint16_t low);
+static int run_add(struct container * container, uint16_t low);
+static int run_remove(struct container * container, uint16_t low);
+
+/** Grows the array or runs of a container.
+ *
+ *  Arguments:
+ *    container: The container.
+ *    size: The size of one array value or run.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise.
+ */
+static int container_grow(struct container * container, size_t size);
+
+/** ORs a container's values into a bitmap.
+ *
+ *  Arguments:
+ *    container: The container.
+ *    words: The bitmap.
+ */
+static void container_or_words(const struct container * container,
+	uint64_t * words);
+
+/** Makes a container from a bitmap.
+ *
+ *  Arguments:
+ *    container: The container to set up.
+ *    words: A bitmap from malloc.
+ *    cardinality: The number of bits set.
+ *
+ *  Returns:
+ *    Zero on success, with words taken or freed. A negative
+ *    number otherwise, with the container and words as
+ *    they were.
+ */
+static int container_from_words(struct container * container,
+	uint64_t * words, uint32_t cardinality);
+
+/** Changes a run container to whichever of an array or
+ *  bitmap suits its cardinality.
+ *
+ *  Arguments:
+ *    container: The container.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise, with
+ *    the container unchanged.
+ */
+static int container_unrun(struct container * container);
+
+static int container_copy(struct container * to, const struct container * from);
+static size_t container_size(const struct container * container);
+
+/** The smallest an array or bitmap of some values can be.
+ *
+ *  Arguments:
+ *    cardinality: The number of values.
+ *
+ *  Returns:
+ *    The size in bytes.
+ */
+static size_t plain_size(uint32_t cardinality);
+static void container_free(struct container * container);
+
+/** Works out the union of two containers with the same key.
+ *
+ *  Arguments:
+ *    out: The container to set up, with its key set.
+ *    a: The first container.
+ *    b: The second container.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise.
+ */
+static int container_union(struct container * out,
+	const struct container * a, const struct container * b);
+
+/** Works out the intersection of two containers with the
+ *  same key.
+ *
+ *  Arguments:
+ *    out: The container to set up, with its key set.
+ *    a: The first container.
+ *    b: The second container.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise. The
+ *    result may be empty.
+ */
+static int container_intersection(struct container * out,
+	const struct container * a, const struct container * b);
+
+static uint32_t container_intersection_cardinality(
+	const struct container * a, const struct container * b);
+
+/** Counts the runs a container would take.
+ *
+ *  Arguments:
+ *    container: An array or bitmap container.
+ *
+ *  Returns:
+ *    The number of runs.
+ */
+static uint32_t count_runs(const struct container * container);
+
+struct dt_roaring * dt_roaring_new(void)
+{
+	struct dt_roaring * roaring = malloc(sizeof(*roaring));
+	if (!roaring) return NULL;
+
+	roaring->containers = NULL;
+	roaring->length = 0;
+	roaring->capacity = 0;
+	return roaring;
+}
+
+int dt_roaring_add(struct dt_roaring * roaring, uint32_t value)
+{
+	size_t index;
+	struct container * container;
+
+	if (find_container(roaring, value >> 16, &index)) {
+		container = roaring->containers + index;
+	} else {
+		container = insert_container(roaring, index, value >> 16);
+		if (!container) return DT_ROARING_ENOMEM;
+	}
+
+	if (container_add(container, value & 0xffff)) {
+		if (!container->cardinality) erase_container(roaring, index);
+		return DT_ROARING_ENOMEM;
+	}
+	return 0;
+}
+
+int dt_roaring_remove(struct dt_roaring * roaring, uint32_t value)
+{
+	size_t index;
+	if (!find_container(roaring, value >> 16, &index)) return 0;
+
+	struct container * container = roaring->containers + index;
+	if (container_remove(container, value & 0xffff)) {
+		return DT_ROARING_ENOMEM;
+	}
+
+	if (!container->cardinality) erase_container(roaring, index);
+	return 0;
+}
+
+bool dt_roaring_has(const struct dt_roaring * roaring, uint32_t value)
+{
+	size_t index;
+	if (!find_container(roaring, value >> 16, &index)) return false;
+	return container_has(roaring->containers + index, value & 0xffff);
+}
+
+size_t dt_roaring_cardinality(const struct dt_roaring * roaring)
+{
+	size_t cardinality = 0;
+	for (size_t i = 0; i < roaring->length; i++) {
+		cardinality += roaring->containers[i].cardinality;
+	}
+	return cardinality;
+}
+
+struct dt_roaring * dt_roaring_union(const struct dt_roaring * a,
+	const struct dt_roaring * b)
+{
+	struct dt_roaring * out = dt_roaring_new();
+	if (!out) return NULL;
+
+	if (reserve_containers(out, a->length + b->length)) {
+		dt_roaring_del(out);
+		return NULL;
+	}
+
+	size_t i = 0;
+	size_t j = 0;
+	while (i < a->length || j < b->length) {
+		const struct container * from_a = i < a->length ?
+			a->containers + i : NULL;
+		const struct container * from_b = j < b->length ?
+			b->containers + j : NULL;
+		struct container * container = out->containers + out->length;
+		int result;
+
+		if (from_a && from_b && from_a->key == from_b->key) {
+			container->key = from_a->key;
+			result = container_union(container, from_a, from_b);
+			i++;
+			j++;
+		} else if (from_a && (!from_b || from_a->key < from_b->key)) {
+			result = container_copy(container, from_a);
+			i++;
+		} else {
+			result = container_copy(container, from_b);
+			j++;
+		}
+
+		if (result) {
+			dt_roaring_del(out);
+			return NULL;
+		}
+		out->length++;
+	}
+
+	return out;
+}
+
+struct dt_roaring * dt_roaring_intersection(const struct dt_roaring * a,
+	const struct dt_roaring * b)
+{
+	struct dt_roaring * out = dt_roaring_new();
+	if (!out) return NULL;
+
+	size_t fewest = a->length < b->length ? a->length : b->length;
+	if (reserve_containers(out, fewest)) {
+		dt_roaring_del(out);
+		return NULL;
+	}
+
+	size_t i = 0;
+	size_t j = 0;
+	while (i < a->length && j < b->length) {
+		const struct container * from_a = a->containers + i;
+		const struct container * from_b = b->containers + j;
+
+		if (from_a->key < from_b->key) {
+			i++;
+			continue;
+		}
+		if (from_b->key < from_a->key) {
+			j++;
+			continue;
+		}
+
+		struct container * container = out->containers + out->length;
+		container->key = from_a->key;
+		if (container_intersection(container, from_a, from_b)) {
+			dt_roaring_del(out);
+			return NULL;
+		}
+
+		if (container->cardinality) {
+			out->length++;
+		} else {
+			container_free(container);
+		}
+		i++;
+		j++;
+	}
+
+	return out;
+}
+
+size_t dt_roaring_intersection_cardinality(const struct dt_roaring * a,
+	const struct dt_roaring * b)
+{
+	size_t cardinality = 0;
+	size_t i = 0;
+	size_t j = 0;
+
+	while (i < a->length && j < b->length) {
+		const struct container * from_a = a->containers + i;
+		const struct container * from_b = b->containers + j;
+
+		if (from_a->key < from_b->key) {
+			i++;
+		} else if (from_b->key < from_a->key) {
+			j++;
+		} else {
+			cardinality += container_intersection_cardinality(from_a, from_b);
+			i++;
+			j++;
+		}
+	}
+
+	return cardinality;
+}
+
+void dt_roaring_optimize(struct dt_roaring * roaring)
+{
+	uint64_t * words = NULL;
+
+	for (size_t i = 0; i < roaring->length; i++) {
+		struct container * container = roaring->containers + i;
+		if (container->type == RUN) continue;
+
+		uint32_t runs = count_runs(container);
+		if (sizeof(struct run) * runs >= plain_size(container->cardinality)) {
+			continue;
+		}
+
+		struct run * built = malloc(sizeof(*built) * runs);
+		if (!built) break;
+
+		const uint64_t * bits;
+		if (container->type == BITMAP) {
+			bits = container->words;
+		} else {
+			if (!words) {
+				words = malloc(sizeof(*words) * BITMAP_WORDS);
+				if (!words) {
+					free(built);
+					break;
+				}
+			}
+			memset(words, 0, sizeof(*words) * BITMAP_WORDS);
+			container_or_words(container, words);
+			bits = words;
+		}
+
+		uint32_t start = next_bit(bits, 0, true);
+		for (uint32_t k = 0; k < runs; k++) {
+			uint32_t end = next_bit(bits, start, false);
+			built[k].start = start;
+			built[k].length = end - start - 1;
+			start = next_bit(bits, end, true);
+		}
+
+		container_free(container);
+		container->type = RUN;
+		container->runs = built;
+		container->length = runs;
+		container->capacity = runs;
+	}
+
+	free(words);
+}
+
+size_t dt_roaring_size(const struct dt_roaring * roaring)
+{
+	size_t size = sizeof(*roaring) +
+		sizeof(*roaring->containers) * roaring->capacity;
+
+	for (size_t i = 0; i < roaring->length; i++) {
+		size += container_size(roaring->containers + i);
+	}
+	return size;
+}
+
+void dt_roaring_del(struct dt_roaring * roaring)
+{
+	for (size_t i = 0; i < roaring->length; i++) {
+		container_free(roaring->containers + i);
+	}
+	free(roaring->containers);
+	free(roaring);
+}
+
+struct dt_roaring_cursor * dt_roaring_cursor_new(
+	const struct dt_roaring * roaring)
+{
+	struct dt_roaring_cursor * cursor = malloc(sizeof(*cursor));
+	if (!cursor) return NULL;
+
+	cursor->roaring = roaring;
+	cursor->container = 0;
+	cursor->position = 0;
+	cursor->offset = 0;
+	return cursor;
+}
+
+bool dt_roaring_cursor_next(struct dt_roaring_cursor * cursor,
+	uint32_t * value)
+{
+	const struct dt_roaring * roaring = cursor->roaring;
+
+	for (; cursor->container < roaring->length; cursor->container++) {
+		const struct container * container =
+			roaring->containers + cursor->container;
+		uint32_t high = (uint32_t) container->key << 16;
+
+		switch (container->type) {
+		case ARRAY:
+			if (cursor->position < container->length) {
+				*value = high | container->values[cursor->position++];
+				return true;
+			}
+			break;
+		case BITMAP: {
+			uint32_t bit = next_bit(container->words, cursor->position, true);
+			if (bit < CONTAINER_VALUES) {
+				cursor->position = bit + 1;
+				*value = high | bit;
+				return true;
+			}
+			break;
+		}
+		default:
+			if (cursor->position < container->length) {
+				const struct run * run = container->runs + cursor->position;
+				*value = high | (run->start + cursor->offset);
+				if (cursor->offset == run->length) {
+					cursor->position++;
+					cursor->offset = 0;
+				} else {
+					cursor->offset++;
+				}
+				return true;
+			}
+			break;
+		}
+
+		cursor->position = 0;
+		cursor->offset = 0;
+	}
+
+	return false;
+}
+
+void dt_roaring_cursor_del(struct dt_roaring_cursor * cursor)
+{
+	free(cursor);
+}
+
+
+static bool find_container(const struct dt_roaring * roaring, uint16_t key,
+	size_t * index)
+{
+	size_t low = 0;
+	size_t high = roaring->length;
+
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		uint16_t found = roaring->containers[middle].key;
+
+		if (found == key) {
+			*index = middle;
+			return true;
+		}
+		if (found < key) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	*index = low;
+	return false;
+}
+
+static struct container * insert_container(struct dt_roaring * roaring,
+	size_t index, uint16_t key)
+{
+	if (reserve_containers(roaring, roaring->length + 1)) return NULL;
+
+	uint16_t * values = malloc(sizeof(*values) * INITIAL_ARRAY);
+	if (!values) return NULL;
+
+	struct container * container = roaring->containers + index;
+	memmove(container + 1, container,
+		sizeof(*container) * (roaring->length - index));
+	roaring->length++;
+
+	container->key = key;
+	container->type = ARRAY;
+	container->cardinality = 0;
+	container->length = 0;
+	container->capacity = INITIAL_ARRAY;
+	container->values = values;
+	return container;
+}
+
+static void erase_container(struct dt_roaring * roaring, size_t index)
+{
+	struct container * container = roaring->containers + index;
+	container_free(container);
+
+	roaring->length--;
+	memmove(container, container + 1,
+		sizeof(*container) * (roaring->length - index));
+}
+
+static int reserve_containers(struct dt_roaring * roaring, size_t count)
+{
+	if (count <= roaring->capacity) return 0;
+
+	size_t capacity = roaring->capacity ?
+		roaring->capacity : INITIAL_CONTAINERS;
+	while (capacity < count) capacity *= 2;
+
+	struct container * containers = realloc(roaring->containers,
+		sizeof(*containers) * capacity);
+	if (!containers) return DT_ROARING_ENOMEM;
+
+	roaring->containers = containers;
+	roaring->capacity = capacity;
+	return 0;
+}
+
+static bool find_value(const uint16_t * values, uint32_t length,
+	uint16_t low, uint32_t * index)
+{
+	uint32_t first = 0;
+	uint32_t last = length;
+
+	while (first < last) {
+		uint32_t middle = first + (last - first) / 2;
+		if (values[middle] == low) {
+			*index = middle;
+			return true;
+		}
+		if (values[middle] < low) {
+			first = middle + 1;
+		} else {
+			last = middle;
+		}
+	}
+
+	*index = first;
+	return false;
+}
+
+static long find_run(const struct run * runs, uint32_t length, uint16_t low)
+{
+	uint32_t first = 0;
+	uint32_t last = length;
+
+	// The first run starting after low.
+	while (first < last) {
+		uint32_t middle = first + (last - first) / 2;
+		if (runs[middle].start <= low) {
+			first = middle + 1;
+		} else {
+			last = middle;
+		}
+	}
+
+	return (long) first - 1;
+}
+
+static uint32_t next_bit(const uint64_t * words, uint32_t from, bool set)
+{
+	while (from < CONTAINER_VALUES) {
+		uint64_t word = set ? words[from / 64] : ~words[from / 64];
+		word &= ~0ull << (from % 64);
+
+		if (word) return from / 64 * 64 + __builtin_ctzll(word);
+		from = (from / 64 + 1) * 64;
+	}
+
+	return CONTAINER_VALUES;
+}
+
+static uint32_t count_range(const uint64_t * words, uint32_t first,
+	uint32_t last)
+{
+	uint32_t first_word = first / 64;
+	uint32_t last_word = last / 64;
+	uint64_t first_mask = ~0ull << (first % 64);
+	uint64_t last_mask = ~0ull >> (63 - last % 64);
+
+	if (first_word == last_word) {
+		return __builtin_popcountll(words[first_word] & first_mask & last_mask);
+	}
+
+	uint32_t count = __builtin_popcountll(words[first_word] & first_mask);
+	for (uint32_t i = first_word + 1; i < last_word; i++) {
+		count += __builtin_popcountll(words[i]);
+	}
+	return count + __builtin_popcountll(words[last_word] & last_mask);
+}
+
+static void set_range(uint64_t * words, uint32_t first, uint32_t last)
+{
+	uint32_t first_word = first / 64;
+	uint32_t last_word = last / 64;
+	uint64_t first_mask = ~0ull << (first % 64);
+	uint64_t last_mask = ~0ull >> (63 - last % 64);
+
+	if (first_word == last_word) {
+		words[first_word] |= first_mask & last_mask;
+		return;
+	}
+
+	words[first_word] |= first_mask;
+	for (uint32_t i = first_word + 1; i < last_word; i++) {
+		words[i] = ~0ull;
+	}
+	words[last_word] |= last_mask;
+}
+
+static bool container_has(const struct container * container, uint16_t low)
+{
+	uint32_t index;
+
+	switch (container->type) {
+	case ARRAY:
+		return find_value(container->values, container->length, low, &index);
+	case BITMAP:
+		return container->words[low / 64] >> (low % 64) & 1;
+	default: {
+		long run = find_run(container->runs, container->length, low);
+		return run >= 0 && low <= (uint32_t) container->runs[run].start +
+			container->runs[run].length;
+	}
+	}
+}
+
+static int container_add(struct container * container, uint16_t low)
+{
+	switch (container->type) {
+	case ARRAY: {
+		uint32_t index;
+		if (find_value(container->values, container->length, low, &index)) {
+			return 0;
+		}
+
+		if (container->length == ARRAY_MAX) {
+			// Full, a bitmap is smaller from here on.
+			uint64_t * words = calloc(BITMAP_WORDS, sizeof(*words));
+			if (!words) return DT_ROARING_ENOMEM;
+
+			container_or_words(container, words);
+			free(container->values);
+			container->type = BITMAP;
+			container->words = words;
+			return container_add(container, low);
+		}
+
+		if (container->length == container->capacity &&
+			container_grow(container, sizeof(*container->values))) {
+			return DT_ROARING_ENOMEM;
+		}
+
+		memmove(container->values + index + 1, container->values + index,
+			sizeof(*container->values) * (container->length - index));
+		container->values[index] = low;
+		container->length++;
+		container->cardinality++;
+		return 0;
+	}
+	case BITMAP: {
+		uint64_t bit = 1ull << (low % 64);
+		if (container->words[low / 64] & bit) return 0;
+
+		container->words[low / 64] |= bit;
+		container->cardinality++;
+		return 0;
+	}
+	default:
+		return run_add(container, low);
+	}
+}
+
+static int container_remove(struct container * container, uint16_t low)
+{
+	switch (container->type) {
+	case ARRAY: {
+		uint32_t index;
+		if (!find_value(container->values, container->length, low, &index)) {
+			return 0;
+		}
+
+		container->length--;
+		container->cardinality--;
+		memmove(container->values + index, container->values + index + 1,
+			sizeof(*container->values) * (container->length - index));
+
+		if (container->length && container->length < container->capacity / 4) {
+			// Failing to shrink is harmless.
+			uint16_t * values = realloc(container->values,
+				sizeof(*values) * container->capacity / 2);
+			if (values) {
+				container->values = values;
+				container->capacity /= 2;
+			}
+		}
+		return 0;
+	}
+	case BITMAP: {
+		uint64_t bit = 1ull << (low % 64);
+		if (!(container->words[low / 64] & bit)) return 0;
+
+		container->words[low / 64] &= ~bit;
+		container->cardinality--;
+
+		// Well below where an array grows into a bitmap, so
+		// a container on the border does not flip back and
+		// forth. Failing to shrink is harmless.
+		if (container->cardinality == ARRAY_MAX / 2) {
+			container_from_words(container, container->words,
+				container->cardinality);
+		}
+		return 0;
+	}
+	default:
+		return run_remove(container, low);
+	}
+}
+
+static int run_add(struct container * container, uint16_t low)
+{
+	struct run * runs = container->runs;
+	long before = find_run(runs, container->length, low);
+	uint32_t after = before + 1;
+
+	if (before >= 0 && low <= (uint32_t) runs[before].start +
+		runs[before].length) {
+		return 0;
+	}
+
+	if (before >= 0 &&
+		low == (uint32_t) runs[before].start + runs[before].length + 1) {
+		// Extends the run before, and may join it to the next.
+		runs[before].length++;
+		if (after < container->length && runs[after].start == low + 1) {
+			runs[before].length += runs[after].length + 1;
+			container->length--;
+			memmove(runs + after, runs + after + 1,
+				sizeof(*runs) * (container->length - after));
+		}
+	} else if (after < container->length && runs[after].start == low + 1) {
+		runs[after].start--;
+		runs[after].length++;
+	} else {
+		if (container->length == container->capacity &&
+			container_grow(container, sizeof(*runs))) {
+			return DT_ROARING_ENOMEM;
+		}
+
+		runs = container->runs;
+		memmove(runs + after + 1, runs + after,
+			sizeof(*runs) * (container->length - after));
+		runs[after].start = low;
+		runs[after].length = 0;
+		container->length++;
+	}
+
+	container->cardinality++;
+
+	if (sizeof(struct run) * container->length >
+		plain_size(container->cardinality)) {
+		// Failing to convert is harmless.
+		container_unrun(container);
+	}
+	return 0;
+}
+
+static int run_remove(struct container * container, uint16_t low)
+{
+	struct run * runs = container->runs;
+	long index = find_run(runs, container->length, low);
+
+	if (index < 0) return 0;
+
+	uint32_t start = runs[index].start;
+	uint32_t end = start + runs[index].length;
+	if (low > end) return 0;
+
+	if (start == end) {
+		container->length--;
+		memmove(runs + index, runs + index + 1,
+			sizeof(*runs) * (container->length - index));
+	} else if (low == start) {
+		runs[index].start++;
+		runs[index].length--;
+	} else if (low == end) {
+		runs[index].length--;
+	} else {
+		// Splits the run in two.
+		if (container->length == container->capacity &&
+			container_grow(container, sizeof(*runs))) {
+			return DT_ROARING_ENOMEM;
+		}
+
+		runs = container->runs;
+		memmove(runs + index + 2, runs + index + 1,
+			sizeof(*runs) * (container->length - index - 1));
+		runs[index].length = low - start - 1;
+		runs[index + 1].start = low + 1;
+		runs[index + 1].length = end - low - 1;
+		container->length++;
+	}
+
+	container->cardinality--;
+	return 0;
+}
+
+static int container_grow(struct container * container, size_t size)
+{
+	uint32_t capacity = container->capacity ? container->capacity * 2 : 1;
+	void * grown = realloc(container->values, size * capacity);
+	if (!grown) return DT_ROARING_ENOMEM;
+
+	container->values = grown;
+	container->capacity = capacity;
+	return 0;
+}
+
+static void container_or_words(const struct container * container,
+	uint64_t * words)
+{
+	switch (container->type) {
+	case ARRAY:
+		for (uint32_t i = 0; i < container->length; i++) {
+			uint16_t low = container->values[i];
+			words[low / 64] |= 1ull << (low % 64);
+		}
+		return;
+	case BITMAP:
+		for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+			words[i] |= container->words[i];
+		}
+		return;
+	default:
+		for (uint32_t i = 0; i < container->length; i++) {
+			const struct run * run = container->runs + i;
+			set_range(words, run->start, (uint32_t) run->start + run->length);
+		}
+		return;
+	}
+}
+
+static int container_from_words(struct container * container,
+	uint64_t * words, uint32_t cardinality)
+{
+	if (cardinality > ARRAY_MAX) {
+		container->type = BITMAP;
+		container->words = words;
+		container->cardinality = cardinality;
+		return 0;
+	}
+
+	uint16_t * values = malloc(sizeof(*values) *
+		(cardinality ? cardinality : 1));
+	if (!values) return DT_ROARING_ENOMEM;
+
+	uint32_t length = 0;
+	for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+		uint64_t word = words[i];
+		while (word) {
+			values[length++] = i * 64 + __builtin_ctzll(word);
+			// Clears the lowest bit set.
+			word &= word - 1;
+		}
+	}
+	free(words);
+
+	container->type = ARRAY;
+	container->values = values;
+	container->cardinality = cardinality;
+	container->length = length;
+	container->capacity = cardinality ? cardinality : 1;
+	return 0;
+}
+
+static int container_unrun(struct container * container)
+{
+	uint64_t * words = calloc(BITMAP_WORDS, sizeof(*words));
+	if (!words) return DT_ROARING_ENOMEM;
+
+	container_or_words(container, words);
+
+	struct run * runs = container->runs;
+	if (container_from_words(container, words, container->cardinality)) {
+		free(words);
+		return DT_ROARING_ENOMEM;
+	}
+
+	free(runs);
+	return 0;
+}
+
+static int container_copy(struct container * to, const struct container * from)
+{
+	*to = *from;
+
+	size_t size;
+	switch (from->type) {
+	case ARRAY:
+		size = sizeof(*from->values) * from->length;
+		break;
+	case BITMAP:
+		size = sizeof(*from->words) * BITMAP_WORDS;
+		break;
+	default:
+		size = sizeof(*from->runs) * from->length;
+		break;
+	}
+
+	to->values = malloc(size ? size : 1);
+	if (!to->values) return DT_ROARING_ENOMEM;
+
+	memcpy(to->values, from->values, size);
+	to->capacity = from->length;
+	return 0;
+}
+
+static size_t container_size(const struct container * container)
+{
+	switch (container->type) {
+	case ARRAY:
+		return sizeof(*container->values) * container->capacity;
+	case BITMAP:
+		return sizeof(*container->words) * BITMAP_WORDS;
+	default:
+		return sizeof(*container->runs) * container->capacity;
+	}
+}
+
+static size_t plain_size(uint32_t cardinality)
+{
+	if (cardinality > ARRAY_MAX) return sizeof(uint64_t) * BITMAP_WORDS;
+	return sizeof(uint16_t) * cardinality;
+}
+
+static void container_free(struct container * container)
+{
+	// Every kind of data shares the one pointer.
+	free(container->values);
+}
+
+static int container_union(struct container * out,
+	const struct container * a, const struct container * b)
+{
+	if (a->type == ARRAY && b->type == ARRAY &&
+		a->cardinality + b->cardinality <= ARRAY_MAX) {
+		uint32_t capacity = a->cardinality + b->cardinality;
+		uint16_t * values = malloc(sizeof(*values) * capacity);
+		if (!values) return DT_ROARING_ENOMEM;
+
+		uint32_t i = 0;
+		uint32_t j = 0;
+		uint32_t length = 0;
+		while (i < a->length && j < b->length) {
+			if (a->values[i] < b->values[j]) {
+				values[length++] = a->values[i++];
+			} else if (b->values[j] < a->values[i]) {
+				values[length++] = b->values[j++];
+			} else {
+				values[length++] = a->values[i++];
+				j++;
+			}
+		}
+		while (i < a->length) values[length++] = a->values[i++];
+		while (j < b->length) values[length++] = b->values[j++];
+
+		out->type = ARRAY;
+		out->values = values;
+		out->length = length;
+		out->capacity = capacity;
+		out->cardinality = length;
+		return 0;
+	}
+
+	uint64_t * words = malloc(sizeof(*words) * BITMAP_WORDS);
+	if (!words) return DT_ROARING_ENOMEM;
+
+	if (a->type == BITMAP && b->type == BITMAP) {
+		// Word at a time, which compilers vectorise.
+		for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+			words[i] = a->words[i] | b->words[i];
+		}
+	} else {
+		memset(words, 0, sizeof(*words) * BITMAP_WORDS);
+		container_or_words(a, words);
+		container_or_words(b, words);
+	}
+
+	uint32_t cardinality = 0;
+	for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+		cardinality += __builtin_popcountll(words[i]);
+	}
+
+	if (container_from_words(out, words, cardinality)) {
+		free(words);
+		return DT_ROARING_ENOMEM;
+	}
+	return 0;
+}
+
+static int container_intersection(struct container * out,
+	const struct container * a, const struct container * b)
+{
+	if (b->type == ARRAY && a->type != ARRAY) {
+		const struct container * swap = a;
+		a = b;
+		b = swap;
+	}
+
+	if (a->type == ARRAY) {
+		// Keep the values of the array that the other has.
+		uint32_t capacity = a->length ? a->length : 1;
+		uint16_t * values = malloc(sizeof(*values) * capacity);
+		if (!values) return DT_ROARING_ENOMEM;
+
+		uint32_t length = 0;
+		for (uint32_t i = 0; i < a->length; i++) {
+			if (container_has(b, a->values[i])) {
+				values[length++] = a->values[i];
+			}
+		}
+
+		out->type = ARRAY;
+		out->values = values;
+		out->length = length;
+		out->capacity = capacity;
+		out->cardinality = length;
+		return 0;
+	}
+
+	uint64_t * words = calloc(BITMAP_WORDS, sizeof(*words));
+	if (!words) return DT_ROARING_ENOMEM;
+
+	if (a->type == BITMAP && b->type == BITMAP) {
+		for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+			words[i] = a->words[i] & b->words[i];
+		}
+	} else {
+		// At least one is runs, lay both out as bitmaps.
+		uint64_t * other = calloc(BITMAP_WORDS, sizeof(*other));
+		if (!other) {
+			free(words);
+			return DT_ROARING_ENOMEM;
+		}
+
+		container_or_words(a, words);
+		container_or_words(b, other);
+		for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+			words[i] &= other[i];
+		}
+		free(other);
+	}
+
+	uint32_t cardinality = 0;
+	for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+		cardinality += __builtin_popcountll(words[i]);
+	}
+
+	if (container_from_words(out, words, cardinality)) {
+		free(words);
+		return DT_ROARING_ENOMEM;
+	}
+	return 0;
+}
+
+static uint32_t container_intersection_cardinality(
+	const struct container * a, const struct container * b)
+{
+	if (b->type == ARRAY && a->type != ARRAY) {
+		const struct container * swap = a;
+		a = b;
+		b = swap;
+	}
+
+	if (a->type == ARRAY) {
+		uint32_t cardinality = 0;
+		for (uint32_t i = 0; i < a->length; i++) {
+			cardinality += container_has(b, a->values[i]);
+		}
+		return cardinality;
+	}
+
+	if (a->type == BITMAP && b->type == BITMAP) {
+		uint32_t cardinality = 0;
+		for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+			cardinality += __builtin_popcountll(a->words[i] & b->words[i]);
+		}
+		return cardinality;
+	}
+
+	if (a->type != RUN) {
+		const struct container * swap = a;
+		a = b;
+		b = swap;
+	}
+
+	uint32_t cardinality = 0;
+	if (b->type == BITMAP) {
+		for (uint32_t i = 0; i < a->length; i++) {
+			const struct run * run = a->runs + i;
+			cardinality += count_range(b->words, run->start,
+				(uint32_t) run->start + run->length);
+		}
+		return cardinality;
+	}
+
+	// Both runs, add up where they overlap.
+	uint32_t i = 0;
+	uint32_t j = 0;
+	while (i < a->length && j < b->length) {
+		uint32_t a_end = (uint32_t) a->runs[i].start + a->runs[i].length;
+		uint32_t b_end = (uint32_t) b->runs[j].start + b->runs[j].length;
+		uint32_t start = a->runs[i].start > b->runs[j].start ?
+			a->runs[i].start : b->runs[j].start;
+		uint32_t end = a_end < b_end ? a_end : b_end;
+
+		if (start <= end) cardinality += end - start + 1;
+		if (a_end < b_end) {
+			i++;
+		} else {
+			j++;
+		}
+	}
+	return cardinality;
+}
+
+static uint32_t count_runs(const struct container * container)
+{
+	uint32_t runs = 0;
+
+	switch (container->type) {
+	case ARRAY:
+		for (uint32_t i = 0; i < container->length; i++) {
+			if (!i || container->values[i] != container->values[i - 1] + 1) {
+				runs++;
+			}
+		}
+		return runs;
+	case BITMAP: {
+		// A run starts at each bit set whose bit below is clear.
+		uint64_t carry = 0;
+		for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+			uint64_t word = container->words[i];
+			runs += __builtin_popcountll(word & ~(word << 1 | carry));
+			carry = word >> 63;
+		}
+		return runs;
+	}
+	default:
+		return container->length;
+	}
+}
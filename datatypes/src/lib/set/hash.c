@@ -3,13 +3,15 @@
 #include "set/error.h"
 
 #include <stdbool.h>
-#include <stdlib.h>
+#include <string.h>
 
+#include "allocator.h"
 #include "buffers.h"
-#include "list.h"
+#include "hashing.h"
+#include "list/vector.h"
 #include "set/tree.h"
 
-#define BUCKET_SET dt_set_tree_new
+#define BUCKET_SET dt_set_tree_new_with_allocator
 
 // This must be a power of two.
 //
@@ -19,12 +21,25 @@
 #define DEFAULT_BUCKETS_COUNT 16
 
 struct set_implementation;
+struct hash_set;
+
+// Small sets use inline_buckets and only allocate
+// a bucket array once they grow.
 struct set_implementation {
 	int (* comparator)(void * a, void * b);
 	unsigned int (* hash)(void * item);
 	struct dt_set * * buckets;
 	size_t buckets_size;
 	size_t item_count;
+	// Where the set, its buckets and item lists come from.
+	const struct dt_allocator * allocator;
+	struct dt_set * inline_buckets[DEFAULT_BUCKETS_COUNT];
+};
+
+// The set and its implementation share one allocation.
+struct hash_set {
+	struct dt_set set;
+	struct set_implementation implementation;
 };
 
 static int set_insert(struct dt_set * this, void * item);
@@ -56,38 +71,28 @@ static struct dt_set * get_bucket_set(
 	void * item,
 	bool create);
 
-// Remaps the hash to another hash.
-// Used to avoid poor hash results.
-static long universal_hash_a = 1188764207l;
-static long universal_hash_b = 3227431836l;
-static long const universal_hash_prime = 4294967311l;
-static unsigned int universal_hash(unsigned int hash);
-
 struct dt_set * dt_set_hash_new(
 	int (* comparator)(void * a, void * b),
 	unsigned int (* hash)(void * item))
 {
-	struct dt_set * set;
-	set = malloc(sizeof(*set));
+	return dt_set_hash_new_with_allocator(comparator, hash, NULL);
+}
 
-	if (!set) return NULL;
+struct dt_set * dt_set_hash_new_with_allocator(
+	int (* comparator)(void * a, void * b),
+	unsigned int (* hash)(void * item),
+	const struct dt_allocator * allocator)
+{
+	struct hash_set * hash_set;
+	hash_set = dt_allocator_alloc(allocator, sizeof(*hash_set));
 
-	struct set_implementation * implementation;
-	implementation = malloc(sizeof(*implementation));
+	if (!hash_set) return NULL;
 
-	if (!implementation) {
-		free(set);
-		return NULL;
-	}
+	struct dt_set * set = &hash_set->set;
+	struct set_implementation * implementation = &hash_set->implementation;
 
-	struct dt_set * * buckets;
-	size_t buckets_size = ARRAY_SIZE(buckets, DEFAULT_BUCKETS_COUNT);
-	buckets = malloc(buckets_size);
-	if (!buckets) {
-		free(implementation);
-		free(set);
-		return NULL;
-	}
+	struct dt_set * * buckets = implementation->inline_buckets;
+	size_t buckets_size = sizeof(implementation->inline_buckets);
 	for (size_t i = 0; i < ARRAY_LENGTH(buckets, buckets_size); i++) {
 		buckets[i] = NULL;
 	}
@@ -104,6 +109,7 @@ struct dt_set * dt_set_hash_new(
 	implementation->buckets = buckets;
 	implementation->buckets_size = buckets_size;
 	implementation->item_count = 0;
+	implementation->allocator = allocator;
 
 	return set;
 }
@@ -157,7 +163,7 @@ static struct dt_list * set_items(const struct dt_set * this)
 {
 	struct set_implementation * data = this->_data;
 
-	struct dt_list * list = dt_list_new();
+	struct dt_list * list = dt_list_vector_new_with_allocator(data->allocator);
 	if (!list) return NULL;
 
 	for (size_t i = 0; i < ARRAY_LENGTH(data->buckets, data->buckets_size); i++) {
@@ -173,14 +179,9 @@ static struct dt_list * set_items(const struct dt_set * this)
 			return NULL;
 		}
 
+		struct dt_list_iterator storage;
 		struct dt_list_iterator * iter;
-		iter = bucket_list->iterator(bucket_list);
-
-		if (!iter) {
-			bucket_list->del(bucket_list);
-			list->del(list);
-			return NULL;
-		}
+		iter = bucket_list->iterator_init(bucket_list, &storage);
 
 		for (; iter->valid(iter); iter->next(iter)) {
 			list->insert(list, list->length(list), iter->get(iter));
@@ -201,9 +202,10 @@ static void set_del(struct dt_set * this)
 		if (!bucket_set) continue;
 		bucket_set->del(bucket_set);
 	}
-	free(data->buckets);
-	free(data);
-	free(this);
+	if (data->buckets != data->inline_buckets) {
+		dt_allocator_free(data->allocator, data->buckets, data->buckets_size);
+	}
+	dt_allocator_free(data->allocator, this, sizeof(struct hash_set));
 }
 
 static void grow(struct dt_set * this)
@@ -218,15 +220,20 @@ static void grow(struct dt_set * this)
 	struct dt_list * items = this->items(this);
 	if (!items) return;
 
+	struct dt_list_iterator storage;
 	struct dt_list_iterator * iter;
-	iter = items->iterator(items);
-	if (!iter) {
-		items->del(items);
-		return;
-	}
+	iter = items->iterator_init(items, &storage);
 
 	struct dt_set * * new_buckets;
-	new_buckets = realloc(data->buckets, new_size);
+	if (data->buckets == data->inline_buckets) {
+		new_buckets = dt_allocator_alloc(data->allocator, new_size);
+		if (new_buckets) {
+			memcpy(new_buckets, data->buckets, data->buckets_size);
+		}
+	} else {
+		new_buckets = dt_allocator_realloc(data->allocator,
+			data->buckets, data->buckets_size, new_size);
+	}
 	if (!new_buckets) {
 		iter->del(iter);
 		items->del(items);
@@ -237,15 +244,20 @@ static void grow(struct dt_set * this)
 	for (size_t i = 0; i < ARRAY_LENGTH(data->buckets, data->buckets_size); i++) {
 		struct dt_set * bucket = data->buckets[i];
 		if (bucket) bucket->del(bucket);
+	}
+	for (size_t i = 0; i < ARRAY_LENGTH(data->buckets, new_size); i++) {
 		data->buckets[i] = NULL;
 	}
 	data->buckets_size = new_size;
+	data->item_count = 0;
 
 	for (; iter->valid(iter); iter->next(iter)) {
 		// If we run out of memory now ...
 		// There's no real way to recover.
 		this->insert(this, iter->get(iter));
 	}
+	iter->del(iter);
+	items->del(items);
 }
 
 static bool should_grow(struct set_implementation * data)
@@ -268,32 +280,17 @@ static struct dt_set * get_bucket_set(
 	bool create)
 {
 	unsigned int hash = data->hash(item);
-	hash = universal_hash(hash);
+	hash = dt_hash_universal(hash);
 	hash = hash & (ARRAY_LENGTH(data->buckets, data->buckets_size) - 1);
 
 	struct dt_set * bucket_set;
 	bucket_set = data->buckets[hash];
 
 	if (!bucket_set && create) {
-		bucket_set = BUCKET_SET(data->comparator, data->hash);
+		bucket_set = BUCKET_SET(data->comparator, data->hash,
+			data->allocator);
 		data->buckets[hash] = bucket_set;
 	}
 
 	return bucket_set;
 }
-
-static unsigned int universal_hash(unsigned int hash)
-{
-	unsigned long a = universal_hash_a;
-	unsigned long b = universal_hash_b;
-	unsigned long p = universal_hash_prime;
-
-	unsigned long bits = ((unsigned int) ~0);
-	unsigned int shift = sizeof(unsigned int) * 8;
-
-	// Computes (a * hash + b) % p without ever overflowing.
-
-	return
-		((((a >> shift) * ((1 << shift) * hash % p)) % p +
-		(a & bits) % p) + b) % p;
-}
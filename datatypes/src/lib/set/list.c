@@ -2,23 +2,55 @@
 #include "set/list.h"
 #include "set/error.h"
 
-#include <stdlib.h>
-
+#include "allocator.h"
 #include "list.h"
 #include "list/error.h"
 #include "list/readonly.h"
+#include "list/vector.h"
 
 struct set_implementation;
+struct list_set;
+
 struct set_implementation {
+	// The list lives in here so the set is a single allocation.
+	struct dt_list_vector_storage list_storage;
 	int (* comparator)(void * a, void * b);
 	struct dt_list * list;
+	// Where the set, its list and item lists come from.
+	const struct dt_allocator * allocator;
+};
+
+// The set and its implementation share one allocation.
+struct list_set {
+	struct dt_set set;
+	struct set_implementation implementation;
 };
 
+_Static_assert(
+	sizeof(struct list_set) <= sizeof(struct dt_set_list_storage),
+	"dt_set_list_storage is too small");
+
 static int set_insert(struct dt_set * this, void * item);
 static void * set_has(const struct dt_set * this, void * item);
 static void set_remove(struct dt_set * this, void * item);
 static struct dt_list * set_items(const struct dt_set * this);
 static void set_del(struct dt_set * this);
+static void set_dispose(struct dt_set * this);
+
+/** Sets up a set in place.
+ *
+ *  Arguments:
+ *    list_set: The memory to set the set up in.
+ *    comparator: An ordering function for the items.
+ *    allocator: Where the list grows into. NULL for malloc.
+ *
+ *  Returns:
+ *    The set.
+ */
+static struct dt_set * list_set_init(
+	struct list_set * list_set,
+	int (* comparator)(void * a, void * b),
+	const struct dt_allocator * allocator);
 
 /** Finds the index to insert the item at
  *  in the list.
@@ -52,25 +84,40 @@ struct dt_set * dt_set_list_new(
 	int (* comparator)(void * a, void * b),
 	unsigned int (* hash)(void * item))
 {
-	struct dt_set * set;
-	set = malloc(sizeof(*set));
+	return dt_set_list_new_with_allocator(comparator, hash, NULL);
+}
 
-	if (!set) return NULL;
+struct dt_set * dt_set_list_new_with_allocator(
+	int (* comparator)(void * a, void * b),
+	unsigned int (* hash)(void * item),
+	const struct dt_allocator * allocator)
+{
+	struct list_set * list_set;
+	list_set = dt_allocator_alloc(allocator, sizeof(*list_set));
 
-	struct set_implementation * implementation;
-	implementation = malloc(sizeof(*implementation));
+	if (!list_set) return NULL;
 
-	if (!implementation) {
-		free(set);
-		return NULL;
-	}
+	return list_set_init(list_set, comparator, allocator);
+}
 
-	struct dt_list * list = dt_list_new();
-	if (!list) {
-		free(implementation);
-		free(set);
-		return NULL;
-	}
+struct dt_set * dt_set_list_init(
+	struct dt_set_list_storage * storage,
+	int (* comparator)(void * a, void * b),
+	unsigned int (* hash)(void * item))
+{
+	struct dt_set * set;
+	set = list_set_init((struct list_set *) storage, comparator, NULL);
+	set->del = &set_dispose;
+	return set;
+}
+
+static struct dt_set * list_set_init(
+	struct list_set * list_set,
+	int (* comparator)(void * a, void * b),
+	const struct dt_allocator * allocator)
+{
+	struct dt_set * set = &list_set->set;
+	struct set_implementation * implementation = &list_set->implementation;
 
 	set->insert = &set_insert;
 	set->has = &set_has;
@@ -80,7 +127,9 @@ struct dt_set * dt_set_list_new(
 	set->_data = implementation;
 
 	implementation->comparator = comparator;
-	implementation->list = list;
+	implementation->allocator = allocator;
+	implementation->list = dt_list_vector_init_with_allocator(
+		&implementation->list_storage, allocator);
 	return set;
 }
 
@@ -128,16 +177,21 @@ static void set_remove(struct dt_set * this, void * item)
 static struct dt_list * set_items(const struct dt_set * this)
 {
 	const struct set_implementation * data = this->_data;
-	return dt_list_readonly_new(data->list);
+	return dt_list_readonly_new_with_allocator(data->list, data->allocator);
 
 }
 
 static void set_del(struct dt_set * this)
+{
+	struct set_implementation * data = this->_data;
+	set_dispose(this);
+	dt_allocator_free(data->allocator, this, sizeof(struct list_set));
+}
+
+static void set_dispose(struct dt_set * this)
 {
 	struct set_implementation * data = this->_data;
 	data->list->del(data->list);
-	free(data);
-	free(this);
 }
 
 static size_t find_index(
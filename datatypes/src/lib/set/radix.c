@@ -0,0 +1,1039 @@
+
+#include "set/radix.h"
+#include "set/error.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "list.h"
+
+// Up to this many bytes of a node's compressed path are kept
+// in the node. Longer paths are checked against a leaf below.
+#define PREFIX_LENGTH 8
+
+// Node sizes. A node grows into the next size up when full
+// and shrinks a little before it could fit the size down,
+// so a node on the border does not flip back and forth.
+enum node_type {
+	NODE4,
+	NODE16,
+	NODE48,
+	NODE256
+};
+
+#define NODE16_SHRINK 3
+#define NODE48_SHRINK 12
+#define NODE256_SHRINK 37
+
+struct set_implementation;
+struct radix_set;
+struct radix_leaf;
+struct radix_node;
+
+// Children are either nodes or leaves. Leaves are tagged by
+// setting the low bit of the pointer.
+struct radix_leaf {
+	char * item;
+	// The length of the item including its NUL. The NUL
+	// is part of the key so no key is a prefix of another.
+	size_t length;
+};
+
+// The header every node starts with.
+struct radix_node {
+	unsigned char type;
+	unsigned short count;
+	// The bytes all the keys below share, skipped over
+	// rather than having a node each.
+	size_t prefix_length;
+	unsigned char prefix[PREFIX_LENGTH];
+};
+
+// The small nodes keep their keys sorted, children matching.
+struct radix_node4 {
+	struct radix_node node;
+	unsigned char keys[4];
+	void * children[4];
+};
+
+struct radix_node16 {
+	struct radix_node node;
+	unsigned char keys[16];
+	void * children[16];
+};
+
+// index holds one more than the child's slot, zero for none.
+struct radix_node48 {
+	struct radix_node node;
+	unsigned char index[256];
+	void * children[48];
+};
+
+struct radix_node256 {
+	struct radix_node node;
+	void * children[256];
+};
+
+struct set_implementation {
+	void * root;
+	// The longest key ever inserted, which bounds how deep
+	// the tree can be.
+	size_t longest;
+};
+
+// The set and its implementation share one allocation.
+struct radix_set {
+	struct dt_set set;
+	struct set_implementation implementation;
+};
+
+// A node being walked and where the walk is up to in it.
+struct cursor_frame {
+	const struct radix_node * node;
+	unsigned int next;
+};
+
+struct dt_set_radix_cursor {
+	// The subtree to start from, until the first call.
+	void * start;
+	size_t length;
+	struct cursor_frame frames[];
+};
+
+static int set_insert(struct dt_set * this, void * item);
+static void * set_has(const struct dt_set * this, void * item);
+static void set_remove(struct dt_set * this, void * item);
+static struct dt_list * set_items(const struct dt_set * this);
+static void set_del(struct dt_set * this);
+
+static int is_leaf(const void * child);
+static struct radix_leaf * leaf_of(const void * child);
+static void * leaf_child(struct radix_leaf * leaf);
+
+/** Checks if a leaf holds a key.
+ *
+ *  Arguments:
+ *    leaf: The leaf.
+ *    key: The key, with its NUL.
+ *    key_length: The length of the key.
+ *
+ *  Returns:
+ *    Non zero if they are the same.
+ */
+static int leaf_matches(const struct radix_leaf * leaf,
+	const unsigned char * key, size_t key_length);
+
+/** Allocates an empty node.
+ *
+ *  Arguments:
+ *    type: The size of node.
+ *
+ *  Returns:
+ *    The node. Or NULL if there is not enough memory.
+ */
+static struct radix_node * node_new(enum node_type type);
+
+/** Copies the count and prefix of a node into one
+ *  replacing it.
+ *
+ *  Arguments:
+ *    to: The new node.
+ *    from: The old node.
+ */
+static void copy_header(struct radix_node * to, const struct radix_node * from);
+
+/** Finds the slot for a child.
+ *
+ *  Arguments:
+ *    node: The node to look in.
+ *    byte: The key byte of the child.
+ *
+ *  Returns:
+ *    The slot holding the child. Or NULL if there is none.
+ */
+static void ** find_child(struct radix_node * node, unsigned char byte);
+
+/** Adds a child to a node, growing it if it is full.
+ *
+ *  Arguments:
+ *    ref: Where the node is linked from.
+ *    node: The node.
+ *    byte: The key byte of the child.
+ *    child: The child.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise.
+ */
+static int add_child(void ** ref, struct radix_node * node,
+	unsigned char byte, void * child);
+
+/** Adds a child to the sorted keys of a small node.
+ *
+ *  Arguments:
+ *    keys: The keys of the node.
+ *    children: The children of the node.
+ *    count: The number of children. There must be
+ *      room for one more.
+ *    byte: The key byte of the child.
+ *    child: The child.
+ */
+static void sorted_insert(unsigned char * keys, void ** children,
+	size_t count, unsigned char byte, void * child);
+
+/** Takes a child out of a node, shrinking or collapsing
+ *  the node if it gets small enough.
+ *
+ *  Arguments:
+ *    ref: Where the node is linked from.
+ *    node: The node.
+ *    byte: The key byte of the child.
+ *    slot: The slot holding the child.
+ */
+static void remove_child(void ** ref, struct radix_node * node,
+	unsigned char byte, void ** slot);
+
+/** Finds the leftmost leaf of a subtree.
+ *
+ *  Arguments:
+ *    child: A node or a leaf.
+ *
+ *  Returns:
+ *    The leaf with the smallest key.
+ */
+static struct radix_leaf * minimum(const void * child);
+
+/** Compares a key with the prefix bytes kept in a node.
+ *
+ *  Arguments:
+ *    node: The node.
+ *    key: The key.
+ *    key_length: The length of the key.
+ *    depth: How far into the key the node is.
+ *
+ *  Returns:
+ *    The number of bytes that matched.
+ *
+ *  Notes:
+ *    Only the bytes kept in the node are checked, a leaf
+ *    check must confirm the rest.
+ */
+static size_t check_prefix(const struct radix_node * node,
+	const unsigned char * key, size_t key_length, size_t depth);
+
+/** Finds where a key leaves the whole prefix of a node.
+ *
+ *  Arguments:
+ *    node: The node.
+ *    key: The key.
+ *    key_length: The length of the key.
+ *    depth: How far into the key the node is.
+ *
+ *  Returns:
+ *    The number of bytes that matched, at most
+ *    the prefix length.
+ */
+static size_t prefix_mismatch(const struct radix_node * node,
+	const unsigned char * key, size_t key_length, size_t depth);
+
+/** Inserts a leaf into the tree.
+ *
+ *  Arguments:
+ *    root: Where the tree is linked from.
+ *    leaf: The new leaf.
+ *
+ *  Returns:
+ *    Zero if it was added. One if the key was already
+ *    there. A negative number otherwise.
+ */
+static int tree_insert(void ** root, struct radix_leaf * leaf);
+
+/** Finds the leaf holding a key.
+ *
+ *  Arguments:
+ *    root: The root of the tree.
+ *    key: The key, with its NUL.
+ *    key_length: The length of the key.
+ *
+ *  Returns:
+ *    The leaf. Or NULL if the key is not there.
+ */
+static struct radix_leaf * tree_find(void * root,
+	const unsigned char * key, size_t key_length);
+
+/** Unlinks the leaf holding a key.
+ *
+ *  Arguments:
+ *    root: Where the tree is linked from.
+ *    key: The key, with its NUL.
+ *    key_length: The length of the key.
+ *
+ *  Returns:
+ *    The leaf. Or NULL if the key is not there.
+ */
+static struct radix_leaf * tree_remove(void ** root,
+	const unsigned char * key, size_t key_length);
+
+static void tree_free(void * child);
+
+/** Takes the next child of the node a frame is walking.
+ *
+ *  Arguments:
+ *    frame: The frame.
+ *
+ *  Returns:
+ *    The child. Or NULL if every child has been taken.
+ */
+static void * frame_next(struct cursor_frame * frame);
+
+struct dt_set * dt_set_radix_new(void)
+{
+	struct radix_set * radix;
+	radix = malloc(sizeof(*radix));
+
+	if (!radix) return NULL;
+
+	struct dt_set * set = &radix->set;
+	struct set_implementation * implementation = &radix->implementation;
+
+	set->insert = &set_insert;
+	set->has = &set_has;
+	set->remove = &set_remove;
+	set->items = &set_items;
+	set->del = &set_del;
+	set->_data = implementation;
+
+	implementation->root = NULL;
+	implementation->longest = 0;
+	return set;
+}
+
+struct dt_set_radix_cursor * dt_set_radix_prefix_cursor(
+	const struct dt_set * set, const char * prefix)
+{
+	const struct set_implementation * data = set->_data;
+
+	// Each node on a path takes at least one byte of the
+	// key, so the longest key bounds the frames needed.
+	if (data->longest > (((size_t) -1) - sizeof(struct dt_set_radix_cursor)) /
+		sizeof(struct cursor_frame)) {
+		// Overflow
+		return NULL;
+	}
+
+	struct dt_set_radix_cursor * cursor = malloc(
+		sizeof(*cursor) + sizeof(struct cursor_frame) * data->longest);
+	if (!cursor) return NULL;
+
+	cursor->length = 0;
+
+	// Walk down to the subtree holding every key with the
+	// prefix. The prefix goes without its NUL.
+	const unsigned char * key = (const unsigned char *) prefix;
+	size_t key_length = strlen(prefix);
+	void * child = data->root;
+	size_t depth = 0;
+
+	while (child && depth < key_length) {
+		if (is_leaf(child)) {
+			const struct radix_leaf * leaf = leaf_of(child);
+			if (leaf->length - 1 < key_length ||
+				memcmp(leaf->item + depth, key + depth, key_length - depth)) {
+				child = NULL;
+			}
+			break;
+		}
+
+		struct radix_node * node = child;
+		if (node->prefix_length) {
+			size_t needed = key_length - depth;
+			if (needed > node->prefix_length) needed = node->prefix_length;
+
+			if (prefix_mismatch(node, key, key_length, depth) < needed) {
+				child = NULL;
+				break;
+			}
+
+			depth += node->prefix_length;
+			if (depth >= key_length) break;
+		}
+
+		void ** slot = find_child(node, key[depth]);
+		child = slot ? *slot : NULL;
+		depth++;
+	}
+
+	cursor->start = child;
+	return cursor;
+}
+
+void * dt_set_radix_cursor_next(struct dt_set_radix_cursor * cursor)
+{
+	void * child = cursor->start;
+	cursor->start = NULL;
+
+	for (;;) {
+		if (child) {
+			if (is_leaf(child)) return leaf_of(child)->item;
+
+			struct cursor_frame * frame = cursor->frames + cursor->length;
+			frame->node = child;
+			frame->next = 0;
+			cursor->length++;
+		}
+
+		if (!cursor->length) return NULL;
+
+		child = frame_next(cursor->frames + cursor->length - 1);
+		if (!child) cursor->length--;
+	}
+}
+
+void dt_set_radix_cursor_del(struct dt_set_radix_cursor * cursor)
+{
+	free(cursor);
+}
+
+
+static int set_insert(struct dt_set * this, void * item)
+{
+	struct set_implementation * data = this->_data;
+
+	struct radix_leaf * leaf = malloc(sizeof(*leaf));
+	if (!leaf) return DT_SET_ENOMEM;
+
+	leaf->item = item;
+	leaf->length = strlen(item) + 1;
+
+	int result = tree_insert(&data->root, leaf);
+	if (result) {
+		// Already there or out of memory.
+		free(leaf);
+		return result < 0 ? result : 0;
+	}
+
+	if (leaf->length > data->longest) data->longest = leaf->length;
+	return 0;
+}
+
+static void * set_has(const struct dt_set * this, void * item)
+{
+	const struct set_implementation * data = this->_data;
+	struct radix_leaf * leaf = tree_find(data->root,
+		(const unsigned char *) item, strlen(item) + 1);
+
+	return leaf ? leaf->item : NULL;
+}
+
+static void set_remove(struct dt_set * this, void * item)
+{
+	struct set_implementation * data = this->_data;
+	free(tree_remove(&data->root,
+		(const unsigned char *) item, strlen(item) + 1));
+}
+
+static struct dt_list * set_items(const struct dt_set * this)
+{
+	struct dt_list * list;
+	list = dt_list_new();
+	if (!list) return NULL;
+
+	struct dt_set_radix_cursor * cursor = dt_set_radix_prefix_cursor(this, "");
+	if (!cursor) {
+		list->del(list);
+		return NULL;
+	}
+
+	struct dt_list_iterator storage;
+	struct dt_list_iterator * iterator;
+	iterator = list->iterator_init(list, &storage);
+
+	void * item;
+	while ((item = dt_set_radix_cursor_next(cursor))) {
+		if (iterator->insert(iterator, item)) {
+			iterator->del(iterator);
+			dt_set_radix_cursor_del(cursor);
+			list->del(list);
+			return NULL;
+		}
+		iterator->next(iterator);
+	}
+
+	iterator->del(iterator);
+	dt_set_radix_cursor_del(cursor);
+	return list;
+}
+
+static void set_del(struct dt_set * this)
+{
+	struct set_implementation * data = this->_data;
+	tree_free(data->root);
+	free(this);
+}
+
+static int is_leaf(const void * child)
+{
+	return (uintptr_t) child & 1;
+}
+
+static struct radix_leaf * leaf_of(const void * child)
+{
+	return (struct radix_leaf *) ((uintptr_t) child - 1);
+}
+
+static void * leaf_child(struct radix_leaf * leaf)
+{
+	return (void *) ((uintptr_t) leaf + 1);
+}
+
+static int leaf_matches(const struct radix_leaf * leaf,
+	const unsigned char * key, size_t key_length)
+{
+	return leaf->length == key_length &&
+		memcmp(leaf->item, key, key_length) == 0;
+}
+
+static struct radix_node * node_new(enum node_type type)
+{
+	size_t size;
+	switch (type) {
+	case NODE4: size = sizeof(struct radix_node4); break;
+	case NODE16: size = sizeof(struct radix_node16); break;
+	case NODE48: size = sizeof(struct radix_node48); break;
+	default: size = sizeof(struct radix_node256); break;
+	}
+
+	struct radix_node * node = calloc(1, size);
+	if (!node) return NULL;
+
+	node->type = type;
+	return node;
+}
+
+static void copy_header(struct radix_node * to, const struct radix_node * from)
+{
+	to->count = from->count;
+	to->prefix_length = from->prefix_length;
+	memcpy(to->prefix, from->prefix, sizeof(to->prefix));
+}
+
+static void ** find_child(struct radix_node * node, unsigned char byte)
+{
+	switch (node->type) {
+	case NODE4: {
+		struct radix_node4 * node4 = (struct radix_node4 *) node;
+		for (size_t i = 0; i < node->count && node4->keys[i] <= byte; i++) {
+			if (node4->keys[i] == byte) return node4->children + i;
+		}
+		return NULL;
+	}
+	case NODE16: {
+		struct radix_node16 * node16 = (struct radix_node16 *) node;
+		for (size_t i = 0; i < node->count && node16->keys[i] <= byte; i++) {
+			if (node16->keys[i] == byte) return node16->children + i;
+		}
+		return NULL;
+	}
+	case NODE48: {
+		struct radix_node48 * node48 = (struct radix_node48 *) node;
+		if (!node48->index[byte]) return NULL;
+		return node48->children + node48->index[byte] - 1;
+	}
+	default: {
+		struct radix_node256 * node256 = (struct radix_node256 *) node;
+		if (!node256->children[byte]) return NULL;
+		return node256->children + byte;
+	}
+	}
+}
+
+static int add_child(void ** ref, struct radix_node * node,
+	unsigned char byte, void * child)
+{
+	switch (node->type) {
+	case NODE4: {
+		struct radix_node4 * node4 = (struct radix_node4 *) node;
+		if (node->count < 4) {
+			sorted_insert(node4->keys, node4->children, node->count,
+				byte, child);
+			node->count++;
+			return 0;
+		}
+
+		struct radix_node16 * node16 =
+			(struct radix_node16 *) node_new(NODE16);
+		if (!node16) return DT_SET_ENOMEM;
+
+		copy_header(&node16->node, node);
+		memcpy(node16->keys, node4->keys, sizeof(node4->keys));
+		memcpy(node16->children, node4->children, sizeof(node4->children));
+		*ref = node16;
+		free(node4);
+		return add_child(ref, &node16->node, byte, child);
+	}
+	case NODE16: {
+		struct radix_node16 * node16 = (struct radix_node16 *) node;
+		if (node->count < 16) {
+			sorted_insert(node16->keys, node16->children, node->count,
+				byte, child);
+			node->count++;
+			return 0;
+		}
+
+		struct radix_node48 * node48 =
+			(struct radix_node48 *) node_new(NODE48);
+		if (!node48) return DT_SET_ENOMEM;
+
+		copy_header(&node48->node, node);
+		for (size_t i = 0; i < 16; i++) {
+			node48->index[node16->keys[i]] = i + 1;
+			node48->children[i] = node16->children[i];
+		}
+		*ref = node48;
+		free(node16);
+		return add_child(ref, &node48->node, byte, child);
+	}
+	case NODE48: {
+		struct radix_node48 * node48 = (struct radix_node48 *) node;
+		if (node->count < 48) {
+			// Removals leave holes, take the first.
+			size_t slot = 0;
+			while (node48->children[slot]) slot++;
+
+			node48->children[slot] = child;
+			node48->index[byte] = slot + 1;
+			node->count++;
+			return 0;
+		}
+
+		struct radix_node256 * node256 =
+			(struct radix_node256 *) node_new(NODE256);
+		if (!node256) return DT_SET_ENOMEM;
+
+		copy_header(&node256->node, node);
+		for (size_t i = 0; i < 256; i++) {
+			if (node48->index[i]) {
+				node256->children[i] = node48->children[node48->index[i] - 1];
+			}
+		}
+		*ref = node256;
+		free(node48);
+		return add_child(ref, &node256->node, byte, child);
+	}
+	default: {
+		struct radix_node256 * node256 = (struct radix_node256 *) node;
+		node256->children[byte] = child;
+		node->count++;
+		return 0;
+	}
+	}
+}
+
+static void sorted_insert(unsigned char * keys, void ** children,
+	size_t count, unsigned char byte, void * child)
+{
+	size_t i = 0;
+	while (i < count && keys[i] < byte) i++;
+
+	memmove(keys + i + 1, keys + i, count - i);
+	memmove(children + i + 1, children + i, sizeof(*children) * (count - i));
+	keys[i] = byte;
+	children[i] = child;
+}
+
+static void remove_child(void ** ref, struct radix_node * node,
+	unsigned char byte, void ** slot)
+{
+	switch (node->type) {
+	case NODE4: {
+		struct radix_node4 * node4 = (struct radix_node4 *) node;
+		size_t i = slot - node4->children;
+		memmove(node4->keys + i, node4->keys + i + 1, node->count - i - 1);
+		memmove(node4->children + i, node4->children + i + 1,
+			sizeof(*slot) * (node->count - i - 1));
+		node->count--;
+
+		if (node->count > 1) return;
+
+		// One child left, it can take this node's place.
+		void * child = node4->children[0];
+		if (!is_leaf(child)) {
+			// Its prefix becomes this prefix, the byte
+			// leading to it, then its own prefix.
+			struct radix_node * only = child;
+			size_t length = node->prefix_length;
+			if (length < PREFIX_LENGTH) {
+				node->prefix[length] = node4->keys[0];
+				length++;
+			}
+			if (length < PREFIX_LENGTH) {
+				size_t copied = only->prefix_length;
+				if (copied > PREFIX_LENGTH - length) {
+					copied = PREFIX_LENGTH - length;
+				}
+				memcpy(node->prefix + length, only->prefix, copied);
+				length += copied;
+			}
+			if (length > PREFIX_LENGTH) length = PREFIX_LENGTH;
+
+			memcpy(only->prefix, node->prefix, length);
+			only->prefix_length += node->prefix_length + 1;
+		}
+
+		*ref = child;
+		free(node4);
+		return;
+	}
+	case NODE16: {
+		struct radix_node16 * node16 = (struct radix_node16 *) node;
+		size_t i = slot - node16->children;
+		memmove(node16->keys + i, node16->keys + i + 1, node->count - i - 1);
+		memmove(node16->children + i, node16->children + i + 1,
+			sizeof(*slot) * (node->count - i - 1));
+		node->count--;
+
+		if (node->count != NODE16_SHRINK) return;
+
+		// Failing to shrink is harmless.
+		struct radix_node4 * node4 = (struct radix_node4 *) node_new(NODE4);
+		if (!node4) return;
+
+		copy_header(&node4->node, node);
+		memcpy(node4->keys, node16->keys, node->count);
+		memcpy(node4->children, node16->children,
+			sizeof(*slot) * node->count);
+		*ref = node4;
+		free(node16);
+		return;
+	}
+	case NODE48: {
+		struct radix_node48 * node48 = (struct radix_node48 *) node;
+		*slot = NULL;
+		node48->index[byte] = 0;
+		node->count--;
+
+		if (node->count != NODE48_SHRINK) return;
+
+		// Failing to shrink is harmless.
+		struct radix_node16 * node16 =
+			(struct radix_node16 *) node_new(NODE16);
+		if (!node16) return;
+
+		copy_header(&node16->node, node);
+		size_t count = 0;
+		for (size_t i = 0; i < 256; i++) {
+			if (!node48->index[i]) continue;
+			node16->keys[count] = i;
+			node16->children[count] = node48->children[node48->index[i] - 1];
+			count++;
+		}
+		*ref = node16;
+		free(node48);
+		return;
+	}
+	default: {
+		struct radix_node256 * node256 = (struct radix_node256 *) node;
+		*slot = NULL;
+		node->count--;
+
+		if (node->count != NODE256_SHRINK) return;
+
+		// Failing to shrink is harmless.
+		struct radix_node48 * node48 =
+			(struct radix_node48 *) node_new(NODE48);
+		if (!node48) return;
+
+		copy_header(&node48->node, node);
+		size_t count = 0;
+		for (size_t i = 0; i < 256; i++) {
+			if (!node256->children[i]) continue;
+			node48->index[i] = count + 1;
+			node48->children[count] = node256->children[i];
+			count++;
+		}
+		*ref = node48;
+		free(node256);
+		return;
+	}
+	}
+}
+
+static struct radix_leaf * minimum(const void * child)
+{
+	while (!is_leaf(child)) {
+		const struct radix_node * node = child;
+		size_t i = 0;
+
+		switch (node->type) {
+		case NODE4:
+			child = ((const struct radix_node4 *) node)->children[0];
+			break;
+		case NODE16:
+			child = ((const struct radix_node16 *) node)->children[0];
+			break;
+		case NODE48: {
+			const struct radix_node48 * node48 =
+				(const struct radix_node48 *) node;
+			while (!node48->index[i]) i++;
+			child = node48->children[node48->index[i] - 1];
+			break;
+		}
+		default: {
+			const struct radix_node256 * node256 =
+				(const struct radix_node256 *) node;
+			while (!node256->children[i]) i++;
+			child = node256->children[i];
+			break;
+		}
+		}
+	}
+
+	return leaf_of(child);
+}
+
+static size_t check_prefix(const struct radix_node * node,
+	const unsigned char * key, size_t key_length, size_t depth)
+{
+	size_t limit = node->prefix_length;
+	if (limit > PREFIX_LENGTH) limit = PREFIX_LENGTH;
+	if (limit > key_length - depth) limit = key_length - depth;
+
+	size_t i = 0;
+	while (i < limit && node->prefix[i] == key[depth + i]) i++;
+	return i;
+}
+
+static size_t prefix_mismatch(const struct radix_node * node,
+	const unsigned char * key, size_t key_length, size_t depth)
+{
+	size_t i = check_prefix(node, key, key_length, depth);
+	if (i < PREFIX_LENGTH || node->prefix_length <= PREFIX_LENGTH) return i;
+
+	// The rest of the prefix is only kept in the keys below.
+	const struct radix_leaf * least = minimum(node);
+	const unsigned char * least_key = (const unsigned char *) least->item;
+
+	size_t limit = key_length - depth;
+	if (limit > node->prefix_length) limit = node->prefix_length;
+
+	while (i < limit && least_key[depth + i] == key[depth + i]) i++;
+	return i;
+}
+
+static int tree_insert(void ** root, struct radix_leaf * leaf)
+{
+	const unsigned char * key = (const unsigned char *) leaf->item;
+	void ** ref = root;
+	size_t depth = 0;
+
+	for (;;) {
+		void * child = *ref;
+
+		if (!child) {
+			*ref = leaf_child(leaf);
+			return 0;
+		}
+
+		if (is_leaf(child)) {
+			struct radix_leaf * other = leaf_of(child);
+			if (leaf_matches(other, key, leaf->length)) return 1;
+
+			// Split the leaf into a node over both keys. Neither
+			// key is a prefix of the other so they differ before
+			// either ends.
+			const unsigned char * other_key =
+				(const unsigned char *) other->item;
+			struct radix_node4 * node4 =
+				(struct radix_node4 *) node_new(NODE4);
+			if (!node4) return DT_SET_ENOMEM;
+
+			size_t common = 0;
+			while (key[depth + common] == other_key[depth + common]) common++;
+
+			node4->node.prefix_length = common;
+			memcpy(node4->node.prefix, key + depth,
+				common < PREFIX_LENGTH ? common : PREFIX_LENGTH);
+
+			sorted_insert(node4->keys, node4->children, 0,
+				other_key[depth + common], child);
+			sorted_insert(node4->keys, node4->children, 1,
+				key[depth + common], leaf_child(leaf));
+			node4->node.count = 2;
+
+			*ref = node4;
+			return 0;
+		}
+
+		struct radix_node * node = child;
+		if (node->prefix_length) {
+			size_t mismatch = prefix_mismatch(node, key, leaf->length, depth);
+
+			if (mismatch < node->prefix_length) {
+				// The key leaves the prefix part way, split it
+				// with a node where they part.
+				struct radix_node4 * node4 =
+					(struct radix_node4 *) node_new(NODE4);
+				if (!node4) return DT_SET_ENOMEM;
+
+				node4->node.prefix_length = mismatch;
+				memcpy(node4->node.prefix, node->prefix,
+					mismatch < PREFIX_LENGTH ? mismatch : PREFIX_LENGTH);
+
+				unsigned char byte;
+				size_t rest = node->prefix_length - mismatch - 1;
+				if (node->prefix_length <= PREFIX_LENGTH) {
+					byte = node->prefix[mismatch];
+					memmove(node->prefix, node->prefix + mismatch + 1, rest);
+				} else {
+					const unsigned char * least_key =
+						(const unsigned char *) minimum(node)->item;
+					byte = least_key[depth + mismatch];
+					memcpy(node->prefix, least_key + depth + mismatch + 1,
+						rest < PREFIX_LENGTH ? rest : PREFIX_LENGTH);
+				}
+				node->prefix_length = rest;
+
+				sorted_insert(node4->keys, node4->children, 0, byte, node);
+				sorted_insert(node4->keys, node4->children, 1,
+					key[depth + mismatch], leaf_child(leaf));
+				node4->node.count = 2;
+
+				*ref = node4;
+				return 0;
+			}
+
+			depth += node->prefix_length;
+		}
+
+		void ** slot = find_child(node, key[depth]);
+		if (!slot) return add_child(ref, node, key[depth], leaf_child(leaf));
+
+		ref = slot;
+		depth++;
+	}
+}
+
+static struct radix_leaf * tree_find(void * root,
+	const unsigned char * key, size_t key_length)
+{
+	void * child = root;
+	size_t depth = 0;
+
+	while (child) {
+		if (is_leaf(child)) {
+			struct radix_leaf * leaf = leaf_of(child);
+			return leaf_matches(leaf, key, key_length) ? leaf : NULL;
+		}
+
+		struct radix_node * node = child;
+		if (node->prefix_length) {
+			// Skip the prefix on the bytes kept here, the leaf
+			// check at the end catches any difference past them.
+			size_t kept = node->prefix_length < PREFIX_LENGTH ?
+				node->prefix_length : PREFIX_LENGTH;
+			if (check_prefix(node, key, key_length, depth) != kept) return NULL;
+			depth += node->prefix_length;
+		}
+
+		if (depth >= key_length) return NULL;
+
+		void ** slot = find_child(node, key[depth]);
+		child = slot ? *slot : NULL;
+		depth++;
+	}
+
+	return NULL;
+}
+
+static struct radix_leaf * tree_remove(void ** root,
+	const unsigned char * key, size_t key_length)
+{
+	void ** ref = root;
+	size_t depth = 0;
+
+	while (*ref) {
+		if (is_leaf(*ref)) {
+			// Only a lone leaf at the root gets here.
+			struct radix_leaf * leaf = leaf_of(*ref);
+			if (!leaf_matches(leaf, key, key_length)) return NULL;
+
+			*ref = NULL;
+			return leaf;
+		}
+
+		struct radix_node * node = *ref;
+		if (node->prefix_length) {
+			size_t kept = node->prefix_length < PREFIX_LENGTH ?
+				node->prefix_length : PREFIX_LENGTH;
+			if (check_prefix(node, key, key_length, depth) != kept) return NULL;
+			depth += node->prefix_length;
+		}
+
+		if (depth >= key_length) return NULL;
+
+		void ** slot = find_child(node, key[depth]);
+		if (!slot) return NULL;
+
+		if (is_leaf(*slot)) {
+			struct radix_leaf * leaf = leaf_of(*slot);
+			if (!leaf_matches(leaf, key, key_length)) return NULL;
+
+			remove_child(ref, node, key[depth], slot);
+			return leaf;
+		}
+
+		ref = slot;
+		depth++;
+	}
+
+	return NULL;
+}
+
+static void tree_free(void * child)
+{
+	if (!child) return;
+
+	if (is_leaf(child)) {
+		free(leaf_of(child));
+		return;
+	}
+
+	struct cursor_frame frame = {child, 0};
+	void * grandchild;
+	while ((grandchild = frame_next(&frame))) {
+		tree_free(grandchild);
+	}
+	free(child);
+}
+
+static void * frame_next(struct cursor_frame * frame)
+{
+	const struct radix_node * node = frame->node;
+
+	switch (node->type) {
+	case NODE4:
+		if (frame->next >= node->count) return NULL;
+		return ((const struct radix_node4 *) node)->children[frame->next++];
+	case NODE16:
+		if (frame->next >= node->count) return NULL;
+		return ((const struct radix_node16 *) node)->children[frame->next++];
+	case NODE48: {
+		const struct radix_node48 * node48 =
+			(const struct radix_node48 *) node;
+		while (frame->next < 256) {
+			unsigned char index = node48->index[frame->next++];
+			if (index) return node48->children[index - 1];
+		}
+		return NULL;
+	}
+	default: {
+		const struct radix_node256 * node256 =
+			(const struct radix_node256 *) node;
+		while (frame->next < 256) {
+			void * child = node256->children[frame->next++];
+			if (child) return child;
+		}
+		return NULL;
+	}
+	}
+}
@@ -0,0 +1,120 @@
+
+#include "set/roaring.h"
+#include "set/error.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "list.h"
+#include "roaring.h"
+
+struct set_implementation;
+struct roaring_set;
+
+struct set_implementation {
+	struct dt_roaring * roaring;
+};
+
+// The set and its implementation share one allocation.
+struct roaring_set {
+	struct dt_set set;
+	struct set_implementation implementation;
+};
+
+static int set_insert(struct dt_set * this, void * item);
+static void * set_has(const struct dt_set * this, void * item);
+static void set_remove(struct dt_set * this, void * item);
+static struct dt_list * set_items(const struct dt_set * this);
+static void set_del(struct dt_set * this);
+
+struct dt_set * dt_set_roaring_new(void)
+{
+	struct roaring_set * roaring;
+	roaring = malloc(sizeof(*roaring));
+
+	if (!roaring) return NULL;
+
+	struct dt_set * set = &roaring->set;
+	struct set_implementation * implementation = &roaring->implementation;
+
+	implementation->roaring = dt_roaring_new();
+	if (!implementation->roaring) {
+		free(roaring);
+		return NULL;
+	}
+
+	set->insert = &set_insert;
+	set->has = &set_has;
+	set->remove = &set_remove;
+	set->items = &set_items;
+	set->del = &set_del;
+	set->_data = implementation;
+
+	return set;
+}
+
+static int set_insert(struct dt_set * this, void * item)
+{
+	struct set_implementation * data = this->_data;
+
+	if ((uintptr_t) item > UINT32_MAX) return DT_SET_ERROR;
+	if (dt_roaring_add(data->roaring, (uintptr_t) item)) return DT_SET_ENOMEM;
+	return 0;
+}
+
+static void * set_has(const struct dt_set * this, void * item)
+{
+	const struct set_implementation * data = this->_data;
+
+	if ((uintptr_t) item > UINT32_MAX) return NULL;
+	return dt_roaring_has(data->roaring, (uintptr_t) item) ? item : NULL;
+}
+
+static void set_remove(struct dt_set * this, void * item)
+{
+	struct set_implementation * data = this->_data;
+
+	if ((uintptr_t) item > UINT32_MAX) return;
+	// Only splitting a run can fail, which leaves the item in.
+	dt_roaring_remove(data->roaring, (uintptr_t) item);
+}
+
+static struct dt_list * set_items(const struct dt_set * this)
+{
+	const struct set_implementation * data = this->_data;
+	struct dt_list * list;
+	list = dt_list_new();
+	if (!list) return NULL;
+
+	struct dt_roaring_cursor * cursor = dt_roaring_cursor_new(data->roaring);
+	if (!cursor) {
+		list->del(list);
+		return NULL;
+	}
+
+	struct dt_list_iterator storage;
+	struct dt_list_iterator * iterator;
+	iterator = list->iterator_init(list, &storage);
+
+	uint32_t value;
+	while (dt_roaring_cursor_next(cursor, &value)) {
+		if (iterator->insert(iterator, (void *) (uintptr_t) value)) {
+			iterator->del(iterator);
+			dt_roaring_cursor_del(cursor);
+			list->del(list);
+			return NULL;
+		}
+		iterator->next(iterator);
+	}
+
+	iterator->del(iterator);
+	dt_roaring_cursor_del(cursor);
+	return list;
+}
+
+static void set_del(struct dt_set * this)
+{
+	struct set_implementation * data = this->_data;
+	dt_roaring_del(data->roaring);
+	free(this);
+}
@@ -0,0 +1,172 @@
+
+#include "set/sparse.h"
+#include "set/error.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "list.h"
+
+struct set_implementation;
+struct sparse_set;
+
+// An item is in the set when its sparse entry points at a
+// dense slot below length that holds it. Stale entries
+// fail that check, which is why clear can just reset the
+// length.
+struct set_implementation {
+	size_t universe;
+	size_t length;
+	void ** dense;
+	size_t * sparse;
+};
+
+// The set, its implementation and both arrays share one
+// allocation. The dense array follows the sparse one.
+struct sparse_set {
+	struct dt_set set;
+	struct set_implementation implementation;
+	size_t sparse[];
+};
+
+static int set_insert(struct dt_set * this, void * item);
+static void * set_has(const struct dt_set * this, void * item);
+static void set_remove(struct dt_set * this, void * item);
+static struct dt_list * set_items(const struct dt_set * this);
+static void set_del(struct dt_set * this);
+
+/** Finds where an item is in the dense array.
+ *
+ *  Arguments:
+ *    data: The set implementation.
+ *    item: The item.
+ *    index: Where to put its index in the dense array.
+ *
+ *  Returns:
+ *    True if the item is in the set.
+ */
+static bool find(const struct set_implementation * data, void * item,
+	size_t * index);
+
+struct dt_set * dt_set_sparse_new(size_t universe)
+{
+	_Static_assert(sizeof(size_t) == sizeof(void *),
+		"the dense array must line up after the sparse one");
+
+	if (universe > (((size_t) -1) - sizeof(struct sparse_set)) /
+		(sizeof(size_t) + sizeof(void *))) {
+		// Overflow
+		return NULL;
+	}
+
+	// Zeroed so no entry is ever read uninitialised. For a
+	// large universe the zero pages come from the system
+	// on first touch rather than being written here.
+	struct sparse_set * sparse;
+	sparse = calloc(1, sizeof(*sparse) +
+		(sizeof(size_t) + sizeof(void *)) * universe);
+
+	if (!sparse) return NULL;
+
+	struct dt_set * set = &sparse->set;
+	struct set_implementation * implementation = &sparse->implementation;
+
+	set->insert = &set_insert;
+	set->has = &set_has;
+	set->remove = &set_remove;
+	set->items = &set_items;
+	set->del = &set_del;
+	set->_data = implementation;
+
+	implementation->universe = universe;
+	implementation->length = 0;
+	implementation->sparse = sparse->sparse;
+	implementation->dense = (void **) (sparse->sparse + universe);
+	return set;
+}
+
+void dt_set_sparse_clear(struct dt_set * set)
+{
+	struct set_implementation * data = set->_data;
+	data->length = 0;
+}
+
+size_t dt_set_sparse_length(const struct dt_set * set)
+{
+	const struct set_implementation * data = set->_data;
+	return data->length;
+}
+
+void * const * dt_set_sparse_items(const struct dt_set * set)
+{
+	const struct set_implementation * data = set->_data;
+	return data->dense;
+}
+
+
+static int set_insert(struct dt_set * this, void * item)
+{
+	struct set_implementation * data = this->_data;
+	size_t index;
+
+	if ((uintptr_t) item >= data->universe) return DT_SET_ERROR;
+
+	// Already there, nothing to add.
+	if (find(data, item, &index)) return 0;
+
+	data->dense[data->length] = item;
+	data->sparse[(uintptr_t) item] = data->length;
+	data->length++;
+	return 0;
+}
+
+static void * set_has(const struct dt_set * this, void * item)
+{
+	const struct set_implementation * data = this->_data;
+	size_t index;
+
+	return find(data, item, &index) ? item : NULL;
+}
+
+static void set_remove(struct dt_set * this, void * item)
+{
+	struct set_implementation * data = this->_data;
+	size_t index;
+
+	if (!find(data, item, &index)) return;
+
+	// Move the last item into the gap.
+	data->length--;
+	void * last = data->dense[data->length];
+	data->dense[index] = last;
+	data->sparse[(uintptr_t) last] = index;
+}
+
+static struct dt_list * set_items(const struct dt_set * this)
+{
+	const struct set_implementation * data = this->_data;
+	struct dt_list * list;
+	list = dt_list_new();
+	if (!list) return NULL;
+
+	if (list->append_many(list, data->dense, data->length)) {
+		list->del(list);
+		return NULL;
+	}
+	return list;
+}
+
+static void set_del(struct dt_set * this)
+{
+	free(this);
+}
+
+static bool find(const struct set_implementation * data, void * item,
+	size_t * index)
+{
+	uintptr_t value = (uintptr_t) item;
+	if (value >= data->universe) return false;
+
+	*index = data->sparse[value];
+	return *index < data->length && data->dense[*index] == item;
+}
@@ -2,10 +2,12 @@
 #include "set/tree.h"
 #include "set/error.h"
 
-#include <stdlib.h>
+#include "allocator.h"
+#include "list/vector.h"
 
 struct set_implementation;
 struct set_tree;
+struct tree_set;
 
 // Note:
 // LEFT + RIGHT = BALANCED
@@ -25,6 +27,14 @@ struct set_tree {
 struct set_implementation {
 	int (* comparator)(void * a, void * b);
 	struct set_tree * tree;
+	// Where the set, its nodes and item lists come from.
+	const struct dt_allocator * allocator;
+};
+
+// The set and its implementation share one allocation.
+struct tree_set {
+	struct dt_set set;
+	struct set_implementation implementation;
 };
 
 
@@ -49,18 +59,21 @@ static void set_tree_insert_balance (
 static int set_tree_remove_find(
 	struct set_tree * * tree,
 	void * item,
-	int (* comparator)(void * a, void * b));
+	int (* comparator)(void * a, void * b),
+	const struct dt_allocator * allocator);
 
 static int set_tree_remove(
 	struct set_tree * * tree,
 	struct set_tree * * to_swap,
-	int direction);
+	int direction,
+	const struct dt_allocator * allocator);
 
 static int set_tree_remove_balance(
 	struct set_tree * * tree,
 	int side);
 
-static void set_tree_free(struct set_tree * tree);
+static void set_tree_free(struct set_tree * tree,
+	const struct dt_allocator * allocator);
 
 static void set_tree_collect(
 	struct set_tree * tree,
@@ -73,18 +86,21 @@ struct dt_set * dt_set_tree_new(
 	int (* comparator)(void * a, void * b),
 	unsigned int (* hash)(void * item))
 {
-	struct dt_set * set;
-	set = malloc(sizeof(*set));
+	return dt_set_tree_new_with_allocator(comparator, hash, NULL);
+}
 
-	if (!set) return NULL;
+struct dt_set * dt_set_tree_new_with_allocator(
+	int (* comparator)(void * a, void * b),
+	unsigned int (* hash)(void * item),
+	const struct dt_allocator * allocator)
+{
+	struct tree_set * tree;
+	tree = dt_allocator_alloc(allocator, sizeof(*tree));
 
-	struct set_implementation * implementation;
-	implementation = malloc(sizeof(*implementation));
+	if (!tree) return NULL;
 
-	if (!implementation) {
-		free(set);
-		return NULL;
-	}
+	struct dt_set * set = &tree->set;
+	struct set_implementation * implementation = &tree->implementation;
 
 	set->insert = &set_insert;
 	set->has = &set_has;
@@ -95,6 +111,7 @@ struct dt_set * dt_set_tree_new(
 
 	implementation->comparator = comparator;
 	implementation->tree = NULL;
+	implementation->allocator = allocator;
 	return set;
 }
 
@@ -102,7 +119,11 @@ static int set_insert(struct dt_set * this, void * item)
 {
 	struct set_implementation * data = this->_data;
 	struct set_tree * node;
-	node = malloc(sizeof(*node));
+
+	// Already there, nothing to add.
+	if (set_tree_find(data->tree, item, data->comparator)) return 0;
+
+	node = dt_allocator_alloc(data->allocator, sizeof(*node));
 
 	if (!node) return DT_SET_ENOMEM;
 
@@ -127,23 +148,20 @@ static void * set_has(const struct dt_set * this, void * item)
 static void set_remove(struct dt_set * this, void * item)
 {
 	struct set_implementation * data = this->_data;
-	set_tree_remove_find(&(data->tree), item, data->comparator);
+	set_tree_remove_find(&(data->tree), item, data->comparator,
+		data->allocator);
 }
 
 static struct dt_list * set_items(const struct dt_set * this)
 {
 	struct set_implementation * data = this->_data;
 	struct dt_list * list;
-	list = dt_list_new();
+	list = dt_list_vector_new_with_allocator(data->allocator);
 	if (!list) return NULL;
 
+	struct dt_list_iterator storage;
 	struct dt_list_iterator * iterator;
-	iterator = list->iterator(list);
-
-	if (!iterator) {
-		list->del(list);
-		return NULL;
-	}
+	iterator = list->iterator_init(list, &storage);
 
 	set_tree_collect(data->tree, iterator);
 	iterator->del(iterator);
@@ -153,9 +171,8 @@ static struct dt_list * set_items(const struct dt_set * this)
 static void set_del(struct dt_set * this)
 {
 	struct set_implementation * data = this->_data;
-	set_tree_free(data->tree);
-	free(data);
-	free(this);
+	set_tree_free(data->tree, data->allocator);
+	dt_allocator_free(data->allocator, this, sizeof(struct tree_set));
 }
 
 static struct set_tree * set_tree_find(
@@ -260,19 +277,20 @@ static void set_tree_insert_balance (
 static int set_tree_remove_find(
 	struct set_tree * * tree,
 	void * item,
-	int (* comparator)(void * a, void * b))
+	int (* comparator)(void * a, void * b),
+	const struct dt_allocator * allocator)
 {
 	int compare = comparator(item, (*tree)->value);
 	if (compare == 0) {
-		return set_tree_remove(tree, tree, BALANCED);
+		return set_tree_remove(tree, tree, BALANCED, allocator);
 	} else if (compare < 0) {
 		if (set_tree_remove_find(
-				&((*tree)->left), item, comparator)) {
+				&((*tree)->left), item, comparator, allocator)) {
 			return set_tree_remove_balance(tree, LEFT);
 		}
 	} else {
 		if (set_tree_remove_find(
-				&((*tree)->right), item, comparator)) {
+				&((*tree)->right), item, comparator, allocator)) {
 			return set_tree_remove_balance(tree, RIGHT);
 		}
 	}
@@ -282,21 +300,22 @@ static int set_tree_remove_find(
 static int set_tree_remove(
 	struct set_tree * * tree,
 	struct set_tree * * to_swap,
-	enum balance_t direction)
+	enum balance_t direction,
+	const struct dt_allocator * allocator)
 {
 	int offset;
 	int side;
 	if (direction == BALANCED) {
 		if ((*tree)->right) {
 			offset = set_tree_remove(
-				&((*tree)->right), to_swap, RIGHT);
+				&((*tree)->right), to_swap, RIGHT, allocator);
 			side = RIGHT;
 		} else if ((*tree)->left) {
 			offset = set_tree_remove(
-				&((*tree)->left), to_swap, LEFT);
+				&((*tree)->left), to_swap, LEFT, allocator);
 			side = LEFT;
 		} else {
-			free(*tree);
+			dt_allocator_free(allocator, *tree, sizeof(**tree));
 			*tree = NULL;
 			return 1;
 		}
@@ -305,20 +324,20 @@ static int set_tree_remove(
 			void * value = (*to_swap)->value;
 			(*to_swap)->value = (*tree)->value;
 			(*tree)->value = value;
-			return set_tree_remove(tree, tree, BALANCED);
+			return set_tree_remove(tree, tree, BALANCED, allocator);
 		}
 		offset = set_tree_remove(
-			&((*tree)->left), to_swap, direction);
+			&((*tree)->left), to_swap, direction, allocator);
 		side = LEFT;
 	} else {
 		if (!(*tree)->right) {
 			void * value = (*to_swap)->value;
 			(*to_swap)->value = (*tree)->value;
 			(*tree)->value = value;
-			return set_tree_remove(tree, tree, BALANCED);
+			return set_tree_remove(tree, tree, BALANCED, allocator);
 		}
 		offset = set_tree_remove(
-			&((*tree)->right), to_swap, direction);
+			&((*tree)->right), to_swap, direction, allocator);
 		side = RIGHT;
 	}
 
@@ -398,12 +417,13 @@ static void set_tree_collect(
 	set_tree_collect(tree->right, iterator);
 }
 
-static void set_tree_free(struct set_tree * tree)
+static void set_tree_free(struct set_tree * tree,
+	const struct dt_allocator * allocator)
 {
 	if (!tree) return;
-	set_tree_free(tree->left);
-	set_tree_free(tree->right);
-	free(tree);
+	set_tree_free(tree->left, allocator);
+	set_tree_free(tree->right, allocator);
+	dt_allocator_free(allocator, tree, sizeof(*tree));
 }
 
 static void rotate_left(struct set_tree * * tree)
@@ -0,0 +1,192 @@
+#include "stack/bounded.h"
+#include "stack/error.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct stack_implementation;
+struct bounded_stack;
+
+struct stack_implementation {
+	size_t capacity;
+	int policy;
+	// The index of the oldest item. The rest follow it,
+	// wrapping around the end of the buffer.
+	size_t bottom;
+	size_t length;
+	void ** items;
+};
+
+// The stack, its implementation and its buffer share
+// one allocation.
+struct bounded_stack {
+	struct dt_stack stack;
+	struct stack_implementation implementation;
+	void * items[];
+};
+
+
+static int stack_push(struct dt_stack * this, void * item);
+static void * stack_pop(struct dt_stack * this);
+static int stack_push_many(struct dt_stack * this, void * const * items,
+	size_t count);
+static size_t stack_pop_many(struct dt_stack * this, void ** out,
+	size_t count);
+static void * stack_peek(const struct dt_stack * this);
+static size_t stack_length(const struct dt_stack * this);
+static void stack_del(struct dt_stack * this);
+
+/** Wraps an index that may have run past the end of the buffer.
+ *
+ *  Arguments:
+ *    data: The stack implementation.
+ *    index: An index less than twice the capacity.
+ *
+ *  Returns:
+ *    The index in the buffer.
+ */
+static size_t wrap(const struct stack_implementation * data, size_t index);
+
+struct dt_stack * dt_stack_bounded_new(size_t capacity, int policy)
+{
+	if (!capacity) return NULL;
+	if (policy != DT_STACK_BOUNDED_FAIL &&
+		policy != DT_STACK_BOUNDED_OVERWRITE) return NULL;
+
+	if (capacity > (((size_t) -1) - sizeof(struct bounded_stack)) /
+		sizeof(void *)) {
+		// Overflow
+		return NULL;
+	}
+
+	struct bounded_stack * bounded;
+	bounded = malloc(sizeof(*bounded) + sizeof(void *) * capacity);
+
+	if (!bounded) return NULL;
+
+	struct dt_stack * stack = &bounded->stack;
+	struct stack_implementation * implementation = &bounded->implementation;
+
+	implementation->capacity = capacity;
+	implementation->policy = policy;
+	implementation->bottom = 0;
+	implementation->length = 0;
+	implementation->items = bounded->items;
+
+	stack->push = stack_push;
+	stack->pop = stack_pop;
+	stack->push_many = stack_push_many;
+	stack->pop_many = stack_pop_many;
+	stack->peek = stack_peek;
+	stack->length = stack_length;
+	stack->del = stack_del;
+	stack->_data = implementation;
+
+	return stack;
+}
+
+
+static int stack_push(struct dt_stack * this, void * item)
+{
+	struct stack_implementation * data = this->_data;
+
+	if (data->length == data->capacity) {
+		if (data->policy == DT_STACK_BOUNDED_FAIL) return DT_STACK_ENOMEM;
+
+		// The oldest slot becomes the top.
+		data->items[data->bottom] = item;
+		data->bottom = wrap(data, data->bottom + 1);
+		return 0;
+	}
+
+	data->items[wrap(data, data->bottom + data->length)] = item;
+	data->length++;
+
+	return 0;
+}
+
+static void * stack_pop(struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+
+	if (!data->length) return NULL;
+
+	data->length--;
+	return data->items[wrap(data, data->bottom + data->length)];
+}
+
+static int stack_push_many(struct dt_stack * this, void * const * items,
+	size_t count)
+{
+	struct stack_implementation * data = this->_data;
+
+	if (count > data->capacity - data->length) {
+		if (data->policy == DT_STACK_BOUNDED_FAIL) return DT_STACK_ENOMEM;
+
+		// Anything before the last capacity items would
+		// be overwritten anyway.
+		if (count > data->capacity) {
+			items += count - data->capacity;
+			count = data->capacity;
+		}
+	}
+
+	// At most two copies, either side of the wrap.
+	size_t slot = wrap(data, data->bottom + data->length);
+	size_t first = data->capacity - slot;
+	if (first > count) first = count;
+
+	memcpy(data->items + slot, items, sizeof(*items) * first);
+	memcpy(data->items, items + first, sizeof(*items) * (count - first));
+
+	size_t length = data->length + count;
+	if (length > data->capacity) {
+		data->bottom = wrap(data, data->bottom + length - data->capacity);
+		length = data->capacity;
+	}
+	data->length = length;
+
+	return 0;
+}
+
+static size_t stack_pop_many(struct dt_stack * this, void ** out,
+	size_t count)
+{
+	struct stack_implementation * data = this->_data;
+	if (count > data->length) count = data->length;
+
+	data->length -= count;
+
+	size_t slot = wrap(data, data->bottom + data->length);
+	size_t first = data->capacity - slot;
+	if (first > count) first = count;
+
+	memcpy(out, data->items + slot, sizeof(*out) * first);
+	memcpy(out + first, data->items, sizeof(*out) * (count - first));
+
+	return count;
+}
+
+static void * stack_peek(const struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+	if (!data->length) return NULL;
+
+	return data->items[wrap(data, data->bottom + data->length - 1)];
+}
+
+static size_t stack_length(const struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+	return data->length;
+}
+
+static void stack_del(struct dt_stack * this)
+{
+	free(this);
+}
+
+static size_t wrap(const struct stack_implementation * data, size_t index)
+{
+	if (index >= data->capacity) return index - data->capacity;
+	return index;
+}
@@ -0,0 +1,138 @@
+#include "stack/intrusive.h"
+#include "stack/error.h"
+#include <stdlib.h>
+
+struct stack_implementation;
+struct intrusive_stack;
+
+struct stack_implementation {
+	struct dt_stack_link * top;
+	size_t length;
+	// Where the link sits in each item.
+	size_t offset;
+};
+
+// The stack and its implementation share one allocation.
+struct intrusive_stack {
+	struct dt_stack stack;
+	struct stack_implementation implementation;
+};
+
+
+static int stack_push(struct dt_stack * this, void * item);
+static void * stack_pop(struct dt_stack * this);
+static int stack_push_many(struct dt_stack * this, void * const * items,
+	size_t count);
+static size_t stack_pop_many(struct dt_stack * this, void ** out,
+	size_t count);
+static void * stack_peek(const struct dt_stack * this);
+static size_t stack_length(const struct dt_stack * this);
+static void stack_del(struct dt_stack * this);
+
+struct dt_stack * dt_stack_intrusive_new(size_t offset)
+{
+	struct intrusive_stack * intrusive;
+	intrusive = malloc(sizeof(*intrusive));
+
+	if (!intrusive) return NULL;
+
+	struct dt_stack * stack = &intrusive->stack;
+	struct stack_implementation * implementation = &intrusive->implementation;
+
+	implementation->top = NULL;
+	implementation->length = 0;
+	implementation->offset = offset;
+
+	stack->push = stack_push;
+	stack->pop = stack_pop;
+	stack->push_many = stack_push_many;
+	stack->pop_many = stack_pop_many;
+	stack->peek = stack_peek;
+	stack->length = stack_length;
+	stack->del = stack_del;
+	stack->_data = implementation;
+
+	return stack;
+}
+
+
+static int stack_push(struct dt_stack * this, void * item)
+{
+	struct stack_implementation * data = this->_data;
+	struct dt_stack_link * link =
+		(struct dt_stack_link *) ((char *) item + data->offset);
+
+	link->next = data->top;
+	data->top = link;
+	data->length++;
+
+	return 0;
+}
+
+static void * stack_pop(struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+
+	if (!data->top) return NULL;
+
+	struct dt_stack_link * link = data->top;
+	data->top = link->next;
+	link->next = NULL;
+
+	data->length--;
+	return (char *) link - data->offset;
+}
+
+static int stack_push_many(struct dt_stack * this, void * const * items,
+	size_t count)
+{
+	struct stack_implementation * data = this->_data;
+
+	for (size_t i = 0; i < count; i++) {
+		struct dt_stack_link * link =
+			(struct dt_stack_link *) ((char *) items[i] + data->offset);
+
+		link->next = data->top;
+		data->top = link;
+	}
+
+	data->length += count;
+	return 0;
+}
+
+static size_t stack_pop_many(struct dt_stack * this, void ** out,
+	size_t count)
+{
+	struct stack_implementation * data = this->_data;
+	if (count > data->length) count = data->length;
+
+	for (size_t i = count; i > 0; i--) {
+		struct dt_stack_link * link = data->top;
+		data->top = link->next;
+		link->next = NULL;
+		out[i - 1] = (char *) link - data->offset;
+	}
+
+	data->length -= count;
+	return count;
+}
+
+static void * stack_peek(const struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+	if (!data->top) return NULL;
+
+	return (char *) data->top - data->offset;
+}
+
+static size_t stack_length(const struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+	return data->length;
+}
+
+static void stack_del(struct dt_stack * this)
+{
+	// The items belong to the caller.
+	free(this);
+}
@@ -1,14 +1,29 @@
 
 #include "stack/linked.h"
 #include "stack/error.h"
-#include <stdlib.h>
+#include <stdbool.h>
+
+#include "allocator.h"
+#include "pool.h"
 
 struct stack_implementation;
 struct stack_node;
+struct linked_stack;
 
 struct stack_implementation {
 	struct stack_node * nodes;
 	size_t length;
+	// Where nodes come from. NULL for the allocator.
+	struct dt_pool * pool;
+	bool owns_pool;
+	// Where the stack and its nodes come from.
+	const struct dt_allocator * allocator;
+};
+
+// The stack and its implementation share one allocation.
+struct linked_stack {
+	struct dt_stack stack;
+	struct stack_implementation implementation;
 };
 
 struct stack_node {
@@ -19,30 +34,98 @@ struct stack_node {
 
 static int stack_push(struct dt_stack * this, void * item);
 static void * stack_pop(struct dt_stack * this);
+static int stack_push_many(struct dt_stack * this, void * const * items,
+	size_t count);
+static size_t stack_pop_many(struct dt_stack * this, void ** out,
+	size_t count);
 static void * stack_peek(const struct dt_stack * this);
 static size_t stack_length(const struct dt_stack * this);
 static void stack_del(struct dt_stack * this);
 
+/** Sets up a new linked stack.
+ *
+ *  Arguments:
+ *    pool: Where nodes come from. NULL for the allocator.
+ *    owns_pool: True if the stack deletes the pool.
+ *    allocator: Where the stack comes from. NULL for malloc.
+ *
+ *  Returns:
+ *    A new stack. Or NULL if there is not enough memory.
+ */
+static struct dt_stack * linked_new(struct dt_pool * pool, bool owns_pool,
+	const struct dt_allocator * allocator);
+
+/** Allocates a node.
+ *
+ *  Arguments:
+ *    data: The stack implementation.
+ *
+ *  Returns:
+ *    A new node. Or NULL if there is not enough memory.
+ */
+static struct stack_node * node_new(struct stack_implementation * data);
+
+/** Frees a node.
+ *
+ *  Arguments:
+ *    data: The stack implementation.
+ *    node: The node to free.
+ */
+static void node_free(struct stack_implementation * data,
+	struct stack_node * node);
+
 struct dt_stack * dt_stack_linked_new(void)
 {
-	struct dt_stack * stack;
-	stack = malloc(sizeof(*stack));
+	return linked_new(NULL, false, NULL);
+}
 
-	if (!stack) return NULL;
+struct dt_stack * dt_stack_linked_new_with_allocator(
+	const struct dt_allocator * allocator)
+{
+	return linked_new(NULL, false, allocator);
+}
 
-	struct stack_implementation * implementation;
-	implementation = malloc(sizeof(*implementation));
+struct dt_stack * dt_stack_linked_pooled_new(struct dt_pool * pool)
+{
+	if (!pool) {
+		pool = dt_pool_new(dt_stack_linked_node_size(), 0);
+		if (!pool) return NULL;
 
-	if (!implementation) {
-		free(stack);
-		return NULL;
+		struct dt_stack * stack = linked_new(pool, true, NULL);
+		if (!stack) dt_pool_del(pool);
+		return stack;
 	}
-	
+
+	if (dt_pool_item_size(pool) < dt_stack_linked_node_size()) return NULL;
+	return linked_new(pool, false, NULL);
+}
+
+size_t dt_stack_linked_node_size(void)
+{
+	return sizeof(struct stack_node);
+}
+
+static struct dt_stack * linked_new(struct dt_pool * pool, bool owns_pool,
+	const struct dt_allocator * allocator)
+{
+	struct linked_stack * linked;
+	linked = dt_allocator_alloc(allocator, sizeof(*linked));
+
+	if (!linked) return NULL;
+
+	struct dt_stack * stack = &linked->stack;
+	struct stack_implementation * implementation = &linked->implementation;
+
 	implementation->length = 0;
 	implementation->nodes = NULL;
+	implementation->pool = pool;
+	implementation->owns_pool = owns_pool;
+	implementation->allocator = allocator;
 
 	stack->push = stack_push;
 	stack->pop = stack_pop;
+	stack->push_many = stack_push_many;
+	stack->pop_many = stack_pop_many;
 	stack->peek = stack_peek;
 	stack->length = stack_length;
 	stack->del = stack_del;
@@ -55,9 +138,7 @@ struct dt_stack * dt_stack_linked_new(void)
 static int stack_push(struct dt_stack * this, void * item)
 {
 	struct stack_implementation * data = this->_data;
-	struct stack_node * new_node;
-
-	new_node = malloc(sizeof(*new_node));
+	struct stack_node * new_node = node_new(data);
 
 	if (!new_node) return DT_STACK_ENOMEM;
 
@@ -81,13 +162,62 @@ static void * stack_pop(struct dt_stack * this)
 	struct stack_node * del_node = data->nodes;
 
 	data->nodes = del_node->next;
-	free(del_node);
+	node_free(data, del_node);
 
 	data->length--;
 	return return_value;
 
 }
 
+static int stack_push_many(struct dt_stack * this, void * const * items,
+	size_t count)
+{
+	struct stack_implementation * data = this->_data;
+
+	// Build the chain from the bottom up and only join
+	// it to the stack once every node is there.
+	struct stack_node * top = data->nodes;
+
+	for (size_t i = 0; i < count; i++) {
+		struct stack_node * new_node = node_new(data);
+
+		if (!new_node) {
+			while (top != data->nodes) {
+				struct stack_node * del_node = top;
+				top = top->next;
+				node_free(data, del_node);
+			}
+			return DT_STACK_ENOMEM;
+		}
+
+		new_node->value = items[i];
+		new_node->next = top;
+		top = new_node;
+	}
+
+	data->nodes = top;
+	data->length += count;
+
+	return 0;
+}
+
+static size_t stack_pop_many(struct dt_stack * this, void ** out,
+	size_t count)
+{
+	struct stack_implementation * data = this->_data;
+	if (count > data->length) count = data->length;
+
+	for (size_t i = count; i > 0; i--) {
+		struct stack_node * del_node = data->nodes;
+		out[i - 1] = del_node->value;
+		data->nodes = del_node->next;
+		node_free(data, del_node);
+	}
+
+	data->length -= count;
+	return count;
+}
+
 static void * stack_peek(const struct dt_stack * this)
 {
 	struct stack_implementation * data = this->_data;
@@ -106,16 +236,38 @@ static size_t stack_length(const struct dt_stack * this)
 static void stack_del(struct dt_stack * this)
 {
 	struct stack_implementation * data = this->_data;
+
+	if (data->owns_pool) {
+		// Every node is in the pool.
+		dt_pool_del(data->pool);
+		dt_allocator_free(data->allocator, this, sizeof(struct linked_stack));
+		return;
+	}
+
 	struct stack_node * last_node = data->nodes;
 
 	while (last_node) {
 		struct stack_node * del_node = last_node;
 		last_node = last_node->next;
-
-		free(del_node);
+		node_free(data, del_node);
 	}
 
-	free(data);
-	free(this);
+	dt_allocator_free(data->allocator, this, sizeof(struct linked_stack));
 }
 
+
+static struct stack_node * node_new(struct stack_implementation * data)
+{
+	if (data->pool) return dt_pool_alloc(data->pool);
+	return dt_allocator_alloc(data->allocator, sizeof(struct stack_node));
+}
+
+static void node_free(struct stack_implementation * data,
+	struct stack_node * node)
+{
+	if (data->pool) {
+		dt_pool_free(data->pool, node);
+	} else {
+		dt_allocator_free(data->allocator, node, sizeof(*node));
+	}
+}
@@ -0,0 +1,300 @@
+#include "stack/lockfree.h"
+#include "stack/error.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+struct stack_implementation;
+struct stack_node;
+struct tagged_node;
+struct lockfree_stack;
+
+// A node and a count of the swaps made to the pointer
+// holding it. The count changes on every swap so a
+// stale read never matches, even for the same node.
+struct tagged_node {
+	struct stack_node * node;
+	uintptr_t tag;
+};
+
+struct stack_implementation {
+	_Atomic struct tagged_node top;
+	// Popped nodes waiting to be reused. They are never
+	// freed while the stack lives so a thread that lost a
+	// race can still read them safely.
+	_Atomic struct tagged_node free_nodes;
+	atomic_size_t length;
+};
+
+// The stack and its implementation share one allocation.
+struct lockfree_stack {
+	struct dt_stack stack;
+	struct stack_implementation implementation;
+};
+
+struct stack_node {
+	void * _Atomic value;
+	struct stack_node * _Atomic next;
+};
+
+
+static int stack_push(struct dt_stack * this, void * item);
+static void * stack_pop(struct dt_stack * this);
+static int stack_push_many(struct dt_stack * this, void * const * items,
+	size_t count);
+static size_t stack_pop_many(struct dt_stack * this, void ** out,
+	size_t count);
+static void * stack_peek(const struct dt_stack * this);
+static size_t stack_length(const struct dt_stack * this);
+static void stack_del(struct dt_stack * this);
+
+/** Pushes a chain of nodes on to a tagged list in one swap.
+ *
+ *  Arguments:
+ *    head: The head of the list.
+ *    first: The node to put on top.
+ *    last: The bottom node of the chain, reached from
+ *          first through next.
+ */
+static void tagged_push(_Atomic struct tagged_node * head,
+	struct stack_node * first, struct stack_node * last);
+
+/** Pops a chain of nodes off a tagged list in one swap.
+ *
+ *  Arguments:
+ *    head: The head of the list.
+ *    count: The most nodes to pop, at least one.
+ *    popped: A result variable. The number of nodes popped.
+ *
+ *  Returns:
+ *    The node that was on top, with the rest of the chain
+ *    reached through next. Or NULL if the list is empty.
+ */
+static struct stack_node * tagged_pop(_Atomic struct tagged_node * head,
+	size_t count, size_t * popped);
+
+/** Frees every node in a tagged list.
+ *
+ *  Arguments:
+ *    head: The head of the list.
+ */
+static void tagged_free(_Atomic struct tagged_node * head);
+
+struct dt_stack * dt_stack_lockfree_new(void)
+{
+	struct lockfree_stack * lockfree;
+	lockfree = malloc(sizeof(*lockfree));
+
+	if (!lockfree) return NULL;
+
+	struct dt_stack * stack = &lockfree->stack;
+	struct stack_implementation * implementation = &lockfree->implementation;
+
+	struct tagged_node empty = {NULL, 0};
+	atomic_init(&implementation->top, empty);
+	atomic_init(&implementation->free_nodes, empty);
+	atomic_init(&implementation->length, 0);
+
+	stack->push = stack_push;
+	stack->pop = stack_pop;
+	stack->push_many = stack_push_many;
+	stack->pop_many = stack_pop_many;
+	stack->peek = stack_peek;
+	stack->length = stack_length;
+	stack->del = stack_del;
+	stack->_data = implementation;
+
+	return stack;
+}
+
+
+static int stack_push(struct dt_stack * this, void * item)
+{
+	struct stack_implementation * data = this->_data;
+
+	size_t popped;
+	struct stack_node * node = tagged_pop(&data->free_nodes, 1, &popped);
+	if (!node) {
+		node = malloc(sizeof(*node));
+		if (!node) return DT_STACK_ENOMEM;
+	}
+
+	atomic_store_explicit(&node->value, item, memory_order_relaxed);
+
+	// Counted before the node is visible so a racing pop
+	// can never take the length below zero.
+	atomic_fetch_add_explicit(&data->length, 1, memory_order_relaxed);
+	tagged_push(&data->top, node, node);
+
+	return 0;
+}
+
+static void * stack_pop(struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+
+	size_t popped;
+	struct stack_node * node = tagged_pop(&data->top, 1, &popped);
+	if (!node) return NULL;
+
+	atomic_fetch_sub_explicit(&data->length, 1, memory_order_relaxed);
+
+	void * value = atomic_load_explicit(&node->value, memory_order_relaxed);
+	tagged_push(&data->free_nodes, node, node);
+
+	return value;
+}
+
+static int stack_push_many(struct dt_stack * this, void * const * items,
+	size_t count)
+{
+	struct stack_implementation * data = this->_data;
+	if (!count) return 0;
+
+	// Take what nodes are free in one go and make up
+	// the rest, then publish the whole chain at once.
+	size_t reused = 0;
+	struct stack_node * first = tagged_pop(&data->free_nodes, count, &reused);
+	struct stack_node * last = first;
+
+	for (size_t i = 1; i < reused; i++) {
+		last = atomic_load_explicit(&last->next, memory_order_relaxed);
+	}
+
+	for (size_t i = reused; i < count; i++) {
+		struct stack_node * node = malloc(sizeof(*node));
+
+		if (!node) {
+			if (first) tagged_push(&data->free_nodes, first, last);
+			return DT_STACK_ENOMEM;
+		}
+
+		atomic_store_explicit(&node->next, first, memory_order_relaxed);
+		first = node;
+		if (!last) last = node;
+	}
+
+	// The first node ends up on top so it holds the last item.
+	struct stack_node * node = first;
+	for (size_t i = count; i > 0; i--) {
+		atomic_store_explicit(&node->value, items[i - 1],
+			memory_order_relaxed);
+		node = atomic_load_explicit(&node->next, memory_order_relaxed);
+	}
+
+	atomic_fetch_add_explicit(&data->length, count, memory_order_relaxed);
+	tagged_push(&data->top, first, last);
+
+	return 0;
+}
+
+static size_t stack_pop_many(struct dt_stack * this, void ** out,
+	size_t count)
+{
+	struct stack_implementation * data = this->_data;
+	if (!count) return 0;
+
+	size_t popped;
+	struct stack_node * first = tagged_pop(&data->top, count, &popped);
+	if (!first) return 0;
+
+	atomic_fetch_sub_explicit(&data->length, popped, memory_order_relaxed);
+
+	struct stack_node * last = first;
+	for (size_t i = popped; i > 0; i--) {
+		out[i - 1] = atomic_load_explicit(&last->value,
+			memory_order_relaxed);
+		if (i > 1) {
+			last = atomic_load_explicit(&last->next, memory_order_relaxed);
+		}
+	}
+
+	tagged_push(&data->free_nodes, first, last);
+
+	return popped;
+}
+
+static void * stack_peek(const struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+	struct tagged_node top = atomic_load_explicit(&data->top,
+		memory_order_acquire);
+
+	if (!top.node) return NULL;
+
+	// The node may have been popped since, in which case
+	// this is the value it held at some recent point.
+	return atomic_load_explicit(&top.node->value, memory_order_relaxed);
+}
+
+static size_t stack_length(const struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+	return atomic_load_explicit(&data->length, memory_order_relaxed);
+}
+
+static void stack_del(struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+
+	tagged_free(&data->top);
+	tagged_free(&data->free_nodes);
+
+	free(this);
+}
+
+static void tagged_push(_Atomic struct tagged_node * head,
+	struct stack_node * first, struct stack_node * last)
+{
+	struct tagged_node old = atomic_load_explicit(head,
+		memory_order_relaxed);
+	struct tagged_node new;
+
+	do {
+		atomic_store_explicit(&last->next, old.node, memory_order_relaxed);
+		new.node = first;
+		new.tag = old.tag + 1;
+	} while (!atomic_compare_exchange_weak_explicit(head, &old, new,
+		memory_order_release, memory_order_relaxed));
+}
+
+static struct stack_node * tagged_pop(_Atomic struct tagged_node * head,
+	size_t count, size_t * popped)
+{
+	struct tagged_node old = atomic_load_explicit(head,
+		memory_order_acquire);
+	struct tagged_node new;
+
+	do {
+		*popped = 0;
+		if (!old.node) return NULL;
+
+		// Nodes are never freed while in use so these reads
+		// are safe. If another thread got here first the
+		// tag will have moved on and the swap fails. Only a
+		// swap of the head can change the chain below it.
+		new.node = old.node;
+		while (new.node && *popped < count) {
+			new.node = atomic_load_explicit(&new.node->next,
+				memory_order_relaxed);
+			(*popped)++;
+		}
+		new.tag = old.tag + 1;
+	} while (!atomic_compare_exchange_weak_explicit(head, &old, new,
+		memory_order_acquire, memory_order_acquire));
+
+	return old.node;
+}
+
+static void tagged_free(_Atomic struct tagged_node * head)
+{
+	struct tagged_node top = atomic_load_explicit(head,
+		memory_order_relaxed);
+	struct stack_node * node = top.node;
+
+	while (node) {
+		struct stack_node * del_node = node;
+		node = atomic_load_explicit(&node->next, memory_order_relaxed);
+		free(del_node);
+	}
+}
@@ -0,0 +1,230 @@
+#include "stack/segmented.h"
+#include "stack/error.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct stack_implementation;
+struct stack_segment;
+struct segmented_stack;
+
+struct stack_segment {
+	struct stack_segment * previous;
+	void * items[DT_STACK_SEGMENTED_SEGMENT_LENGTH];
+};
+
+struct stack_implementation {
+	// The segment holding the top item. Only the first
+	// segment is ever left empty.
+	struct stack_segment * top;
+	// The number of items in the top segment.
+	size_t top_length;
+	size_t length;
+	// An emptied segment kept for the next push across
+	// a boundary.
+	struct stack_segment * spare;
+};
+
+// The stack and its implementation share one allocation.
+struct segmented_stack {
+	struct dt_stack stack;
+	struct stack_implementation implementation;
+};
+
+
+static int stack_push(struct dt_stack * this, void * item);
+static void * stack_pop(struct dt_stack * this);
+static int stack_push_many(struct dt_stack * this, void * const * items,
+	size_t count);
+static size_t stack_pop_many(struct dt_stack * this, void ** out,
+	size_t count);
+static void * stack_peek(const struct dt_stack * this);
+static size_t stack_length(const struct dt_stack * this);
+static void stack_del(struct dt_stack * this);
+
+/** Makes room for at least one more item on top.
+ *
+ *  Arguments:
+ *    data: The stack implementation.
+ *
+ *  Returns:
+ *    Zero on success. DT_STACK_ENOMEM if there is
+ *    not enough memory.
+ */
+static int grow(struct stack_implementation * data);
+
+/** Drops the top segment if it is empty and not the only one.
+ *
+ *  Arguments:
+ *    data: The stack implementation.
+ */
+static void shrink(struct stack_implementation * data);
+
+struct dt_stack * dt_stack_segmented_new(void)
+{
+	struct segmented_stack * segmented;
+	segmented = malloc(sizeof(*segmented));
+
+	if (!segmented) return NULL;
+
+	struct dt_stack * stack = &segmented->stack;
+	struct stack_implementation * implementation = &segmented->implementation;
+
+	implementation->top = NULL;
+	implementation->top_length = 0;
+	implementation->length = 0;
+	implementation->spare = NULL;
+
+	stack->push = stack_push;
+	stack->pop = stack_pop;
+	stack->push_many = stack_push_many;
+	stack->pop_many = stack_pop_many;
+	stack->peek = stack_peek;
+	stack->length = stack_length;
+	stack->del = stack_del;
+	stack->_data = implementation;
+
+	return stack;
+}
+
+
+static int stack_push(struct dt_stack * this, void * item)
+{
+	struct stack_implementation * data = this->_data;
+
+	if (grow(data)) return DT_STACK_ENOMEM;
+
+	data->top->items[data->top_length] = item;
+	data->top_length++;
+	data->length++;
+
+	return 0;
+}
+
+static void * stack_pop(struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+
+	if (!data->length) return NULL;
+
+	data->top_length--;
+	data->length--;
+	void * item = data->top->items[data->top_length];
+	shrink(data);
+
+	return item;
+}
+
+static int stack_push_many(struct dt_stack * this, void * const * items,
+	size_t count)
+{
+	struct stack_implementation * data = this->_data;
+	size_t pushed = 0;
+
+	// A segment at a time.
+	while (pushed < count) {
+		if (grow(data)) {
+			while (pushed--) stack_pop(this);
+			return DT_STACK_ENOMEM;
+		}
+
+		size_t chunk = DT_STACK_SEGMENTED_SEGMENT_LENGTH - data->top_length;
+		if (chunk > count - pushed) chunk = count - pushed;
+
+		memcpy(data->top->items + data->top_length, items + pushed,
+			sizeof(*items) * chunk);
+		data->top_length += chunk;
+		data->length += chunk;
+		pushed += chunk;
+	}
+
+	return 0;
+}
+
+static size_t stack_pop_many(struct dt_stack * this, void ** out,
+	size_t count)
+{
+	struct stack_implementation * data = this->_data;
+	if (count > data->length) count = data->length;
+
+	size_t left = count;
+
+	while (left) {
+		size_t chunk = data->top_length;
+		if (chunk > left) chunk = left;
+
+		data->top_length -= chunk;
+		data->length -= chunk;
+		left -= chunk;
+		memcpy(out + left, data->top->items + data->top_length,
+			sizeof(*out) * chunk);
+
+		shrink(data);
+	}
+
+	return count;
+}
+
+static void * stack_peek(const struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+	if (!data->length) return NULL;
+
+	return data->top->items[data->top_length - 1];
+}
+
+static size_t stack_length(const struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+	return data->length;
+}
+
+static void stack_del(struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+	struct stack_segment * segment = data->top;
+
+	while (segment) {
+		struct stack_segment * del_segment = segment;
+		segment = segment->previous;
+		free(del_segment);
+	}
+
+	free(data->spare);
+	free(this);
+}
+
+static int grow(struct stack_implementation * data)
+{
+	if (data->top && data->top_length < DT_STACK_SEGMENTED_SEGMENT_LENGTH) {
+		return 0;
+	}
+
+	struct stack_segment * segment = data->spare;
+
+	if (segment) {
+		data->spare = NULL;
+	} else {
+		segment = malloc(sizeof(*segment));
+		if (!segment) return DT_STACK_ENOMEM;
+	}
+
+	segment->previous = data->top;
+	data->top = segment;
+	data->top_length = 0;
+
+	return 0;
+}
+
+static void shrink(struct stack_implementation * data)
+{
+	if (data->top_length || !data->top->previous) return;
+
+	// Keep the newest empty segment. An older spare
+	// has gone unused for a whole segment of pops.
+	struct stack_segment * empty = data->top;
+	data->top = empty->previous;
+	data->top_length = DT_STACK_SEGMENTED_SEGMENT_LENGTH;
+
+	free(data->spare);
+	data->spare = empty;
+}
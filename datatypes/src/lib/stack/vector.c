@@ -2,50 +2,112 @@
 #include "stack/vector.h"
 #include "stack/error.h"
 
-#include <stdlib.h>
+#include <string.h>
 
+#include "allocator.h"
 #include "buffers.h"
 
 struct stack_implementation;
+struct vector_stack;
+
+// Small stacks keep their items in inline_buffer and only move
+// to the heap once they outgrow it.
 struct stack_implementation {
+	// Where the stack and its buffer come from.
+	const struct dt_allocator * allocator;
 	void ** buffer;
 	size_t buffer_size;
 	size_t length;
+	void * inline_buffer[DT_STACK_VECTOR_INLINE_LENGTH];
+};
+
+// The stack and its implementation share one allocation.
+struct vector_stack {
+	struct dt_stack stack;
+	struct stack_implementation implementation;
 };
 
+_Static_assert(
+	sizeof(struct vector_stack) <= sizeof(struct dt_stack_vector_storage),
+	"dt_stack_vector_storage is too small");
+
 static int stack_push(struct dt_stack * this, void * item);
 static void * stack_pop(struct dt_stack * this);
+static int stack_push_many(struct dt_stack * this, void * const * items,
+	size_t count);
+static size_t stack_pop_many(struct dt_stack * this, void ** out,
+	size_t count);
 static void * stack_peek(const struct dt_stack * this);
 static size_t stack_length(const struct dt_stack * this);
 static void stack_del(struct dt_stack * this);
+static void stack_dispose(struct dt_stack * this);
+
+/** Moves the items into a buffer of the given size.
+ *
+ *  Arguments:
+ *    data: The stack implementation.
+ *    new_size: The new size of the buffer in bytes.
+ *
+ *  Returns:
+ *    Zero on success. A negative number otherwise.
+ *
+ *  Notes:
+ *    Sizes that fit in the inline buffer use it
+ *    and release any heap buffer.
+ */
+static int resize(struct stack_implementation * data, size_t new_size);
+
+/** Sets up a stack in place.
+ *
+ *  Arguments:
+ *    vector: The memory to set the stack up in.
+ *    allocator: Where the buffer comes from. NULL for malloc.
+ *
+ *  Returns:
+ *    The stack.
+ */
+static struct dt_stack * vector_init(struct vector_stack * vector,
+	const struct dt_allocator * allocator);
 
 struct dt_stack * dt_stack_vector_new(void)
 {
-	struct dt_stack * stack;
-	stack = malloc(sizeof(*stack));
-	
-	if (!stack) return NULL;
+	return dt_stack_vector_new_with_allocator(NULL);
+}
 
-	struct stack_implementation * implementation;
-	implementation = malloc(sizeof(*implementation));
+struct dt_stack * dt_stack_vector_new_with_allocator(
+	const struct dt_allocator * allocator)
+{
+	struct vector_stack * vector;
+	vector = dt_allocator_alloc(allocator, sizeof(*vector));
 
-	if (!implementation) {
-		free(stack);
-		return NULL;
-	}
+	if (!vector) return NULL;
 
-	implementation->buffer_size = ARRAY_SIZE(implementation->buffer, 8);
-	implementation->length = 0;
-	implementation->buffer = malloc(implementation->buffer_size);
+	return vector_init(vector, allocator);
+}
 
-	if (!implementation->buffer) {
-		free(implementation);
-		free(stack);
-		return NULL;
-	}
+struct dt_stack * dt_stack_vector_init(struct dt_stack_vector_storage * storage)
+{
+	struct dt_stack * stack = vector_init((struct vector_stack *) storage,
+		NULL);
+	stack->del = stack_dispose;
+	return stack;
+}
+
+static struct dt_stack * vector_init(struct vector_stack * vector,
+	const struct dt_allocator * allocator)
+{
+	struct dt_stack * stack = &vector->stack;
+	struct stack_implementation * implementation = &vector->implementation;
+
+	implementation->allocator = allocator;
+	implementation->buffer = implementation->inline_buffer;
+	implementation->buffer_size = sizeof(implementation->inline_buffer);
+	implementation->length = 0;
 
 	stack->push = stack_push;
 	stack->pop = stack_pop;
+	stack->push_many = stack_push_many;
+	stack->pop_many = stack_pop_many;
 	stack->peek = stack_peek;
 	stack->length = stack_length;
 	stack->del = stack_del;
@@ -68,11 +130,7 @@ static int stack_push(struct dt_stack * this, void * item)
 			return DT_STACK_ENOMEM;
 		}
 
-                void ** new_buf = realloc(data->buffer, new_size);
-                if (!new_buf) return DT_STACK_ENOMEM;
-
-                data->buffer = new_buf;
-                data->buffer_size = new_size;
+		if (resize(data, new_size)) return DT_STACK_ENOMEM;
 	}
 	
 	data->buffer[this->length(this)] = item;
@@ -92,18 +150,68 @@ static void * stack_pop(struct dt_stack * this)
 		ARRAY_LENGTH(data->buffer, data->buffer_size);
 
 	if (buffer_length / 4 > this->length(this)) {
-                size_t new_size = data->buffer_size / 2;
-                void ** new_buf = realloc(data->buffer, new_size);
-
-                if (new_buf) {
-                        data->buffer = new_buf;
-                        data->buffer_size = new_size;
-                }
+		// Failing to shrink is harmless.
+		resize(data, data->buffer_size / 2);
 	}
 		
 	return return_value;
 }
 
+static int stack_push_many(struct dt_stack * this, void * const * items,
+	size_t count)
+{
+	struct stack_implementation * data = this->_data;
+	if (!count) return 0;
+
+	size_t length = data->length + count;
+
+	if (length < data->length ||
+		ARRAY_LENGTH(data->buffer, ((size_t) -1)) < length) {
+		//Overflow
+		return DT_STACK_ENOMEM;
+	}
+
+	size_t new_size = data->buffer_size;
+	while (ARRAY_LENGTH(data->buffer, new_size) < length) {
+		if (new_size * 2 < new_size) {
+			//Overflow
+			new_size = ARRAY_SIZE(data->buffer, length);
+			break;
+		}
+		new_size *= 2;
+	}
+
+	if (resize(data, new_size)) return DT_STACK_ENOMEM;
+
+	memcpy(data->buffer + data->length, items,
+		ARRAY_SIZE(data->buffer, count));
+	data->length = length;
+	return 0;
+}
+
+static size_t stack_pop_many(struct dt_stack * this, void ** out,
+	size_t count)
+{
+	struct stack_implementation * data = this->_data;
+	if (count > data->length) count = data->length;
+	if (!count) return 0;
+
+	data->length -= count;
+	memcpy(out, data->buffer + data->length,
+		ARRAY_SIZE(data->buffer, count));
+
+	size_t new_size = data->buffer_size;
+	while (ARRAY_LENGTH(data->buffer, new_size) / 4 > data->length &&
+		new_size > sizeof(data->inline_buffer)) {
+		new_size /= 2;
+	}
+
+	// Failing to shrink is harmless.
+	resize(data, new_size);
+
+	return count;
+}
+
 static void * stack_peek(const struct dt_stack * this)
 {
 	struct stack_implementation * data = this->_data;
@@ -120,8 +228,47 @@ static size_t stack_length(const struct dt_stack * this)
 static void stack_del(struct dt_stack * this)
 {
 	struct stack_implementation * data = this->_data;
-	free(data->buffer);
-	free(data);
-	free(this);
+	stack_dispose(this);
+	dt_allocator_free(data->allocator, this, sizeof(struct vector_stack));
 }
 
+static void stack_dispose(struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+	if (data->buffer != data->inline_buffer) {
+		dt_allocator_free(data->allocator, data->buffer, data->buffer_size);
+	}
+}
+
+static int resize(struct stack_implementation * data, size_t new_size)
+{
+	if (new_size < sizeof(data->inline_buffer)) {
+		new_size = sizeof(data->inline_buffer);
+	}
+
+	if (new_size == data->buffer_size) return 0;
+
+	if (new_size == sizeof(data->inline_buffer)) {
+		// Only shrinking gets here so the items fit.
+		memcpy(data->inline_buffer, data->buffer,
+			ARRAY_SIZE(data->buffer, data->length));
+		dt_allocator_free(data->allocator, data->buffer, data->buffer_size);
+		data->buffer = data->inline_buffer;
+	} else if (data->buffer == data->inline_buffer) {
+		void ** new_buf = dt_allocator_alloc(data->allocator, new_size);
+		if (!new_buf) return DT_STACK_ENOMEM;
+
+		memcpy(new_buf, data->inline_buffer,
+			ARRAY_SIZE(data->buffer, data->length));
+		data->buffer = new_buf;
+	} else {
+		void ** new_buf = dt_allocator_realloc(data->allocator,
+			data->buffer, data->buffer_size, new_size);
+		if (!new_buf) return DT_STACK_ENOMEM;
+
+		data->buffer = new_buf;
+	}
+
+	data->buffer_size = new_size;
+	return 0;
+}
@@ -0,0 +1,318 @@
+#include "stack/workstealing.h"
+#include "stack/error.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The number of items the first buffer holds. Always a
+// power of two so indexes wrap with a mask.
+#define INITIAL_LENGTH 32
+
+struct stack_implementation;
+struct stack_buffer;
+struct workstealing_stack;
+
+// A circular buffer. Items live at their index masked by
+// the length, so growing copies them to the same indexes.
+struct stack_buffer {
+	// The buffer this one replaced, kept for thieves
+	// that may still be reading it.
+	struct stack_buffer * previous;
+	long long length;
+	void * _Atomic items[];
+};
+
+struct stack_implementation {
+	// Thieves take from the top, the owner pushes and
+	// pops at the bottom. The items are [top, bottom).
+	atomic_llong top;
+	atomic_llong bottom;
+	struct stack_buffer * _Atomic buffer;
+};
+
+// The stack and its implementation share one allocation.
+struct workstealing_stack {
+	struct dt_stack stack;
+	struct stack_implementation implementation;
+};
+
+
+static int stack_push(struct dt_stack * this, void * item);
+static void * stack_pop(struct dt_stack * this);
+static int stack_push_many(struct dt_stack * this, void * const * items,
+	size_t count);
+static size_t stack_pop_many(struct dt_stack * this, void ** out,
+	size_t count);
+static void * stack_peek(const struct dt_stack * this);
+static size_t stack_length(const struct dt_stack * this);
+static void stack_del(struct dt_stack * this);
+
+/** Allocates an empty buffer.
+ *
+ *  Arguments:
+ *    length: The number of items, a power of two.
+ *
+ *  Returns:
+ *    A new buffer. Or NULL if there is not enough memory.
+ */
+static struct stack_buffer * buffer_new(long long length);
+
+/** Makes sure the owner's buffer can take more items.
+ *
+ *  Arguments:
+ *    data: The stack implementation.
+ *    top: The top index the owner last read.
+ *    bottom: The bottom index.
+ *    count: The number of items about to be pushed.
+ *
+ *  Returns:
+ *    The buffer to push into. Or NULL if there is
+ *    not enough memory.
+ *
+ *  Notes:
+ *    Grows by doubling like the vector stack, but copies
+ *    into a new buffer rather than reallocating as a thief
+ *    may be reading the old one.
+ */
+static struct stack_buffer * reserve(struct stack_implementation * data,
+	long long top, long long bottom, size_t count);
+
+struct dt_stack * dt_stack_workstealing_new(void)
+{
+	struct workstealing_stack * workstealing;
+	workstealing = malloc(sizeof(*workstealing));
+
+	if (!workstealing) return NULL;
+
+	struct stack_buffer * buffer = buffer_new(INITIAL_LENGTH);
+	if (!buffer) {
+		free(workstealing);
+		return NULL;
+	}
+
+	struct dt_stack * stack = &workstealing->stack;
+	struct stack_implementation * implementation =
+		&workstealing->implementation;
+
+	atomic_init(&implementation->top, 0);
+	atomic_init(&implementation->bottom, 0);
+	atomic_init(&implementation->buffer, buffer);
+
+	stack->push = stack_push;
+	stack->pop = stack_pop;
+	stack->push_many = stack_push_many;
+	stack->pop_many = stack_pop_many;
+	stack->peek = stack_peek;
+	stack->length = stack_length;
+	stack->del = stack_del;
+	stack->_data = implementation;
+
+	return stack;
+}
+
+int dt_stack_workstealing_steal(struct dt_stack * stack, void ** item)
+{
+	struct stack_implementation * data = stack->_data;
+
+	long long top = atomic_load_explicit(&data->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	long long bottom = atomic_load_explicit(&data->bottom,
+		memory_order_acquire);
+
+	if (top >= bottom) return DT_STACK_EEMPTY;
+
+	struct stack_buffer * buffer = atomic_load_explicit(&data->buffer,
+		memory_order_acquire);
+	void * taken = atomic_load_explicit(
+		&buffer->items[top & (buffer->length - 1)], memory_order_relaxed);
+
+	if (!atomic_compare_exchange_strong_explicit(&data->top, &top, top + 1,
+		memory_order_seq_cst, memory_order_relaxed)) {
+		return DT_STACK_EAGAIN;
+	}
+
+	*item = taken;
+	return 0;
+}
+
+
+static int stack_push(struct dt_stack * this, void * item)
+{
+	return stack_push_many(this, &item, 1);
+}
+
+static void * stack_pop(struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+
+	long long bottom = atomic_load_explicit(&data->bottom,
+		memory_order_relaxed) - 1;
+	struct stack_buffer * buffer = atomic_load_explicit(&data->buffer,
+		memory_order_relaxed);
+
+	// Claim the bottom item before looking at the top so a
+	// thief either sees the claim or the owner sees the theft.
+	atomic_store_explicit(&data->bottom, bottom, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	long long top = atomic_load_explicit(&data->top, memory_order_relaxed);
+
+	if (top > bottom) {
+		// Empty.
+		atomic_store_explicit(&data->bottom, bottom + 1,
+			memory_order_relaxed);
+		return NULL;
+	}
+
+	void * item = atomic_load_explicit(
+		&buffer->items[bottom & (buffer->length - 1)], memory_order_relaxed);
+
+	if (top == bottom) {
+		// The last item, race the thieves for it.
+		if (!atomic_compare_exchange_strong_explicit(&data->top, &top,
+			top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+			item = NULL;
+		}
+		atomic_store_explicit(&data->bottom, bottom + 1,
+			memory_order_relaxed);
+	}
+
+	return item;
+}
+
+static int stack_push_many(struct dt_stack * this, void * const * items,
+	size_t count)
+{
+	struct stack_implementation * data = this->_data;
+	if (!count) return 0;
+
+	long long bottom = atomic_load_explicit(&data->bottom,
+		memory_order_relaxed);
+	long long top = atomic_load_explicit(&data->top, memory_order_acquire);
+
+	struct stack_buffer * buffer = reserve(data, top, bottom, count);
+	if (!buffer) return DT_STACK_ENOMEM;
+
+	for (size_t i = 0; i < count; i++) {
+		atomic_store_explicit(
+			&buffer->items[(bottom + i) & (buffer->length - 1)],
+			items[i], memory_order_relaxed);
+	}
+
+	// Thieves must see the items before the new bottom.
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&data->bottom, bottom + count,
+		memory_order_relaxed);
+
+	return 0;
+}
+
+static size_t stack_pop_many(struct dt_stack * this, void ** out,
+	size_t count)
+{
+	// Each item may be raced for so take them one at a time.
+	size_t popped = 0;
+
+	while (popped < count) {
+		void * item = stack_pop(this);
+		if (!item) break;
+
+		popped++;
+		out[count - popped] = item;
+	}
+
+	// Close the gap if the stack ran out.
+	if (popped < count) {
+		memmove(out, out + count - popped, sizeof(*out) * popped);
+	}
+
+	return popped;
+}
+
+static void * stack_peek(const struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+
+	long long bottom = atomic_load_explicit(&data->bottom,
+		memory_order_relaxed);
+	long long top = atomic_load_explicit(&data->top, memory_order_acquire);
+	if (top >= bottom) return NULL;
+
+	struct stack_buffer * buffer = atomic_load_explicit(&data->buffer,
+		memory_order_relaxed);
+	return atomic_load_explicit(
+		&buffer->items[(bottom - 1) & (buffer->length - 1)],
+		memory_order_relaxed);
+}
+
+static size_t stack_length(const struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+
+	long long bottom = atomic_load_explicit(&data->bottom,
+		memory_order_relaxed);
+	long long top = atomic_load_explicit(&data->top, memory_order_acquire);
+	if (top >= bottom) return 0;
+	return bottom - top;
+}
+
+static void stack_del(struct dt_stack * this)
+{
+	struct stack_implementation * data = this->_data;
+	struct stack_buffer * buffer = atomic_load_explicit(&data->buffer,
+		memory_order_relaxed);
+
+	while (buffer) {
+		struct stack_buffer * del_buffer = buffer;
+		buffer = buffer->previous;
+		free(del_buffer);
+	}
+
+	free(this);
+}
+
+static struct stack_buffer * buffer_new(long long length)
+{
+	if ((size_t) length > (((size_t) -1) - sizeof(struct stack_buffer)) /
+		sizeof(void *)) {
+		// Overflow
+		return NULL;
+	}
+
+	struct stack_buffer * buffer = malloc(sizeof(*buffer) +
+		sizeof(void *) * length);
+	if (!buffer) return NULL;
+
+	buffer->previous = NULL;
+	buffer->length = length;
+	return buffer;
+}
+
+static struct stack_buffer * reserve(struct stack_implementation * data,
+	long long top, long long bottom, size_t count)
+{
+	struct stack_buffer * buffer = atomic_load_explicit(&data->buffer,
+		memory_order_relaxed);
+	long long needed = bottom - top + (long long) count;
+
+	if (needed <= buffer->length) return buffer;
+
+	long long length = buffer->length;
+	while (length < needed) {
+		if (length * 2 < length) return NULL;
+		length *= 2;
+	}
+
+	struct stack_buffer * grown = buffer_new(length);
+	if (!grown) return NULL;
+
+	for (long long i = top; i < bottom; i++) {
+		atomic_store_explicit(&grown->items[i & (length - 1)],
+			atomic_load_explicit(&buffer->items[i & (buffer->length - 1)],
+				memory_order_relaxed),
+			memory_order_relaxed);
+	}
+
+	grown->previous = buffer;
+	atomic_store_explicit(&data->buffer, grown, memory_order_release);
+	return grown;
+}
@@ -0,0 +1,305 @@
+#include "gtest/gtest.h"
+
+#include "allocator.h"
+#include "list.h"
+#include "list/error.h"
+#include "list/linked.h"
+#include "list/readonly.h"
+#include "list/vector.h"
+#include "set.h"
+#include "set/error.h"
+#include "set/hash.h"
+#include "set/list.h"
+#include "set/tree.h"
+#include "stack.h"
+#include "stack/error.h"
+#include "stack/linked.h"
+#include "stack/vector.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Counts what goes through it and fails once
+// allocations_left runs out.
+struct counts {
+	size_t allocations;
+	size_t frees;
+	size_t live_bytes;
+	size_t allocations_left;
+};
+
+static void * counting_alloc(void * ctx, size_t size)
+{
+	struct counts * counts = (struct counts *) ctx;
+	if (!counts->allocations_left) return NULL;
+	counts->allocations_left--;
+	counts->allocations++;
+	counts->live_bytes += size;
+	return malloc(size);
+}
+
+static void * counting_realloc(void * ctx, void * pointer,
+	size_t old_size, size_t new_size)
+{
+	struct counts * counts = (struct counts *) ctx;
+	if (!counts->allocations_left) return NULL;
+	counts->allocations_left--;
+	void * resized = realloc(pointer, new_size);
+	if (resized) counts->live_bytes += new_size - old_size;
+	return resized;
+}
+
+static void counting_free(void * ctx, void * pointer, size_t size)
+{
+	struct counts * counts = (struct counts *) ctx;
+	counts->frees++;
+	counts->live_bytes -= size;
+	free(pointer);
+}
+
+struct counting_allocator {
+	struct counts counts;
+	struct dt_allocator allocator;
+
+	counting_allocator()
+	{
+		counts.allocations = 0;
+		counts.frees = 0;
+		counts.live_bytes = 0;
+		counts.allocations_left = SIZE_MAX;
+		allocator.alloc = &counting_alloc;
+		allocator.realloc = &counting_realloc;
+		allocator.free = &counting_free;
+		allocator.ctx = &counts;
+	}
+};
+
+int compare(void * a, void * b)
+{
+	uintptr_t x = (uintptr_t) a;
+	uintptr_t y = (uintptr_t) b;
+	return
+		x == y ? 0 :
+		x < y ? -1 : 1;
+}
+
+unsigned int hash(void * item)
+{
+	return (uintptr_t) item;
+}
+
+void * item(uintptr_t value)
+{
+	return (void *) value;
+}
+
+// Grows the list past any inline storage, walks it with a
+// heap iterator and shrinks it back down.
+void use_list(struct dt_list * list)
+{
+	for (uintptr_t i = 1; i <= 100; i++) {
+		EXPECT_EQ(0, list->insert(list, list->length(list), item(i)));
+	}
+
+	struct dt_list_iterator * iterator = list->iterator(list);
+	ASSERT_TRUE(iterator);
+	uintptr_t expected = 1;
+	for (; iterator->valid(iterator); iterator->next(iterator)) {
+		EXPECT_EQ(item(expected++), iterator->get(iterator));
+	}
+	iterator->del(iterator);
+
+	while (list->length(list) > 3) {
+		EXPECT_EQ(0, list->remove(list, 0));
+	}
+}
+
+void use_set(struct dt_set * set)
+{
+	for (uintptr_t i = 1; i <= 1000; i++) {
+		EXPECT_EQ(0, set->insert(set, item(i)));
+	}
+	for (uintptr_t i = 1; i <= 1000; i += 2) {
+		set->remove(set, item(i));
+	}
+
+	struct dt_list * items = set->items(set);
+	ASSERT_TRUE(items);
+	EXPECT_EQ(500u, items->length(items));
+
+	struct dt_list_iterator * iterator = items->iterator(items);
+	ASSERT_TRUE(iterator);
+	iterator->del(iterator);
+	items->del(items);
+}
+
+void use_stack(struct dt_stack * stack)
+{
+	for (uintptr_t i = 1; i <= 100; i++) {
+		EXPECT_EQ(0, stack->push(stack, item(i)));
+	}
+	for (uintptr_t i = 100; i > 3; i--) {
+		EXPECT_EQ(item(i), stack->pop(stack));
+	}
+}
+
+TEST (AllocatorTest, ListsUseTheAllocator) {
+	struct dt_list * (* constructors[])(const struct dt_allocator *) = {
+		&dt_list_vector_new_with_allocator,
+		&dt_list_linked_new_with_allocator
+	};
+
+	for (auto constructor : constructors) {
+		counting_allocator counting;
+		struct dt_list * list = constructor(&counting.allocator);
+		ASSERT_TRUE(list);
+		use_list(list);
+		list->del(list);
+
+		// The list itself, its buffer or nodes and the iterator.
+		EXPECT_LT(2u, counting.counts.allocations);
+		EXPECT_EQ(counting.counts.allocations, counting.counts.frees);
+		EXPECT_EQ(0u, counting.counts.live_bytes);
+	}
+}
+
+TEST (AllocatorTest, ReadonlyListUsesTheAllocator) {
+	counting_allocator counting;
+	struct dt_list * list = dt_list_linked_new();
+	for (uintptr_t i = 1; i <= 10; i++) {
+		list->insert(list, i - 1, item(i));
+	}
+
+	struct dt_list * readonly =
+		dt_list_readonly_new_with_allocator(list, &counting.allocator);
+	ASSERT_TRUE(readonly);
+	EXPECT_EQ(10u, readonly->length(readonly));
+	EXPECT_EQ(item(4), readonly->get(readonly, 3));
+
+	struct dt_list_iterator * iterator = readonly->iterator(readonly);
+	ASSERT_TRUE(iterator);
+	EXPECT_EQ(item(1), iterator->get(iterator));
+	iterator->del(iterator);
+	readonly->del(readonly);
+	list->del(list);
+
+	EXPECT_EQ(2u, counting.counts.allocations);
+	EXPECT_EQ(2u, counting.counts.frees);
+	EXPECT_EQ(0u, counting.counts.live_bytes);
+}
+
+TEST (AllocatorTest, SetsUseTheAllocator) {
+	struct dt_set * (* constructors[])(int (*)(void *, void *),
+		unsigned int (*)(void *), const struct dt_allocator *) = {
+		&dt_set_hash_new_with_allocator,
+		&dt_set_tree_new_with_allocator,
+		&dt_set_list_new_with_allocator
+	};
+
+	for (auto constructor : constructors) {
+		counting_allocator counting;
+		struct dt_set * set =
+			constructor(&compare, &hash, &counting.allocator);
+		ASSERT_TRUE(set);
+		use_set(set);
+		set->del(set);
+
+		EXPECT_LT(2u, counting.counts.allocations);
+		EXPECT_EQ(counting.counts.allocations, counting.counts.frees);
+		EXPECT_EQ(0u, counting.counts.live_bytes);
+	}
+}
+
+TEST (AllocatorTest, StacksUseTheAllocator) {
+	struct dt_stack * (* constructors[])(const struct dt_allocator *) = {
+		&dt_stack_vector_new_with_allocator,
+		&dt_stack_linked_new_with_allocator
+	};
+
+	for (auto constructor : constructors) {
+		counting_allocator counting;
+		struct dt_stack * stack = constructor(&counting.allocator);
+		ASSERT_TRUE(stack);
+		use_stack(stack);
+		stack->del(stack);
+
+		EXPECT_LT(1u, counting.counts.allocations);
+		EXPECT_EQ(counting.counts.allocations, counting.counts.frees);
+		EXPECT_EQ(0u, counting.counts.live_bytes);
+	}
+}
+
+TEST (AllocatorTest, NullIsMalloc) {
+	struct dt_list * list = dt_list_vector_new_with_allocator(NULL);
+	ASSERT_TRUE(list);
+	use_list(list);
+	list->del(list);
+
+	struct dt_set * set = dt_set_hash_new_with_allocator(
+		&compare, &hash, NULL);
+	ASSERT_TRUE(set);
+	use_set(set);
+	set->del(set);
+
+	struct dt_stack * stack = dt_stack_linked_new_with_allocator(NULL);
+	ASSERT_TRUE(stack);
+	use_stack(stack);
+	stack->del(stack);
+}
+
+TEST (AllocatorTest, FailuresAreReported) {
+	counting_allocator counting;
+	counting.counts.allocations_left = 0;
+	EXPECT_FALSE(dt_list_linked_new_with_allocator(&counting.allocator));
+	EXPECT_FALSE(dt_set_tree_new_with_allocator(
+		&compare, &hash, &counting.allocator));
+
+	counting.counts.allocations_left = 1;
+	struct dt_list * list =
+		dt_list_linked_new_with_allocator(&counting.allocator);
+	ASSERT_TRUE(list);
+	EXPECT_EQ(DT_LIST_ENOMEM, list->insert(list, 0, item(1)));
+	EXPECT_EQ(0u, list->length(list));
+	list->del(list);
+
+	counting.counts.allocations_left = 1;
+	struct dt_stack * stack =
+		dt_stack_vector_new_with_allocator(&counting.allocator);
+	ASSERT_TRUE(stack);
+	for (uintptr_t i = 1; i <= DT_STACK_VECTOR_INLINE_LENGTH; i++) {
+		EXPECT_EQ(0, stack->push(stack, item(i)));
+	}
+	EXPECT_EQ(DT_STACK_ENOMEM, stack->push(stack, item(99)));
+	stack->del(stack);
+
+	EXPECT_EQ(counting.counts.allocations, counting.counts.frees);
+	EXPECT_EQ(0u, counting.counts.live_bytes);
+}
+
+TEST (AllocatorTest, SplicingBetweenAllocatorsCopies) {
+	counting_allocator first;
+	counting_allocator second;
+	struct dt_list * a = dt_list_linked_new_with_allocator(&first.allocator);
+	struct dt_list * b = dt_list_linked_new_with_allocator(&second.allocator);
+
+	for (uintptr_t i = 1; i <= 10; i++) {
+		a->insert(a, i - 1, item(i));
+	}
+	EXPECT_EQ(0, dt_list_linked_splice(b, 0, a, 2, 7));
+	EXPECT_EQ(5u, a->length(a));
+	EXPECT_EQ(5u, b->length(b));
+	EXPECT_EQ(item(3), b->get(b, 0));
+
+	struct dt_list * rest = dt_list_linked_split_at(b, 2);
+	ASSERT_TRUE(rest);
+	EXPECT_EQ(3u, rest->length(rest));
+
+	a->del(a);
+	b->del(b);
+	rest->del(rest);
+
+	EXPECT_EQ(first.counts.allocations, first.counts.frees);
+	EXPECT_EQ(0u, first.counts.live_bytes);
+	EXPECT_EQ(second.counts.allocations, second.counts.frees);
+	EXPECT_EQ(0u, second.counts.live_bytes);
+}
@@ -0,0 +1,506 @@
+
+#include "gtest/gtest.h"
+
+
+
+#include "list.h"
+#include "list/error.h"
+#include "list/gap.h"
+
+static char items[] = "";
+static struct dt_list * new_list() {
+	return dt_list_gap_new();
+}
+
+TEST (ListTest, BasicListUsage) {
+	struct dt_list * list = new_list();
+	EXPECT_TRUE(list) << "New failed!";
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+
+	EXPECT_EQ(1, list->length(list));
+
+	EXPECT_EQ(0, list->remove(list, 0));
+
+	EXPECT_EQ(0, list->length(list));
+
+	list->del(list);
+}
+
+TEST (ListTest, SmallList) {
+	
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+
+	EXPECT_EQ(4, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+
+	EXPECT_EQ(0, list->remove(list, 1));
+	EXPECT_EQ(3, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 2, list->get(list, 1));
+	EXPECT_EQ(items + 3, list->get(list, 2));
+
+	EXPECT_EQ(0, list->remove(list, 2));
+	EXPECT_EQ(0, list->remove(list, 0));
+
+	EXPECT_EQ(1, list->length(list));
+
+	EXPECT_EQ(items + 2, list->get(list, 0));
+
+	EXPECT_EQ(0, list->insert(list, 1, items + 3));
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+
+	EXPECT_EQ(3, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 2, list->get(list, 1));
+	EXPECT_EQ(items + 3, list->get(list, 2));
+	
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+
+	EXPECT_EQ(4, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	
+	list->del(list);
+}
+
+TEST (ListTest, RandomInsertGet) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 3));
+	EXPECT_EQ(0, list->insert(list, 0, items + 1));
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	
+	list->del(list);
+}
+
+TEST (IterateForwardTest, ScanTest) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+
+	iterator->del(iterator);
+	list->del(list);
+}
+
+
+
+TEST (IterateForwardTest, InsertTest) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 1));
+	EXPECT_EQ(0, list->insert(list, 1, items + 3));
+
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+	
+	EXPECT_EQ(0, iterator->insert(iterator, items + 0));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+	
+	EXPECT_EQ(0, iterator->insert(iterator, items + 2));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+
+	EXPECT_EQ(0, iterator->insert(iterator, items + 4));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 4, iterator->get(iterator));
+
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+	
+	iterator->del(iterator);
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	EXPECT_EQ(items + 4, list->get(list, 4));
+
+	EXPECT_EQ(5, list->length(list));
+
+	list->del(list);
+	
+}
+
+TEST (IterateForwardTest, DeleteTest) {
+	struct dt_list * list = new_list();
+	
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+	EXPECT_EQ(0, list->insert(list, 4, items + 4));
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 4, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+	
+	iterator->del(iterator);
+
+	EXPECT_EQ(items + 1, list->get(list, 0));
+	EXPECT_EQ(items + 3, list->get(list, 1));
+
+	EXPECT_EQ(2, list->length(list));
+
+	list->del(list);
+}
+
+TEST (IterateBackwardTest, ScanTest) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->previous(iterator));
+
+	iterator->del(iterator);
+	list->del(list);
+}
+
+TEST (IterateBackwardTest, InsertTest) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 1));
+	EXPECT_EQ(0, list->insert(list, 1, items + 3));
+
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+	
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	
+	EXPECT_EQ(0, iterator->insert(iterator, items + 4));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 4, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->insert(iterator, items + 2));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->insert(iterator, items + 0));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+
+	iterator->del(iterator);
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	EXPECT_EQ(items + 4, list->get(list, 4));
+
+	EXPECT_EQ(5, list->length(list));
+
+	list->del(list);
+	
+}
+
+TEST (IterateBackwardTest, DeleteTest) {
+	struct dt_list * list = new_list();
+	
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+	EXPECT_EQ(0, list->insert(list, 4, items + 4));
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->previous(iterator));
+
+	iterator->del(iterator);
+
+	EXPECT_EQ(items + 1, list->get(list, 0));
+	EXPECT_EQ(items + 3, list->get(list, 1));
+
+	EXPECT_EQ(2, list->length(list));
+
+	list->del(list);
+}
+
+TEST (GapTest, MovingEdits) {
+	struct dt_list * list = new_list();
+	char expected[64];
+	size_t length = 0;
+	size_t cursor = 0;
+
+	// Walk a cursor back and forth so the gap has to follow
+	// it across buffer growth and shrinking.
+	for (size_t i = 0; i < 64; i++) {
+		cursor = (cursor + 37) % (length + 1);
+		for (size_t j = length; j > cursor; j--) {
+			expected[j] = expected[j - 1];
+		}
+		expected[cursor] = (char) i;
+		length++;
+		EXPECT_EQ(0, list->insert(list, cursor, items + i));
+	}
+
+	EXPECT_EQ(length, list->length(list));
+	for (size_t i = 0; i < length; i++) {
+		EXPECT_EQ(items + expected[i], list->get(list, i));
+	}
+
+	while (length > 1) {
+		cursor = (cursor + 11) % length;
+		for (size_t j = cursor; j + 1 < length; j++) {
+			expected[j] = expected[j + 1];
+		}
+		length--;
+		EXPECT_EQ(0, list->remove(list, cursor));
+		EXPECT_EQ(items + expected[length / 2],
+			list->get(list, length / 2));
+	}
+
+	EXPECT_EQ(1, list->length(list));
+	EXPECT_EQ(items + expected[0], list->get(list, 0));
+
+	list->del(list);
+}
+
+TEST (RangeTest, InsertRange) {
+	struct dt_list * list = new_list();
+
+	void * first[] = {items + 0, items + 4};
+	void * middle[] = {items + 1, items + 2, items + 3};
+
+	EXPECT_EQ(0, list->insert_range(list, 0, first, 2));
+	EXPECT_EQ(0, list->insert_range(list, 1, middle, 3));
+	EXPECT_EQ(0, list->insert_range(list, 5, middle, 0));
+	EXPECT_EQ(DT_LIST_EINDEX, list->insert_range(list, 6, middle, 3));
+
+	EXPECT_EQ(5, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	EXPECT_EQ(items + 4, list->get(list, 4));
+
+	list->del(list);
+}
+
+TEST (RangeTest, RemoveRange) {
+	struct dt_list * list = new_list();
+
+	void * all[] = {
+		items + 0, items + 1, items + 2, items + 3, items + 4,
+		items + 5, items + 6, items + 7, items + 8, items + 9};
+
+	EXPECT_EQ(0, list->insert_range(list, 0, all, 10));
+
+	EXPECT_EQ(DT_LIST_EINDEX, list->remove_range(list, 8, 3));
+	EXPECT_EQ(DT_LIST_EINDEX, list->remove_range(list, 11, 0));
+	EXPECT_EQ(0, list->remove_range(list, 2, 3));
+	EXPECT_EQ(0, list->remove_range(list, 5, 2));
+	EXPECT_EQ(0, list->remove_range(list, 0, 1));
+
+	EXPECT_EQ(4, list->length(list));
+
+	EXPECT_EQ(items + 1, list->get(list, 0));
+	EXPECT_EQ(items + 5, list->get(list, 1));
+	EXPECT_EQ(items + 6, list->get(list, 2));
+	EXPECT_EQ(items + 7, list->get(list, 3));
+
+	EXPECT_EQ(0, list->remove_range(list, 0, 4));
+	EXPECT_EQ(0, list->length(list));
+
+	list->del(list);
+}
+
+TEST (RangeTest, AppendMany) {
+	struct dt_list * list = new_list();
+
+	void * all[40];
+	for (size_t i = 0; i < 40; i++) {
+		all[i] = items + i;
+	}
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 40));
+	EXPECT_EQ(0, list->append_many(list, all, 20));
+	EXPECT_EQ(0, list->append_many(list, all + 20, 20));
+
+	EXPECT_EQ(41, list->length(list));
+	EXPECT_EQ(items + 40, list->get(list, 0));
+	for (size_t i = 0; i < 40; i++) {
+		EXPECT_EQ(items + i, list->get(list, i + 1));
+	}
+
+	list->del(list);
+}
+
+TEST (IterateInitTest, ScanAndEdit) {
+	struct dt_list * list = new_list();
+
+	struct dt_list_iterator storage;
+	struct dt_list_iterator * iterator = list->iterator_init(list, &storage);
+	EXPECT_EQ(&storage, iterator);
+
+	for (size_t i = 0; i < 20; i++) {
+		EXPECT_EQ(0, iterator->insert(iterator, items + i));
+		iterator->next(iterator);
+	}
+	EXPECT_EQ(20, list->length(list));
+	EXPECT_FALSE(iterator->valid(iterator));
+
+	// Walk back and drop every other item.
+	while (!iterator->previous(iterator)) {
+		if (iterator->position % 2) {
+			EXPECT_EQ(0, iterator->remove(iterator));
+		}
+	}
+	iterator->del(iterator);
+
+	EXPECT_EQ(10, list->length(list));
+	iterator = list->iterator_init(list, &storage);
+	for (size_t i = 0; i < 10; i++) {
+		EXPECT_TRUE(iterator->valid(iterator));
+		EXPECT_EQ(items + i * 2, iterator->get(iterator));
+		iterator->next(iterator);
+	}
+	EXPECT_FALSE(iterator->valid(iterator));
+	iterator->del(iterator);
+
+	list->del(list);
+}
@@ -0,0 +1,592 @@
+#include "gtest/gtest.h"
+
+
+
+#include "list.h"
+#include "list/error.h"
+#include "list/intrusive.h"
+
+#include <stddef.h>
+#include <string.h>
+
+struct element {
+	int value;
+	struct dt_list_link link;
+};
+
+static struct element items[2048];
+static struct dt_list * new_list() {
+	return dt_list_intrusive_new(offsetof(struct element, link));
+}
+
+TEST (ListTest, BasicListUsage) {
+	struct dt_list * list = new_list();
+	EXPECT_TRUE(list) << "New failed!";
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+
+	EXPECT_EQ(1, list->length(list));
+
+	EXPECT_EQ(0, list->remove(list, 0));
+
+	EXPECT_EQ(0, list->length(list));
+
+	list->del(list);
+}
+
+TEST (ListTest, SmallList) {
+	
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+
+	EXPECT_EQ(4, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+
+	EXPECT_EQ(0, list->remove(list, 1));
+	EXPECT_EQ(3, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 2, list->get(list, 1));
+	EXPECT_EQ(items + 3, list->get(list, 2));
+
+	EXPECT_EQ(0, list->remove(list, 2));
+	EXPECT_EQ(0, list->remove(list, 0));
+
+	EXPECT_EQ(1, list->length(list));
+
+	EXPECT_EQ(items + 2, list->get(list, 0));
+
+	EXPECT_EQ(0, list->insert(list, 1, items + 3));
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+
+	EXPECT_EQ(3, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 2, list->get(list, 1));
+	EXPECT_EQ(items + 3, list->get(list, 2));
+	
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+
+	EXPECT_EQ(4, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	
+	list->del(list);
+}
+
+TEST (ListTest, RandomInsertGet) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 3));
+	EXPECT_EQ(0, list->insert(list, 0, items + 1));
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	
+	list->del(list);
+}
+
+TEST (IterateForwardTest, ScanTest) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+
+	iterator->del(iterator);
+	list->del(list);
+}
+
+
+
+TEST (IterateForwardTest, InsertTest) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 1));
+	EXPECT_EQ(0, list->insert(list, 1, items + 3));
+
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+	
+	EXPECT_EQ(0, iterator->insert(iterator, items + 0));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+	
+	EXPECT_EQ(0, iterator->insert(iterator, items + 2));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+
+	EXPECT_EQ(0, iterator->insert(iterator, items + 4));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 4, iterator->get(iterator));
+
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+	
+	iterator->del(iterator);
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	EXPECT_EQ(items + 4, list->get(list, 4));
+
+	EXPECT_EQ(5, list->length(list));
+
+	list->del(list);
+	
+}
+
+TEST (IterateForwardTest, DeleteTest) {
+	struct dt_list * list = new_list();
+	
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+	EXPECT_EQ(0, list->insert(list, 4, items + 4));
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 4, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+	
+	iterator->del(iterator);
+
+	EXPECT_EQ(items + 1, list->get(list, 0));
+	EXPECT_EQ(items + 3, list->get(list, 1));
+
+	EXPECT_EQ(2, list->length(list));
+
+	list->del(list);
+}
+
+TEST (IterateBackwardTest, ScanTest) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->previous(iterator));
+
+	iterator->del(iterator);
+	list->del(list);
+}
+
+TEST (IterateBackwardTest, InsertTest) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 1));
+	EXPECT_EQ(0, list->insert(list, 1, items + 3));
+
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+	
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	
+	EXPECT_EQ(0, iterator->insert(iterator, items + 4));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 4, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->insert(iterator, items + 2));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->insert(iterator, items + 0));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+
+	iterator->del(iterator);
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	EXPECT_EQ(items + 4, list->get(list, 4));
+
+	EXPECT_EQ(5, list->length(list));
+
+	list->del(list);
+	
+}
+
+TEST (IterateBackwardTest, DeleteTest) {
+	struct dt_list * list = new_list();
+	
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+	EXPECT_EQ(0, list->insert(list, 4, items + 4));
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->previous(iterator));
+
+	iterator->del(iterator);
+
+	EXPECT_EQ(items + 1, list->get(list, 0));
+	EXPECT_EQ(items + 3, list->get(list, 1));
+
+	EXPECT_EQ(2, list->length(list));
+
+	list->del(list);
+}
+
+TEST (RangeTest, InsertRange) {
+	struct dt_list * list = new_list();
+
+	void * first[] = {items + 0, items + 4};
+	void * middle[] = {items + 1, items + 2, items + 3};
+
+	EXPECT_EQ(0, list->insert_range(list, 0, first, 2));
+	EXPECT_EQ(0, list->insert_range(list, 1, middle, 3));
+	EXPECT_EQ(0, list->insert_range(list, 5, middle, 0));
+	EXPECT_EQ(DT_LIST_EINDEX, list->insert_range(list, 6, middle, 3));
+
+	EXPECT_EQ(5, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	EXPECT_EQ(items + 4, list->get(list, 4));
+
+	list->del(list);
+}
+
+TEST (RangeTest, RemoveRange) {
+	struct dt_list * list = new_list();
+
+	void * all[] = {
+		items + 0, items + 1, items + 2, items + 3, items + 4,
+		items + 5, items + 6, items + 7, items + 8, items + 9};
+
+	EXPECT_EQ(0, list->insert_range(list, 0, all, 10));
+
+	EXPECT_EQ(DT_LIST_EINDEX, list->remove_range(list, 8, 3));
+	EXPECT_EQ(DT_LIST_EINDEX, list->remove_range(list, 11, 0));
+	EXPECT_EQ(0, list->remove_range(list, 2, 3));
+	EXPECT_EQ(0, list->remove_range(list, 5, 2));
+	EXPECT_EQ(0, list->remove_range(list, 0, 1));
+
+	EXPECT_EQ(4, list->length(list));
+
+	EXPECT_EQ(items + 1, list->get(list, 0));
+	EXPECT_EQ(items + 5, list->get(list, 1));
+	EXPECT_EQ(items + 6, list->get(list, 2));
+	EXPECT_EQ(items + 7, list->get(list, 3));
+
+	EXPECT_EQ(0, list->remove_range(list, 0, 4));
+	EXPECT_EQ(0, list->length(list));
+
+	list->del(list);
+}
+
+TEST (RangeTest, AppendMany) {
+	struct dt_list * list = new_list();
+
+	void * all[40];
+	for (size_t i = 0; i < 40; i++) {
+		all[i] = items + i;
+	}
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 40));
+	EXPECT_EQ(0, list->append_many(list, all, 20));
+	EXPECT_EQ(0, list->append_many(list, all + 20, 20));
+
+	EXPECT_EQ(41, list->length(list));
+	EXPECT_EQ(items + 40, list->get(list, 0));
+	for (size_t i = 0; i < 40; i++) {
+		EXPECT_EQ(items + i, list->get(list, i + 1));
+	}
+
+	list->del(list);
+}
+
+TEST (IterateInitTest, ScanAndEdit) {
+	struct dt_list * list = new_list();
+
+	struct dt_list_iterator storage;
+	struct dt_list_iterator * iterator = list->iterator_init(list, &storage);
+	EXPECT_EQ(&storage, iterator);
+
+	for (size_t i = 0; i < 20; i++) {
+		EXPECT_EQ(0, iterator->insert(iterator, items + i));
+		iterator->next(iterator);
+	}
+	EXPECT_EQ(20, list->length(list));
+	EXPECT_FALSE(iterator->valid(iterator));
+
+	// Walk back and drop every other item.
+	while (!iterator->previous(iterator)) {
+		if (iterator->position % 2) {
+			EXPECT_EQ(0, iterator->remove(iterator));
+		}
+	}
+	iterator->del(iterator);
+
+	EXPECT_EQ(10, list->length(list));
+	iterator = list->iterator_init(list, &storage);
+	for (size_t i = 0; i < 10; i++) {
+		EXPECT_TRUE(iterator->valid(iterator));
+		EXPECT_EQ(items + i * 2, iterator->get(iterator));
+		iterator->next(iterator);
+	}
+	EXPECT_FALSE(iterator->valid(iterator));
+	iterator->del(iterator);
+
+	list->del(list);
+}
+
+TEST (FingerTest, MixedEdits) {
+	// Keeps a plain array alongside the list so every way of
+	// moving the finger and tail gets checked against it.
+	struct dt_list * list = new_list();
+	void * expected[200];
+	size_t length = 0;
+
+	unsigned int state = 12345;
+	for (size_t step = 0; step < 2000; step++) {
+		state = state * 1103515245 + 12345;
+		unsigned int r = state >> 16;
+		size_t index = length ? r % (length + 1) : 0;
+
+		if (length < 200 && (r & 0x3) != 0) {
+			void * item = items + step;
+			EXPECT_EQ(0, list->insert(list, index, item));
+			memmove(expected + index + 1, expected + index,
+				sizeof(*expected) * (length - index));
+			expected[index] = item;
+			length++;
+		} else if (length) {
+			if (index == length) index--;
+			EXPECT_EQ(0, list->remove(list, index));
+			memmove(expected + index, expected + index + 1,
+				sizeof(*expected) * (length - index - 1));
+			length--;
+		}
+
+		ASSERT_EQ(length, list->length(list));
+		if (length) {
+			EXPECT_EQ(expected[length - 1], list->get(list, length - 1));
+			EXPECT_EQ(expected[length / 2], list->get(list, length / 2));
+		}
+	}
+
+	for (size_t i = 0; i < length; i++) {
+		EXPECT_EQ(expected[i], list->get(list, i));
+	}
+	for (size_t i = length; i > 0; i--) {
+		EXPECT_EQ(expected[i - 1], list->get(list, i - 1));
+	}
+
+	EXPECT_EQ(DT_LIST_EINDEX, list->remove(list, length));
+
+	list->del(list);
+}
+
+TEST (FingerTest, IteratorEditsKeepTail) {
+	struct dt_list * list = new_list();
+
+	struct dt_list_iterator storage;
+	struct dt_list_iterator * iterator = list->iterator_init(list, &storage);
+	for (size_t i = 0; i < 10; i++) {
+		EXPECT_EQ(0, iterator->insert(iterator, items + i));
+		iterator->next(iterator);
+	}
+
+	// Drop the last item through the iterator then append.
+	iterator->previous(iterator);
+	EXPECT_EQ(0, iterator->remove(iterator));
+	iterator->del(iterator);
+
+	EXPECT_EQ(0, list->insert(list, list->length(list), items + 20));
+	EXPECT_EQ(10, list->length(list));
+	EXPECT_EQ(items + 8, list->get(list, 8));
+	EXPECT_EQ(items + 20, list->get(list, 9));
+	EXPECT_EQ(items + 0, list->get(list, 0));
+
+	EXPECT_EQ(0, list->remove_range(list, 5, 5));
+	EXPECT_EQ(0, list->insert(list, 5, items + 30));
+	EXPECT_EQ(items + 4, list->get(list, 4));
+	EXPECT_EQ(items + 30, list->get(list, 5));
+
+	list->del(list);
+}
+
+struct two_links {
+	struct dt_list_link by_age;
+	int value;
+	struct dt_list_link by_name;
+};
+
+TEST (IntrusiveTest, TwoLinks) {
+	// One item can be in two lists through different links.
+	struct two_links people[4];
+	struct dt_list * ages = dt_list_intrusive_new(
+		offsetof(struct two_links, by_age));
+	struct dt_list * names = dt_list_intrusive_new(
+		offsetof(struct two_links, by_name));
+
+	for (size_t i = 0; i < 4; i++) {
+		people[i].value = (int) i;
+		EXPECT_EQ(0, ages->insert(ages, i, people + i));
+		EXPECT_EQ(0, names->insert(names, 0, people + i));
+	}
+
+	for (size_t i = 0; i < 4; i++) {
+		EXPECT_EQ(people + i, ages->get(ages, i));
+		EXPECT_EQ(people + 3 - i, names->get(names, i));
+	}
+
+	// The links are chained through the items themselves.
+	EXPECT_EQ(&people[1].by_age, people[0].by_age.next);
+	EXPECT_EQ(&people[2].by_name, people[3].by_name.next);
+
+	// Removing from one list leaves the other alone and
+	// clears the link so the item can be reused.
+	EXPECT_EQ(0, ages->remove(ages, 1));
+	EXPECT_EQ(NULL, people[1].by_age.next);
+	EXPECT_EQ(NULL, people[1].by_age.previous);
+	EXPECT_EQ(people + 1, names->get(names, 2));
+	EXPECT_EQ(0, ages->insert(ages, 3, people + 1));
+	EXPECT_EQ(people + 1, ages->get(ages, 3));
+
+	ages->del(ages);
+	names->del(names);
+	EXPECT_EQ(1, people[1].value);
+}
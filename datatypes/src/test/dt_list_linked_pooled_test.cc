@@ -0,0 +1,628 @@
+#include "gtest/gtest.h"
+
+
+
+#include "list.h"
+#include "list/error.h"
+#include "list/linked.h"
+
+#include <string.h>
+
+static char items[] = "";
+static struct dt_list * new_list() {
+	return dt_list_linked_pooled_new(NULL);
+}
+
+TEST (ListTest, BasicListUsage) {
+	struct dt_list * list = new_list();
+	EXPECT_TRUE(list) << "New failed!";
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+
+	EXPECT_EQ(1, list->length(list));
+
+	EXPECT_EQ(0, list->remove(list, 0));
+
+	EXPECT_EQ(0, list->length(list));
+
+	list->del(list);
+}
+
+TEST (ListTest, SmallList) {
+	
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+
+	EXPECT_EQ(4, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+
+	EXPECT_EQ(0, list->remove(list, 1));
+	EXPECT_EQ(3, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 2, list->get(list, 1));
+	EXPECT_EQ(items + 3, list->get(list, 2));
+
+	EXPECT_EQ(0, list->remove(list, 2));
+	EXPECT_EQ(0, list->remove(list, 0));
+
+	EXPECT_EQ(1, list->length(list));
+
+	EXPECT_EQ(items + 2, list->get(list, 0));
+
+	EXPECT_EQ(0, list->insert(list, 1, items + 3));
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+
+	EXPECT_EQ(3, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 2, list->get(list, 1));
+	EXPECT_EQ(items + 3, list->get(list, 2));
+	
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+
+	EXPECT_EQ(4, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	
+	list->del(list);
+}
+
+TEST (ListTest, RandomInsertGet) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 3));
+	EXPECT_EQ(0, list->insert(list, 0, items + 1));
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	
+	list->del(list);
+}
+
+TEST (IterateForwardTest, ScanTest) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+
+	iterator->del(iterator);
+	list->del(list);
+}
+
+
+
+TEST (IterateForwardTest, InsertTest) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 1));
+	EXPECT_EQ(0, list->insert(list, 1, items + 3));
+
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+	
+	EXPECT_EQ(0, iterator->insert(iterator, items + 0));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+	
+	EXPECT_EQ(0, iterator->insert(iterator, items + 2));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+
+	EXPECT_EQ(0, iterator->insert(iterator, items + 4));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 4, iterator->get(iterator));
+
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+	
+	iterator->del(iterator);
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	EXPECT_EQ(items + 4, list->get(list, 4));
+
+	EXPECT_EQ(5, list->length(list));
+
+	list->del(list);
+	
+}
+
+TEST (IterateForwardTest, DeleteTest) {
+	struct dt_list * list = new_list();
+	
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+	EXPECT_EQ(0, list->insert(list, 4, items + 4));
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 4, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+	
+	iterator->del(iterator);
+
+	EXPECT_EQ(items + 1, list->get(list, 0));
+	EXPECT_EQ(items + 3, list->get(list, 1));
+
+	EXPECT_EQ(2, list->length(list));
+
+	list->del(list);
+}
+
+TEST (IterateBackwardTest, ScanTest) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->previous(iterator));
+
+	iterator->del(iterator);
+	list->del(list);
+}
+
+TEST (IterateBackwardTest, InsertTest) {
+	struct dt_list * list = new_list();
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 1));
+	EXPECT_EQ(0, list->insert(list, 1, items + 3));
+
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+	
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	
+	EXPECT_EQ(0, iterator->insert(iterator, items + 4));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 4, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->insert(iterator, items + 2));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->insert(iterator, items + 0));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+
+	iterator->del(iterator);
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	EXPECT_EQ(items + 4, list->get(list, 4));
+
+	EXPECT_EQ(5, list->length(list));
+
+	list->del(list);
+	
+}
+
+TEST (IterateBackwardTest, DeleteTest) {
+	struct dt_list * list = new_list();
+	
+	EXPECT_EQ(0, list->insert(list, 0, items + 0));
+	EXPECT_EQ(0, list->insert(list, 1, items + 1));
+	EXPECT_EQ(0, list->insert(list, 2, items + 2));
+	EXPECT_EQ(0, list->insert(list, 3, items + 3));
+	EXPECT_EQ(0, list->insert(list, 4, items + 4));
+
+	struct dt_list_iterator * iterator =
+		list->iterator(list);
+
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(0, iterator->next(iterator));
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->next(iterator));
+	
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_FALSE(iterator->valid(iterator));
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 3, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 2, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 1, iterator->get(iterator));
+
+	EXPECT_EQ(0, iterator->previous(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(items + 0, iterator->get(iterator));
+	EXPECT_EQ(0, iterator->remove(iterator));
+	EXPECT_TRUE(iterator->valid(iterator));
+	EXPECT_EQ(DT_LIST_EINDEX, iterator->previous(iterator));
+
+	iterator->del(iterator);
+
+	EXPECT_EQ(items + 1, list->get(list, 0));
+	EXPECT_EQ(items + 3, list->get(list, 1));
+
+	EXPECT_EQ(2, list->length(list));
+
+	list->del(list);
+}
+
+TEST (RangeTest, InsertRange) {
+	struct dt_list * list = new_list();
+
+	void * first[] = {items + 0, items + 4};
+	void * middle[] = {items + 1, items + 2, items + 3};
+
+	EXPECT_EQ(0, list->insert_range(list, 0, first, 2));
+	EXPECT_EQ(0, list->insert_range(list, 1, middle, 3));
+	EXPECT_EQ(0, list->insert_range(list, 5, middle, 0));
+	EXPECT_EQ(DT_LIST_EINDEX, list->insert_range(list, 6, middle, 3));
+
+	EXPECT_EQ(5, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	EXPECT_EQ(items + 4, list->get(list, 4));
+
+	list->del(list);
+}
+
+TEST (RangeTest, RemoveRange) {
+	struct dt_list * list = new_list();
+
+	void * all[] = {
+		items + 0, items + 1, items + 2, items + 3, items + 4,
+		items + 5, items + 6, items + 7, items + 8, items + 9};
+
+	EXPECT_EQ(0, list->insert_range(list, 0, all, 10));
+
+	EXPECT_EQ(DT_LIST_EINDEX, list->remove_range(list, 8, 3));
+	EXPECT_EQ(DT_LIST_EINDEX, list->remove_range(list, 11, 0));
+	EXPECT_EQ(0, list->remove_range(list, 2, 3));
+	EXPECT_EQ(0, list->remove_range(list, 5, 2));
+	EXPECT_EQ(0, list->remove_range(list, 0, 1));
+
+	EXPECT_EQ(4, list->length(list));
+
+	EXPECT_EQ(items + 1, list->get(list, 0));
+	EXPECT_EQ(items + 5, list->get(list, 1));
+	EXPECT_EQ(items + 6, list->get(list, 2));
+	EXPECT_EQ(items + 7, list->get(list, 3));
+
+	EXPECT_EQ(0, list->remove_range(list, 0, 4));
+	EXPECT_EQ(0, list->length(list));
+
+	list->del(list);
+}
+
+TEST (RangeTest, AppendMany) {
+	struct dt_list * list = new_list();
+
+	void * all[40];
+	for (size_t i = 0; i < 40; i++) {
+		all[i] = items + i;
+	}
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 40));
+	EXPECT_EQ(0, list->append_many(list, all, 20));
+	EXPECT_EQ(0, list->append_many(list, all + 20, 20));
+
+	EXPECT_EQ(41, list->length(list));
+	EXPECT_EQ(items + 40, list->get(list, 0));
+	for (size_t i = 0; i < 40; i++) {
+		EXPECT_EQ(items + i, list->get(list, i + 1));
+	}
+
+	list->del(list);
+}
+
+TEST (IterateInitTest, ScanAndEdit) {
+	struct dt_list * list = new_list();
+
+	struct dt_list_iterator storage;
+	struct dt_list_iterator * iterator = list->iterator_init(list, &storage);
+	EXPECT_EQ(&storage, iterator);
+
+	for (size_t i = 0; i < 20; i++) {
+		EXPECT_EQ(0, iterator->insert(iterator, items + i));
+		iterator->next(iterator);
+	}
+	EXPECT_EQ(20, list->length(list));
+	EXPECT_FALSE(iterator->valid(iterator));
+
+	// Walk back and drop every other item.
+	while (!iterator->previous(iterator)) {
+		if (iterator->position % 2) {
+			EXPECT_EQ(0, iterator->remove(iterator));
+		}
+	}
+	iterator->del(iterator);
+
+	EXPECT_EQ(10, list->length(list));
+	iterator = list->iterator_init(list, &storage);
+	for (size_t i = 0; i < 10; i++) {
+		EXPECT_TRUE(iterator->valid(iterator));
+		EXPECT_EQ(items + i * 2, iterator->get(iterator));
+		iterator->next(iterator);
+	}
+	EXPECT_FALSE(iterator->valid(iterator));
+	iterator->del(iterator);
+
+	list->del(list);
+}
+
+TEST (FingerTest, MixedEdits) {
+	// Keeps a plain array alongside the list so every way of
+	// moving the finger and tail gets checked against it.
+	struct dt_list * list = new_list();
+	void * expected[200];
+	size_t length = 0;
+
+	unsigned int state = 12345;
+	for (size_t step = 0; step < 2000; step++) {
+		state = state * 1103515245 + 12345;
+		unsigned int r = state >> 16;
+		size_t index = length ? r % (length + 1) : 0;
+
+		if (length < 200 && (r & 0x3) != 0) {
+			void * item = items + step;
+			EXPECT_EQ(0, list->insert(list, index, item));
+			memmove(expected + index + 1, expected + index,
+				sizeof(*expected) * (length - index));
+			expected[index] = item;
+			length++;
+		} else if (length) {
+			if (index == length) index--;
+			EXPECT_EQ(0, list->remove(list, index));
+			memmove(expected + index, expected + index + 1,
+				sizeof(*expected) * (length - index - 1));
+			length--;
+		}
+
+		ASSERT_EQ(length, list->length(list));
+		if (length) {
+			EXPECT_EQ(expected[length - 1], list->get(list, length - 1));
+			EXPECT_EQ(expected[length / 2], list->get(list, length / 2));
+		}
+	}
+
+	for (size_t i = 0; i < length; i++) {
+		EXPECT_EQ(expected[i], list->get(list, i));
+	}
+	for (size_t i = length; i > 0; i--) {
+		EXPECT_EQ(expected[i - 1], list->get(list, i - 1));
+	}
+
+	EXPECT_EQ(DT_LIST_EINDEX, list->remove(list, length));
+
+	list->del(list);
+}
+
+TEST (FingerTest, IteratorEditsKeepTail) {
+	struct dt_list * list = new_list();
+
+	struct dt_list_iterator storage;
+	struct dt_list_iterator * iterator = list->iterator_init(list, &storage);
+	for (size_t i = 0; i < 10; i++) {
+		EXPECT_EQ(0, iterator->insert(iterator, items + i));
+		iterator->next(iterator);
+	}
+
+	// Drop the last item through the iterator then append.
+	iterator->previous(iterator);
+	EXPECT_EQ(0, iterator->remove(iterator));
+	iterator->del(iterator);
+
+	EXPECT_EQ(0, list->insert(list, list->length(list), items + 20));
+	EXPECT_EQ(10, list->length(list));
+	EXPECT_EQ(items + 8, list->get(list, 8));
+	EXPECT_EQ(items + 20, list->get(list, 9));
+	EXPECT_EQ(items + 0, list->get(list, 0));
+
+	EXPECT_EQ(0, list->remove_range(list, 5, 5));
+	EXPECT_EQ(0, list->insert(list, 5, items + 30));
+	EXPECT_EQ(items + 4, list->get(list, 4));
+	EXPECT_EQ(items + 30, list->get(list, 5));
+
+	list->del(list);
+}
+
+TEST (PoolTest, SharedPool) {
+	struct dt_pool * pool = dt_pool_new(dt_list_linked_node_size(), 16);
+	ASSERT_TRUE(pool);
+
+	struct dt_list * first = dt_list_linked_pooled_new(pool);
+	struct dt_list * second = dt_list_linked_pooled_new(pool);
+	ASSERT_TRUE(first);
+	ASSERT_TRUE(second);
+
+	for (size_t i = 0; i < 32; i++) {
+		EXPECT_EQ(0, first->insert(first, i, items + i));
+		EXPECT_EQ(0, second->insert(second, 0, items + i));
+	}
+	EXPECT_EQ(64, dt_pool_length(pool));
+	EXPECT_EQ(4, dt_pool_slab_count(pool));
+
+	// Nodes freed by one list are reused by the other.
+	EXPECT_EQ(0, first->remove_range(first, 0, 32));
+	EXPECT_EQ(32, dt_pool_length(pool));
+	for (size_t i = 0; i < 32; i++) {
+		EXPECT_EQ(0, second->insert(second, 0, items + i));
+	}
+	EXPECT_EQ(4, dt_pool_slab_count(pool));
+
+	for (size_t i = 0; i < 64; i++) {
+		EXPECT_EQ(items + (31 - i % 32), second->get(second, i));
+	}
+
+	first->del(first);
+	second->del(second);
+	EXPECT_EQ(0, dt_pool_length(pool));
+	dt_pool_del(pool);
+}
+
+TEST (PoolTest, PoolTooSmall) {
+	struct dt_pool * pool = dt_pool_new(1, 0);
+	ASSERT_TRUE(pool);
+	EXPECT_EQ(NULL, dt_list_linked_pooled_new(pool));
+	dt_pool_del(pool);
+}
+
+TEST (PoolTest, SpliceAcrossPools) {
+	struct dt_pool * pool = dt_pool_new(dt_list_linked_node_size(), 16);
+	ASSERT_TRUE(pool);
+
+	struct dt_list * shared = dt_list_linked_pooled_new(pool);
+	struct dt_list * owner = dt_list_linked_pooled_new(NULL);
+	struct dt_list * plain = dt_list_linked_new();
+	ASSERT_TRUE(shared);
+	ASSERT_TRUE(owner);
+	ASSERT_TRUE(plain);
+
+	for (size_t i = 0; i < 20; i++) {
+		EXPECT_EQ(0, owner->insert(owner, i, items + i));
+	}
+
+	// Each move crosses to a different pool so the nodes are
+	// copied and given back to where they came from.
+	EXPECT_EQ(0, dt_list_linked_splice(shared, 0, owner, 5, 15));
+	EXPECT_EQ(10, dt_pool_length(pool));
+	EXPECT_EQ(0, dt_list_linked_concat(plain, shared));
+	EXPECT_EQ(0, dt_pool_length(pool));
+	EXPECT_EQ(0, dt_list_linked_splice(owner, 5, plain, 0, 10));
+
+	ASSERT_EQ(20, owner->length(owner));
+	for (size_t i = 0; i < 20; i++) {
+		EXPECT_EQ(items + i, owner->get(owner, i));
+	}
+
+	// A split of a shared pool list stays in the pool.
+	EXPECT_EQ(0, dt_list_linked_concat(shared, owner));
+	struct dt_list * rest = dt_list_linked_split_at(shared, 12);
+	ASSERT_TRUE(rest);
+	EXPECT_EQ(20, dt_pool_length(pool));
+	EXPECT_EQ(items + 12, rest->get(rest, 0));
+	EXPECT_EQ(8, rest->length(rest));
+
+	rest->del(rest);
+	shared->del(shared);
+	owner->del(owner);
+	plain->del(plain);
+	EXPECT_EQ(0, dt_pool_length(pool));
+	dt_pool_del(pool);
+}
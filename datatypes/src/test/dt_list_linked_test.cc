@@ -5,6 +5,10 @@
 #include "list.h"
 #include "list/error.h"
 #include "list/linked.h"
+#include "list/readonly.h"
+#include "list/vector.h"
+
+#include <string.h>
 
 static char items[] = "";
 static struct dt_list * new_list() {
@@ -357,3 +361,404 @@ TEST (IterateBackwardTest, DeleteTest) {
 
 	list->del(list);
 }
+
+TEST (RangeTest, InsertRange) {
+	struct dt_list * list = new_list();
+
+	void * first[] = {items + 0, items + 4};
+	void * middle[] = {items + 1, items + 2, items + 3};
+
+	EXPECT_EQ(0, list->insert_range(list, 0, first, 2));
+	EXPECT_EQ(0, list->insert_range(list, 1, middle, 3));
+	EXPECT_EQ(0, list->insert_range(list, 5, middle, 0));
+	EXPECT_EQ(DT_LIST_EINDEX, list->insert_range(list, 6, middle, 3));
+
+	EXPECT_EQ(5, list->length(list));
+
+	EXPECT_EQ(items + 0, list->get(list, 0));
+	EXPECT_EQ(items + 1, list->get(list, 1));
+	EXPECT_EQ(items + 2, list->get(list, 2));
+	EXPECT_EQ(items + 3, list->get(list, 3));
+	EXPECT_EQ(items + 4, list->get(list, 4));
+
+	list->del(list);
+}
+
+TEST (RangeTest, RemoveRange) {
+	struct dt_list * list = new_list();
+
+	void * all[] = {
+		items + 0, items + 1, items + 2, items + 3, items + 4,
+		items + 5, items + 6, items + 7, items + 8, items + 9};
+
+	EXPECT_EQ(0, list->insert_range(list, 0, all, 10));
+
+	EXPECT_EQ(DT_LIST_EINDEX, list->remove_range(list, 8, 3));
+	EXPECT_EQ(DT_LIST_EINDEX, list->remove_range(list, 11, 0));
+	EXPECT_EQ(0, list->remove_range(list, 2, 3));
+	EXPECT_EQ(0, list->remove_range(list, 5, 2));
+	EXPECT_EQ(0, list->remove_range(list, 0, 1));
+
+	EXPECT_EQ(4, list->length(list));
+
+	EXPECT_EQ(items + 1, list->get(list, 0));
+	EXPECT_EQ(items + 5, list->get(list, 1));
+	EXPECT_EQ(items + 6, list->get(list, 2));
+	EXPECT_EQ(items + 7, list->get(list, 3));
+
+	EXPECT_EQ(0, list->remove_range(list, 0, 4));
+	EXPECT_EQ(0, list->length(list));
+
+	list->del(list);
+}
+
+TEST (RangeTest, AppendMany) {
+	struct dt_list * list = new_list();
+
+	void * all[40];
+	for (size_t i = 0; i < 40; i++) {
+		all[i] = items + i;
+	}
+
+	EXPECT_EQ(0, list->insert(list, 0, items + 40));
+	EXPECT_EQ(0, list->append_many(list, all, 20));
+	EXPECT_EQ(0, list->append_many(list, all + 20, 20));
+
+	EXPECT_EQ(41, list->length(list));
+	EXPECT_EQ(items + 40, list->get(list, 0));
+	for (size_t i = 0; i < 40; i++) {
+		EXPECT_EQ(items + i, list->get(list, i + 1));
+	}
+
+	list->del(list);
+}
+
+TEST (IterateInitTest, ScanAndEdit) {
+	struct dt_list * list = new_list();
+
+	struct dt_list_iterator storage;
+	struct dt_list_iterator * iterator = list->iterator_init(list, &storage);
+	EXPECT_EQ(&storage, iterator);
+
+	for (size_t i = 0; i < 20; i++) {
+		EXPECT_EQ(0, iterator->insert(iterator, items + i));
+		iterator->next(iterator);
+	}
+	EXPECT_EQ(20, list->length(list));
+	EXPECT_FALSE(iterator->valid(iterator));
+
+	// Walk back and drop every other item.
+	while (!iterator->previous(iterator)) {
+		if (iterator->position % 2) {
+			EXPECT_EQ(0, iterator->remove(iterator));
+		}
+	}
+	iterator->del(iterator);
+
+	EXPECT_EQ(10, list->length(list));
+	iterator = list->iterator_init(list, &storage);
+	for (size_t i = 0; i < 10; i++) {
+		EXPECT_TRUE(iterator->valid(iterator));
+		EXPECT_EQ(items + i * 2, iterator->get(iterator));
+		iterator->next(iterator);
+	}
+	EXPECT_FALSE(iterator->valid(iterator));
+	iterator->del(iterator);
+
+	list->del(list);
+}
+
+TEST (FingerTest, MixedEdits) {
+	// Keeps a plain array alongside the list so every way of
+	// moving the finger and tail gets checked against it.
+	struct dt_list * list = new_list();
+	void * expected[200];
+	size_t length = 0;
+
+	unsigned int state = 12345;
+	for (size_t step = 0; step < 2000; step++) {
+		state = state * 1103515245 + 12345;
+		unsigned int r = state >> 16;
+		size_t index = length ? r % (length + 1) : 0;
+
+		if (length < 200 && (r & 0x3) != 0) {
+			void * item = items + step;
+			EXPECT_EQ(0, list->insert(list, index, item));
+			memmove(expected + index + 1, expected + index,
+				sizeof(*expected) * (length - index));
+			expected[index] = item;
+			length++;
+		} else if (length) {
+			if (index == length) index--;
+			EXPECT_EQ(0, list->remove(list, index));
+			memmove(expected + index, expected + index + 1,
+				sizeof(*expected) * (length - index - 1));
+			length--;
+		}
+
+		ASSERT_EQ(length, list->length(list));
+		if (length) {
+			EXPECT_EQ(expected[length - 1], list->get(list, length - 1));
+			EXPECT_EQ(expected[length / 2], list->get(list, length / 2));
+		}
+	}
+
+	for (size_t i = 0; i < length; i++) {
+		EXPECT_EQ(expected[i], list->get(list, i));
+	}
+	for (size_t i = length; i > 0; i--) {
+		EXPECT_EQ(expected[i - 1], list->get(list, i - 1));
+	}
+
+	EXPECT_EQ(DT_LIST_EINDEX, list->remove(list, length));
+
+	list->del(list);
+}
+
+TEST (FingerTest, IteratorEditsKeepTail) {
+	struct dt_list * list = new_list();
+
+	struct dt_list_iterator storage;
+	struct dt_list_iterator * iterator = list->iterator_init(list, &storage);
+	for (size_t i = 0; i < 10; i++) {
+		EXPECT_EQ(0, iterator->insert(iterator, items + i));
+		iterator->next(iterator);
+	}
+
+	// Drop the last item through the iterator then append.
+	iterator->previous(iterator);
+	EXPECT_EQ(0, iterator->remove(iterator));
+	iterator->del(iterator);
+
+	EXPECT_EQ(0, list->insert(list, list->length(list), items + 20));
+	EXPECT_EQ(10, list->length(list));
+	EXPECT_EQ(items + 8, list->get(list, 8));
+	EXPECT_EQ(items + 20, list->get(list, 9));
+	EXPECT_EQ(items + 0, list->get(list, 0));
+
+	EXPECT_EQ(0, list->remove_range(list, 5, 5));
+	EXPECT_EQ(0, list->insert(list, 5, items + 30));
+	EXPECT_EQ(items + 4, list->get(list, 4));
+	EXPECT_EQ(items + 30, list->get(list, 5));
+
+	list->del(list);
+}
+
+/** Checks the list holds items + first, items + first + 1 and so
+ *  on, walking both ways so the previous links are checked too.
+ */
+static void expect_run(struct dt_list * list, size_t first, size_t length) {
+	ASSERT_EQ(length, list->length(list));
+
+	struct dt_list_iterator storage;
+	struct dt_list_iterator * iterator = list->iterator_init(list, &storage);
+	for (size_t i = 0; i < length; i++) {
+		EXPECT_EQ(items + first + i, iterator->get(iterator));
+		iterator->next(iterator);
+	}
+	EXPECT_FALSE(iterator->valid(iterator));
+	for (size_t i = length; i > 0; i--) {
+		EXPECT_EQ(0, iterator->previous(iterator));
+		EXPECT_EQ(items + first + i - 1, iterator->get(iterator));
+	}
+	iterator->del(iterator);
+
+	// Appending goes through the tail.
+	if (length) {
+		EXPECT_EQ(items + first + length - 1, list->get(list, length - 1));
+	}
+}
+
+TEST (SpliceTest, SpliceRange) {
+	struct dt_list * dst = new_list();
+	struct dt_list * src = new_list();
+
+	for (size_t i = 0; i < 10; i++) {
+		EXPECT_EQ(0, dst->insert(dst, i, items + i));
+		EXPECT_EQ(0, src->insert(src, i, items + 10 + i));
+	}
+
+	// Move the middle of src to the end of dst.
+	EXPECT_EQ(0, dt_list_linked_splice(dst, 10, src, 0, 10));
+	expect_run(dst, 0, 20);
+	expect_run(src, 0, 0);
+
+	// And back again in two pieces.
+	EXPECT_EQ(0, dt_list_linked_splice(src, 0, dst, 15, 20));
+	EXPECT_EQ(0, dt_list_linked_splice(src, 0, dst, 10, 15));
+	expect_run(dst, 0, 10);
+	expect_run(src, 10, 10);
+
+	// Into the middle.
+	EXPECT_EQ(0, dt_list_linked_splice(src, 5, dst, 0, 0));
+	EXPECT_EQ(0, dt_list_linked_splice(dst, 10, src, 0, 10));
+	EXPECT_EQ(0, dt_list_linked_splice(src, 0, dst, 2, 18));
+	EXPECT_EQ(4, dst->length(dst));
+	EXPECT_EQ(items + 0, dst->get(dst, 0));
+	EXPECT_EQ(items + 1, dst->get(dst, 1));
+	EXPECT_EQ(items + 18, dst->get(dst, 2));
+	EXPECT_EQ(items + 19, dst->get(dst, 3));
+	expect_run(src, 2, 16);
+
+	EXPECT_EQ(0, dst->insert(dst, dst->length(dst), items + 20));
+	EXPECT_EQ(items + 20, dst->get(dst, 4));
+
+	dst->del(dst);
+	src->del(src);
+}
+
+TEST (SpliceTest, SpliceErrors) {
+	struct dt_list * dst = new_list();
+	struct dt_list * src = new_list();
+	struct dt_list_vector_storage storage;
+	struct dt_list * vector = dt_list_vector_init(&storage);
+
+	for (size_t i = 0; i < 4; i++) {
+		EXPECT_EQ(0, src->insert(src, i, items + i));
+	}
+
+	EXPECT_EQ(DT_LIST_EINDEX, dt_list_linked_splice(dst, 1, src, 0, 1));
+	EXPECT_EQ(DT_LIST_EINDEX, dt_list_linked_splice(dst, 0, src, 2, 1));
+	EXPECT_EQ(DT_LIST_EINDEX, dt_list_linked_splice(dst, 0, src, 0, 5));
+	EXPECT_EQ(DT_LIST_ETYPE, dt_list_linked_splice(src, 0, src, 0, 1));
+	EXPECT_EQ(DT_LIST_ETYPE, dt_list_linked_splice(vector, 0, src, 0, 1));
+	EXPECT_EQ(DT_LIST_ETYPE, dt_list_linked_concat(src, vector));
+	EXPECT_EQ(NULL, dt_list_linked_split_at(vector, 0));
+	EXPECT_EQ(NULL, dt_list_linked_split_at(src, 5));
+	expect_run(src, 0, 4);
+	expect_run(dst, 0, 0);
+
+	vector->del(vector);
+	dst->del(dst);
+	src->del(src);
+}
+
+TEST (SpliceTest, SpliceIterators) {
+	struct dt_list * dst = new_list();
+	struct dt_list * src = new_list();
+
+	for (size_t i = 0; i < 4; i++) {
+		EXPECT_EQ(0, dst->insert(dst, dst->length(dst), items + i));
+	}
+	for (size_t i = 4; i < 10; i++) {
+		EXPECT_EQ(0, src->insert(src, src->length(src), items + i));
+	}
+	EXPECT_EQ(0, dst->insert(dst, dst->length(dst), items + 10));
+
+	struct dt_list_iterator dst_storage;
+	struct dt_list_iterator begin_storage;
+	struct dt_list_iterator end_storage;
+	struct dt_list_iterator * at = dst->iterator_init(dst, &dst_storage);
+	struct dt_list_iterator * begin = src->iterator_init(src, &begin_storage);
+	struct dt_list_iterator * end = src->iterator_init(src, &end_storage);
+
+	for (size_t i = 0; i < 4; i++) at->next(at);
+	for (size_t i = 0; i < 6; i++) end->next(end);
+
+	EXPECT_EQ(DT_LIST_EINDEX, dt_list_linked_splice_iterators(at, end, begin));
+	EXPECT_EQ(DT_LIST_ETYPE, dt_list_linked_splice_iterators(begin, begin, end));
+	EXPECT_EQ(DT_LIST_ETYPE, dt_list_linked_splice_iterators(begin, at, end));
+
+	EXPECT_EQ(0, dt_list_linked_splice_iterators(at, begin, end));
+	expect_run(dst, 0, 11);
+	expect_run(src, 0, 0);
+
+	// The iterators stay usable afterwards.
+	EXPECT_EQ(items + 4, at->get(at));
+	EXPECT_EQ(4, at->position);
+	EXPECT_FALSE(begin->valid(begin));
+	EXPECT_FALSE(end->valid(end));
+	EXPECT_EQ(0, begin->insert(begin, items + 11));
+	EXPECT_EQ(items + 11, src->get(src, 0));
+
+	at->del(at);
+	begin->del(begin);
+	end->del(end);
+	dst->del(dst);
+	src->del(src);
+}
+
+TEST (SpliceTest, SpliceReadonlyIterators) {
+	struct dt_list * dst = new_list();
+	struct dt_list * src = new_list();
+
+	for (size_t i = 0; i < 4; i++) {
+		EXPECT_EQ(0, dst->insert(dst, dst->length(dst), items + i));
+		EXPECT_EQ(0, src->insert(src, src->length(src), items + 4 + i));
+	}
+
+	struct dt_list * read_dst = dt_list_readonly_new(dst);
+	struct dt_list * read_src = dt_list_readonly_new(src);
+
+	struct dt_list_iterator dst_storage;
+	struct dt_list_iterator begin_storage;
+	struct dt_list_iterator end_storage;
+	struct dt_list_iterator read_dst_storage;
+	struct dt_list_iterator read_begin_storage;
+	struct dt_list_iterator read_end_storage;
+	struct dt_list_iterator * at = dst->iterator_init(dst, &dst_storage);
+	struct dt_list_iterator * begin = src->iterator_init(src, &begin_storage);
+	struct dt_list_iterator * end = src->iterator_init(src, &end_storage);
+	struct dt_list_iterator * read_at =
+		read_dst->iterator_init(read_dst, &read_dst_storage);
+	struct dt_list_iterator * read_begin =
+		read_src->iterator_init(read_src, &read_begin_storage);
+	struct dt_list_iterator * read_end =
+		read_src->iterator_init(read_src, &read_end_storage);
+
+	for (size_t i = 0; i < 2; i++) {
+		end->next(end);
+		read_end->next(read_end);
+	}
+
+	EXPECT_EQ(DT_LIST_ETYPE,
+		dt_list_linked_splice_iterators(read_at, begin, end));
+	EXPECT_EQ(DT_LIST_ETYPE,
+		dt_list_linked_splice_iterators(at, read_begin, read_end));
+	EXPECT_EQ(DT_LIST_ETYPE,
+		dt_list_linked_splice_iterators(at, begin, read_end));
+	expect_run(dst, 0, 4);
+	expect_run(src, 4, 4);
+
+	read_at->del(read_at);
+	read_begin->del(read_begin);
+	read_end->del(read_end);
+	at->del(at);
+	begin->del(begin);
+	end->del(end);
+	read_dst->del(read_dst);
+	read_src->del(read_src);
+	dst->del(dst);
+	src->del(src);
+}
+
+TEST (SpliceTest, ConcatAndSplit) {
+	struct dt_list * list = new_list();
+
+	for (size_t i = 0; i < 100; i++) {
+		EXPECT_EQ(0, list->insert(list, i, items + i));
+	}
+
+	struct dt_list * rest = dt_list_linked_split_at(list, 40);
+	ASSERT_TRUE(rest);
+	expect_run(list, 0, 40);
+	expect_run(rest, 40, 60);
+
+	struct dt_list * empty = dt_list_linked_split_at(rest, 60);
+	ASSERT_TRUE(empty);
+	expect_run(empty, 0, 0);
+	expect_run(rest, 40, 60);
+
+	EXPECT_EQ(0, dt_list_linked_concat(list, empty));
+	EXPECT_EQ(0, dt_list_linked_concat(list, rest));
+	expect_run(list, 0, 100);
+	expect_run(rest, 0, 0);
+
+	EXPECT_EQ(0, dt_list_linked_concat(rest, list));
+	expect_run(rest, 0, 100);
+	expect_run(list, 0, 0);
+
+	empty->del(empty);
+	rest->del(rest);
+	list->del(list);
+}
@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+
+#include "lru.h"
+#include "lru/error.h"
+
+#include <list>
+#include <vector>
+
+struct entry {
+	int key;
+	int value;
+};
+
+static std::vector<int> evicted;
+
+int compare(void * a, void * b)
+{
+	int x = ((struct entry *)a)->key;
+	int y = ((struct entry *)b)->key;
+	return
+		x == y ? 0 :
+		x < y ? -1 : 1;
+}
+
+unsigned int hash(void * item)
+{
+	return ((struct entry *)item)->key;
+}
+
+unsigned int bad_hash(void * item)
+{
+	// Every key collides.
+	return 3;
+}
+
+void evict(void * item)
+{
+	evicted.push_back(((struct entry *)item)->key);
+}
+
+TEST (LruTest, BasicUsage) {
+	struct entry entries[4] = {{0, 10}, {1, 11}, {2, 12}, {3, 13}};
+	struct entry probe = {0, 0};
+	evicted.clear();
+
+	struct dt_lru * lru = dt_lru_new(3, &compare, &hash, &evict);
+	EXPECT_TRUE(lru) << "New failed!";
+
+	EXPECT_EQ(0, dt_lru_put(lru, entries + 0));
+	EXPECT_EQ(0, dt_lru_put(lru, entries + 1));
+	EXPECT_EQ(0, dt_lru_put(lru, entries + 2));
+	EXPECT_EQ(3, dt_lru_length(lru));
+
+	// Getting 0 makes 1 the least recently used.
+	EXPECT_EQ(entries + 0, dt_lru_get(lru, &probe));
+	EXPECT_EQ(0, dt_lru_put(lru, entries + 3));
+	EXPECT_EQ(std::vector<int>({1}), evicted);
+	EXPECT_EQ(3, dt_lru_length(lru));
+
+	probe.key = 1;
+	EXPECT_EQ(NULL, dt_lru_get(lru, &probe));
+	probe.key = 2;
+	EXPECT_EQ(entries + 2, dt_lru_get(lru, &probe));
+
+	dt_lru_del(lru);
+	EXPECT_EQ(std::vector<int>({1, 0, 3, 2}), evicted);
+}
+
+TEST (LruTest, ReplaceAndRemove) {
+	struct entry entries[3] = {{0, 10}, {1, 11}, {0, 20}};
+	struct entry probe = {0, 0};
+	evicted.clear();
+
+	struct dt_lru * lru = dt_lru_new(2, &compare, &hash, &evict);
+
+	EXPECT_EQ(0, dt_lru_put(lru, entries + 0));
+	EXPECT_EQ(0, dt_lru_put(lru, entries + 1));
+
+	// An equal item replaces the old one and is promoted.
+	EXPECT_EQ(0, dt_lru_put(lru, entries + 2));
+	EXPECT_EQ(std::vector<int>({0}), evicted);
+	EXPECT_EQ(2, dt_lru_length(lru));
+	EXPECT_EQ(entries + 2, dt_lru_get(lru, &probe));
+
+	// Putting the same item again evicts nothing.
+	EXPECT_EQ(0, dt_lru_put(lru, entries + 2));
+	EXPECT_EQ(1, evicted.size());
+
+	probe.key = 1;
+	EXPECT_EQ(entries + 1, dt_lru_remove(lru, &probe));
+	EXPECT_EQ(NULL, dt_lru_remove(lru, &probe));
+	EXPECT_EQ(1, dt_lru_length(lru));
+	EXPECT_EQ(1, evicted.size());
+
+	dt_lru_del(lru);
+	EXPECT_EQ(std::vector<int>({0, 0}), evicted);
+
+	EXPECT_EQ(NULL, dt_lru_new(0, &compare, &hash, &evict));
+}
+
+TEST (LruTest, MatchesModel) {
+	// Random gets and puts checked against a simple list
+	// model, with a hash that puts every key in one chain.
+	for (int pass = 0; pass < 2; pass++) {
+		std::vector<struct entry> entries(64);
+		std::list<int> model;
+		struct dt_lru * lru = dt_lru_new(10, &compare,
+			pass ? &bad_hash : &hash, NULL);
+		unsigned int state = 1;
+
+		for (int i = 0; i < 64; i++) entries[i] = {i, i};
+
+		for (int step = 0; step < 5000; step++) {
+			state = state * 1103515245u + 12345u;
+			int key = (state >> 8) % 64;
+			struct entry probe = {key, 0};
+			bool cached = false;
+			for (int k : model) cached = cached || k == key;
+
+			if (state >> 30 & 1) {
+				void * found = dt_lru_get(lru, &probe);
+				EXPECT_EQ(cached ? &entries[key] : NULL, found);
+				if (cached) {
+					model.remove(key);
+					model.push_front(key);
+				}
+			} else if (state >> 29 & 1) {
+				EXPECT_EQ(0, dt_lru_put(lru, &entries[key]));
+				model.remove(key);
+				model.push_front(key);
+				if (model.size() > 10) model.pop_back();
+			} else {
+				void * removed = dt_lru_remove(lru, &probe);
+				EXPECT_EQ(cached ? &entries[key] : NULL, removed);
+				model.remove(key);
+			}
+
+			ASSERT_EQ(model.size(), dt_lru_length(lru));
+		}
+
+		dt_lru_del(lru);
+	}
+}
@@ -0,0 +1,233 @@
+#include "gtest/gtest.h"
+
+#include "map.h"
+#include "map/error.h"
+#include "map/hash.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <map>
+
+int compare(void * a, void * b)
+{
+	int x = *(int *)a;
+	int y = *(int *)b;
+	return
+		x == y ? 0 :
+		x < y ? -1 : 1;
+}
+
+unsigned int hash(void * key)
+{
+	return *(int *)key;
+}
+
+unsigned int bad_hash(void * key)
+{
+	// Every key collides.
+	return 7;
+}
+
+int compare_bytes(void * a, void * b)
+{
+	int compare = memcmp(a, b, 3);
+	return compare < 0 ? -1 : compare > 0;
+}
+
+unsigned int hash_bytes(void * key)
+{
+	unsigned char * bytes = (unsigned char *) key;
+	return bytes[0] | bytes[1] << 8 | bytes[2] << 16;
+}
+
+static int sum_values(void * key, void * value, void * context)
+{
+	*(long *) context += *(int *) value;
+	return 0;
+}
+
+static int stop_at_key(void * key, void * value, void * context)
+{
+	return *(int *) key == *(int *) context ? 5 : 0;
+}
+
+TEST (MapTest, BasicUsage) {
+	struct dt_map * map = dt_map_new(sizeof(int), sizeof(int),
+		&compare, &hash);
+	EXPECT_TRUE(map) << "New failed!";
+
+	int key = 1;
+	int value = 10;
+	EXPECT_EQ(0, map->put(map, &key, &value));
+	EXPECT_EQ(1, map->length(map));
+
+	// The map keeps its own copies.
+	value = 20;
+	EXPECT_EQ(10, *(int *) map->get(map, &key));
+
+	EXPECT_EQ(0, map->put(map, &key, &value));
+	EXPECT_EQ(1, map->length(map));
+	EXPECT_EQ(20, *(int *) map->get(map, &key));
+
+	// Values can be changed in place.
+	*(int *) map->get(map, &key) = 30;
+	EXPECT_EQ(30, *(int *) map->get(map, &key));
+
+	key = 2;
+	EXPECT_EQ(NULL, map->get(map, &key));
+	map->remove(map, &key);
+	EXPECT_EQ(1, map->length(map));
+
+	key = 1;
+	map->remove(map, &key);
+	EXPECT_EQ(0, map->length(map));
+	EXPECT_EQ(NULL, map->get(map, &key));
+
+	map->del(map);
+}
+
+TEST (MapTest, ManyKeys) {
+	// Checked against std::map through growing and shrinking.
+	struct dt_map * map = dt_map_hash_new(sizeof(int), sizeof(int),
+		&compare, &hash);
+	std::map<int, int> expected;
+	unsigned int state = 1;
+
+	for (int round = 0; round < 3; round++) {
+		for (int i = 0; i < 5000; i++) {
+			state = state * 1103515245u + 12345u;
+			int key = (state >> 8) % 20000;
+			int value = i;
+			EXPECT_EQ(0, map->put(map, &key, &value));
+			expected[key] = value;
+		}
+		EXPECT_EQ(expected.size(), map->length(map));
+
+		for (int key = 0; key < 20000; key++) {
+			int * value = (int *) map->get(map, &key);
+			if (expected.count(key)) {
+				ASSERT_TRUE(value);
+				EXPECT_EQ(expected[key], *value);
+			} else {
+				EXPECT_EQ(NULL, value);
+			}
+		}
+
+		for (int key = round; key < 20000; key += 2) {
+			map->remove(map, &key);
+			expected.erase(key);
+		}
+		EXPECT_EQ(expected.size(), map->length(map));
+	}
+
+	for (int key = 0; key < 20000; key++) map->remove(map, &key);
+	EXPECT_EQ(0, map->length(map));
+
+	map->del(map);
+}
+
+TEST (MapTest, Collisions) {
+	struct dt_map * map = dt_map_hash_new(sizeof(int), sizeof(int),
+		&compare, &bad_hash);
+
+	for (int key = 0; key < 200; key++) {
+		int value = key * 3;
+		EXPECT_EQ(0, map->put(map, &key, &value));
+	}
+
+	// Removing from the middle of a long probe.
+	for (int key = 0; key < 200; key += 3) map->remove(map, &key);
+
+	for (int key = 0; key < 200; key++) {
+		int * value = (int *) map->get(map, &key);
+		if (key % 3 == 0) {
+			EXPECT_EQ(NULL, value);
+		} else {
+			ASSERT_TRUE(value);
+			EXPECT_EQ(key * 3, *value);
+		}
+	}
+
+	map->del(map);
+}
+
+TEST (MapTest, Iterate) {
+	struct dt_map * map = dt_map_new(sizeof(int), sizeof(int),
+		&compare, &hash);
+
+	for (int key = 1; key <= 100; key++) {
+		EXPECT_EQ(0, map->put(map, &key, &key));
+	}
+
+	long sum = 0;
+	EXPECT_EQ(0, map->iterate(map, &sum_values, &sum));
+	EXPECT_EQ(5050, sum);
+
+	int stop = 42;
+	EXPECT_EQ(5, map->iterate(map, &stop_at_key, &stop));
+	stop = 101;
+	EXPECT_EQ(0, map->iterate(map, &stop_at_key, &stop));
+
+	map->del(map);
+}
+
+TEST (MapTest, Sizes) {
+	// Odd sized keys and values that need alignment.
+	struct value {
+		double weight;
+		char name[5];
+	};
+
+	struct dt_map * map = dt_map_hash_new(3, sizeof(struct value),
+		&compare_bytes, &hash_bytes);
+	for (int i = 0; i < 1000; i++) {
+		unsigned char key[3] = {
+			(unsigned char) i, (unsigned char) (i >> 8), 'k'};
+		struct value value = {i / 2.0, "abcd"};
+		EXPECT_EQ(0, map->put(map, key, &value));
+	}
+	for (int i = 0; i < 1000; i++) {
+		unsigned char key[3] = {
+			(unsigned char) i, (unsigned char) (i >> 8), 'k'};
+		struct value * value = (struct value *) map->get(map, key);
+		ASSERT_TRUE(value);
+		EXPECT_EQ(0, (uintptr_t) value % alignof(struct value));
+		EXPECT_EQ(i / 2.0, value->weight);
+		EXPECT_STREQ("abcd", value->name);
+	}
+	map->del(map);
+
+	// No values at all, a set of keys.
+	map = dt_map_hash_new(sizeof(int), 0, &compare, &hash);
+	for (int key = 0; key < 100; key++) {
+		EXPECT_EQ(0, map->put(map, &key, NULL));
+	}
+	int key = 50;
+	EXPECT_TRUE(map->get(map, &key));
+	key = 100;
+	EXPECT_EQ(NULL, map->get(map, &key));
+	map->del(map);
+
+	EXPECT_EQ(NULL, dt_map_hash_new(0, 4, &compare, &hash));
+}
+
+TEST (MapTest, PutFromItself) {
+	// A value read out of the map survives the map growing.
+	struct dt_map * map = dt_map_hash_new(sizeof(int), sizeof(int),
+		&compare, &hash);
+
+	int key = 0;
+	int value = 1234;
+	EXPECT_EQ(0, map->put(map, &key, &value));
+
+	for (key = 1; key < 1000; key++) {
+		int previous = key - 1;
+		EXPECT_EQ(0, map->put(map, &key, map->get(map, &previous)));
+	}
+
+	key = 999;
+	EXPECT_EQ(1234, *(int *) map->get(map, &key));
+
+	map->del(map);
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+
+#include "pool.h"
+
+#include <string.h>
+
+TEST (PoolTest, AllocFree) {
+	struct dt_pool * pool = dt_pool_new(24, 4);
+	ASSERT_TRUE(pool);
+	EXPECT_LE(24, dt_pool_item_size(pool));
+	EXPECT_EQ(0, dt_pool_slab_count(pool));
+
+	char * a = (char *) dt_pool_alloc(pool);
+	char * b = (char *) dt_pool_alloc(pool);
+	ASSERT_TRUE(a);
+	ASSERT_TRUE(b);
+	EXPECT_NE(a, b);
+	EXPECT_EQ(1, dt_pool_slab_count(pool));
+	EXPECT_EQ(2, dt_pool_length(pool));
+
+	memset(a, 0xaa, 24);
+	memset(b, 0xbb, 24);
+
+	// The last item freed is the first handed back.
+	dt_pool_free(pool, a);
+	EXPECT_EQ(1, dt_pool_length(pool));
+	EXPECT_EQ(a, dt_pool_alloc(pool));
+	EXPECT_EQ(2, dt_pool_length(pool));
+
+	dt_pool_del(pool);
+}
+
+TEST (PoolTest, Slabs) {
+	struct dt_pool * pool = dt_pool_new(sizeof(void *), 8);
+	ASSERT_TRUE(pool);
+
+	void * all[100];
+	for (size_t i = 0; i < 100; i++) {
+		all[i] = dt_pool_alloc(pool);
+		ASSERT_TRUE(all[i]);
+		EXPECT_EQ(0, (size_t) all[i] % sizeof(void *));
+		// Write over the whole item to catch overlaps.
+		memcpy(all[i], &i, sizeof(i));
+	}
+	EXPECT_EQ(13, dt_pool_slab_count(pool));
+
+	for (size_t i = 0; i < 100; i++) {
+		size_t value;
+		memcpy(&value, all[i], sizeof(value));
+		EXPECT_EQ(i, value);
+	}
+
+	for (size_t i = 0; i < 100; i++) {
+		dt_pool_free(pool, all[i]);
+	}
+	EXPECT_EQ(0, dt_pool_length(pool));
+
+	for (size_t i = 0; i < 100; i++) {
+		EXPECT_TRUE(dt_pool_alloc(pool));
+	}
+	EXPECT_EQ(13, dt_pool_slab_count(pool));
+
+	dt_pool_del(pool);
+}
+
+TEST (PoolTest, SmallItems) {
+	// Items are made big enough to hold the free list.
+	struct dt_pool * pool = dt_pool_new(1, 0);
+	ASSERT_TRUE(pool);
+	EXPECT_LE(sizeof(void *), dt_pool_item_size(pool));
+
+	void * a = dt_pool_alloc(pool);
+	void * b = dt_pool_alloc(pool);
+	dt_pool_free(pool, a);
+	dt_pool_free(pool, b);
+	EXPECT_EQ(b, dt_pool_alloc(pool));
+	EXPECT_EQ(a, dt_pool_alloc(pool));
+
+	dt_pool_del(pool);
+}
@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+
+#include "pqueue.h"
+#include "pqueue/error.h"
+#include "pqueue/heap.h"
+
+#include <algorithm>
+#include <vector>
+
+static int keys[4096];
+
+int compare(void * a, void * b)
+{
+	int x = *(int *)a;
+	int y = *(int *)b;
+	return
+		x == y ? 0 :
+		x < y ? -1 : 1;
+}
+
+/** Pushes keys[0, count) then checks they pop in order.
+ */
+static void expect_sorted(struct dt_pqueue * pqueue, size_t count)
+{
+	std::vector<int> sorted(keys, keys + count);
+	std::sort(sorted.begin(), sorted.end());
+
+	for (size_t i = 0; i < count; i++) {
+		EXPECT_EQ(0, pqueue->push(pqueue, keys + i));
+	}
+	EXPECT_EQ(count, pqueue->length(pqueue));
+
+	for (size_t i = 0; i < count; i++) {
+		int * peeked = (int *) pqueue->peek(pqueue);
+		int * popped = (int *) pqueue->pop_min(pqueue);
+		ASSERT_TRUE(popped);
+		EXPECT_EQ(peeked, popped);
+		EXPECT_EQ(sorted[i], *popped);
+	}
+
+	EXPECT_EQ(0, pqueue->length(pqueue));
+	EXPECT_EQ(NULL, pqueue->peek(pqueue));
+	EXPECT_EQ(NULL, pqueue->pop_min(pqueue));
+}
+
+TEST (PqueueTest, BasicUsage) {
+	struct dt_pqueue * pqueue = dt_pqueue_new(&compare);
+	EXPECT_TRUE(pqueue) << "New failed!";
+
+	keys[0] = 3;
+	keys[1] = 1;
+	keys[2] = 2;
+
+	EXPECT_EQ(0, pqueue->push(pqueue, keys + 0));
+	EXPECT_EQ(keys + 0, pqueue->peek(pqueue));
+	EXPECT_EQ(0, pqueue->push(pqueue, keys + 1));
+	EXPECT_EQ(keys + 1, pqueue->peek(pqueue));
+	EXPECT_EQ(0, pqueue->push(pqueue, keys + 2));
+	EXPECT_EQ(keys + 1, pqueue->peek(pqueue));
+	EXPECT_EQ(3, pqueue->length(pqueue));
+
+	EXPECT_EQ(keys + 1, pqueue->pop_min(pqueue));
+	EXPECT_EQ(keys + 2, pqueue->pop_min(pqueue));
+	EXPECT_EQ(keys + 0, pqueue->pop_min(pqueue));
+	EXPECT_EQ(NULL, pqueue->pop_min(pqueue));
+
+	pqueue->del(pqueue);
+}
+
+TEST (PqueueTest, Duplicates) {
+	struct dt_pqueue * pqueue = dt_pqueue_new(&compare);
+
+	for (size_t i = 0; i < 100; i++) keys[i] = i % 3;
+	expect_sorted(pqueue, 100);
+
+	pqueue->del(pqueue);
+}
+
+TEST (PqueueTest, Arities) {
+	for (size_t arity = 2; arity <= 9; arity++) {
+		struct dt_pqueue * pqueue = dt_pqueue_heap_new(&compare, arity);
+		ASSERT_TRUE(pqueue);
+
+		// Ascending, descending then scrambled.
+		for (size_t i = 0; i < 4096; i++) keys[i] = i;
+		expect_sorted(pqueue, 4096);
+		for (size_t i = 0; i < 4096; i++) keys[i] = 4096 - i;
+		expect_sorted(pqueue, 4096);
+		for (size_t i = 0; i < 4096; i++) keys[i] = (i * 2654435761u) % 1000;
+		expect_sorted(pqueue, 4096);
+
+		pqueue->del(pqueue);
+	}
+}
+
+TEST (PqueueTest, Interleaved) {
+	struct dt_pqueue * pqueue = dt_pqueue_heap_new(&compare, 3);
+
+	// A queue that grows and shrinks while staying sorted.
+	for (size_t i = 0; i < 4096; i++) keys[i] = (i * 2654435761u) % 4096;
+
+	size_t pushed = 0;
+	while (pushed < 4096) {
+		for (size_t i = 0; i < 7 && pushed < 4096; i++, pushed++) {
+			EXPECT_EQ(0, pqueue->push(pqueue, keys + pushed));
+		}
+		int * popped = (int *) pqueue->pop_min(pqueue);
+		ASSERT_TRUE(popped);
+		EXPECT_LE(*popped, *(int *) pqueue->peek(pqueue));
+	}
+
+	int last = -1;
+	while (pqueue->length(pqueue)) {
+		int * popped = (int *) pqueue->pop_min(pqueue);
+		EXPECT_LE(last, *popped);
+		last = *popped;
+	}
+
+	pqueue->del(pqueue);
+}
+
+TEST (PqueueTest, BadArity) {
+	EXPECT_EQ(NULL, dt_pqueue_heap_new(&compare, 0));
+	EXPECT_EQ(NULL, dt_pqueue_heap_new(&compare, 1));
+}
@@ -0,0 +1,189 @@
+#include "gtest/gtest.h"
+
+#include "pqueue.h"
+#include "pqueue/error.h"
+#include "pqueue/pairing.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+static int keys[4096];
+
+int compare(void * a, void * b)
+{
+	int x = *(int *)a;
+	int y = *(int *)b;
+	return
+		x == y ? 0 :
+		x < y ? -1 : 1;
+}
+
+/** Pushes keys[0, count) then checks they pop in order.
+ */
+static void expect_sorted(struct dt_pqueue * pqueue, size_t count)
+{
+	std::vector<int> sorted(keys, keys + count);
+	std::sort(sorted.begin(), sorted.end());
+
+	for (size_t i = 0; i < count; i++) {
+		EXPECT_EQ(0, pqueue->push(pqueue, keys + i));
+	}
+	EXPECT_EQ(count, pqueue->length(pqueue));
+
+	for (size_t i = 0; i < count; i++) {
+		int * peeked = (int *) pqueue->peek(pqueue);
+		int * popped = (int *) pqueue->pop_min(pqueue);
+		ASSERT_TRUE(popped);
+		EXPECT_EQ(peeked, popped);
+		EXPECT_EQ(sorted[i], *popped);
+	}
+
+	EXPECT_EQ(0, pqueue->length(pqueue));
+	EXPECT_EQ(NULL, pqueue->peek(pqueue));
+	EXPECT_EQ(NULL, pqueue->pop_min(pqueue));
+}
+
+TEST (PqueueTest, BasicUsage) {
+	struct dt_pqueue * pqueue = dt_pqueue_pairing_new(&compare);
+	EXPECT_TRUE(pqueue) << "New failed!";
+
+	keys[0] = 3;
+	keys[1] = 1;
+	keys[2] = 2;
+
+	EXPECT_EQ(0, pqueue->push(pqueue, keys + 0));
+	EXPECT_EQ(keys + 0, pqueue->peek(pqueue));
+	EXPECT_EQ(0, pqueue->push(pqueue, keys + 1));
+	EXPECT_EQ(keys + 1, pqueue->peek(pqueue));
+	EXPECT_EQ(0, pqueue->push(pqueue, keys + 2));
+	EXPECT_EQ(keys + 1, pqueue->peek(pqueue));
+	EXPECT_EQ(3, pqueue->length(pqueue));
+
+	EXPECT_EQ(keys + 1, pqueue->pop_min(pqueue));
+	EXPECT_EQ(keys + 2, pqueue->pop_min(pqueue));
+	EXPECT_EQ(keys + 0, pqueue->pop_min(pqueue));
+	EXPECT_EQ(NULL, pqueue->pop_min(pqueue));
+
+	pqueue->del(pqueue);
+}
+
+TEST (PqueueTest, Sorts) {
+	struct dt_pqueue * pqueue = dt_pqueue_pairing_new(&compare);
+
+	for (size_t i = 0; i < 100; i++) keys[i] = i % 3;
+	expect_sorted(pqueue, 100);
+	for (size_t i = 0; i < 4096; i++) keys[i] = i;
+	expect_sorted(pqueue, 4096);
+	for (size_t i = 0; i < 4096; i++) keys[i] = 4096 - i;
+	expect_sorted(pqueue, 4096);
+	for (size_t i = 0; i < 4096; i++) keys[i] = (i * 2654435761u) % 1000;
+	expect_sorted(pqueue, 4096);
+
+	pqueue->del(pqueue);
+}
+
+TEST (HandleTest, DecreaseKey) {
+	struct dt_pqueue * pqueue = dt_pqueue_pairing_new(&compare);
+	struct dt_pqueue_handle * handles[16];
+
+	for (size_t i = 0; i < 16; i++) {
+		keys[i] = 100 + i;
+		handles[i] = dt_pqueue_pairing_push(pqueue, keys + i);
+		ASSERT_TRUE(handles[i]);
+		EXPECT_EQ(keys + i, dt_pqueue_pairing_item(handles[i]));
+	}
+
+	// Deep in the heap to the front.
+	keys[9] = 1;
+	dt_pqueue_pairing_decrease_key(pqueue, handles[9]);
+	EXPECT_EQ(keys + 9, pqueue->peek(pqueue));
+
+	// Lowered but not to the front.
+	keys[12] = 50;
+	dt_pqueue_pairing_decrease_key(pqueue, handles[12]);
+	keys[0] = 0;
+	dt_pqueue_pairing_decrease_key(pqueue, handles[0]);
+
+	EXPECT_EQ(keys + 0, pqueue->pop_min(pqueue));
+	EXPECT_EQ(keys + 9, pqueue->pop_min(pqueue));
+	EXPECT_EQ(keys + 12, pqueue->pop_min(pqueue));
+	EXPECT_EQ(keys + 1, pqueue->pop_min(pqueue));
+	EXPECT_EQ(12, pqueue->length(pqueue));
+
+	pqueue->del(pqueue);
+}
+
+TEST (HandleTest, Remove) {
+	struct dt_pqueue * pqueue = dt_pqueue_pairing_new(&compare);
+	struct dt_pqueue_handle * handles[16];
+
+	for (size_t i = 0; i < 16; i++) {
+		keys[i] = i;
+		handles[i] = dt_pqueue_pairing_push(pqueue, keys + i);
+	}
+	// Give the root some children.
+	EXPECT_EQ(keys + 0, pqueue->pop_min(pqueue));
+
+	dt_pqueue_pairing_remove(pqueue, handles[5]);
+	dt_pqueue_pairing_remove(pqueue, handles[1]);
+	dt_pqueue_pairing_remove(pqueue, handles[15]);
+	EXPECT_EQ(12, pqueue->length(pqueue));
+
+	for (size_t i = 2; i < 15; i++) {
+		if (i == 5) continue;
+		EXPECT_EQ(keys + i, pqueue->pop_min(pqueue));
+	}
+	EXPECT_EQ(NULL, pqueue->pop_min(pqueue));
+
+	pqueue->del(pqueue);
+}
+
+TEST (HandleTest, MatchesMultiset) {
+	// Random pushes, pops, decreases and removes checked
+	// against a std::multiset of the keys.
+	struct dt_pqueue * pqueue = dt_pqueue_pairing_new(&compare);
+	std::vector<struct dt_pqueue_handle *> handles(4096);
+	std::vector<size_t> queued;
+	std::multiset<int> expected;
+	unsigned int state = 1;
+	size_t pushed = 0;
+
+	for (size_t step = 0; step < 20000; step++) {
+		state = state * 1103515245u + 12345u;
+		unsigned int r = state >> 8;
+
+		if (r % 4 == 0 && pushed < 4096) {
+			keys[pushed] = r % 5000;
+			handles[pushed] = dt_pqueue_pairing_push(pqueue, keys + pushed);
+			expected.insert(keys[pushed]);
+			queued.push_back(pushed);
+			pushed++;
+		} else if (r % 4 == 1 && !queued.empty()) {
+			size_t at = r % queued.size();
+			size_t i = queued[at];
+			expected.erase(expected.find(keys[i]));
+			keys[i] -= r % 100;
+			expected.insert(keys[i]);
+			dt_pqueue_pairing_decrease_key(pqueue, handles[i]);
+		} else if (r % 4 == 2 && !queued.empty()) {
+			size_t at = r % queued.size();
+			size_t i = queued[at];
+			expected.erase(expected.find(keys[i]));
+			dt_pqueue_pairing_remove(pqueue, handles[i]);
+			queued[at] = queued.back();
+			queued.pop_back();
+		} else if (!queued.empty()) {
+			int * popped = (int *) pqueue->pop_min(pqueue);
+			ASSERT_TRUE(popped);
+			EXPECT_EQ(*expected.begin(), *popped);
+			expected.erase(expected.begin());
+			queued.erase(std::find(queued.begin(), queued.end(),
+				(size_t) (popped - keys)));
+		}
+
+		ASSERT_EQ(expected.size(), pqueue->length(pqueue));
+	}
+
+	pqueue->del(pqueue);
+}
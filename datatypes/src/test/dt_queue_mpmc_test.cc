@@ -0,0 +1,145 @@
+#include "gtest/gtest.h"
+
+#include "queue.h"
+#include "queue/error.h"
+#include "queue/mpmc.h"
+
+#include <stdint.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static char items[] = "";
+static struct dt_queue * new_queue(size_t capacity) {
+	return dt_queue_mpmc_new(capacity);
+}
+
+TEST (QueueTest, BasicQueueUsage) {
+	struct dt_queue * queue = new_queue(4);
+	EXPECT_TRUE(queue) << "New failed!";
+
+	EXPECT_EQ(0, queue->push(queue, items + 0));
+	EXPECT_EQ(0, queue->push(queue, items + 1));
+	EXPECT_EQ(2, queue->length(queue));
+
+	EXPECT_EQ(items + 0, queue->pop(queue));
+	EXPECT_EQ(items + 1, queue->pop(queue));
+	EXPECT_EQ(NULL, queue->pop(queue));
+	EXPECT_EQ(0, queue->length(queue));
+
+	queue->del(queue);
+}
+
+TEST (QueueTest, FullAndWrapping) {
+	// Rounded up to 8.
+	struct dt_queue * queue = new_queue(5);
+
+	for (size_t lap = 0; lap < 10; lap++) {
+		for (size_t i = 0; i < 8; i++) {
+			EXPECT_EQ(0, queue->push(queue, items + i));
+		}
+		EXPECT_EQ(DT_QUEUE_EFULL, queue->push(queue, items + 8));
+		EXPECT_EQ(8, queue->length(queue));
+
+		// Part way, so the next lap starts elsewhere.
+		for (size_t i = 0; i < 5; i++) {
+			EXPECT_EQ(items + i, queue->pop(queue));
+		}
+		for (size_t i = 5; i < 8; i++) {
+			EXPECT_EQ(items + i, queue->pop(queue));
+		}
+		EXPECT_EQ(NULL, queue->pop(queue));
+
+		EXPECT_EQ(0, queue->push(queue, items + 9));
+		EXPECT_EQ(items + 9, queue->pop(queue));
+	}
+
+	queue->del(queue);
+
+	EXPECT_EQ(NULL, new_queue(0));
+}
+
+TEST (StressTest, ProducerConsumer) {
+	// Everything arrives, once and in order.
+	struct dt_queue * queue = new_queue(64);
+	const uintptr_t count = 200000;
+
+	std::thread producer([&]() {
+		for (uintptr_t i = 1; i <= count; i++) {
+			while (queue->push(queue, (void *) i)) std::this_thread::yield();
+		}
+	});
+
+	uintptr_t expected = 1;
+	while (expected <= count) {
+		void * item = queue->pop(queue);
+		if (!item) {
+			std::this_thread::yield();
+			continue;
+		}
+		ASSERT_EQ(expected, (uintptr_t) item);
+		expected++;
+	}
+
+	producer.join();
+	EXPECT_EQ(NULL, queue->pop(queue));
+	queue->del(queue);
+}
+
+TEST (StressTest, ManyProducersManyConsumers) {
+	// Every item arrives exactly once and each producer's
+	// items arrive in the order it pushed them.
+	struct dt_queue * queue = new_queue(32);
+	const size_t producers = 4;
+	const size_t consumers = 4;
+	const uintptr_t count = 50000;
+
+	std::vector<std::thread> threads;
+	std::vector<std::vector<uintptr_t>> received(consumers);
+
+	for (size_t p = 0; p < producers; p++) {
+		threads.emplace_back([&, p]() {
+			for (uintptr_t i = 0; i < count; i++) {
+				void * item = (void *) ((i << 3 | p) + 1);
+				while (queue->push(queue, item)) std::this_thread::yield();
+			}
+		});
+	}
+
+	std::atomic<size_t> popped(0);
+	for (size_t c = 0; c < consumers; c++) {
+		threads.emplace_back([&, c]() {
+			while (popped.load() < producers * count) {
+				void * item = queue->pop(queue);
+				if (!item) {
+					std::this_thread::yield();
+					continue;
+				}
+				received[c].push_back((uintptr_t) item - 1);
+				popped++;
+			}
+		});
+	}
+
+	for (auto & thread : threads) thread.join();
+
+	std::vector<size_t> seen(producers);
+	for (size_t c = 0; c < consumers; c++) {
+		std::vector<uintptr_t> last(producers, 0);
+		std::vector<bool> any(producers, false);
+		for (uintptr_t item : received[c]) {
+			size_t p = item & 7;
+			uintptr_t i = item >> 3;
+			ASSERT_LT(p, producers);
+			if (any[p]) EXPECT_LT(last[p], i);
+			last[p] = i;
+			any[p] = true;
+			seen[p]++;
+		}
+	}
+	for (size_t p = 0; p < producers; p++) EXPECT_EQ(count, seen[p]);
+
+	EXPECT_EQ(NULL, queue->pop(queue));
+	queue->del(queue);
+}
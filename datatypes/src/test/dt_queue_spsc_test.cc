@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+
+#include "queue.h"
+#include "queue/error.h"
+#include "queue/spsc.h"
+
+#include <stdint.h>
+
+#include <thread>
+
+static char items[] = "";
+static struct dt_queue * new_queue(size_t capacity) {
+	return dt_queue_spsc_new(capacity);
+}
+
+TEST (QueueTest, BasicQueueUsage) {
+	struct dt_queue * queue = new_queue(4);
+	EXPECT_TRUE(queue) << "New failed!";
+
+	EXPECT_EQ(0, queue->push(queue, items + 0));
+	EXPECT_EQ(0, queue->push(queue, items + 1));
+	EXPECT_EQ(2, queue->length(queue));
+
+	EXPECT_EQ(items + 0, queue->pop(queue));
+	EXPECT_EQ(items + 1, queue->pop(queue));
+	EXPECT_EQ(NULL, queue->pop(queue));
+	EXPECT_EQ(0, queue->length(queue));
+
+	queue->del(queue);
+}
+
+TEST (QueueTest, FullAndWrapping) {
+	// Rounded up to 8.
+	struct dt_queue * queue = new_queue(5);
+
+	for (size_t lap = 0; lap < 10; lap++) {
+		for (size_t i = 0; i < 8; i++) {
+			EXPECT_EQ(0, queue->push(queue, items + i));
+		}
+		EXPECT_EQ(DT_QUEUE_EFULL, queue->push(queue, items + 8));
+		EXPECT_EQ(8, queue->length(queue));
+
+		// Part way, so the next lap starts elsewhere.
+		for (size_t i = 0; i < 5; i++) {
+			EXPECT_EQ(items + i, queue->pop(queue));
+		}
+		for (size_t i = 5; i < 8; i++) {
+			EXPECT_EQ(items + i, queue->pop(queue));
+		}
+		EXPECT_EQ(NULL, queue->pop(queue));
+
+		EXPECT_EQ(0, queue->push(queue, items + 9));
+		EXPECT_EQ(items + 9, queue->pop(queue));
+	}
+
+	queue->del(queue);
+
+	EXPECT_EQ(NULL, new_queue(0));
+}
+
+TEST (StressTest, ProducerConsumer) {
+	// Everything arrives, once and in order.
+	struct dt_queue * queue = new_queue(64);
+	const uintptr_t count = 200000;
+
+	std::thread producer([&]() {
+		for (uintptr_t i = 1; i <= count; i++) {
+			while (queue->push(queue, (void *) i)) std::this_thread::yield();
+		}
+	});
+
+	uintptr_t expected = 1;
+	while (expected <= count) {
+		void * item = queue->pop(queue);
+		if (!item) {
+			std::this_thread::yield();
+			continue;
+		}
+		ASSERT_EQ(expected, (uintptr_t) item);
+		expected++;
+	}
+
+	producer.join();
+	EXPECT_EQ(NULL, queue->pop(queue));
+	queue->del(queue);
+}
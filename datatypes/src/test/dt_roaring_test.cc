@@ -0,0 +1,272 @@
+#include "gtest/gtest.h"
+
+#include "roaring.h"
+#include "roaring/error.h"
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <vector>
+
+#include <stdint.h>
+
+std::vector<uint32_t> values(struct dt_roaring * roaring)
+{
+	std::vector<uint32_t> found;
+	struct dt_roaring_cursor * cursor = dt_roaring_cursor_new(roaring);
+	EXPECT_TRUE(cursor) << "Cursor failed!";
+
+	uint32_t value;
+	while (dt_roaring_cursor_next(cursor, &value)) {
+		found.push_back(value);
+	}
+
+	dt_roaring_cursor_del(cursor);
+	return found;
+}
+
+// Sparse, dense and long stretches of values over a few
+// containers, so each kind of container turns up. The kind
+// for each key turns with the seed.
+struct dt_roaring * make(unsigned long seed, std::set<uint32_t> & model)
+{
+	struct dt_roaring * roaring = dt_roaring_new();
+	unsigned long state = seed;
+
+	for (uint32_t key = 0; key < 6; key++) {
+		uint32_t high = key << 16;
+		uint32_t kind = (key + seed) % 3;
+		size_t count = kind == 0 ? 100 : kind == 1 ? 20000 : 0;
+
+		for (size_t i = 0; i < count; i++) {
+			state = state * 6364136223846793005ul + 1442695040888963407ul;
+			uint32_t value = high | (state >> 33) % 65536;
+			EXPECT_EQ(0, dt_roaring_add(roaring, value));
+			model.insert(value);
+		}
+
+		if (kind == 2) {
+			for (uint32_t run = 0; run < 8; run++) {
+				state = state * 6364136223846793005ul + 1442695040888963407ul;
+				uint32_t start = (state >> 33) % 60000;
+				for (uint32_t value = start; value < start + 3000; value++) {
+					EXPECT_EQ(0, dt_roaring_add(roaring, high | value));
+					model.insert(high | value);
+				}
+			}
+		}
+	}
+
+	dt_roaring_optimize(roaring);
+	return roaring;
+}
+
+TEST (RoaringTest, BasicUsage) {
+	struct dt_roaring * roaring = dt_roaring_new();
+	EXPECT_TRUE(roaring) << "New failed!";
+
+	EXPECT_FALSE(dt_roaring_has(roaring, 7));
+	EXPECT_EQ(0, dt_roaring_add(roaring, 7));
+	EXPECT_EQ(0, dt_roaring_add(roaring, 7));
+	EXPECT_EQ(0, dt_roaring_add(roaring, UINT32_MAX));
+	EXPECT_EQ(0, dt_roaring_add(roaring, 0));
+	EXPECT_TRUE(dt_roaring_has(roaring, 7));
+	EXPECT_TRUE(dt_roaring_has(roaring, UINT32_MAX));
+	EXPECT_TRUE(dt_roaring_has(roaring, 0));
+	EXPECT_FALSE(dt_roaring_has(roaring, 8));
+	EXPECT_EQ(3u, dt_roaring_cardinality(roaring));
+
+	EXPECT_EQ(std::vector<uint32_t>({0, 7, UINT32_MAX}), values(roaring));
+
+	EXPECT_EQ(0, dt_roaring_remove(roaring, 7));
+	EXPECT_EQ(0, dt_roaring_remove(roaring, 8));
+	EXPECT_FALSE(dt_roaring_has(roaring, 7));
+	EXPECT_EQ(2u, dt_roaring_cardinality(roaring));
+
+	dt_roaring_del(roaring);
+}
+
+TEST (RoaringTest, GrowsIntoBitmap) {
+	// Every other value of one container, past the point
+	// an array is bigger than a bitmap and back.
+	struct dt_roaring * roaring = dt_roaring_new();
+
+	for (uint32_t i = 0; i < 20000; i += 2) {
+		EXPECT_EQ(0, dt_roaring_add(roaring, 0x50000 + i));
+	}
+	EXPECT_EQ(10000u, dt_roaring_cardinality(roaring));
+	EXPECT_LE(dt_roaring_size(roaring), 8192u + 1024u);
+
+	for (uint32_t i = 0; i < 20000; i++) {
+		EXPECT_EQ(i % 2 == 0, dt_roaring_has(roaring, 0x50000 + i)) << i;
+	}
+
+	for (uint32_t i = 0; i < 19000; i += 2) {
+		EXPECT_EQ(0, dt_roaring_remove(roaring, 0x50000 + i));
+	}
+	EXPECT_EQ(500u, dt_roaring_cardinality(roaring));
+	EXPECT_LE(dt_roaring_size(roaring), 2048u + 256u);
+
+	std::vector<uint32_t> expected;
+	for (uint32_t i = 19000; i < 20000; i += 2) expected.push_back(0x50000 + i);
+	EXPECT_EQ(expected, values(roaring));
+
+	dt_roaring_del(roaring);
+}
+
+TEST (RoaringTest, Runs) {
+	struct dt_roaring * roaring = dt_roaring_new();
+
+	for (uint32_t i = 1000; i < 200000; i++) {
+		EXPECT_EQ(0, dt_roaring_add(roaring, i));
+	}
+	size_t before = dt_roaring_size(roaring);
+	dt_roaring_optimize(roaring);
+	EXPECT_LT(dt_roaring_size(roaring), 512u);
+	EXPECT_LT(dt_roaring_size(roaring), before);
+	EXPECT_EQ(199000u, dt_roaring_cardinality(roaring));
+
+	// Splitting, shortening and joining runs.
+	EXPECT_EQ(0, dt_roaring_remove(roaring, 5000));
+	EXPECT_EQ(0, dt_roaring_remove(roaring, 1000));
+	EXPECT_EQ(0, dt_roaring_remove(roaring, 199999));
+	EXPECT_FALSE(dt_roaring_has(roaring, 5000));
+	EXPECT_FALSE(dt_roaring_has(roaring, 1000));
+	EXPECT_TRUE(dt_roaring_has(roaring, 4999));
+	EXPECT_TRUE(dt_roaring_has(roaring, 5001));
+	EXPECT_TRUE(dt_roaring_has(roaring, 1001));
+	EXPECT_EQ(198997u, dt_roaring_cardinality(roaring));
+
+	EXPECT_EQ(0, dt_roaring_add(roaring, 5000));
+	EXPECT_EQ(0, dt_roaring_add(roaring, 999));
+	EXPECT_TRUE(dt_roaring_has(roaring, 5000));
+	EXPECT_FALSE(dt_roaring_has(roaring, 1000));
+	EXPECT_TRUE(dt_roaring_has(roaring, 999));
+
+	std::vector<uint32_t> found = values(roaring);
+	EXPECT_EQ(198999u, found.size());
+	EXPECT_EQ(999u, found[0]);
+	EXPECT_EQ(1001u, found[1]);
+	EXPECT_EQ(199998u, found.back());
+
+	// Scattered values make runs the worst choice, they
+	// turn back into an array.
+	for (uint32_t i = 0x70000; i < 0x70000 + 600; i++) {
+		EXPECT_EQ(0, dt_roaring_add(roaring, i));
+	}
+	dt_roaring_optimize(roaring);
+	for (uint32_t i = 0x70000 + 1; i < 0x70000 + 600; i += 2) {
+		EXPECT_EQ(0, dt_roaring_remove(roaring, i));
+	}
+	for (uint32_t i = 0x70000; i < 0x70000 + 600; i += 2) {
+		EXPECT_EQ(0, dt_roaring_add(roaring, i + 1000));
+		EXPECT_TRUE(dt_roaring_has(roaring, i));
+	}
+
+	dt_roaring_del(roaring);
+}
+
+TEST (RoaringTest, AgreesWithSet) {
+	std::set<uint32_t> model;
+	struct dt_roaring * roaring = make(3, model);
+	unsigned long state = 11;
+
+	for (size_t i = 0; i < 100000; i++) {
+		state = state * 6364136223846793005ul + 1442695040888963407ul;
+		uint32_t value = (state >> 33) % (6 << 16);
+
+		if ((state >> 20) % 2) {
+			EXPECT_EQ(0, dt_roaring_add(roaring, value));
+			model.insert(value);
+		} else {
+			EXPECT_EQ(0, dt_roaring_remove(roaring, value));
+			model.erase(value);
+		}
+	}
+
+	EXPECT_EQ(model.size(), dt_roaring_cardinality(roaring));
+	for (uint32_t value = 0; value < (7 << 16); value++) {
+		ASSERT_EQ(model.count(value) == 1, dt_roaring_has(roaring, value))
+			<< value;
+	}
+	EXPECT_EQ(std::vector<uint32_t>(model.begin(), model.end()),
+		values(roaring));
+
+	dt_roaring_del(roaring);
+}
+
+TEST (RoaringTest, UnionAndIntersection) {
+	// a and b meet each kind of container with another
+	// kind, a and c with the same kind.
+	std::set<uint32_t> a_model;
+	std::set<uint32_t> b_model;
+	std::set<uint32_t> c_model;
+	std::set<uint32_t> none;
+	struct dt_roaring * a = make(1, a_model);
+	struct dt_roaring * b = make(2, b_model);
+	struct dt_roaring * c = make(4, c_model);
+	struct dt_roaring * empty = dt_roaring_new();
+
+	struct dt_roaring * mixed = dt_roaring_union(b, c);
+	ASSERT_TRUE(mixed);
+	dt_roaring_optimize(mixed);
+	std::set<uint32_t> mixed_model = b_model;
+	mixed_model.insert(c_model.begin(), c_model.end());
+
+	struct dt_roaring * pairs[][2] = {{a, b}, {b, a}, {a, c}, {c, b},
+		{mixed, a}, {b, mixed}, {a, empty}, {empty, c}};
+	std::set<uint32_t> * models[][2] = {{&a_model, &b_model},
+		{&b_model, &a_model}, {&a_model, &c_model}, {&c_model, &b_model},
+		{&mixed_model, &a_model}, {&b_model, &mixed_model},
+		{&a_model, &none}, {&none, &c_model}};
+
+	for (size_t i = 0; i < sizeof(pairs) / sizeof(*pairs); i++) {
+		std::vector<uint32_t> both;
+		std::set_intersection(models[i][0]->begin(), models[i][0]->end(),
+			models[i][1]->begin(), models[i][1]->end(),
+			std::back_inserter(both));
+		std::vector<uint32_t> either;
+		std::set_union(models[i][0]->begin(), models[i][0]->end(),
+			models[i][1]->begin(), models[i][1]->end(),
+			std::back_inserter(either));
+
+		struct dt_roaring * intersection =
+			dt_roaring_intersection(pairs[i][0], pairs[i][1]);
+		ASSERT_TRUE(intersection);
+		EXPECT_EQ(both, values(intersection)) << i;
+		EXPECT_EQ(both.size(), dt_roaring_cardinality(intersection));
+		EXPECT_EQ(both.size(),
+			dt_roaring_intersection_cardinality(pairs[i][0], pairs[i][1]));
+
+		struct dt_roaring * either_roaring =
+			dt_roaring_union(pairs[i][0], pairs[i][1]);
+		ASSERT_TRUE(either_roaring);
+		EXPECT_EQ(either, values(either_roaring)) << i;
+		EXPECT_EQ(either.size(), dt_roaring_cardinality(either_roaring));
+
+		dt_roaring_del(intersection);
+		dt_roaring_del(either_roaring);
+	}
+
+	dt_roaring_del(a);
+	dt_roaring_del(b);
+	dt_roaring_del(c);
+	dt_roaring_del(empty);
+	dt_roaring_del(mixed);
+}
+
+TEST (RoaringTest, DenseIdsAreSmall) {
+	// Half of the first two million ids.
+	struct dt_roaring * roaring = dt_roaring_new();
+	unsigned long state = 5;
+
+	for (uint32_t i = 0; i < 2000000; i++) {
+		state = state * 6364136223846793005ul + 1442695040888963407ul;
+		if ((state >> 40) % 2) EXPECT_EQ(0, dt_roaring_add(roaring, i));
+	}
+
+	// About a bit per id, in whole containers.
+	EXPECT_LT(dt_roaring_size(roaring), (2000000u / 65536 + 1) * 8192 + 4096u);
+
+	dt_roaring_del(roaring);
+}
@@ -217,3 +217,19 @@ TEST (SetListTest, ShrunkSet) {
 	set->del(set);
 }
 
+
+TEST (SetTest, Grow) {
+	struct dt_set * set = new_set();
+
+	// Enough inserts to outgrow the first bucket array.
+	for (int round = 0; round < 2; round++) {
+		for (int i = 0; i < 256; i++) {
+			EXPECT_EQ(0, set->insert(set, items + i));
+		}
+	}
+	for (int i = 0; i < 256; i++) {
+		EXPECT_EQ(items + i, set->has(set, items + i));
+	}
+
+	set->del(set);
+}
@@ -216,3 +216,49 @@ TEST (SetListTest, ShrunkSet) {
 	set->del(set);
 }
 
+
+TEST (SetInitTest, InCallerStorage) {
+	struct dt_set_list_storage storage;
+	struct dt_set * set = dt_set_list_init(&storage, &compare, &hash);
+
+	for (int i = 0; i < 64; i++) {
+		EXPECT_EQ(0, set->insert(set, items + i));
+	}
+	for (int i = 0; i < 64; i += 2) {
+		set->remove(set, items + i);
+	}
+	for (int i = 0; i < 64; i++) {
+		EXPECT_EQ(i % 2 == 1, set->has(set, items + i) != NULL);
+	}
+
+	set->del(set);
+}
+
+TEST (SetListTest, IterateInit) {
+	struct dt_set * set = new_set();
+
+	for (int i = 'a'; i <= 'z'; i++) {
+		EXPECT_EQ(0, set->insert(set, items + i));
+	}
+
+	struct dt_list * list = set->items(set);
+	struct dt_list_iterator storage;
+	struct dt_list_iterator * iterator = list->iterator_init(list, &storage);
+
+	// The items are read only.
+	EXPECT_EQ(NULL, iterator->insert);
+	EXPECT_EQ(NULL, iterator->remove);
+	EXPECT_EQ(list, iterator->list);
+
+	for (int i = 'a'; i <= 'z'; i++) {
+		EXPECT_TRUE(iterator->valid(iterator));
+		EXPECT_EQ(items + i, iterator->get(iterator));
+		EXPECT_EQ((size_t) (i - 'a'), iterator->position);
+		iterator->next(iterator);
+	}
+	EXPECT_FALSE(iterator->valid(iterator));
+	iterator->del(iterator);
+
+	list->del(list);
+	set->del(set);
+}
@@ -0,0 +1,264 @@
+#include "gtest/gtest.h"
+
+#include "set.h"
+#include "set/error.h"
+#include "set/radix.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <string.h>
+
+struct dt_set * new_set()
+{
+	return dt_set_radix_new();
+}
+
+std::vector<std::string> list_items(struct dt_list * list)
+{
+	std::vector<std::string> items;
+	struct dt_list_iterator * iterator;
+	iterator = list->iterator(list);
+
+	for (; iterator->valid(iterator); iterator->next(iterator)) {
+		items.push_back((char *) iterator->get(iterator));
+	}
+
+	iterator->del(iterator);
+	return items;
+}
+
+std::vector<std::string> prefixed(struct dt_set * set, const char * prefix)
+{
+	std::vector<std::string> items;
+	struct dt_set_radix_cursor * cursor;
+	cursor = dt_set_radix_prefix_cursor(set, prefix);
+	EXPECT_TRUE(cursor) << "Cursor failed!";
+
+	void * item;
+	while ((item = dt_set_radix_cursor_next(cursor))) {
+		items.push_back((char *) item);
+	}
+
+	dt_set_radix_cursor_del(cursor);
+	return items;
+}
+
+TEST (SetTest, BasicSetUsage) {
+	struct dt_set * set = new_set();
+	EXPECT_TRUE(set) << "New failed!";
+
+	char item[] = "a";
+	char copy[] = "a";
+
+	EXPECT_FALSE(set->has(set, item));
+	EXPECT_EQ(0, set->insert(set, item));
+	EXPECT_EQ(item, set->has(set, copy));
+	EXPECT_EQ(0, set->insert(set, copy));
+	EXPECT_EQ(item, set->has(set, copy));
+	set->remove(set, copy);
+	EXPECT_FALSE(set->has(set, item));
+
+	set->del(set);
+}
+
+TEST (SetTest, EmptyString) {
+	struct dt_set * set = new_set();
+
+	char empty[] = "";
+	char a[] = "a";
+
+	EXPECT_EQ(0, set->insert(set, a));
+	EXPECT_FALSE(set->has(set, empty));
+	EXPECT_EQ(0, set->insert(set, empty));
+	EXPECT_EQ(empty, set->has(set, empty));
+	EXPECT_EQ(a, set->has(set, a));
+
+	set->remove(set, a);
+	EXPECT_EQ(empty, set->has(set, empty));
+	EXPECT_FALSE(set->has(set, a));
+
+	set->del(set);
+}
+
+TEST (SetTest, PrefixKeys) {
+	// Keys that are prefixes of each other and share
+	// long runs of bytes.
+	struct dt_set * set = new_set();
+
+	char keys[][40] = {
+		"/usr",
+		"/usr/local",
+		"/usr/local/share/doc",
+		"/usr/local/share/man",
+		"/usr/local/shared",
+		"/usr/lib",
+		"/u",
+		""
+	};
+	size_t count = sizeof(keys) / sizeof(*keys);
+
+	for (size_t i = 0; i < count; i++) {
+		EXPECT_EQ(0, set->insert(set, keys[i]));
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		EXPECT_EQ(keys[i], set->has(set, keys[i]));
+	}
+
+	char missing[][40] = {
+		"/us", "/usr/", "/usr/local/share", "/usr/local/share/do",
+		"/usr/local/share/docs", "/v"
+	};
+	for (size_t i = 0; i < sizeof(missing) / sizeof(*missing); i++) {
+		EXPECT_FALSE(set->has(set, missing[i])) << missing[i];
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		set->remove(set, keys[i]);
+		EXPECT_FALSE(set->has(set, keys[i]));
+		for (size_t j = i + 1; j < count; j++) {
+			EXPECT_EQ(keys[j], set->has(set, keys[j]));
+		}
+	}
+
+	set->del(set);
+}
+
+TEST (SetTest, EveryByte) {
+	// Fills one node with every byte to grow it through
+	// each size, then empties it to shrink it back.
+	struct dt_set * set = new_set();
+
+	char keys[256][4];
+	for (size_t i = 1; i < 256; i++) {
+		keys[i][0] = 'x';
+		keys[i][1] = i;
+		keys[i][2] = 'y';
+		keys[i][3] = '\0';
+	}
+
+	for (size_t i = 255; i > 0; i--) {
+		EXPECT_EQ(0, set->insert(set, keys[i]));
+		for (size_t j = 255; j >= i; j--) {
+			EXPECT_EQ(keys[j], set->has(set, keys[j]));
+		}
+	}
+
+	for (size_t i = 1; i < 256; i++) {
+		set->remove(set, keys[i]);
+		EXPECT_FALSE(set->has(set, keys[i]));
+		for (size_t j = i + 1; j < 256; j++) {
+			EXPECT_EQ(keys[j], set->has(set, keys[j]));
+		}
+	}
+
+	set->del(set);
+}
+
+TEST (SetTest, AgreesWithSet) {
+	// Random keys over a few letters, so paths are long
+	// and share prefixes of every length. Half start with
+	// a stem longer than a node keeps.
+	struct dt_set * set = new_set();
+	std::set<std::string> model;
+
+	const size_t count = 4000;
+	std::vector<std::string> strings(count);
+	unsigned long state = 1;
+	for (size_t i = 0; i < count; i++) {
+		state = state * 6364136223846793005ul + 1442695040888963407ul;
+		size_t length = (state >> 33) % 24;
+		if (i % 2) strings[i] = "/a/long/shared/stem/";
+		for (size_t j = 0; j < length; j++) {
+			state = state * 6364136223846793005ul + 1442695040888963407ul;
+			strings[i].push_back("abc/"[(state >> 33) % 4]);
+		}
+	}
+
+	for (size_t round = 0; round < 3; round++) {
+		for (size_t i = 0; i < count; i++) {
+			state = state * 6364136223846793005ul + 1442695040888963407ul;
+			std::string & key = strings[(state >> 33) % count];
+			char * item = (char *) key.c_str();
+
+			if ((state >> 20) % 3) {
+				EXPECT_EQ(0, set->insert(set, item));
+				model.insert(key);
+			} else {
+				set->remove(set, item);
+				model.erase(key);
+			}
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			bool found = set->has(set, (char *) strings[i].c_str());
+			EXPECT_EQ(model.count(strings[i]) == 1, found) << strings[i];
+		}
+
+		struct dt_list * list = set->items(set);
+		ASSERT_TRUE(list);
+		std::vector<std::string> expected(model.begin(), model.end());
+		EXPECT_EQ(expected, list_items(list));
+		list->del(list);
+	}
+
+	const char * prefixes[] = {"", "a", "ab", "c/c", "/a/b", "abcabc", "d",
+		"/a/long/sh", "/a/long/shared/stem/", "/a/long/shared/stem/ab/"};
+	for (size_t i = 0; i < sizeof(prefixes) / sizeof(*prefixes); i++) {
+		std::string prefix = prefixes[i];
+		std::vector<std::string> expected;
+		for (auto iter = model.lower_bound(prefix);
+			iter != model.end() && iter->compare(0, prefix.size(), prefix) == 0;
+			iter++) {
+			expected.push_back(*iter);
+		}
+		EXPECT_EQ(expected, prefixed(set, prefixes[i])) << prefix;
+	}
+
+	set->del(set);
+}
+
+TEST (SetCursorTest, Prefixes) {
+	struct dt_set * set = new_set();
+
+	char keys[][64] = {
+		"https://example.com/",
+		"https://example.com/about",
+		"https://example.com/blog/2024/01/hello",
+		"https://example.com/blog/2024/02/again",
+		"https://example.org/",
+		"http://example.com/"
+	};
+	size_t count = sizeof(keys) / sizeof(*keys);
+
+	EXPECT_TRUE(prefixed(set, "").empty());
+	EXPECT_TRUE(prefixed(set, "https").empty());
+
+	for (size_t i = 0; i < count; i++) {
+		EXPECT_EQ(0, set->insert(set, keys[i]));
+	}
+
+	std::vector<std::string> blog = {
+		"https://example.com/blog/2024/01/hello",
+		"https://example.com/blog/2024/02/again"
+	};
+	EXPECT_EQ(blog, prefixed(set, "https://example.com/blog"));
+	EXPECT_EQ(blog, prefixed(set, "https://example.com/b"));
+	EXPECT_EQ(std::vector<std::string>({
+		"https://example.com/blog/2024/02/again"
+	}), prefixed(set, "https://example.com/blog/2024/02/again"));
+
+	EXPECT_EQ(5u, prefixed(set, "https://").size());
+	EXPECT_EQ(6u, prefixed(set, "http").size());
+	EXPECT_EQ(count, prefixed(set, "").size());
+
+	EXPECT_TRUE(prefixed(set, "https://example.com/blog/2025").empty());
+	EXPECT_TRUE(prefixed(set, "https://example.net").empty());
+	EXPECT_TRUE(prefixed(set, "https://example.com/about/").empty());
+	EXPECT_TRUE(prefixed(set, "ftp").empty());
+
+	set->del(set);
+}
@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+
+#include "set.h"
+#include "set/error.h"
+#include "set/roaring.h"
+
+#include <stdint.h>
+
+void * item(uintptr_t value)
+{
+	return (void *) value;
+}
+
+TEST (SetTest, BasicSetUsage) {
+	struct dt_set * set = dt_set_roaring_new();
+	EXPECT_TRUE(set) << "New failed!";
+
+	EXPECT_FALSE(set->has(set, item(42)));
+	EXPECT_EQ(0, set->insert(set, item(42)));
+	EXPECT_EQ(item(42), set->has(set, item(42)));
+	set->remove(set, item(42));
+	EXPECT_FALSE(set->has(set, item(42)));
+
+	if (sizeof(uintptr_t) > 4) {
+		EXPECT_EQ(DT_SET_ERROR, set->insert(set, item(UINT32_MAX + (uintptr_t) 1)));
+	}
+	EXPECT_EQ(0, set->insert(set, item(UINT32_MAX)));
+	EXPECT_EQ(item(UINT32_MAX), set->has(set, item(UINT32_MAX)));
+
+	set->del(set);
+}
+
+TEST (SetListTest, ItemsInOrder) {
+	struct dt_set * set = dt_set_roaring_new();
+
+	uintptr_t values[] = {900000, 3, 70000, 1, 65536, 65535};
+	for (size_t i = 0; i < sizeof(values) / sizeof(*values); i++) {
+		EXPECT_EQ(0, set->insert(set, item(values[i])));
+	}
+	set->remove(set, item(70000));
+
+	struct dt_list * list = set->items(set);
+	ASSERT_TRUE(list);
+
+	uintptr_t expected[] = {1, 3, 65535, 65536, 900000};
+	ASSERT_EQ(sizeof(expected) / sizeof(*expected), list->length(list));
+	for (size_t i = 0; i < sizeof(expected) / sizeof(*expected); i++) {
+		EXPECT_EQ(item(expected[i]), list->get(list, i));
+	}
+
+	list->del(list);
+	set->del(set);
+}
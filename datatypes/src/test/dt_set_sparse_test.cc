@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+
+#include "set.h"
+#include "set/error.h"
+#include "set/sparse.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include <stdint.h>
+
+void * item(uintptr_t value)
+{
+	return (void *) value;
+}
+
+std::vector<uintptr_t> sorted_items(struct dt_set * set)
+{
+	void * const * items = dt_set_sparse_items(set);
+	std::vector<uintptr_t> values;
+	for (size_t i = 0; i < dt_set_sparse_length(set); i++) {
+		values.push_back((uintptr_t) items[i]);
+	}
+	std::sort(values.begin(), values.end());
+	return values;
+}
+
+TEST (SetTest, BasicSetUsage) {
+	struct dt_set * set = dt_set_sparse_new(100);
+	EXPECT_TRUE(set) << "New failed!";
+
+	EXPECT_FALSE(set->has(set, item(42)));
+	EXPECT_EQ(0, set->insert(set, item(42)));
+	EXPECT_EQ(0, set->insert(set, item(42)));
+	EXPECT_EQ(item(42), set->has(set, item(42)));
+	EXPECT_EQ(1u, dt_set_sparse_length(set));
+	set->remove(set, item(42));
+	EXPECT_FALSE(set->has(set, item(42)));
+	EXPECT_EQ(0u, dt_set_sparse_length(set));
+
+	EXPECT_EQ(DT_SET_ERROR, set->insert(set, item(100)));
+	EXPECT_FALSE(set->has(set, item(100)));
+	EXPECT_EQ(0, set->insert(set, item(99)));
+	EXPECT_EQ(item(99), set->has(set, item(99)));
+
+	set->del(set);
+}
+
+TEST (SetTest, ClearAndReuse) {
+	struct dt_set * set = dt_set_sparse_new(1000);
+
+	for (uintptr_t i = 1; i < 1000; i += 3) {
+		EXPECT_EQ(0, set->insert(set, item(i)));
+	}
+	dt_set_sparse_clear(set);
+	EXPECT_EQ(0u, dt_set_sparse_length(set));
+
+	// The stale entries must not show through.
+	for (uintptr_t i = 1; i < 1000; i++) {
+		EXPECT_FALSE(set->has(set, item(i))) << i;
+	}
+
+	EXPECT_EQ(0, set->insert(set, item(7)));
+	EXPECT_EQ(0, set->insert(set, item(4)));
+	EXPECT_EQ(item(4), set->has(set, item(4)));
+	EXPECT_EQ(item(7), set->has(set, item(7)));
+	EXPECT_FALSE(set->has(set, item(1)));
+	EXPECT_EQ(std::vector<uintptr_t>({4, 7}), sorted_items(set));
+
+	set->del(set);
+}
+
+TEST (SetTest, AgreesWithSet) {
+	const uintptr_t universe = 5000;
+	struct dt_set * set = dt_set_sparse_new(universe);
+	std::set<uintptr_t> model;
+	unsigned long state = 1;
+
+	for (size_t round = 0; round < 4; round++) {
+		for (size_t i = 0; i < 20000; i++) {
+			state = state * 6364136223846793005ul + 1442695040888963407ul;
+			uintptr_t value = (state >> 33) % universe;
+
+			if ((state >> 20) % 3) {
+				EXPECT_EQ(0, set->insert(set, item(value)));
+				model.insert(value);
+			} else {
+				set->remove(set, item(value));
+				model.erase(value);
+			}
+		}
+
+		EXPECT_EQ(model.size(), dt_set_sparse_length(set));
+		for (uintptr_t value = 1; value < universe; value++) {
+			EXPECT_EQ(model.count(value) == 1,
+				set->has(set, item(value)) != NULL) << value;
+		}
+		EXPECT_EQ(std::vector<uintptr_t>(model.begin(), model.end()),
+			sorted_items(set));
+
+		dt_set_sparse_clear(set);
+		model.clear();
+	}
+
+	set->del(set);
+}
+
+TEST (SetListTest, BasicUsage) {
+	struct dt_set * set = dt_set_sparse_new(64);
+
+	uintptr_t values[] = {5, 9, 33, 2, 63};
+	for (size_t i = 0; i < sizeof(values) / sizeof(*values); i++) {
+		EXPECT_EQ(0, set->insert(set, item(values[i])));
+	}
+	set->remove(set, item(9));
+
+	struct dt_list * list = set->items(set);
+	ASSERT_TRUE(list);
+
+	// Insertion order, with the last item moved into the
+	// removed one's place.
+	uintptr_t expected[] = {5, 63, 33, 2};
+	ASSERT_EQ(sizeof(expected) / sizeof(*expected), list->length(list));
+	for (size_t i = 0; i < sizeof(expected) / sizeof(*expected); i++) {
+		EXPECT_EQ(item(expected[i]), list->get(list, i));
+	}
+
+	list->del(list);
+	set->del(set);
+}
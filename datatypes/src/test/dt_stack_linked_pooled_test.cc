@@ -0,0 +1,220 @@
+#include "gtest/gtest.h"
+
+#include "stack.h"
+#include "stack/error.h"
+#include "stack/linked.h"
+
+static char items[] = "";
+static struct dt_stack * new_stack() {
+	return dt_stack_linked_pooled_new(NULL);
+}
+
+TEST (StackTest, BasicStackUsage) {
+	struct dt_stack * stack = new_stack();
+	EXPECT_TRUE(stack) << "New failed!";
+
+	EXPECT_EQ(0, stack->push(stack, items + 0));
+
+	EXPECT_EQ(1, stack->length(stack));
+
+	EXPECT_EQ(items + 0, stack->pop(stack));
+
+	stack->del(stack);
+}
+
+TEST (StackTest, SmallStack) {
+	struct dt_stack * stack = new_stack();
+	
+	EXPECT_EQ(0, stack->push(stack, items + 0));
+	EXPECT_EQ(0, stack->push(stack, items + 1));
+	EXPECT_EQ(0, stack->push(stack, items + 2));
+	EXPECT_EQ(0, stack->push(stack, items + 3));
+
+	EXPECT_EQ(4, stack->length(stack));
+
+	EXPECT_EQ(items + 3, stack->pop(stack));
+	EXPECT_EQ(items + 2, stack->pop(stack));
+	EXPECT_EQ(items + 1, stack->pop(stack));
+	EXPECT_EQ(items + 0, stack->pop(stack));
+	EXPECT_EQ(NULL, stack->pop(stack));
+
+	EXPECT_EQ(0, stack->length(stack));
+
+	stack->del(stack);
+}
+
+TEST (StackTest, SmallPeek) {
+	struct dt_stack * stack = new_stack();
+	
+	EXPECT_EQ(0, stack->push(stack, items + 0));
+	EXPECT_EQ(items + 0, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 1));
+	EXPECT_EQ(items + 1, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 2));
+	EXPECT_EQ(items + 2, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 3));
+	EXPECT_EQ(items + 3, stack->peek(stack));
+
+	EXPECT_EQ(4, stack->length(stack));
+
+	EXPECT_EQ(items + 3, stack->pop(stack));
+	EXPECT_EQ(items + 2, stack->peek(stack));
+	EXPECT_EQ(items + 2, stack->pop(stack));
+	EXPECT_EQ(items + 1, stack->peek(stack));
+	EXPECT_EQ(items + 1, stack->pop(stack));
+	EXPECT_EQ(items + 0, stack->peek(stack));
+	EXPECT_EQ(items + 0, stack->pop(stack));
+	EXPECT_EQ(NULL, stack->peek(stack));
+
+	EXPECT_EQ(0, stack->length(stack));
+
+	stack->del(stack);
+
+}
+
+TEST (StackTest, LargeStack) {
+	struct dt_stack * stack = new_stack();
+	
+	EXPECT_EQ(0, stack->push(stack, items + 0));
+	EXPECT_EQ(items + 0, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 1));
+	EXPECT_EQ(items + 1, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 2));
+	EXPECT_EQ(items + 2, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 3));
+	EXPECT_EQ(items + 3, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 4));
+	EXPECT_EQ(items + 4, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 5));
+	EXPECT_EQ(items + 5, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 6));
+	EXPECT_EQ(items + 6, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 7));
+	EXPECT_EQ(items + 7, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 8));
+	EXPECT_EQ(items + 8, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 9));
+	EXPECT_EQ(items + 9, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 10));
+	EXPECT_EQ(items + 10, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 11));
+	EXPECT_EQ(items + 11, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 12));
+	EXPECT_EQ(items + 12, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 13));
+	EXPECT_EQ(items + 13, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 14));
+	EXPECT_EQ(items + 14, stack->peek(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 15));
+	EXPECT_EQ(items + 15, stack->peek(stack));
+
+
+	EXPECT_EQ(16, stack->length(stack));
+
+	EXPECT_EQ(items + 15, stack->pop(stack));
+	EXPECT_EQ(items + 14, stack->peek(stack));
+	EXPECT_EQ(items + 14, stack->pop(stack));
+	EXPECT_EQ(items + 13, stack->peek(stack));
+	EXPECT_EQ(items + 13, stack->pop(stack));
+	EXPECT_EQ(items + 12, stack->peek(stack));
+	EXPECT_EQ(items + 12, stack->pop(stack));
+	EXPECT_EQ(items + 11, stack->peek(stack));
+	EXPECT_EQ(items + 11, stack->pop(stack));
+	EXPECT_EQ(items + 10, stack->peek(stack));
+	EXPECT_EQ(items + 10, stack->pop(stack));
+	EXPECT_EQ(items + 9, stack->peek(stack));
+	EXPECT_EQ(items + 9, stack->pop(stack));
+	EXPECT_EQ(items + 8, stack->peek(stack));
+	EXPECT_EQ(items + 8, stack->pop(stack));
+	EXPECT_EQ(items + 7, stack->peek(stack));
+	EXPECT_EQ(items + 7, stack->pop(stack));
+	EXPECT_EQ(items + 6, stack->peek(stack));
+	EXPECT_EQ(items + 6, stack->pop(stack));
+	EXPECT_EQ(items + 5, stack->peek(stack));
+	EXPECT_EQ(items + 5, stack->pop(stack));
+	EXPECT_EQ(items + 4, stack->peek(stack));
+	EXPECT_EQ(items + 4, stack->pop(stack));
+	EXPECT_EQ(items + 3, stack->peek(stack));
+	EXPECT_EQ(items + 3, stack->pop(stack));
+	EXPECT_EQ(items + 2, stack->peek(stack));
+	EXPECT_EQ(items + 2, stack->pop(stack));
+	EXPECT_EQ(items + 1, stack->peek(stack));
+	EXPECT_EQ(items + 1, stack->pop(stack));
+	EXPECT_EQ(items + 0, stack->peek(stack));
+	EXPECT_EQ(items + 0, stack->pop(stack));
+	EXPECT_EQ(NULL, stack->peek(stack));
+
+	EXPECT_EQ(0, stack->length(stack));
+
+	stack->del(stack);
+}
+
+TEST (PoolTest, SharedPool) {
+	struct dt_pool * pool = dt_pool_new(dt_stack_linked_node_size(), 8);
+	ASSERT_TRUE(pool);
+
+	struct dt_stack * first = dt_stack_linked_pooled_new(pool);
+	struct dt_stack * second = dt_stack_linked_pooled_new(pool);
+	ASSERT_TRUE(first);
+	ASSERT_TRUE(second);
+
+	for (size_t i = 0; i < 16; i++) {
+		EXPECT_EQ(0, first->push(first, items + i));
+	}
+	EXPECT_EQ(2, dt_pool_slab_count(pool));
+
+	// Moving everything across needs no new slabs.
+	while (first->length(first)) {
+		EXPECT_EQ(0, second->push(second, first->pop(first)));
+	}
+	EXPECT_EQ(2, dt_pool_slab_count(pool));
+	EXPECT_EQ(16, dt_pool_length(pool));
+
+	for (size_t i = 0; i < 16; i++) {
+		EXPECT_EQ(items + i, second->pop(second));
+	}
+
+	second->push(second, items + 1);
+	first->del(first);
+	second->del(second);
+	EXPECT_EQ(0, dt_pool_length(pool));
+	dt_pool_del(pool);
+}
+
+TEST (BatchTest, PushPopMany) {
+	struct dt_stack * stack = new_stack();
+	void * in[1200];
+	void * out[1200];
+
+	for (size_t i = 0; i < 1200; i++) in[i] = items + i;
+
+	EXPECT_EQ(0, stack->push_many(stack, in, 0));
+	EXPECT_EQ(0, stack->length(stack));
+	EXPECT_EQ(0, stack->push_many(stack, in, 3));
+	EXPECT_EQ(items + 2, stack->peek(stack));
+	EXPECT_EQ(0, stack->push_many(stack, in + 3, 1197));
+	EXPECT_EQ(1200, stack->length(stack));
+
+	// Batches mix with single pushes and pops.
+	EXPECT_EQ(items + 1199, stack->pop(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 1199));
+
+	// Items come out in the order they went in.
+	EXPECT_EQ(700, stack->pop_many(stack, out, 700));
+	for (size_t i = 0; i < 700; i++) {
+		EXPECT_EQ(items + 500 + i, out[i]);
+	}
+	EXPECT_EQ(500, stack->length(stack));
+	EXPECT_EQ(items + 499, stack->peek(stack));
+
+	EXPECT_EQ(500, stack->pop_many(stack, out, 1200));
+	for (size_t i = 0; i < 500; i++) {
+		EXPECT_EQ(items + i, out[i]);
+	}
+
+	EXPECT_EQ(0, stack->length(stack));
+	EXPECT_EQ(0, stack->pop_many(stack, out, 5));
+	EXPECT_EQ(NULL, stack->peek(stack));
+
+	stack->del(stack);
+}
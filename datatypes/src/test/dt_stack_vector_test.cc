@@ -148,3 +148,63 @@ TEST (StackTest, LargeStack) {
 
 	stack->del(stack);
 }
+
+TEST (InitTest, SpillAndReturn) {
+	struct dt_stack_vector_storage storage;
+	struct dt_stack * stack = dt_stack_vector_init(&storage);
+
+	for (size_t i = 0; i < DT_STACK_VECTOR_INLINE_LENGTH * 4; i++) {
+		EXPECT_EQ(0, stack->push(stack, items + i));
+	}
+	EXPECT_EQ(DT_STACK_VECTOR_INLINE_LENGTH * 4, stack->length(stack));
+
+	for (size_t i = DT_STACK_VECTOR_INLINE_LENGTH * 4; i > 1; i--) {
+		EXPECT_EQ(items + i - 1, stack->pop(stack));
+	}
+	EXPECT_EQ(items + 0, stack->peek(stack));
+
+	// Spill again so del has something to release.
+	for (size_t i = 0; i < DT_STACK_VECTOR_INLINE_LENGTH * 2; i++) {
+		EXPECT_EQ(0, stack->push(stack, items + i));
+	}
+
+	stack->del(stack);
+}
+
+TEST (BatchTest, PushPopMany) {
+	struct dt_stack * stack = new_stack();
+	void * in[1200];
+	void * out[1200];
+
+	for (size_t i = 0; i < 1200; i++) in[i] = items + i;
+
+	EXPECT_EQ(0, stack->push_many(stack, in, 0));
+	EXPECT_EQ(0, stack->length(stack));
+	EXPECT_EQ(0, stack->push_many(stack, in, 3));
+	EXPECT_EQ(items + 2, stack->peek(stack));
+	EXPECT_EQ(0, stack->push_many(stack, in + 3, 1197));
+	EXPECT_EQ(1200, stack->length(stack));
+
+	// Batches mix with single pushes and pops.
+	EXPECT_EQ(items + 1199, stack->pop(stack));
+	EXPECT_EQ(0, stack->push(stack, items + 1199));
+
+	// Items come out in the order they went in.
+	EXPECT_EQ(700, stack->pop_many(stack, out, 700));
+	for (size_t i = 0; i < 700; i++) {
+		EXPECT_EQ(items + 500 + i, out[i]);
+	}
+	EXPECT_EQ(500, stack->length(stack));
+	EXPECT_EQ(items + 499, stack->peek(stack));
+
+	EXPECT_EQ(500, stack->pop_many(stack, out, 1200));
+	for (size_t i = 0; i < 500; i++) {
+		EXPECT_EQ(items + i, out[i]);
+	}
+
+	EXPECT_EQ(0, stack->length(stack));
+	EXPECT_EQ(0, stack->pop_many(stack, out, 5));
+	EXPECT_EQ(NULL, stack->peek(stack));
+
+	stack->del(stack);
+}